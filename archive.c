@@ -0,0 +1,1407 @@
+// archive.c
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE // copy_file_range
+#endif
+#include "archive.h"
+#include "event.h"
+#include "filetype.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <zlib.h>
+
+#define ARCHIVE_MAX_META (1024 * 1024)   // GNU 긴 이름, pax 헤더로 받는 최대 크기
+#define ARCHIVE_COPY_CHUNK (8 * 1024 * 1024) // copy_file_range 한 번에 넘기는 양 (진행률 갱신 단위)
+#define TAR_NUMBER_MAX ((off_t)1 << 62)      // tar 크기의 상한 (512 단위로 올려도 off_t가 넘치지 않도록)
+
+// 최근에 연 압축 파일 (앞이 최근, 메인 스레드 전용)
+static Archive *g_cache[ARCHIVE_CACHE_SLOTS];
+
+// ================ 항목 목록 ================
+
+typedef struct {
+    ArchiveMember *items;
+    int count;
+    int capacity;
+} MemberList;
+
+static inline uint16_t le16(const unsigned char *p) {
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static inline uint32_t le32(const unsigned char *p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static inline uint64_t le64(const unsigned char *p) {
+    return (uint64_t)le32(p) | ((uint64_t)le32(p + 4) << 32);
+}
+
+// 압축 안의 경로 정리 - 앞의 "/"와 "./", 빈 단계와 "."은 빼고, ".."이 있으면 받지 않음
+static bool normalize_name(const char *raw, char *out, size_t out_size) {
+    size_t len = 0;
+    const char *p = raw;
+    while (*p) {
+        while (*p == '/') p++;
+        const char *start = p;
+        while (*p && *p != '/') p++;
+        size_t part = (size_t)(p - start);
+        if (part == 0 || (part == 1 && start[0] == '.')) continue;
+        if (part == 2 && start[0] == '.' && start[1] == '.') return false;
+        if (len + part + 2 > out_size) return false;
+        if (len > 0) out[len++] = '/';
+        memcpy(out + len, start, part);
+        len += part;
+    }
+    out[len] = '\0';
+    return len > 0;
+}
+
+static bool add_member(MemberList *list, const char *raw_name, const char *link, const ArchiveMember *info) {
+    char name[MAX_PATH_LEN];
+    if (!normalize_name(raw_name, name, sizeof(name))) return true; // 쓸 수 없는 이름은 건너뜀
+    if (list->count == list->capacity) {
+        int capacity = list->capacity ? list->capacity * 2 : 256;
+        ArchiveMember *items = realloc(list->items, sizeof(ArchiveMember) * capacity);
+        if (!items) return false;
+        list->items = items;
+        list->capacity = capacity;
+    }
+    ArchiveMember *member = &list->items[list->count];
+    *member = *info;
+    member->name = strdup(name);
+    member->link = (link && link[0]) ? strdup(link) : NULL;
+    if (!member->name || (link && link[0] && !member->link)) {
+        free(member->name);
+        free(member->link);
+        return false;
+    }
+    list->count++;
+    return true;
+}
+
+static void free_members(ArchiveMember *items, int count) {
+    for (int i = 0; i < count; i++) {
+        free(items[i].name);
+        free(items[i].link);
+    }
+    free(items);
+}
+
+// 경로순, 같은 경로면 압축에서 뒤에 있는 것이 뒤로 (나중 것이 앞 것을 덮음)
+static int compare_members(const void *a, const void *b) {
+    const ArchiveMember *x = (const ArchiveMember*)a;
+    const ArchiveMember *y = (const ArchiveMember*)b;
+    int diff = strcmp(x->name, y->name);
+    if (diff != 0) return diff;
+    return (x->offset > y->offset) - (x->offset < y->offset);
+}
+
+// name이 dir 아래에 있는지 ("a/b"는 "a" 아래)
+static bool is_under(const char *name, const char *dir) {
+    size_t len = strlen(dir);
+    return strncmp(name, dir, len) == 0 && name[len] == '/';
+}
+
+// 정렬하고 같은 경로는 마지막 것만 남긴 뒤, 압축에 없는 상위 디렉토리를 채움
+// 정렬된 목록에서는 한 디렉토리의 하위 항목이 연속되므로 지금 경로의 디렉토리들만 스택으로 기억하면 됨
+static bool finalize_members(MemberList *list) {
+    if (list->count == 0) return true;
+    qsort(list->items, list->count, sizeof(ArchiveMember), compare_members);
+
+    MemberList out = {0};
+    const char *stack[MAX_PATH_LEN / 2];
+    int depth = 0;
+    for (int i = 0; i < list->count; i++) {
+        ArchiveMember *member = &list->items[i];
+        if (i + 1 < list->count && strcmp(member->name, list->items[i + 1].name) == 0) {
+            free(member->name);
+            free(member->link);
+            continue;
+        }
+
+        while (depth > 0 && !is_under(member->name, stack[depth - 1])) depth--;
+        // 스택 맨 위 아래로 빠진 디렉토리들
+        const char *from = depth > 0 ? member->name + strlen(stack[depth - 1]) + 1 : member->name;
+        for (const char *slash = strchr(from, '/'); slash; slash = strchr(slash + 1, '/')) {
+            char parent[MAX_PATH_LEN];
+            snprintf(parent, sizeof(parent), "%.*s", (int)(slash - member->name), member->name);
+            ArchiveMember dir = { .mode = S_IFDIR | 0755, .mtime = member->mtime, .offset = member->offset,
+                                  .implied = true };
+            if (!add_member(&out, parent, NULL, &dir)) goto fail;
+            if (depth < (int)(sizeof(stack) / sizeof(stack[0]))) stack[depth++] = out.items[out.count - 1].name;
+        }
+
+        if (out.count == out.capacity) {
+            int capacity = out.capacity ? out.capacity * 2 : 256;
+            ArchiveMember *items = realloc(out.items, sizeof(ArchiveMember) * capacity);
+            if (!items) goto fail;
+            out.items = items;
+            out.capacity = capacity;
+        }
+        out.items[out.count++] = *member; // 이름 소유권을 넘김
+        member->name = NULL;
+        member->link = NULL;
+        if (S_ISDIR(out.items[out.count - 1].mode) && depth < (int)(sizeof(stack) / sizeof(stack[0]))) {
+            stack[depth++] = out.items[out.count - 1].name;
+        }
+    }
+    // 채운 디렉토리가 그보다 앞서야 할 형제("a/b-c" < "a/b/…"의 "a/b") 뒤에 들어갔을 수 있으므로 다시 정렬하고,
+    // 그 형제 때문에 스택에서 빠졌던 디렉토리가 한 번 더 채워졌으면 압축에 있던 쪽을 남김
+    qsort(out.items, out.count, sizeof(ArchiveMember), compare_members);
+    int kept = 0;
+    for (int i = 0; i < out.count; i++) {
+        if (kept > 0 && strcmp(out.items[kept - 1].name, out.items[i].name) == 0) {
+            ArchiveMember *drop = out.items[i].implied ? &out.items[i] : &out.items[kept - 1];
+            free(drop->name);
+            free(drop->link);
+            if (drop == &out.items[kept - 1]) out.items[kept - 1] = out.items[i];
+            continue;
+        }
+        out.items[kept++] = out.items[i];
+    }
+    out.count = kept;
+    free(list->items);
+    *list = out;
+    return true;
+
+fail:
+    for (int i = 0; i < list->count; i++) {
+        free(list->items[i].name);
+        free(list->items[i].link);
+    }
+    free(list->items);
+    free_members(out.items, out.count);
+    memset(list, 0, sizeof(MemberList));
+    return false;
+}
+
+// ================ tar 읽기 (그냥 tar는 pread, tar.gz는 풀면서 접근 지점 기록) ================
+
+typedef struct {
+    int fd;
+    bool gz;
+    off_t pos;                  // 압축 해제한 tar에서의 위치
+    off_t file_size;
+
+    z_stream strm;
+    unsigned char *input;
+    unsigned char *window;      // 출력 링 버퍼 (언제나 마지막 32KB 출력을 담고 있어 접근 지점의 창이 됨)
+    size_t window_pos;          // 다음 출력을 쓸 위치
+    size_t ready_start;         // 아직 넘기지 않은 출력
+    size_t ready;
+    off_t last_point;
+    bool end;
+    bool failed;
+    Archive *archive;           // 접근 지점을 더할 곳
+} TarReader;
+
+static bool add_point(TarReader *r) {
+    Archive *a = r->archive;
+    ArchivePoint *points = realloc(a->points, sizeof(ArchivePoint) * (a->point_count + 1));
+    if (!points) return false;
+    a->points = points;
+    ArchivePoint *point = &points[a->point_count];
+    point->window = malloc(ARCHIVE_WINDOW);
+    if (!point->window) return false;
+    point->out = (off_t)r->strm.total_out;
+    point->in = (off_t)r->strm.total_in;
+    point->bits = r->strm.data_type & 7;
+    // 링의 쓰기 위치부터가 가장 오래된 출력
+    size_t left = r->strm.avail_out;
+    if (left) memcpy(point->window, r->window + ARCHIVE_WINDOW - left, left);
+    if (left < ARCHIVE_WINDOW) memcpy(point->window + left, r->window, ARCHIVE_WINDOW - left);
+    a->point_count++;
+    r->last_point = point->out;
+    return true;
+}
+
+// 넘긴 출력을 다 쓴 뒤에만 부름 - 링의 다음 자리에 새 출력을 만듦
+static bool gz_produce(TarReader *r) {
+    if (r->window_pos == ARCHIVE_WINDOW) r->window_pos = 0;
+    r->strm.next_out = r->window + r->window_pos;
+    r->strm.avail_out = ARCHIVE_WINDOW - r->window_pos;
+    size_t space = r->strm.avail_out;
+
+    while (!r->end && !r->failed && r->strm.avail_out == space) {
+        if (r->strm.avail_in == 0) {
+            ssize_t got = read(r->fd, r->input, ARCHIVE_IO_BUFFER);
+            if (got < 0 && errno == EINTR) continue;
+            if (got <= 0) {
+                r->end = true; // 잘린 파일 - 읽은 데까지만
+                break;
+            }
+            r->strm.next_in = r->input;
+            r->strm.avail_in = (uInt)got;
+        }
+        int ret = inflate(&r->strm, Z_BLOCK);
+        if (ret == Z_NEED_DICT || ret == Z_DATA_ERROR || ret == Z_MEM_ERROR || ret == Z_STREAM_ERROR) {
+            r->failed = true;
+            break;
+        }
+        if (ret == Z_STREAM_END) r->end = true;
+        // 블록 경계 (마지막 블록 뒤 제외)에서 간격이 충분히 벌어졌으면 접근 지점
+        if ((r->strm.data_type & 128) && !(r->strm.data_type & 64) &&
+            (r->archive->point_count == 0 || (off_t)r->strm.total_out - r->last_point >= ARCHIVE_GZ_SPAN)) {
+            if (!add_point(r)) {
+                r->failed = true;
+                break;
+            }
+        }
+    }
+
+    size_t produced = space - r->strm.avail_out;
+    r->ready_start = r->window_pos;
+    r->ready = produced;
+    r->window_pos += produced;
+    return produced > 0;
+}
+
+// n바이트 읽기 (끝이면 덜 읽음)
+static size_t reader_read(TarReader *r, unsigned char *buffer, size_t n) {
+    size_t total = 0;
+    if (!r->gz) {
+        while (total < n) {
+            ssize_t got = pread(r->fd, buffer + total, n - total, r->pos);
+            if (got < 0 && errno == EINTR) continue;
+            if (got <= 0) break;
+            total += (size_t)got;
+            r->pos += got;
+        }
+        return total;
+    }
+    while (total < n) {
+        if (r->ready == 0 && !gz_produce(r)) break;
+        size_t take = r->ready < n - total ? r->ready : n - total;
+        if (buffer) memcpy(buffer + total, r->window + r->ready_start, take);
+        r->ready_start += take;
+        r->ready -= take;
+        r->pos += take;
+        total += take;
+    }
+    return total;
+}
+
+// n바이트 건너뛰기 (그냥 tar는 위치만 옮기고, tar.gz는 풀어서 버림)
+static bool reader_skip(TarReader *r, off_t n) {
+    if (n < 0) return false;
+    if (!r->gz) {
+        if (r->pos + n > r->file_size) return false;
+        r->pos += n;
+        return true;
+    }
+    while (n > 0) {
+        size_t step = n > ARCHIVE_IO_BUFFER ? ARCHIVE_IO_BUFFER : (size_t)n;
+        if (reader_read(r, NULL, step) != step) return false;
+        n -= step;
+    }
+    return true;
+}
+
+// 읽은 압축 파일 위치 (진행률)
+static off_t reader_progress(const TarReader *r) {
+    return r->gz ? (off_t)r->strm.total_in : r->pos;
+}
+
+// tar 숫자 칸 (8진수 또는 맨 앞 비트가 켜진 base-256) - 음수이거나 TAR_NUMBER_MAX를 넘으면 -1
+static off_t tar_number(const unsigned char *p, size_t len) {
+    off_t value = 0;
+    if (p[0] & 0x80) {
+        if (p[0] & 0x40) return -1; // 2의 보수 음수
+        value = p[0] & 0x3f;
+        for (size_t i = 1; i < len; i++) {
+            if (value >= TAR_NUMBER_MAX >> 8) return -1;
+            value = (value << 8) | p[i];
+        }
+        return value;
+    }
+    size_t i = 0;
+    while (i < len && (p[i] == ' ' || p[i] == '\0')) i++;
+    for (; i < len && p[i] >= '0' && p[i] <= '7'; i++) {
+        if (value >= TAR_NUMBER_MAX >> 3) return -1;
+        value = value * 8 + (p[i] - '0');
+    }
+    return value;
+}
+
+static bool tar_header_valid(const unsigned char *h) {
+    unsigned int sum = 0;
+    for (int i = 0; i < 512; i++) sum += (i >= 148 && i < 156) ? ' ' : h[i];
+    return sum == (unsigned int)tar_number(h + 148, 8);
+}
+
+static bool block_is_zero(const unsigned char *h) {
+    for (int i = 0; i < 512; i++) {
+        if (h[i]) return false;
+    }
+    return true;
+}
+
+// 고정 길이 칸을 문자열로
+static void tar_field(const unsigned char *p, size_t len, char *out) {
+    size_t n = strnlen((const char*)p, len);
+    memcpy(out, p, n);
+    out[n] = '\0';
+}
+
+// pax 확장 헤더 ("길이 키=값\n" 반복)에서 쓰는 키만 - size가 숫자가 아니거나 음수, 너무 크면 false
+static bool parse_pax(char *text, size_t len, char **path, char **link, off_t *size, time_t *mtime) {
+    char *p = text;
+    char *end = text + len;
+    while (p < end) {
+        char *key;
+        long record = strtol(p, &key, 10);
+        if (record <= 0 || p + record > end || *key != ' ') break;
+        key++;
+        char *eq = memchr(key, '=', (size_t)(p + record - key));
+        if (!eq) break;
+        *eq = '\0';
+        char *value = eq + 1;
+        p[record - 1] = '\0'; // 끝의 줄바꿈
+        if (strcmp(key, "path") == 0) {
+            free(*path);
+            *path = strdup(value);
+        } else if (strcmp(key, "linkpath") == 0) {
+            free(*link);
+            *link = strdup(value);
+        } else if (strcmp(key, "size") == 0) {
+            char *rest;
+            errno = 0;
+            long long number = strtoll(value, &rest, 10);
+            if (errno != 0 || rest == value || *rest != '\0' || number < 0 || number > TAR_NUMBER_MAX) return false;
+            *size = (off_t)number;
+        } else if (strcmp(key, "mtime") == 0) {
+            *mtime = (time_t)strtoll(value, NULL, 10);
+        }
+        p += record;
+    }
+    return true;
+}
+
+static void scan_progress(ArchiveTask *task, off_t done) {
+    bool wake = false;
+    pthread_mutex_lock(&task->lock);
+    task->done = done;
+    long now = event_now_ms();
+    if (now - task->last_notify_ms >= ARCHIVE_NOTIFY_MS) {
+        task->last_notify_ms = now;
+        wake = true;
+    }
+    pthread_mutex_unlock(&task->lock);
+    if (wake) notify_ui();
+}
+
+// tar 헤더를 차례로 읽어 항목 목록을 만듦 (내용은 읽지 않고 건너뜀)
+static bool tar_scan(TarReader *r, ArchiveTask *task, MemberList *list, char *error, size_t error_size) {
+    unsigned char header[512];
+    char *long_name = NULL, *long_link = NULL;
+    char *pax_path = NULL, *pax_link = NULL;
+    off_t pax_size = -1;
+    time_t pax_mtime = -1;
+    bool ok = true;
+
+    while (!task->cancel) {
+        if (reader_read(r, header, sizeof(header)) != sizeof(header)) break; // 끝 표시 없이 끝난 tar
+        if (block_is_zero(header)) break;
+        if (!tar_header_valid(header)) {
+            snprintf(error, error_size, "tar 헤더가 손상됨 (위치 %lld)", (long long)(r->pos - 512));
+            ok = false;
+            break;
+        }
+
+        off_t size = tar_number(header + 124, 12);
+        if (size < 0) {
+            snprintf(error, error_size, "tar 헤더가 손상됨 (위치 %lld)", (long long)(r->pos - 512));
+            ok = false;
+            break;
+        }
+        char type = (char)header[156];
+        if (type == 'L' || type == 'K' || type == 'x') {
+            // 다음 항목의 긴 이름/링크 또는 pax 속성
+            if (size > ARCHIVE_MAX_META) {
+                snprintf(error, error_size, "tar 확장 헤더가 너무 큼");
+                ok = false;
+                break;
+            }
+            char *text = malloc((size_t)size + 1);
+            if (!text) {
+                snprintf(error, error_size, "메모리 부족");
+                ok = false;
+                break;
+            }
+            if (reader_read(r, (unsigned char*)text, (size_t)size) != (size_t)size ||
+                !reader_skip(r, ((size + 511) & ~(off_t)511) - size)) {
+                free(text);
+                snprintf(error, error_size, "tar가 중간에 끝남");
+                ok = false;
+                break;
+            }
+            text[size] = '\0';
+            if (type == 'L') {
+                free(long_name);
+                long_name = text;
+            } else if (type == 'K') {
+                free(long_link);
+                long_link = text;
+            } else {
+                bool valid = parse_pax(text, (size_t)size, &pax_path, &pax_link, &pax_size, &pax_mtime);
+                free(text);
+                if (!valid) {
+                    snprintf(error, error_size, "tar 확장 헤더가 손상됨");
+                    ok = false;
+                    break;
+                }
+            }
+            continue;
+        }
+
+        if (pax_size >= 0) size = pax_size;
+        char name[MAX_PATH_LEN * 2];
+        if (long_name || pax_path) {
+            snprintf(name, sizeof(name), "%s", long_name ? long_name : pax_path);
+        } else {
+            char base[101], prefix[156];
+            tar_field(header, 100, base);
+            tar_field(header + 345, 155, prefix);
+            if (memcmp(header + 257, "ustar", 5) == 0 && prefix[0]) {
+                snprintf(name, sizeof(name), "%s/%s", prefix, base);
+            } else {
+                snprintf(name, sizeof(name), "%s", base);
+            }
+        }
+        char link[MAX_PATH_LEN];
+        if (long_link || pax_link) {
+            snprintf(link, sizeof(link), "%s", long_link ? long_link : pax_link);
+        } else {
+            char field[101];
+            tar_field(header + 157, 100, field);
+            snprintf(link, sizeof(link), "%s", field);
+        }
+
+        ArchiveMember info = {0};
+        info.mode = (mode_t)(tar_number(header + 100, 8) & 07777);
+        info.mtime = pax_mtime >= 0 ? pax_mtime : (time_t)tar_number(header + 136, 12);
+        info.offset = r->pos;
+        bool keep = true;
+        size_t name_len = strlen(name);
+        if (type == '5' || ((type == '0' || type == '\0') && name_len > 0 && name[name_len - 1] == '/')) {
+            info.mode |= S_IFDIR;
+        } else if (type == '0' || type == '\0' || type == '7') {
+            info.mode |= S_IFREG;
+            info.size = size;
+        } else if (type == '2') {
+            info.mode = S_IFLNK | 0777;
+        } else if (type == '1') {
+            info.mode |= S_IFREG; // 크기와 내용은 꺼낼 때 원본 항목에서
+            info.hardlink = true;
+        } else {
+            keep = false; // 장치 파일, FIFO 등
+        }
+        if (keep) {
+            char target[MAX_PATH_LEN] = "";
+            if (type == '1') normalize_name(link, target, sizeof(target));
+            if (!add_member(list, name, type == '2' ? link : target, &info)) {
+                snprintf(error, error_size, "메모리 부족");
+                ok = false;
+                break;
+            }
+        }
+
+        free(long_name);
+        free(long_link);
+        free(pax_path);
+        free(pax_link);
+        long_name = long_link = pax_path = pax_link = NULL;
+        pax_size = -1;
+        pax_mtime = -1;
+
+        // 내용은 읽지 않고 512바이트 단위로 건너뜀
+        if (!reader_skip(r, (size + 511) & ~(off_t)511)) break;
+        scan_progress(task, reader_progress(r));
+    }
+
+    if (ok && r->failed) {
+        snprintf(error, error_size, "gzip 압축이 손상됨");
+        ok = false;
+    }
+    free(long_name);
+    free(long_link);
+    free(pax_path);
+    free(pax_link);
+    return ok;
+}
+
+// 하드 링크의 크기를 원본 항목의 크기로 (정렬이 끝난 뒤)
+static void resolve_hardlinks(Archive *a) {
+    for (int i = 0; i < a->count; i++) {
+        ArchiveMember *m = &a->members[i];
+        if (!m->hardlink || !m->link) continue;
+        int target = archive_find(a, m->link);
+        if (target >= 0 && !a->members[target].hardlink) m->size = a->members[target].size;
+    }
+}
+
+// ================ zip 읽기 (끝의 중앙 디렉토리만 읽음) ================
+
+static time_t dos_time(uint16_t time, uint16_t date) {
+    struct tm tm = {0};
+    tm.tm_year = ((date >> 9) & 0x7f) + 80;
+    tm.tm_mon = ((date >> 5) & 0x0f) - 1;
+    tm.tm_mday = date & 0x1f;
+    tm.tm_hour = (time >> 11) & 0x1f;
+    tm.tm_min = (time >> 5) & 0x3f;
+    tm.tm_sec = (time & 0x1f) * 2;
+    tm.tm_isdst = -1;
+    return mktime(&tm);
+}
+
+static bool read_exact(int fd, void *buffer, size_t n, off_t offset) {
+    size_t total = 0;
+    while (total < n) {
+        ssize_t got = pread(fd, (char*)buffer + total, n - total, offset + (off_t)total);
+        if (got < 0 && errno == EINTR) continue;
+        if (got <= 0) return false;
+        total += (size_t)got;
+    }
+    return true;
+}
+
+static bool zip_scan(int fd, off_t file_size, MemberList *list, char *error, size_t error_size) {
+    // 끝 레코드는 주석(최대 64KB) 앞에 있음
+    size_t tail = file_size < 65557 + 20 ? (size_t)file_size : 65557 + 20;
+    unsigned char *buffer = malloc(tail);
+    if (!buffer || !read_exact(fd, buffer, tail, file_size - (off_t)tail)) {
+        free(buffer);
+        snprintf(error, error_size, "zip을 읽을 수 없음");
+        return false;
+    }
+    long eocd = -1;
+    for (long i = (long)tail - 22; i >= 0; i--) {
+        if (le32(buffer + i) == 0x06054b50) {
+            eocd = i;
+            break;
+        }
+    }
+    if (eocd < 0) {
+        free(buffer);
+        snprintf(error, error_size, "zip 끝 레코드가 없음");
+        return false;
+    }
+    uint64_t entries = le16(buffer + eocd + 10);
+    uint64_t cd_size = le32(buffer + eocd + 12);
+    uint64_t cd_offset = le32(buffer + eocd + 16);
+    if ((entries == 0xffff || cd_size == 0xffffffffu || cd_offset == 0xffffffffu) && eocd >= 20 &&
+        le32(buffer + eocd - 20) == 0x07064b50) {
+        // zip64 - 위치 레코드가 가리키는 zip64 끝 레코드
+        unsigned char record[56];
+        if (read_exact(fd, record, sizeof(record), (off_t)le64(buffer + eocd - 20 + 8)) &&
+            le32(record) == 0x06064b50) {
+            entries = le64(record + 32);
+            cd_size = le64(record + 40);
+            cd_offset = le64(record + 48);
+        }
+    }
+    free(buffer);
+    if (cd_offset + cd_size > (uint64_t)file_size || cd_size > (uint64_t)1 << 31) {
+        snprintf(error, error_size, "zip 중앙 디렉토리가 손상됨");
+        return false;
+    }
+
+    unsigned char *cd = malloc(cd_size ? cd_size : 1);
+    if (!cd || !read_exact(fd, cd, cd_size, (off_t)cd_offset)) {
+        free(cd);
+        snprintf(error, error_size, "zip 중앙 디렉토리를 읽을 수 없음");
+        return false;
+    }
+
+    bool ok = true;
+    size_t pos = 0;
+    for (uint64_t n = 0; n < entries && pos + 46 <= cd_size; n++) {
+        const unsigned char *e = cd + pos;
+        if (le32(e) != 0x02014b50) break;
+        uint16_t made_by = le16(e + 4);
+        uint16_t flags = le16(e + 8);
+        uint16_t name_len = le16(e + 28), extra_len = le16(e + 30), comment_len = le16(e + 32);
+        if (pos + 46 + name_len + extra_len + comment_len > cd_size) break;
+
+        ArchiveMember info = {0};
+        info.method = (flags & 1) ? -1 : le16(e + 10); // 암호화된 항목은 꺼낼 수 없음
+        info.crc = le32(e + 16);
+        info.mtime = dos_time(le16(e + 12), le16(e + 14));
+        uint64_t packed = le32(e + 20), size = le32(e + 24), offset = le32(e + 42);
+
+        // zip64 추가 칸 (32비트 칸이 가득 찬 값만 순서대로 들어 있음)
+        const unsigned char *extra = e + 46 + name_len;
+        for (size_t x = 0; x + 4 <= extra_len;) {
+            uint16_t id = le16(extra + x), len = le16(extra + x + 2);
+            if (x + 4 + len > extra_len) break;
+            if (id == 0x0001) {
+                const unsigned char *v = extra + x + 4;
+                const unsigned char *v_end = v + len;
+                if (size == 0xffffffffu && v + 8 <= v_end) { size = le64(v); v += 8; }
+                if (packed == 0xffffffffu && v + 8 <= v_end) { packed = le64(v); v += 8; }
+                if (offset == 0xffffffffu && v + 8 <= v_end) { offset = le64(v); }
+            }
+            x += 4 + len;
+        }
+        info.size = (off_t)size;
+        info.packed = (off_t)packed;
+        info.offset = (off_t)offset;
+
+        char name[MAX_PATH_LEN * 2];
+        snprintf(name, sizeof(name), "%.*s", (int)name_len, (const char*)e + 46);
+        mode_t unix_mode = (made_by >> 8) == 3 ? (mode_t)(le32(e + 38) >> 16) : 0;
+        if (name_len > 0 && name[name_len - 1] == '/') {
+            info.mode = S_IFDIR | 0755;
+            info.size = 0;
+        } else if (S_ISLNK(unix_mode)) {
+            info.mode = S_IFLNK | 0777; // 대상은 내용 (꺼낼 때 읽음)
+        } else if (S_ISDIR(unix_mode)) {
+            info.mode = S_IFDIR | (unix_mode & 07777);
+            info.size = 0;
+        } else {
+            info.mode = S_IFREG | (unix_mode & 07777 ? unix_mode & 07777 : 0644);
+        }
+        if (!add_member(list, name, NULL, &info)) {
+            snprintf(error, error_size, "메모리 부족");
+            ok = false;
+            break;
+        }
+        pos += 46 + name_len + extra_len + comment_len;
+    }
+    free(cd);
+    return ok;
+}
+
+// ================ 형식 판별과 색인 만들기 ================
+
+static ArchiveFormat detect_fd(int fd) {
+    unsigned char head[512];
+    ssize_t got = pread(fd, head, sizeof(head), 0);
+    if (got < 4) return ARCHIVE_NONE;
+    if (memcmp(head, "PK\x03\x04", 4) == 0 || memcmp(head, "PK\x05\x06", 4) == 0) return ARCHIVE_ZIP;
+    if (head[0] == 0x1f && head[1] == 0x8b) {
+        // 풀어서 첫 블록이 tar 헤더인지 확인 (그냥 .gz 파일은 열지 않음)
+        unsigned char input[4096], block[512];
+        ssize_t in = pread(fd, input, sizeof(input), 0);
+        if (in <= 0) return ARCHIVE_NONE;
+        z_stream strm = {0};
+        if (inflateInit2(&strm, 15 + 16) != Z_OK) return ARCHIVE_NONE;
+        strm.next_in = input;
+        strm.avail_in = (uInt)in;
+        strm.next_out = block;
+        strm.avail_out = sizeof(block);
+        int ret = inflate(&strm, Z_SYNC_FLUSH);
+        bool full = (strm.avail_out == 0);
+        inflateEnd(&strm);
+        if ((ret == Z_OK || ret == Z_STREAM_END) && full && tar_header_valid(block)) return ARCHIVE_TAR_GZ;
+        return ARCHIVE_NONE;
+    }
+    if (got == 512 && tar_header_valid(head)) return ARCHIVE_TAR;
+    return ARCHIVE_NONE;
+}
+
+ArchiveFormat archive_detect(const char *path) {
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd == -1) return ARCHIVE_NONE;
+    ArchiveFormat format = detect_fd(fd);
+    close(fd);
+    return format;
+}
+
+static bool build_index(ArchiveTask *task, Archive *a, char *error, size_t error_size) {
+    int fd = open(a->path, O_RDONLY | O_CLOEXEC);
+    if (fd == -1) {
+        snprintf(error, error_size, "열 수 없음: %s", strerror(errno));
+        return false;
+    }
+    posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+    a->format = detect_fd(fd);
+
+    MemberList list = {0};
+    bool ok = false;
+    if (a->format == ARCHIVE_ZIP) {
+        ok = zip_scan(fd, a->size, &list, error, error_size);
+    } else if (a->format == ARCHIVE_TAR || a->format == ARCHIVE_TAR_GZ) {
+        TarReader r = { .fd = fd, .gz = (a->format == ARCHIVE_TAR_GZ), .file_size = a->size, .archive = a };
+        if (r.gz) {
+            r.input = malloc(ARCHIVE_IO_BUFFER);
+            r.window = calloc(1, ARCHIVE_WINDOW);
+            if (!r.input || !r.window || inflateInit2(&r.strm, 15 + 16) != Z_OK) {
+                free(r.input);
+                free(r.window);
+                close(fd);
+                snprintf(error, error_size, "메모리 부족");
+                return false;
+            }
+        }
+        ok = tar_scan(&r, task, &list, error, error_size);
+        if (r.gz) {
+            inflateEnd(&r.strm);
+            free(r.input);
+            free(r.window);
+        }
+    } else {
+        snprintf(error, error_size, "지원하지 않는 압축 형식 (tar, tar.gz, zip만)");
+    }
+    close(fd);
+
+    if (ok && task->cancel) {
+        snprintf(error, error_size, "취소됨");
+        ok = false;
+    }
+    if (ok && !finalize_members(&list)) {
+        snprintf(error, error_size, "메모리 부족");
+        ok = false;
+    }
+    if (!ok) {
+        free_members(list.items, list.count);
+        return false;
+    }
+    a->members = list.items;
+    a->count = list.count;
+    resolve_hardlinks(a);
+    return true;
+}
+
+static void archive_free(Archive *a) {
+    if (!a) return;
+    free_members(a->members, a->count);
+    for (int i = 0; i < a->point_count; i++) {
+        free(a->points[i].window);
+    }
+    free(a->points);
+    free(a);
+}
+
+void archive_release(Archive *archive) {
+    if (archive && --archive->refs <= 0) archive_free(archive);
+}
+
+// 같은 파일이면 캐시의 색인을 앞으로 옮겨 돌려줌 (inode가 같아도 내용이 바뀌었으면 버림)
+static Archive* cache_lookup(const struct stat *st) {
+    for (int i = 0; i < ARCHIVE_CACHE_SLOTS && g_cache[i]; i++) {
+        Archive *a = g_cache[i];
+        if (a->dev != st->st_dev || a->ino != st->st_ino) continue;
+        if (a->mtime != st->st_mtime || a->size != st->st_size) {
+            memmove(&g_cache[i], &g_cache[i + 1], sizeof(Archive*) * (ARCHIVE_CACHE_SLOTS - i - 1));
+            g_cache[ARCHIVE_CACHE_SLOTS - 1] = NULL;
+            archive_release(a);
+            return NULL;
+        }
+        memmove(&g_cache[1], &g_cache[0], sizeof(Archive*) * i);
+        g_cache[0] = a;
+        return a;
+    }
+    return NULL;
+}
+
+static void cache_insert(Archive *a) {
+    for (int i = 0; i < ARCHIVE_CACHE_SLOTS; i++) {
+        if (g_cache[i] == a) return;
+    }
+    archive_release(g_cache[ARCHIVE_CACHE_SLOTS - 1]);
+    memmove(&g_cache[1], &g_cache[0], sizeof(Archive*) * (ARCHIVE_CACHE_SLOTS - 1));
+    g_cache[0] = a;
+    a->refs++;
+}
+
+void cleanup_archives() {
+    for (int i = 0; i < ARCHIVE_CACHE_SLOTS; i++) {
+        archive_release(g_cache[i]);
+        g_cache[i] = NULL;
+    }
+}
+
+// ================ 목록 ================
+
+// name 이상인 첫 항목
+static int lower_bound(const Archive *a, const char *name) {
+    int lo = 0, hi = a->count;
+    while (lo < hi) {
+        int mid = lo + (hi - lo) / 2;
+        if (strcmp(a->members[mid].name, name) < 0) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+int archive_find(const Archive *archive, const char *name) {
+    int i = lower_bound(archive, name);
+    return (i < archive->count && strcmp(archive->members[i].name, name) == 0) ? i : -1;
+}
+
+static void fill_entry(FileEntry *file, const char *name, mode_t mode, off_t size, time_t mtime) {
+    memset(file, 0, sizeof(FileEntry));
+    snprintf(file->name, sizeof(file->name), "%s", name);
+    file->mode = mode;
+    file->copy_status = COPY_STATUS_NONE;
+    if (S_ISDIR(mode)) {
+        snprintf(file->type, sizeof(file->type), "디렉토리");
+        snprintf(file->size, sizeof(file->size), "-");
+    } else {
+        if (S_ISLNK(mode)) {
+            snprintf(file->type, sizeof(file->type), "심볼릭 링크");
+        } else {
+            file->file_type = (unsigned short)file_type_from_name(name);
+            snprintf(file->type, sizeof(file->type), "%s", file_type_label(file->file_type));
+        }
+        format_size(size, file->size, sizeof(file->size));
+    }
+    format_time(mtime, file->mtime, sizeof(file->mtime));
+    set_display_widths(file);
+}
+
+int archive_list(const Archive *archive, const char *prefix, FileEntry *files, int max_files) {
+    int count = 0;
+    if (max_files <= 0) return 0;
+    fill_entry(&files[count++], "..", S_IFDIR | 0755, 0, archive->mtime);
+
+    size_t prefix_len = strlen(prefix);
+    int i = lower_bound(archive, prefix);
+    while (i < archive->count && count < max_files) {
+        const ArchiveMember *m = &archive->members[i];
+        if (strncmp(m->name, prefix, prefix_len) != 0) break;
+        const char *rest = m->name + prefix_len;
+        const char *slash = strchr(rest, '/');
+        if (!slash) {
+            fill_entry(&files[count++], rest, m->mode, m->size, m->mtime);
+            i++;
+            continue;
+        }
+        // 더 깊은 항목 - 그 디렉토리 구간 전체를 건너뜀 ("a/b/…"는 "a/b/" 이상 "a/b0" 미만)
+        char bound[MAX_PATH_LEN];
+        snprintf(bound, sizeof(bound), "%.*s0", (int)(slash - m->name), m->name);
+        int next = lower_bound(archive, bound);
+        i = next > i ? next : i + 1;
+    }
+    return count;
+}
+
+// ================ 꺼내기 ================
+
+// 꺼낸 내용을 받는 곳 (파일 또는 메모리)
+typedef struct {
+    int fd;                     // -1이면 buffer에 모음
+    char *buffer;
+    size_t length;
+    size_t capacity;
+    ArchiveTask *task;          // 진행 상황과 취소 (없으면 NULL)
+} ArchiveSink;
+
+static bool sink_progress(ArchiveSink *sink, size_t len) {
+    ArchiveTask *task = sink->task;
+    if (!task) return true;
+    bool wake = false;
+    pthread_mutex_lock(&task->lock);
+    task->done += (off_t)len;
+    long now = event_now_ms();
+    if (now - task->last_notify_ms >= ARCHIVE_NOTIFY_MS) {
+        task->last_notify_ms = now;
+        wake = true;
+    }
+    pthread_mutex_unlock(&task->lock);
+    if (wake) notify_ui();
+    return !task->cancel;
+}
+
+static bool sink_write(ArchiveSink *sink, const unsigned char *data, size_t len) {
+    if (sink->fd == -1) {
+        if (sink->length + len > sink->capacity) return false;
+        memcpy(sink->buffer + sink->length, data, len);
+        sink->length += len;
+        return true;
+    }
+    size_t written = 0;
+    while (written < len) {
+        ssize_t n = write(sink->fd, data + written, len - written);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        written += (size_t)n;
+    }
+    return sink_progress(sink, len);
+}
+
+// 그냥 tar나 저장만 한 zip 항목 - 파일로 꺼낼 때는 커널 안에서 복사
+static bool copy_stored(int fd, off_t offset, off_t length, ArchiveSink *sink, char *error, size_t error_size) {
+    if (sink->fd != -1) {
+        while (length > 0) {
+            size_t step = length > ARCHIVE_COPY_CHUNK ? ARCHIVE_COPY_CHUNK : (size_t)length;
+            ssize_t n = copy_file_range(fd, &offset, sink->fd, NULL, step, 0);
+            if (n < 0 && errno == EINTR) continue;
+            if (n <= 0) break; // 지원하지 않으면 아래의 읽기/쓰기로
+            length -= n;
+            if (!sink_progress(sink, (size_t)n)) {
+                snprintf(error, error_size, "취소됨");
+                return false;
+            }
+        }
+        if (length == 0) return true;
+    }
+    unsigned char *buffer = malloc(ARCHIVE_IO_BUFFER);
+    if (!buffer) {
+        snprintf(error, error_size, "메모리 부족");
+        return false;
+    }
+    bool ok = true;
+    while (length > 0) {
+        size_t step = length > ARCHIVE_IO_BUFFER ? ARCHIVE_IO_BUFFER : (size_t)length;
+        if (!read_exact(fd, buffer, step, offset)) {
+            snprintf(error, error_size, "압축 파일이 중간에 끝남");
+            ok = false;
+            break;
+        }
+        if (!sink_write(sink, buffer, step)) {
+            snprintf(error, error_size, sink->task && sink->task->cancel ? "취소됨" : "쓰기 실패: %s",
+                     strerror(errno));
+            ok = false;
+            break;
+        }
+        offset += (off_t)step;
+        length -= (off_t)step;
+    }
+    free(buffer);
+    return ok;
+}
+
+// deflate 풀기 - skip만큼 버린 뒤 length만큼 넘김 (in부터 압축 파일을 읽음)
+static bool inflate_range(int fd, z_stream *strm, off_t in, off_t skip, off_t length, ArchiveSink *sink,
+                          uLong *crc, char *error, size_t error_size) {
+    unsigned char *input = malloc(ARCHIVE_IO_BUFFER);
+    unsigned char *output = malloc(ARCHIVE_IO_BUFFER);
+    bool ok = (input && output);
+    if (!ok) snprintf(error, error_size, "메모리 부족");
+
+    while (ok && length > 0) {
+        if (strm->avail_in == 0) {
+            ssize_t got = pread(fd, input, ARCHIVE_IO_BUFFER, in);
+            if (got < 0 && errno == EINTR) continue;
+            if (got <= 0) {
+                snprintf(error, error_size, "압축 파일이 중간에 끝남");
+                ok = false;
+                break;
+            }
+            in += got;
+            strm->next_in = input;
+            strm->avail_in = (uInt)got;
+        }
+        strm->next_out = output;
+        strm->avail_out = ARCHIVE_IO_BUFFER;
+        int ret = inflate(strm, Z_NO_FLUSH);
+        if (ret == Z_NEED_DICT || ret == Z_DATA_ERROR || ret == Z_MEM_ERROR || ret == Z_STREAM_ERROR) {
+            snprintf(error, error_size, "압축 내용이 손상됨");
+            ok = false;
+            break;
+        }
+        size_t have = ARCHIVE_IO_BUFFER - strm->avail_out;
+        unsigned char *p = output;
+        if (skip > 0) {
+            size_t drop = skip < (off_t)have ? (size_t)skip : have;
+            skip -= (off_t)drop;
+            p += drop;
+            have -= drop;
+        }
+        if ((off_t)have > length) have = (size_t)length;
+        if (have > 0) {
+            if (crc) *crc = crc32(*crc, p, (uInt)have);
+            if (!sink_write(sink, p, have)) {
+                snprintf(error, error_size, sink->task && sink->task->cancel ? "취소됨" : "쓰기 실패: %s",
+                         strerror(errno));
+                ok = false;
+                break;
+            }
+            length -= (off_t)have;
+        }
+        if (ret == Z_STREAM_END && length > 0) {
+            snprintf(error, error_size, "압축 내용이 예상보다 짧음");
+            ok = false;
+        }
+    }
+    free(input);
+    free(output);
+    return ok;
+}
+
+// tar.gz - offset 앞의 가장 가까운 접근 지점부터만 풂
+static bool gz_extract(int fd, const Archive *a, off_t offset, off_t length, ArchiveSink *sink,
+                       char *error, size_t error_size) {
+    int lo = 0, hi = a->point_count - 1;
+    if (hi < 0) {
+        snprintf(error, error_size, "접근 지점이 없음");
+        return false;
+    }
+    while (lo < hi) {
+        int mid = lo + (hi - lo + 1) / 2;
+        if (a->points[mid].out <= offset) {
+            lo = mid;
+        } else {
+            hi = mid - 1;
+        }
+    }
+    const ArchivePoint *point = &a->points[lo];
+
+    z_stream strm = {0};
+    if (inflateInit2(&strm, -15) != Z_OK) {
+        snprintf(error, error_size, "메모리 부족");
+        return false;
+    }
+    off_t in = point->in;
+    if (point->bits) {
+        // 블록이 바이트 중간에서 시작하면 앞 바이트의 남은 비트부터
+        unsigned char byte;
+        if (!read_exact(fd, &byte, 1, in - 1)) {
+            inflateEnd(&strm);
+            snprintf(error, error_size, "압축 파일을 읽을 수 없음");
+            return false;
+        }
+        inflatePrime(&strm, point->bits, byte >> (8 - point->bits));
+    }
+    inflateSetDictionary(&strm, point->window, ARCHIVE_WINDOW);
+    bool ok = inflate_range(fd, &strm, in, offset - point->out, length, sink, NULL, error, error_size);
+    inflateEnd(&strm);
+    return ok;
+}
+
+static bool zip_extract(int fd, const ArchiveMember *m, ArchiveSink *sink, char *error, size_t error_size) {
+    unsigned char local[30];
+    if (!read_exact(fd, local, sizeof(local), m->offset) || le32(local) != 0x04034b50) {
+        snprintf(error, error_size, "zip 로컬 헤더가 손상됨");
+        return false;
+    }
+    off_t data = m->offset + 30 + le16(local + 26) + le16(local + 28);
+    if (m->method == 0) {
+        return copy_stored(fd, data, m->size, sink, error, error_size);
+    }
+    if (m->method != 8) {
+        snprintf(error, error_size, m->method < 0 ? "암호화된 항목" : "지원하지 않는 zip 압축 방식 (%d)", m->method);
+        return false;
+    }
+    z_stream strm = {0};
+    if (inflateInit2(&strm, -15) != Z_OK) {
+        snprintf(error, error_size, "메모리 부족");
+        return false;
+    }
+    uLong crc = crc32(0, NULL, 0);
+    bool ok = inflate_range(fd, &strm, data, 0, m->size, sink, &crc, error, error_size);
+    inflateEnd(&strm);
+    if (ok && crc != m->crc) {
+        snprintf(error, error_size, "CRC 불일치");
+        ok = false;
+    }
+    return ok;
+}
+
+// 압축 파일을 열고 색인을 만든 뒤 바뀌지 않았는지 확인
+static int open_archive(const Archive *a, char *error, size_t error_size) {
+    int fd = open(a->path, O_RDONLY | O_CLOEXEC);
+    struct stat st;
+    if (fd == -1 || fstat(fd, &st) == -1) {
+        if (fd != -1) close(fd);
+        snprintf(error, error_size, "압축 파일을 열 수 없음: %s", strerror(errno));
+        return -1;
+    }
+    if (st.st_dev != a->dev || st.st_ino != a->ino || st.st_mtime != a->mtime || st.st_size != a->size) {
+        close(fd);
+        snprintf(error, error_size, "압축 파일이 바뀌었음 - 다시 열어 주세요");
+        return -1;
+    }
+    return fd;
+}
+
+// 항목 내용을 sink로 (하드 링크는 원본 항목의 내용)
+static bool extract_data(int fd, const Archive *a, int index, ArchiveSink *sink, char *error, size_t error_size) {
+    const ArchiveMember *m = &a->members[index];
+    if (m->hardlink) {
+        int target = m->link ? archive_find(a, m->link) : -1;
+        if (target < 0 || a->members[target].hardlink) {
+            snprintf(error, error_size, "하드 링크 원본이 없음: %s", m->link ? m->link : "");
+            return false;
+        }
+        m = &a->members[target];
+    }
+    if (a->format == ARCHIVE_ZIP) return zip_extract(fd, m, sink, error, error_size);
+    if (a->format == ARCHIVE_TAR_GZ) return gz_extract(fd, a, m->offset, m->size, sink, error, error_size);
+    return copy_stored(fd, m->offset, m->size, sink, error, error_size);
+}
+
+static bool extract_file_fd(int fd, const Archive *a, int index, const char *dest_path, ArchiveTask *task,
+                            char *error, size_t error_size) {
+    const ArchiveMember *m = &a->members[index];
+    mode_t mode = m->mode & 0777;
+    int out = open(dest_path, O_WRONLY | O_CREAT | O_EXCL | O_NOFOLLOW | O_CLOEXEC, mode ? mode : 0644);
+    if (out == -1) {
+        snprintf(error, error_size, "만들 수 없음: %s", strerror(errno));
+        return false;
+    }
+    ArchiveSink sink = { .fd = out, .task = task };
+    bool ok = extract_data(fd, a, index, &sink, error, error_size);
+    if (ok) {
+        struct timespec times[2] = { { .tv_nsec = UTIME_OMIT }, { .tv_sec = m->mtime } };
+        futimens(out, times);
+    }
+    if (close(out) == -1 && ok) {
+        snprintf(error, error_size, "쓰기 실패: %s", strerror(errno));
+        ok = false;
+    }
+    if (!ok) unlink(dest_path);
+    return ok;
+}
+
+bool archive_extract_file(const Archive *archive, int index, const char *dest_path, char *error, size_t error_size) {
+    if (index < 0 || index >= archive->count || !S_ISREG(archive->members[index].mode)) {
+        snprintf(error, error_size, "일반 파일이 아님");
+        return false;
+    }
+    int fd = open_archive(archive, error, error_size);
+    if (fd == -1) return false;
+    bool ok = extract_file_fd(fd, archive, index, dest_path, NULL, error, error_size);
+    close(fd);
+    return ok;
+}
+
+// 심볼릭 링크 만들기 (zip은 대상이 내용에 들어 있음)
+static bool extract_symlink(int fd, const Archive *a, int index, const char *dest_path, char *error, size_t error_size) {
+    const ArchiveMember *m = &a->members[index];
+    char target[MAX_PATH_LEN];
+    if (m->link) {
+        snprintf(target, sizeof(target), "%s", m->link);
+    } else {
+        ArchiveSink sink = { .fd = -1, .buffer = target, .capacity = sizeof(target) - 1 };
+        if (!extract_data(fd, a, index, &sink, error, error_size)) return false;
+        target[sink.length] = '\0';
+    }
+    if (symlink(target, dest_path) == -1) {
+        snprintf(error, error_size, "링크를 만들 수 없음: %s", strerror(errno));
+        return false;
+    }
+    return true;
+}
+
+// 디렉토리 하나를 하위 구조째 꺼냄 - 심볼릭 링크는 마지막에 만들어 링크를 거쳐 밖에 쓰지 않게 함
+static bool extract_tree(ArchiveTask *task, int fd, const Archive *a, int index, const char *dest_path,
+                         char *error, size_t error_size) {
+    if (mkdir(dest_path, 0755) == -1) {
+        snprintf(error, error_size, "디렉토리를 만들 수 없음: %s", strerror(errno));
+        return false;
+    }
+    const char *root = a->members[index].name;
+    size_t root_len = strlen(root);
+    bool ok = true;
+    for (int pass = 0; pass < 2 && !task->cancel; pass++) {
+        for (int i = index + 1; i < a->count && !task->cancel; i++) {
+            const ArchiveMember *m = &a->members[i];
+            if (!is_under(m->name, root)) break;
+            if ((pass == 1) != S_ISLNK(m->mode)) continue;
+
+            char path[MAX_PATH_LEN * 2];
+            snprintf(path, sizeof(path), "%s/%s", dest_path, m->name + root_len + 1);
+            char item_error[160] = "";
+            bool item_ok;
+            if (S_ISDIR(m->mode)) {
+                item_ok = (mkdir(path, 0755) == 0 || errno == EEXIST);
+                if (!item_ok) snprintf(item_error, sizeof(item_error), "%s", strerror(errno));
+            } else if (S_ISLNK(m->mode)) {
+                item_ok = extract_symlink(fd, a, i, path, item_error, sizeof(item_error));
+            } else {
+                item_ok = extract_file_fd(fd, a, i, path, task, item_error, sizeof(item_error));
+            }
+            if (!item_ok && !task->cancel) {
+                snprintf(error, error_size, "%s: %s", m->name, item_error);
+                ok = false;
+            }
+        }
+    }
+    return ok && !task->cancel;
+}
+
+static void* extract_thread(void *arg) {
+    ArchiveTask *task = (ArchiveTask*)arg;
+    Archive *a = task->archive;
+    char error[256] = "";
+    int fd = open_archive(a, error, sizeof(error));
+
+    for (int n = 0; fd != -1 && n < task->count && !task->cancel; n++) {
+        int index = archive_find(a, task->names[n]);
+        char item_error[256] = "";
+        bool ok = false;
+        if (index < 0) {
+            snprintf(item_error, sizeof(item_error), "압축 안에 없음: %s", task->names[n]);
+        } else {
+            const ArchiveMember *m = &a->members[index];
+            const char *slash = strrchr(m->name, '/');
+            char unique[MAX_NAME_LEN];
+            generate_unique_name_r(task->path, slash ? slash + 1 : m->name, unique, sizeof(unique));
+            char dest[MAX_PATH_LEN * 2];
+            snprintf(dest, sizeof(dest), "%s/%s", strcmp(task->path, "/") == 0 ? "" : task->path, unique);
+            if (S_ISDIR(m->mode)) {
+                ok = extract_tree(task, fd, a, index, dest, item_error, sizeof(item_error));
+            } else if (S_ISLNK(m->mode)) {
+                ok = extract_symlink(fd, a, index, dest, item_error, sizeof(item_error));
+            } else {
+                ok = extract_file_fd(fd, a, index, dest, task, item_error, sizeof(item_error));
+            }
+        }
+        pthread_mutex_lock(&task->lock);
+        if (ok) {
+            task->items_done++;
+        } else if (!task->cancel) {
+            task->items_failed++;
+            if (!error[0]) snprintf(error, sizeof(error), "%s", item_error);
+        }
+        pthread_mutex_unlock(&task->lock);
+    }
+    if (fd != -1) close(fd);
+
+    pthread_mutex_lock(&task->lock);
+    task->ok = (fd != -1 && task->items_failed == 0 && !task->cancel);
+    if (task->cancel) {
+        snprintf(task->message, sizeof(task->message), "꺼내기 취소됨 (%d개 꺼냄)", task->items_done);
+    } else if (task->ok) {
+        snprintf(task->message, sizeof(task->message), "%d개 꺼냄", task->items_done);
+    } else {
+        snprintf(task->message, sizeof(task->message), "%s", error);
+    }
+    task->finished = true;
+    pthread_mutex_unlock(&task->lock);
+    notify_ui();
+    return NULL;
+}
+
+// ================ 백그라운드 작업 ================
+
+static void* load_thread(void *arg) {
+    ArchiveTask *task = (ArchiveTask*)arg;
+    char error[256] = "";
+    bool ok = build_index(task, task->archive, error, sizeof(error));
+    pthread_mutex_lock(&task->lock);
+    task->ok = ok;
+    task->done = task->total;
+    snprintf(task->message, sizeof(task->message), "%s", error);
+    task->finished = true;
+    pthread_mutex_unlock(&task->lock);
+    notify_ui();
+    return NULL;
+}
+
+bool archive_load_start(ArchiveTask *task, const char *path) {
+    memset(task, 0, sizeof(ArchiveTask));
+    struct stat st;
+    if (stat(path, &st) == -1 || !S_ISREG(st.st_mode)) return false;
+    task->kind = ARCHIVE_TASK_LOAD;
+    snprintf(task->path, sizeof(task->path), "%s", path);
+    pthread_mutex_init(&task->lock, NULL);
+    task->total = st.st_size;
+
+    Archive *cached = cache_lookup(&st);
+    if (cached) {
+        cached->refs++;
+        task->archive = cached;
+        task->done = task->total;
+        task->ok = true;
+        task->finished = true;
+        task->active = true;
+        return true;
+    }
+
+    Archive *a = calloc(1, sizeof(Archive));
+    if (!a) {
+        pthread_mutex_destroy(&task->lock);
+        return false;
+    }
+    snprintf(a->path, sizeof(a->path), "%s", path);
+    a->dev = st.st_dev;
+    a->ino = st.st_ino;
+    a->mtime = st.st_mtime;
+    a->size = st.st_size;
+    a->refs = 1; // 작업이 잡은 참조
+    task->archive = a;
+    if (pthread_create(&task->thread, NULL, load_thread, task) != 0) {
+        archive_free(a);
+        pthread_mutex_destroy(&task->lock);
+        return false;
+    }
+    task->thread_started = true;
+    task->active = true;
+    return true;
+}
+
+bool archive_extract_start(ArchiveTask *task, Archive *archive, const char *const *names, int count,
+                           const char *dest_dir) {
+    memset(task, 0, sizeof(ArchiveTask));
+    if (count <= 0) return false;
+    task->kind = ARCHIVE_TASK_EXTRACT;
+    snprintf(task->path, sizeof(task->path), "%s", dest_dir);
+    task->names = calloc(count, sizeof(char*));
+    if (!task->names) return false;
+    for (int i = 0; i < count; i++) {
+        task->names[i] = strdup(names[i]);
+        if (!task->names[i]) break;
+        task->count++;
+
+        // 전체 양 (디렉토리는 하위 파일 합)
+        int index = archive_find(archive, names[i]);
+        if (index < 0) continue;
+        task->total += archive->members[index].size;
+        for (int j = index + 1; S_ISDIR(archive->members[index].mode) && j < archive->count &&
+                                is_under(archive->members[j].name, names[i]); j++) {
+            task->total += archive->members[j].size;
+        }
+    }
+    if (task->count < count) {
+        for (int i = 0; i < task->count; i++) free(task->names[i]);
+        free(task->names);
+        memset(task, 0, sizeof(ArchiveTask));
+        return false;
+    }
+    pthread_mutex_init(&task->lock, NULL);
+    task->archive = archive;
+    archive->refs++;
+    if (pthread_create(&task->thread, NULL, extract_thread, task) != 0) {
+        archive->refs--;
+        for (int i = 0; i < task->count; i++) free(task->names[i]);
+        free(task->names);
+        pthread_mutex_destroy(&task->lock);
+        memset(task, 0, sizeof(ArchiveTask));
+        return false;
+    }
+    task->thread_started = true;
+    task->active = true;
+    return true;
+}
+
+void archive_task_cancel(ArchiveTask *task) {
+    if (!task->active) return;
+    task->cancel = true;
+}
+
+void archive_task_stop(ArchiveTask *task, Archive **taken) {
+    if (taken) *taken = NULL;
+    if (!task->active) return;
+    if (!task->finished) task->cancel = true;
+    if (task->thread_started) pthread_join(task->thread, NULL);
+
+    Archive *a = task->archive;
+    if (task->kind == ARCHIVE_TASK_LOAD && task->ok && !task->cancel && a) {
+        cache_insert(a);
+        if (taken) {
+            *taken = a; // 작업의 참조를 넘김
+            a = NULL;
+        }
+    }
+    archive_release(a);
+    for (int i = 0; i < task->count; i++) {
+        free(task->names[i]);
+    }
+    free(task->names);
+    pthread_mutex_destroy(&task->lock);
+    memset(task, 0, sizeof(ArchiveTask));
+}
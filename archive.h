@@ -0,0 +1,121 @@
+// archive.h
+#ifndef ARCHIVE_H
+#define ARCHIVE_H
+
+#include <stdbool.h>
+#include <sys/types.h>
+#include <pthread.h>
+#include "fs.h"
+
+#define ARCHIVE_WINDOW 32768                 // deflate 참조 창 크기 (접근 지점마다 보관)
+#define ARCHIVE_GZ_SPAN (4 * 1024 * 1024)    // tar.gz 접근 지점 사이의 최소 간격 (압축 해제 기준)
+#define ARCHIVE_IO_BUFFER (128 * 1024)       // 압축 파일을 읽고 꺼낸 파일을 쓰는 버퍼
+#define ARCHIVE_CACHE_SLOTS 4                // 색인을 기억하는 압축 파일 수
+#define ARCHIVE_NOTIFY_MS 100                // 진행 중 화면을 깨우는 최소 간격
+
+// 압축 형식 (확장자가 아니라 앞부분의 서명으로 판별)
+typedef enum {
+    ARCHIVE_NONE = 0,
+    ARCHIVE_TAR,
+    ARCHIVE_TAR_GZ,
+    ARCHIVE_ZIP
+} ArchiveFormat;
+
+// 압축 안의 항목 하나 (경로순으로 정렬되어 한 디렉토리의 하위 항목은 연속된 구간)
+typedef struct {
+    char *name;                // 압축 안의 경로 ("a/b.c", 디렉토리도 끝의 '/' 없음)
+    char *link;                // 심볼릭 링크 대상, tar 하드 링크면 같은 압축 안의 원본 경로
+    off_t size;
+    time_t mtime;
+    mode_t mode;               // 종류 비트 포함 (S_IFREG, S_IFDIR, S_IFLNK)
+    off_t offset;              // tar: 내용의 시작 (압축 해제한 tar 기준), zip: 로컬 헤더 위치
+    off_t packed;              // zip: 압축된 크기
+    unsigned int crc;          // zip: CRC-32
+    int method;                // zip: 0 저장, 8 deflate
+    bool hardlink;
+    bool implied;              // 압축에 없지만 하위 항목 때문에 만든 디렉토리
+} ArchiveMember;
+
+// tar.gz 접근 지점 - deflate 블록 경계의 위치와 그 앞 32KB를 기억해 중간부터 풀 수 있게 함
+typedef struct {
+    off_t out;                 // 압축 해제한 위치
+    off_t in;                  // 압축 파일에서의 위치 (bits가 있으면 그 앞 바이트의 일부부터)
+    int bits;
+    unsigned char *window;
+} ArchivePoint;
+
+// 한 번 만든 압축 파일 색인 (같은 inode와 크기, 수정 시각이면 다시 쓰임)
+typedef struct {
+    char path[MAX_PATH_LEN];
+    dev_t dev;
+    ino_t ino;
+    time_t mtime;
+    off_t size;
+    ArchiveFormat format;
+    ArchiveMember *members;
+    int count;
+    ArchivePoint *points;
+    int point_count;
+    int refs;                  // 캐시, 보는 화면, 꺼내기 작업이 잡은 수 (메인 스레드 전용)
+} Archive;
+
+typedef enum {
+    ARCHIVE_TASK_LOAD = 0,     // 색인 만들기
+    ARCHIVE_TASK_EXTRACT       // 항목 꺼내기
+} ArchiveTaskKind;
+
+// 백그라운드 작업 (색인 만들기 또는 꺼내기)
+typedef struct {
+    bool active;
+    ArchiveTaskKind kind;
+    char path[MAX_PATH_LEN];   // LOAD: 압축 파일, EXTRACT: 꺼낼 디렉토리
+    Archive *archive;          // LOAD의 결과, EXTRACT의 대상 (작업이 참조를 하나 잡음)
+    char **names;              // EXTRACT: 꺼낼 항목 (압축 안의 경로)
+    int count;
+    pthread_t thread;
+    bool thread_started;
+    volatile bool cancel;
+
+    pthread_mutex_t lock;      // 아래 진행 상황 보호
+    off_t done;                // LOAD: 읽은 압축 파일 위치, EXTRACT: 쓴 바이트
+    off_t total;
+    int items_done;
+    int items_failed;
+    bool finished;             // 끝남 (취소 포함)
+    bool ok;
+    char message[256];         // 실패 이유 또는 결과 요약
+    long last_notify_ms;
+} ArchiveTask;
+
+// 앞부분으로 형식 판별 (gzip은 풀어서 tar 헤더인지까지 확인)
+ArchiveFormat archive_detect(const char *path);
+
+// 색인 만들기 시작 (즉시 반환) - 캐시에 있으면 스레드 없이 바로 끝난 상태가 됨
+bool archive_load_start(ArchiveTask *task, const char *path);
+
+// 고른 항목들 꺼내기 시작 - 파일은 dest_dir에 이름만, 디렉토리는 하위 구조째 (이름이 겹치면 고유한 이름)
+bool archive_extract_start(ArchiveTask *task, Archive *archive, const char *const *names, int count,
+                           const char *dest_dir);
+
+// 작업 취소 요청
+void archive_task_cancel(ArchiveTask *task);
+
+// 멈추고 정리 (LOAD가 성공했으면 결과를 캐시에 넣고 taken에 참조를 넘김, 필요 없으면 NULL)
+void archive_task_stop(ArchiveTask *task, Archive **taken);
+
+// 참조 놓기 (캐시에서도 밀려났으면 해제)
+void archive_release(Archive *archive);
+
+// 캐시 전체 해제 (종료할 때)
+void cleanup_archives();
+
+// prefix 디렉토리("" 또는 "a/b/")의 하위 항목을 목록 항목으로 (맨 앞에 "..")
+int archive_list(const Archive *archive, const char *prefix, FileEntry *files, int max_files);
+
+// 경로로 항목 찾기 (없으면 -1)
+int archive_find(const Archive *archive, const char *name);
+
+// 항목 하나를 dest_path로 꺼냄 (일반 파일만, 압축 파일의 나머지는 풀지 않음)
+bool archive_extract_file(const Archive *archive, int index, const char *dest_path, char *error, size_t error_size);
+
+#endif
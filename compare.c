@@ -0,0 +1,515 @@
+// compare.c
+#include "compare.h"
+#include "event.h"
+#include "trash.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <dirent.h>
+#include <sys/stat.h>
+
+// ================ 한쪽 트리 만들기 ================
+
+static CompareNode* compare_node_new(CompareNode *parent, const char *name) {
+    size_t name_len = strlen(name);
+    CompareNode *node = calloc(1, sizeof(CompareNode) + name_len + 1);
+    if (!node) return NULL;
+    node->parent = parent;
+    memcpy(node->name, name, name_len + 1);
+    return node;
+}
+
+// 하위 항목 추가 (디렉토리를 읽는 스레드만 그 디렉토리의 노드를 고치므로 잠금 없음)
+static bool compare_node_append(CompareNode *parent, CompareNode *child) {
+    if (parent->child_count == parent->child_capacity) {
+        int capacity = parent->child_capacity ? parent->child_capacity * 2 : 8;
+        CompareNode **grown = realloc(parent->children, sizeof(CompareNode*) * capacity);
+        if (!grown) return false;
+        parent->children = grown;
+        parent->child_capacity = capacity;
+    }
+    parent->children[parent->child_count++] = child;
+    return true;
+}
+
+static void compare_node_free(CompareNode *node) {
+    if (!node) return;
+    for (int i = 0; i < node->child_count; i++) {
+        compare_node_free(node->children[i]);
+    }
+    free(node->children);
+    free(node->link[0]);
+    free(node->link[1]);
+    free(node);
+}
+
+static bool compare_enter_dir(Walker *w, WalkDir *dir, int dirfd) {
+    (void)dirfd;
+    if (!dir->parent) dir->data = ((CompareSide*)w->user)->tree;
+    return dir->data != NULL;
+}
+
+// 항목마다 이쪽 칸(side)만 채움 - 휴지통은 비교하지 않음
+static bool compare_visit(Walker *w, WalkDir *dir, int dirfd, const char *name,
+                          unsigned char d_type, const struct stat *st) {
+    (void)d_type;
+    CompareSide *side = (CompareSide*)w->user;
+    CompareNode *parent = (CompareNode*)dir->data;
+    if (!parent || !st || strcmp(name, TRASH_DIR_NAME) == 0) return false;
+
+    CompareNode *node = compare_node_new(parent, name);
+    if (!node) return false;
+    if (!compare_node_append(parent, node)) {
+        free(node);
+        return false;
+    }
+    int s = side->side;
+    node->type[s] = IFTODT(st->st_mode);
+    node->size[s] = st->st_size;
+    node->mtime[s] = st->st_mtime;
+    if (S_ISLNK(st->st_mode)) {
+        char target[MAX_PATH_LEN];
+        ssize_t len = readlinkat(dirfd, name, target, sizeof(target) - 1);
+        if (len >= 0) {
+            target[len] = '\0';
+            node->link[s] = strdup(target);
+        }
+    }
+    dir->sum_self[0]++;
+
+    if (S_ISDIR(st->st_mode)) {
+        dir->child_data = node;
+        return true;
+    }
+    return false;
+}
+
+static void compare_leave_dir(Walker *w, WalkDir *dir) {
+    CompareSide *side = (CompareSide*)w->user;
+    CompareTask *task = side->task;
+    bool wake = false;
+    pthread_mutex_lock(&task->lock);
+    task->entries[side->side] += (long)dir->sum_self[0];
+    long now = event_now_ms();
+    if (now - task->last_notify_ms >= COMPARE_NOTIFY_MS) {
+        task->last_notify_ms = now;
+        wake = true;
+    }
+    pthread_mutex_unlock(&task->lock);
+    if (wake) notify_ui();
+}
+
+// ================ 두 트리 합치기 ================
+
+typedef struct {
+    CompareNode **items;
+    int count;
+    int capacity;
+} CompareList;
+
+static void compare_list_add(CompareList *list, CompareNode *node) {
+    if (list->count == list->capacity) {
+        int capacity = list->capacity ? list->capacity * 2 : 256;
+        CompareNode **grown = realloc(list->items, sizeof(CompareNode*) * capacity);
+        if (!grown) {
+            node->state = COMPARE_DIFFERENT; // 비교할 수 없으면 다르다고 봄
+            return;
+        }
+        list->items = grown;
+        list->capacity = capacity;
+    }
+    list->items[list->count++] = node;
+}
+
+static int compare_by_name(const void *a, const void *b) {
+    const CompareNode *x = *(const CompareNode *const *)a;
+    const CompareNode *y = *(const CompareNode *const *)b;
+    return strcmp(x->name, y->name);
+}
+
+// 양쪽에 있는 일반 파일의 상태 - 크기가 다르면 다름, 같으면 수정 시각으로 (내용 비교면 후보로 넘김)
+static void compare_classify_file(CompareTask *task, CompareNode *node, CompareList *candidates) {
+    if (node->size[0] != node->size[1]) {
+        node->state = COMPARE_DIFFERENT;
+    } else if (task->content && node->size[0] > 0) {
+        node->state = COMPARE_SAME;
+        compare_list_add(candidates, node);
+    } else {
+        node->state = (task->content || node->mtime[0] == node->mtime[1]) ? COMPARE_SAME : COMPARE_DIFFERENT;
+    }
+}
+
+// 오른쪽 노드의 내용을 같은 경로의 왼쪽 노드에 합침 (right의 하위 항목은 옮기거나 해제하고 right 자신도 해제)
+static void compare_merge(CompareTask *task, CompareNode *left, CompareNode *right, CompareList *candidates) {
+    left->type[1] = right->type[1];
+    left->size[1] = right->size[1];
+    left->mtime[1] = right->mtime[1];
+    left->link[1] = right->link[1];
+    right->link[1] = NULL;
+    if (left->type[0] == DT_REG && left->type[1] == DT_REG) {
+        compare_classify_file(task, left, candidates);
+    }
+
+    // 양쪽 하위 항목을 이름순으로 정렬해 한 번에 맞춤
+    if (left->child_count > 1) qsort(left->children, left->child_count, sizeof(CompareNode*), compare_by_name);
+    if (right->child_count > 1) qsort(right->children, right->child_count, sizeof(CompareNode*), compare_by_name);
+    int total = left->child_count + right->child_count;
+    CompareNode **merged = total > 0 ? malloc(sizeof(CompareNode*) * total) : NULL;
+    if (total > 0 && !merged) {
+        // 합칠 수 없으면 오른쪽 하위 항목은 버림 (왼쪽만 있는 것으로 보임)
+        compare_node_free(right);
+        return;
+    }
+    int count = 0, l = 0, r = 0;
+    while (l < left->child_count || r < right->child_count) {
+        int order = (l == left->child_count) ? 1 : (r == right->child_count) ? -1
+                  : strcmp(left->children[l]->name, right->children[r]->name);
+        if (order < 0) {
+            merged[count++] = left->children[l++];
+        } else if (order > 0) {
+            CompareNode *moved = right->children[r++];
+            moved->parent = left;
+            merged[count++] = moved;
+        } else {
+            CompareNode *match = left->children[l++];
+            compare_merge(task, match, right->children[r++], candidates);
+            merged[count++] = match;
+        }
+    }
+    free(left->children);
+    left->children = merged;
+    left->child_count = count;
+    left->child_capacity = total;
+
+    right->child_count = 0; // 하위 항목은 모두 옮겨졌거나 해제됨
+    compare_node_free(right);
+}
+
+static int compare_for_display(const void *a, const void *b) {
+    const CompareNode *x = *(const CompareNode *const *)a;
+    const CompareNode *y = *(const CompareNode *const *)b;
+    bool x_dir = (x->type[0] == DT_DIR || x->type[1] == DT_DIR);
+    bool y_dir = (y->type[0] == DT_DIR || y->type[1] == DT_DIR);
+    if (x_dir != y_dir) return x_dir ? -1 : 1;
+    return strcmp(x->name, y->name);
+}
+
+// 하위 항목의 상태와 디렉토리별 합계 확정 (post-order), 화면에 보일 순서로 정렬
+static void compare_summarize(CompareNode *node) {
+    memset(node->counts, 0, sizeof(node->counts));
+    for (int i = 0; i < node->child_count; i++) {
+        CompareNode *child = node->children[i];
+        compare_summarize(child);
+
+        bool matched_dir = false;
+        if (child->type[1] == DT_UNKNOWN) {
+            child->state = COMPARE_LEFT_ONLY;
+        } else if (child->type[0] == DT_UNKNOWN) {
+            child->state = COMPARE_RIGHT_ONLY;
+        } else if (child->type[0] != child->type[1]) {
+            child->state = COMPARE_DIFFERENT;
+        } else if (child->type[0] == DT_DIR) {
+            matched_dir = true;
+            child->state = (child->counts[COMPARE_DIFFERENT] || child->counts[COMPARE_LEFT_ONLY] ||
+                            child->counts[COMPARE_RIGHT_ONLY]) ? COMPARE_DIFFERENT : COMPARE_SAME;
+        } else if (child->type[0] == DT_LNK) {
+            bool same = child->link[0] && child->link[1] && strcmp(child->link[0], child->link[1]) == 0;
+            child->state = same ? COMPARE_SAME : COMPARE_DIFFERENT;
+        } else if (child->type[0] != DT_REG) {
+            child->state = COMPARE_SAME; // 장치, FIFO, 소켓은 종류만 비교
+        }
+        // 일반 파일은 합칠 때와 내용 비교에서 이미 정해짐
+
+        if (!matched_dir) node->counts[child->state]++;
+        for (int s = 0; s < COMPARE_STATES; s++) {
+            node->counts[s] += child->counts[s];
+        }
+    }
+    if (node->child_count > 1) {
+        qsort(node->children, node->child_count, sizeof(CompareNode*), compare_for_display);
+    }
+}
+
+// ================ 내용 비교 ================
+
+static int compare_open(const char *path, off_t size) {
+    int fd = open(path, O_RDONLY | O_NOFOLLOW | O_NONBLOCK | O_CLOEXEC);
+    if (fd == -1) return -1;
+    struct stat st;
+    if (fstat(fd, &st) == -1 || !S_ISREG(st.st_mode) || st.st_size != size) {
+        close(fd); // 그 사이에 바뀐 파일은 다르다고 봄
+        return -1;
+    }
+    posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+    return fd;
+}
+
+static bool read_exact(int fd, char *buffer, size_t len, off_t offset) {
+    size_t done = 0;
+    while (done < len) {
+        ssize_t got = pread(fd, buffer + done, len - done, offset + done);
+        if (got <= 0) {
+            if (got == -1 && errno == EINTR) continue;
+            return false;
+        }
+        done += got;
+    }
+    return true;
+}
+
+// 양쪽을 같은 위치씩 읽어 바로 비교 (두 파일 모두 로컬이라 해시를 거칠 필요 없이 처음 다른 블록에서 멈춤)
+static bool compare_content(CompareTask *task, const CompareNode *node, char *buffer, off_t *read_bytes) {
+    char left[MAX_PATH_LEN], right[MAX_PATH_LEN];
+    compare_node_path(task, node, 0, left, sizeof(left));
+    compare_node_path(task, node, 1, right, sizeof(right));
+    off_t size = node->size[0];
+    int fl = compare_open(left, size);
+    int fr = fl != -1 ? compare_open(right, size) : -1;
+    bool same = (fl != -1 && fr != -1);
+    off_t offset = 0;
+    while (same && offset < size && !task->cancel) {
+        size_t len = (size - offset) < COMPARE_READ_BUFFER ? (size_t)(size - offset) : COMPARE_READ_BUFFER;
+        same = read_exact(fl, buffer, len, offset) && read_exact(fr, buffer + COMPARE_READ_BUFFER, len, offset) &&
+               memcmp(buffer, buffer + COMPARE_READ_BUFFER, len) == 0;
+        offset += len;
+        *read_bytes += 2 * (off_t)len;
+    }
+    if (fl != -1) close(fl);
+    if (fr != -1) close(fr);
+    return same;
+}
+
+typedef struct {
+    CompareTask *task;
+    CompareList *candidates;
+    int next;
+    pthread_mutex_t lock;
+} CompareWork;
+
+static void* compare_worker(void *arg) {
+    CompareWork *work = (CompareWork*)arg;
+    CompareTask *task = work->task;
+    char *buffer = malloc(2 * COMPARE_READ_BUFFER);
+    if (!buffer) return NULL;
+
+    while (!task->cancel) {
+        pthread_mutex_lock(&work->lock);
+        int i = work->next++;
+        pthread_mutex_unlock(&work->lock);
+        if (i >= work->candidates->count) break;
+
+        CompareNode *node = work->candidates->items[i];
+        off_t read_bytes = 0;
+        node->state = compare_content(task, node, buffer, &read_bytes) ? COMPARE_SAME : COMPARE_DIFFERENT;
+
+        bool wake = false;
+        pthread_mutex_lock(&task->lock);
+        task->stage_done++;
+        task->bytes_read += read_bytes;
+        long now = event_now_ms();
+        if (now - task->last_notify_ms >= COMPARE_NOTIFY_MS) {
+            task->last_notify_ms = now;
+            wake = true;
+        }
+        pthread_mutex_unlock(&task->lock);
+        if (wake) notify_ui();
+    }
+    free(buffer);
+    return NULL;
+}
+
+// 후보 파일 쌍을 워커들이 하나씩 가져가 비교 (쌍 단위로 나누므로 큰 파일 하나가 나머지를 막지 않음)
+static void compare_parallel(CompareTask *task, CompareList *candidates) {
+    pthread_mutex_lock(&task->lock);
+    task->stage = COMPARE_STAGE_CONTENT;
+    task->stage_done = 0;
+    task->stage_total = candidates->count;
+    pthread_mutex_unlock(&task->lock);
+    notify_ui();
+    if (candidates->count == 0) return;
+
+    CompareWork work = { .task = task, .candidates = candidates };
+    pthread_mutex_init(&work.lock, NULL);
+
+    int nthreads = walker_default_threads();
+    if (nthreads > COMPARE_MAX_THREADS) nthreads = COMPARE_MAX_THREADS;
+    if (nthreads > candidates->count) nthreads = candidates->count;
+    pthread_t threads[COMPARE_MAX_THREADS];
+    int started = 0;
+    for (int i = 0; i < nthreads; i++) {
+        if (pthread_create(&threads[started], NULL, compare_worker, &work) == 0) started++;
+    }
+    if (started == 0) compare_worker(&work);
+    for (int i = 0; i < started; i++) {
+        pthread_join(threads[i], NULL);
+    }
+    pthread_mutex_destroy(&work.lock);
+}
+
+// ================ 진행 ================
+
+static void* compare_thread(void *arg) {
+    CompareTask *task = (CompareTask*)arg;
+
+    // 양쪽 탐색기를 함께 돌림 (각자 자기 스레드 풀로 자기 트리만 채우므로 서로 잠그지 않음)
+    bool started[2];
+    for (int s = 0; s < 2; s++) {
+        started[s] = walker_start(&task->sides[s].walker, task->root[s]);
+    }
+    for (int s = 0; s < 2; s++) {
+        if (started[s]) walker_wait(&task->sides[s].walker);
+    }
+
+    CompareNode *tree = NULL;
+    if (!task->cancel) {
+        CompareList candidates = {0};
+        tree = task->sides[0].tree;
+        task->sides[0].tree = NULL;
+        compare_merge(task, tree, task->sides[1].tree, &candidates);
+        task->sides[1].tree = NULL;
+        if (task->content) compare_parallel(task, &candidates);
+        free(candidates.items);
+        compare_summarize(tree);
+        tree->state = (tree->counts[COMPARE_DIFFERENT] || tree->counts[COMPARE_LEFT_ONLY] ||
+                       tree->counts[COMPARE_RIGHT_ONLY]) ? COMPARE_DIFFERENT : COMPARE_SAME;
+    }
+    if (task->cancel) { // 반쯤 읽은 트리로는 한쪽에만 있다고 잘못 보이므로 버림
+        compare_node_free(tree);
+        tree = NULL;
+    }
+
+    pthread_mutex_lock(&task->lock);
+    task->tree = tree;
+    task->current = tree;
+    task->stage = COMPARE_STAGE_DONE;
+    task->cancelled = task->cancel;
+    task->finished = true;
+    pthread_mutex_unlock(&task->lock);
+    notify_ui();
+    return NULL;
+}
+
+bool compare_start(CompareTask *task, const char *left, const char *right, bool content, bool one_filesystem) {
+    memset(task, 0, sizeof(CompareTask));
+    snprintf(task->root[0], sizeof(task->root[0]), "%s", left);
+    snprintf(task->root[1], sizeof(task->root[1]), "%s", right);
+    task->content = content;
+
+    for (int s = 0; s < 2; s++) {
+        struct stat st;
+        if (stat(task->root[s], &st) == -1 || !S_ISDIR(st.st_mode)) return false;
+    }
+    task->sides[0].tree = compare_node_new(NULL, "");
+    task->sides[1].tree = compare_node_new(NULL, "");
+    if (!task->sides[0].tree || !task->sides[1].tree) {
+        free(task->sides[0].tree);
+        free(task->sides[1].tree);
+        return false;
+    }
+
+    pthread_mutex_init(&task->lock, NULL);
+    WalkOps ops = { .enter_dir = compare_enter_dir, .visit = compare_visit, .leave_dir = compare_leave_dir };
+    for (int s = 0; s < 2; s++) {
+        CompareSide *side = &task->sides[s];
+        side->task = task;
+        side->side = s;
+        side->tree->type[s] = DT_DIR;
+        walker_init(&side->walker, &ops, side);
+        side->walker.need_stat = true; // 종류, 크기, 수정 시각이 필요
+        side->walker.one_filesystem = one_filesystem;
+    }
+
+    if (pthread_create(&task->thread, NULL, compare_thread, task) != 0) {
+        for (int s = 0; s < 2; s++) {
+            walker_destroy(&task->sides[s].walker);
+            compare_node_free(task->sides[s].tree);
+        }
+        pthread_mutex_destroy(&task->lock);
+        return false;
+    }
+    task->thread_started = true;
+    task->active = true;
+    return true;
+}
+
+void compare_cancel(CompareTask *task) {
+    if (!task->active) return;
+    task->cancel = true;
+    walker_cancel(&task->sides[0].walker);
+    walker_cancel(&task->sides[1].walker);
+}
+
+void compare_stop(CompareTask *task) {
+    if (!task->active) return;
+    compare_cancel(task);
+    if (task->thread_started) pthread_join(task->thread, NULL);
+    for (int s = 0; s < 2; s++) {
+        walker_destroy(&task->sides[s].walker);
+        compare_node_free(task->sides[s].tree);
+    }
+    compare_node_free(task->tree);
+    pthread_mutex_destroy(&task->lock);
+    memset(task, 0, sizeof(CompareTask));
+}
+
+long compare_dirs_scanned(CompareTask *task) {
+    long dirs = 0;
+    for (int s = 0; s < 2; s++) {
+        pthread_mutex_lock(&task->sides[s].walker.lock);
+        dirs += task->sides[s].walker.dirs_scanned;
+        pthread_mutex_unlock(&task->sides[s].walker.lock);
+    }
+    return dirs;
+}
+
+// ================ 보기 ================
+
+int compare_row_count(const CompareTask *task) {
+    const CompareNode *node = task->current;
+    if (!node) return 0;
+    if (task->show_same) return node->child_count;
+    int rows = 0;
+    for (int i = 0; i < node->child_count; i++) {
+        if (node->children[i]->state != COMPARE_SAME) rows++;
+    }
+    return rows;
+}
+
+CompareNode* compare_row(const CompareTask *task, int row) {
+    const CompareNode *node = task->current;
+    if (!node || row < 0) return NULL;
+    for (int i = 0; i < node->child_count; i++) {
+        CompareNode *child = node->children[i];
+        if (!task->show_same && child->state == COMPARE_SAME) continue;
+        if (row-- == 0) return child;
+    }
+    return NULL;
+}
+
+int compare_row_of(const CompareTask *task, const CompareNode *child) {
+    const CompareNode *node = task->current;
+    if (!node) return -1;
+    int row = 0;
+    for (int i = 0; i < node->child_count; i++) {
+        if (node->children[i] == child) return row;
+        if (task->show_same || node->children[i]->state != COMPARE_SAME) row++;
+    }
+    return -1;
+}
+
+void compare_node_path(const CompareTask *task, const CompareNode *node, int side, char *out, size_t out_size) {
+    // 시작 디렉토리까지 올라가며 이름을 뒤에서부터 채움
+    const char *names[MAX_PATH_LEN / 2];
+    int depth = 0;
+    for (const CompareNode *n = node; n && n->parent && depth < (int)(sizeof(names) / sizeof(names[0])); n = n->parent) {
+        names[depth++] = n->name;
+    }
+    size_t len = (size_t)snprintf(out, out_size, "%s", side >= 0 ? task->root[side] : (depth == 0 ? "/" : ""));
+    for (int i = depth - 1; i >= 0 && len < out_size; i--) {
+        bool slash = len > 0 && out[len - 1] == '/';
+        len += (size_t)snprintf(out + len, out_size - len, "%s%s", slash ? "" : "/", names[i]);
+    }
+}
@@ -0,0 +1,109 @@
+// compare.h
+#ifndef COMPARE_H
+#define COMPARE_H
+
+#include <stdbool.h>
+#include <sys/types.h>
+#include <pthread.h>
+#include "fs.h"
+#include "walk.h"
+
+#define COMPARE_READ_BUFFER (256 * 1024) // 내용 비교에서 한쪽 파일을 읽는 버퍼 (워커마다 양쪽 하나씩)
+#define COMPARE_MAX_THREADS 16
+#define COMPARE_NOTIFY_MS 100            // 진행 중 화면을 깨우는 최소 간격
+
+// 항목의 비교 결과
+typedef enum {
+    COMPARE_SAME = 0,          // 양쪽이 같음 (디렉토리면 하위 항목이 모두 같음)
+    COMPARE_DIFFERENT,         // 양쪽에 있지만 종류, 크기, 수정 시각(내용 비교면 내용), 링크 대상이 다름
+    COMPARE_LEFT_ONLY,
+    COMPARE_RIGHT_ONLY,
+    COMPARE_STATES
+} CompareState;
+
+// 진행 단계
+typedef enum {
+    COMPARE_STAGE_SCAN = 0,    // 양쪽 탐색
+    COMPARE_STAGE_CONTENT,     // 크기가 같은 파일의 내용 비교
+    COMPARE_STAGE_DONE
+} CompareStage;
+
+// 비교 트리의 항목 하나 - 양쪽 탐색이 각자 만든 트리를 상대 경로로 합친 것 (0: 왼쪽, 1: 오른쪽)
+typedef struct CompareNode {
+    struct CompareNode *parent;
+    struct CompareNode **children;  // 디렉토리 먼저, 이름순
+    int child_count;
+    int child_capacity;
+    unsigned char type[2];          // d_type (DT_UNKNOWN이면 그쪽에 없음)
+    off_t size[2];
+    time_t mtime[2];
+    char *link[2];                  // 심볼릭 링크 대상
+    CompareState state;
+    long counts[COMPARE_STATES];    // 하위 항목의 상태별 수 (양쪽에 다 있는 디렉토리 자신은 빼고 셈)
+    char name[];
+} CompareNode;
+
+struct CompareTask;
+
+// 한쪽 탐색 (콜백이 어느 쪽 트리를 채우는지 알 수 있도록 탐색기의 user로 넘김)
+typedef struct {
+    struct CompareTask *task;
+    int side;
+    Walker walker;
+    CompareNode *tree;              // 이쪽 시작 디렉토리 (합친 뒤에는 NULL)
+} CompareSide;
+
+// 두 디렉토리 비교 - 양쪽을 각자의 병렬 탐색기로 동시에 읽고, 끝나면 이름으로 맞춰 한 트리로 합침
+// 크기가 같은 파일은 수정 시각으로, 내용 비교를 켜면 워커들이 양쪽을 읽어 바이트 단위로 비교
+typedef struct CompareTask {
+    bool active;                    // 비교 화면이 열려 있거나 결과를 들고 있음
+    char root[2][MAX_PATH_LEN];
+    bool content;                   // 크기가 같은 파일은 내용으로 비교
+    CompareSide sides[2];
+    pthread_t thread;               // 진행 스레드
+    bool thread_started;
+    volatile bool cancel;
+
+    pthread_mutex_t lock;           // 아래 진행 상황 보호
+    CompareStage stage;
+    long entries[2];                // 양쪽에서 읽은 항목 수
+    long stage_done;                // 내용 비교를 끝낸 파일 쌍 수
+    long stage_total;
+    off_t bytes_read;               // 내용 비교로 읽은 바이트 (양쪽 합)
+    bool finished;                  // 끝남 (취소 포함) - 이후 tree는 메인 스레드만 씀
+    bool cancelled;
+    long last_notify_ms;
+
+    CompareNode *tree;              // 합친 트리 (취소하면 NULL)
+
+    // 보기 상태 (메인 스레드 전용, 비교가 끝난 뒤에만 씀)
+    CompareNode *current;
+    int selection;                  // current의 보이는 하위 항목 중 순번
+    bool show_same;                 // 같은 항목도 보여 줌
+} CompareTask;
+
+// 비교 시작 (즉시 반환), one_filesystem이면 마운트 지점을 넘지 않음
+bool compare_start(CompareTask *task, const char *left, const char *right, bool content, bool one_filesystem);
+
+// 진행 취소 (그때까지의 결과는 없음)
+void compare_cancel(CompareTask *task);
+
+// 멈추고 결과 해제 (active도 끔)
+void compare_stop(CompareTask *task);
+
+// 양쪽에서 읽은 디렉토리 수
+long compare_dirs_scanned(CompareTask *task);
+
+// current에서 보이는 하위 항목 수 (show_same이 꺼져 있으면 같은 항목은 숨김)
+int compare_row_count(const CompareTask *task);
+
+// 보이는 하위 항목 중 row번째 (없으면 NULL)
+CompareNode* compare_row(const CompareTask *task, int row);
+
+// 보이는 하위 항목 중 child의 순번 (숨겨져 있으면 -1)
+int compare_row_of(const CompareTask *task, const CompareNode *child);
+
+// 항목의 경로 - side가 0/1이면 그쪽의 절대 경로, 음수면 시작 디렉토리 기준 상대 경로 ("/a/b")
+void compare_node_path(const CompareTask *task, const CompareNode *node, int side, char *out, size_t out_size);
+
+#endif
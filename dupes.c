@@ -0,0 +1,662 @@
+// dupes.c
+#include "dupes.h"
+#include "event.h"
+#include "trash.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <dirent.h>
+#include <sys/stat.h>
+
+// ================ 해시 (XXH64 방식) ================
+
+#define PRIME64_1 0x9E3779B185EBCA87ULL
+#define PRIME64_2 0xC2B2AE3D27D4EB4FULL
+#define PRIME64_3 0x165667B19E3779F9ULL
+#define PRIME64_4 0x85EBCA77C2B2AE63ULL
+#define PRIME64_5 0x27D4EB2F165667C5ULL
+
+static inline uint64_t rotl64(uint64_t x, int r) {
+    return (x << r) | (x >> (64 - r));
+}
+
+static inline uint64_t read64(const unsigned char *p) {
+    uint64_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+static inline uint32_t read32(const unsigned char *p) {
+    uint32_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+static inline uint64_t hash_round(uint64_t acc, uint64_t input) {
+    acc += input * PRIME64_2;
+    acc = rotl64(acc, 31);
+    return acc * PRIME64_1;
+}
+
+static inline uint64_t hash_merge(uint64_t acc, uint64_t value) {
+    acc ^= hash_round(0, value);
+    return acc * PRIME64_1 + PRIME64_4;
+}
+
+// 32바이트씩 네 갈래로 누적 (갈래끼리 의존성이 없어 한 번에 여러 곱셈이 진행됨)
+static const unsigned char* hash_stripes(uint64_t v[4], const unsigned char *p, const unsigned char *end) {
+    uint64_t v1 = v[0], v2 = v[1], v3 = v[2], v4 = v[3];
+    while (end - p >= 32) {
+        v1 = hash_round(v1, read64(p));
+        v2 = hash_round(v2, read64(p + 8));
+        v3 = hash_round(v3, read64(p + 16));
+        v4 = hash_round(v4, read64(p + 24));
+        p += 32;
+    }
+    v[0] = v1; v[1] = v2; v[2] = v3; v[3] = v4;
+    return p;
+}
+
+void dupes_hash_init(DupesHash *hash) {
+    memset(hash, 0, sizeof(DupesHash));
+    hash->v[0] = PRIME64_1 + PRIME64_2;
+    hash->v[1] = PRIME64_2;
+    hash->v[2] = 0;
+    hash->v[3] = -PRIME64_1;
+}
+
+void dupes_hash_update(DupesHash *hash, const void *data, size_t len) {
+    const unsigned char *p = data;
+    const unsigned char *end = p + len;
+    hash->total += len;
+
+    if (hash->buffered + len < 32) {
+        memcpy(hash->buffer + hash->buffered, p, len);
+        hash->buffered += len;
+        return;
+    }
+    if (hash->buffered > 0) {
+        size_t fill = 32 - hash->buffered;
+        memcpy(hash->buffer + hash->buffered, p, fill);
+        hash_stripes(hash->v, hash->buffer, hash->buffer + 32);
+        p += fill;
+        hash->buffered = 0;
+    }
+    p = hash_stripes(hash->v, p, end);
+    if (p < end) {
+        memcpy(hash->buffer, p, end - p);
+        hash->buffered = end - p;
+    }
+}
+
+uint64_t dupes_hash_final(const DupesHash *hash) {
+    uint64_t h;
+    if (hash->total >= 32) {
+        h = rotl64(hash->v[0], 1) + rotl64(hash->v[1], 7) + rotl64(hash->v[2], 12) + rotl64(hash->v[3], 18);
+        for (int i = 0; i < 4; i++) {
+            h = hash_merge(h, hash->v[i]);
+        }
+    } else {
+        h = hash->v[2] + PRIME64_5;
+    }
+    h += hash->total;
+
+    const unsigned char *p = hash->buffer;
+    const unsigned char *end = p + hash->buffered;
+    while (end - p >= 8) {
+        h ^= hash_round(0, read64(p));
+        h = rotl64(h, 27) * PRIME64_1 + PRIME64_4;
+        p += 8;
+    }
+    if (end - p >= 4) {
+        h ^= (uint64_t)read32(p) * PRIME64_1;
+        h = rotl64(h, 23) * PRIME64_2 + PRIME64_3;
+        p += 4;
+    }
+    while (p < end) {
+        h ^= (*p) * PRIME64_5;
+        h = rotl64(h, 11) * PRIME64_1;
+        p++;
+    }
+
+    h ^= h >> 33;
+    h *= PRIME64_2;
+    h ^= h >> 29;
+    h *= PRIME64_3;
+    h ^= h >> 32;
+    return h;
+}
+
+// ================ 파일 읽기 ================
+
+static int dupes_open(const DupesFile *file) {
+    int fd = open(file->path, O_RDONLY | O_NOFOLLOW | O_NONBLOCK | O_CLOEXEC);
+    if (fd == -1) return -1;
+    struct stat st;
+    if (fstat(fd, &st) == -1 || !S_ISREG(st.st_mode) || st.st_size != file->size) {
+        close(fd); // 그 사이에 바뀐 파일은 후보에서 뺌
+        return -1;
+    }
+    return fd;
+}
+
+static bool read_exact(int fd, char *buffer, size_t len, off_t offset) {
+    size_t done = 0;
+    while (done < len) {
+        ssize_t got = pread(fd, buffer + done, len - done, offset + done);
+        if (got <= 0) {
+            if (got == -1 && errno == EINTR) continue;
+            return false;
+        }
+        done += got;
+    }
+    return true;
+}
+
+// 2단계: 앞/뒤 블록 해시 (작은 파일은 전체를 읽으므로 전체 해시도 함께 정해짐)
+static bool hash_edges(DupesFile *file, char *buffer) {
+    int fd = dupes_open(file);
+    if (fd == -1) return false;
+
+    size_t len;
+    bool ok;
+    if (file->size <= 2 * DUPES_EDGE_BYTES) {
+        len = (size_t)file->size;
+        ok = read_exact(fd, buffer, len, 0);
+    } else {
+        len = 2 * DUPES_EDGE_BYTES;
+        ok = read_exact(fd, buffer, DUPES_EDGE_BYTES, 0) &&
+             read_exact(fd, buffer + DUPES_EDGE_BYTES, DUPES_EDGE_BYTES, file->size - DUPES_EDGE_BYTES);
+    }
+    close(fd);
+    if (!ok) return false;
+
+    DupesHash hash;
+    dupes_hash_init(&hash);
+    dupes_hash_update(&hash, buffer, len);
+    file->edge_hash = dupes_hash_final(&hash);
+    if (file->size <= 2 * DUPES_EDGE_BYTES) file->full_hash = file->edge_hash;
+    return true;
+}
+
+// 3단계: 전체 내용 해시 (순차 읽기를 알려 미리 읽기를 키움)
+static bool hash_full(DupesTask *task, DupesFile *file, char *buffer) {
+    int fd = dupes_open(file);
+    if (fd == -1) return false;
+    posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+
+    DupesHash hash;
+    dupes_hash_init(&hash);
+    off_t total = 0;
+    while (!task->cancel) {
+        ssize_t got = read(fd, buffer, DUPES_READ_BUFFER);
+        if (got == -1 && errno == EINTR) continue;
+        if (got <= 0) break;
+        dupes_hash_update(&hash, buffer, got);
+        total += got;
+    }
+    close(fd);
+    if (total != file->size) return false;
+    file->full_hash = dupes_hash_final(&hash);
+    return true;
+}
+
+// ================ 단계 진행 ================
+
+typedef struct {
+    DupesTask *task;
+    const int *items;          // files 번호
+    int count;
+    int next;
+    bool full;                 // true면 전체 해시, 아니면 앞뒤 블록
+    pthread_mutex_t lock;
+} DupesWork;
+
+static void dupes_progress(DupesTask *task, off_t bytes) {
+    bool wake = false;
+    pthread_mutex_lock(&task->lock);
+    task->stage_done++;
+    task->bytes_read += bytes;
+    long now = event_now_ms();
+    if (now - task->last_notify_ms >= DUPES_NOTIFY_MS) {
+        task->last_notify_ms = now;
+        wake = true;
+    }
+    pthread_mutex_unlock(&task->lock);
+    if (wake) notify_ui();
+}
+
+static void* dupes_worker(void *arg) {
+    DupesWork *work = (DupesWork*)arg;
+    DupesTask *task = work->task;
+    char *buffer = malloc(DUPES_READ_BUFFER);
+    if (!buffer) return NULL;
+
+    while (!task->cancel) {
+        pthread_mutex_lock(&work->lock);
+        int i = work->next++;
+        pthread_mutex_unlock(&work->lock);
+        if (i >= work->count) break;
+
+        DupesFile *file = &task->files[work->items[i]];
+        bool ok = work->full ? hash_full(task, file, buffer) : hash_edges(file, buffer);
+        if (!ok) file->failed = true;
+        off_t bytes = work->full ? file->size
+                                 : (file->size < 2 * DUPES_EDGE_BYTES ? file->size : 2 * DUPES_EDGE_BYTES);
+        dupes_progress(task, ok ? bytes : 0);
+    }
+    free(buffer);
+    return NULL;
+}
+
+// 후보를 워커들이 하나씩 가져가 읽음 (파일 단위로 나누므로 큰 파일 하나가 나머지를 막지 않음)
+static void dupes_parallel(DupesTask *task, DupesStage stage, const int *items, int count, bool full) {
+    pthread_mutex_lock(&task->lock);
+    task->stage = stage;
+    task->stage_done = 0;
+    task->stage_total = count;
+    pthread_mutex_unlock(&task->lock);
+    notify_ui();
+    if (count == 0) return;
+
+    DupesWork work = { .task = task, .items = items, .count = count, .full = full };
+    pthread_mutex_init(&work.lock, NULL);
+
+    int nthreads = walker_default_threads();
+    if (nthreads > DUPES_MAX_THREADS) nthreads = DUPES_MAX_THREADS;
+    if (nthreads > count) nthreads = count;
+    pthread_t threads[DUPES_MAX_THREADS];
+    int started = 0;
+    for (int i = 0; i < nthreads; i++) {
+        if (pthread_create(&threads[started], NULL, dupes_worker, &work) == 0) started++;
+    }
+    if (started == 0) dupes_worker(&work);
+    for (int i = 0; i < started; i++) {
+        pthread_join(threads[i], NULL);
+    }
+    pthread_mutex_destroy(&work.lock);
+}
+
+// 정렬 기준 (qsort 콜백에서 파일 배열을 보기 위해 진행 스레드에서만 설정)
+static const DupesFile *g_sort_files;
+
+static int compare_size_inode(const void *a, const void *b) {
+    const DupesFile *x = &g_sort_files[*(const int*)a];
+    const DupesFile *y = &g_sort_files[*(const int*)b];
+    if (x->size != y->size) return x->size < y->size ? 1 : -1;
+    if (x->dev != y->dev) return x->dev < y->dev ? -1 : 1;
+    if (x->ino != y->ino) return x->ino < y->ino ? -1 : 1;
+    return 0;
+}
+
+static int compare_hashes(const void *a, const void *b) {
+    const DupesFile *x = &g_sort_files[*(const int*)a];
+    const DupesFile *y = &g_sort_files[*(const int*)b];
+    if (x->size != y->size) return x->size < y->size ? 1 : -1;
+    if (x->edge_hash != y->edge_hash) return x->edge_hash < y->edge_hash ? -1 : 1;
+    if (x->full_hash != y->full_hash) return x->full_hash < y->full_hash ? -1 : 1;
+    return strcmp(x->path, y->path);
+}
+
+static int compare_groups(const void *a, const void *b) {
+    const DupesGroup *x = (const DupesGroup*)a;
+    const DupesGroup *y = (const DupesGroup*)b;
+    off_t wx = x->size * (x->count - 1);
+    off_t wy = y->size * (y->count - 1);
+    if (wx != wy) return wx < wy ? 1 : -1;
+    return strcmp(x->files[0]->path, y->files[0]->path);
+}
+
+// 실패한 파일을 빼고 남은 후보 수
+static int drop_failed(const DupesTask *task, int *items, int count) {
+    int kept = 0;
+    for (int i = 0; i < count; i++) {
+        if (!task->files[items[i]].failed) items[kept++] = items[i];
+    }
+    return kept;
+}
+
+// items를 (크기, 해시) 순으로 정렬하고 같은 묶음이 둘 이상인 것만 남김
+static int keep_collisions(const DupesTask *task, int *items, int count, bool full) {
+    g_sort_files = task->files;
+    qsort(items, count, sizeof(int), compare_hashes);
+    int kept = 0;
+    for (int start = 0; start < count;) {
+        const DupesFile *first = &task->files[items[start]];
+        int end = start + 1;
+        while (end < count) {
+            const DupesFile *f = &task->files[items[end]];
+            if (f->size != first->size || f->edge_hash != first->edge_hash ||
+                (full && f->full_hash != first->full_hash)) break;
+            end++;
+        }
+        if (end - start >= 2) {
+            memmove(items + kept, items + start, sizeof(int) * (end - start));
+            kept += end - start;
+        }
+        start = end;
+    }
+    return kept;
+}
+
+static void dupes_find(DupesTask *task) {
+    int count = task->file_count;
+    int *items = malloc(sizeof(int) * (count > 0 ? count : 1));
+    if (!items) return;
+
+    // 1단계: 크기가 같은 파일만 (같은 inode의 하드 링크는 한 번만)
+    for (int i = 0; i < count; i++) items[i] = i;
+    g_sort_files = task->files;
+    qsort(items, count, sizeof(int), compare_size_inode);
+    int candidates = 0;
+    for (int start = 0; start < count;) {
+        int end = start + 1;
+        while (end < count && task->files[items[end]].size == task->files[items[start]].size) end++;
+        int distinct_start = candidates;
+        for (int i = start; i < end; i++) {
+            const DupesFile *f = &task->files[items[i]];
+            if (i > start && f->dev == task->files[items[i - 1]].dev && f->ino == task->files[items[i - 1]].ino) {
+                continue;
+            }
+            items[candidates++] = items[i];
+        }
+        if (candidates - distinct_start < 2) candidates = distinct_start;
+        start = end;
+    }
+
+    // 2단계: 앞/뒤 블록
+    dupes_parallel(task, DUPES_STAGE_EDGES, items, candidates, false);
+    if (task->cancel) goto done;
+    candidates = drop_failed(task, items, candidates);
+    candidates = keep_collisions(task, items, candidates, false);
+
+    // 3단계: 앞뒤까지 같은 큰 파일만 전체 해시
+    int *full = malloc(sizeof(int) * (candidates > 0 ? candidates : 1));
+    if (!full) goto done;
+    int full_count = 0;
+    for (int i = 0; i < candidates; i++) {
+        if (task->files[items[i]].size > 2 * DUPES_EDGE_BYTES) full[full_count++] = items[i];
+    }
+    dupes_parallel(task, DUPES_STAGE_FULL, full, full_count, true);
+    free(full);
+    if (task->cancel) goto done;
+    candidates = drop_failed(task, items, candidates);
+    candidates = keep_collisions(task, items, candidates, true);
+
+    // 묶음 만들기
+    DupesGroup *groups = NULL;
+    int group_count = 0;
+    for (int start = 0; start < candidates;) {
+        const DupesFile *first = &task->files[items[start]];
+        int end = start + 1;
+        while (end < candidates && task->files[items[end]].size == first->size &&
+               task->files[items[end]].edge_hash == first->edge_hash &&
+               task->files[items[end]].full_hash == first->full_hash) {
+            end++;
+        }
+        DupesGroup *grown = realloc(groups, sizeof(DupesGroup) * (group_count + 1));
+        DupesFile **files = malloc(sizeof(DupesFile*) * (end - start));
+        if (!grown || !files) {
+            if (grown) groups = grown;
+            free(files);
+            break;
+        }
+        groups = grown;
+        for (int i = start; i < end; i++) {
+            files[i - start] = &task->files[items[i]];
+        }
+        groups[group_count].size = first->size;
+        groups[group_count].files = files;
+        groups[group_count].count = end - start;
+        group_count++;
+        start = end;
+    }
+    if (group_count > 1) qsort(groups, group_count, sizeof(DupesGroup), compare_groups);
+
+    pthread_mutex_lock(&task->lock);
+    task->groups = groups;
+    task->group_count = group_count;
+    pthread_mutex_unlock(&task->lock);
+
+done:
+    free(items);
+}
+
+// 결과 합계 다시 계산 (파일이 둘 미만인 묶음은 없앰)
+static void dupes_recount(DupesTask *task) {
+    int kept = 0;
+    task->wasted = 0;
+    task->duplicate_count = 0;
+    for (int g = 0; g < task->group_count; g++) {
+        DupesGroup *group = &task->groups[g];
+        if (group->count < 2) {
+            free(group->files);
+            continue;
+        }
+        task->wasted += group->size * (group->count - 1);
+        task->duplicate_count += group->count;
+        task->groups[kept++] = *group;
+    }
+    task->group_count = kept;
+    int rows = dupes_file_rows(task);
+    if (task->selection >= rows) task->selection = rows > 0 ? rows - 1 : 0;
+}
+
+static void* dupes_thread(void *arg) {
+    DupesTask *task = (DupesTask*)arg;
+    walker_run(&task->walker, task->root);
+    if (!task->cancel) dupes_find(task);
+
+    pthread_mutex_lock(&task->lock);
+    dupes_recount(task);
+    task->stage = DUPES_STAGE_DONE;
+    task->cancelled = task->cancel;
+    task->finished = true;
+    pthread_mutex_unlock(&task->lock);
+    notify_ui();
+    return NULL;
+}
+
+// 1단계의 파일 목록 - 크기가 0인 파일과 휴지통은 빼고 일반 파일만
+static bool dupes_visit(Walker *w, WalkDir *dir, int dirfd, const char *name,
+                        unsigned char d_type, const struct stat *st) {
+    (void)dirfd;
+    DupesTask *task = (DupesTask*)w->user;
+    if (d_type == DT_DIR) return strcmp(name, TRASH_DIR_NAME) != 0;
+    if (d_type != DT_REG || !st || st->st_size == 0) return false;
+
+    size_t dir_len = strlen(dir->path);
+    size_t name_len = strlen(name);
+    char *path = malloc(dir_len + name_len + 2);
+    if (!path) return false;
+    memcpy(path, dir->path, dir_len);
+    if (dir_len == 0 || path[dir_len - 1] != '/') path[dir_len++] = '/';
+    memcpy(path + dir_len, name, name_len + 1);
+
+    bool wake = false;
+    pthread_mutex_lock(&task->lock);
+    if (task->file_count == task->file_capacity) {
+        int capacity = task->file_capacity ? task->file_capacity * 2 : 1024;
+        DupesFile *grown = realloc(task->files, sizeof(DupesFile) * capacity);
+        if (grown) {
+            task->files = grown;
+            task->file_capacity = capacity;
+        }
+    }
+    if (task->file_count < task->file_capacity) {
+        DupesFile *file = &task->files[task->file_count++];
+        memset(file, 0, sizeof(DupesFile));
+        file->path = path;
+        file->size = st->st_size;
+        file->dev = st->st_dev;
+        file->ino = st->st_ino;
+        path = NULL;
+    }
+    long now = event_now_ms();
+    if (now - task->last_notify_ms >= DUPES_NOTIFY_MS) {
+        task->last_notify_ms = now;
+        wake = true;
+    }
+    pthread_mutex_unlock(&task->lock);
+    free(path);
+    if (wake) notify_ui();
+    return false;
+}
+
+bool dupes_start(DupesTask *task, const char *root, bool one_filesystem) {
+    memset(task, 0, sizeof(DupesTask));
+    snprintf(task->root, sizeof(task->root), "%s", root);
+    pthread_mutex_init(&task->lock, NULL);
+
+    WalkOps ops = { .visit = dupes_visit };
+    walker_init(&task->walker, &ops, task);
+    task->walker.need_stat = true; // 크기와 inode가 필요
+    task->walker.one_filesystem = one_filesystem;
+
+    if (pthread_create(&task->thread, NULL, dupes_thread, task) != 0) {
+        walker_destroy(&task->walker);
+        pthread_mutex_destroy(&task->lock);
+        return false;
+    }
+    task->thread_started = true;
+    task->active = true;
+    return true;
+}
+
+void dupes_cancel(DupesTask *task) {
+    if (!task->active) return;
+    task->cancel = true;
+    walker_cancel(&task->walker);
+}
+
+void dupes_stop(DupesTask *task) {
+    if (!task->active) return;
+    dupes_cancel(task);
+    if (task->thread_started) pthread_join(task->thread, NULL);
+    walker_destroy(&task->walker);
+    for (int g = 0; g < task->group_count; g++) {
+        free(task->groups[g].files);
+    }
+    free(task->groups);
+    for (int i = 0; i < task->file_count; i++) {
+        free(task->files[i].path);
+    }
+    free(task->files);
+    pthread_mutex_destroy(&task->lock);
+    memset(task, 0, sizeof(DupesTask));
+}
+
+long dupes_dirs_scanned(DupesTask *task) {
+    pthread_mutex_lock(&task->walker.lock);
+    long dirs = task->walker.dirs_scanned;
+    pthread_mutex_unlock(&task->walker.lock);
+    return dirs;
+}
+
+int dupes_file_rows(const DupesTask *task) {
+    int rows = 0;
+    for (int g = 0; g < task->group_count; g++) {
+        rows += task->groups[g].count;
+    }
+    return rows;
+}
+
+bool dupes_locate(const DupesTask *task, int ordinal, int *group, int *index) {
+    for (int g = 0; g < task->group_count; g++) {
+        if (ordinal < task->groups[g].count) {
+            *group = g;
+            *index = ordinal;
+            return true;
+        }
+        ordinal -= task->groups[g].count;
+    }
+    return false;
+}
+
+static void group_remove(DupesGroup *group, int index) {
+    memmove(group->files + index, group->files + index + 1, sizeof(DupesFile*) * (group->count - index - 1));
+    group->count--;
+}
+
+void dupes_prune(DupesTask *task) {
+    if (!task->active || !task->finished) return;
+    for (int g = 0; g < task->group_count; g++) {
+        DupesGroup *group = &task->groups[g];
+        for (int i = group->count - 1; i >= 0; i--) {
+            struct stat st;
+            // 다른 파일시스템의 같은 inode 번호로 바뀐 경우도 빼도록 장치까지 비교
+            if (lstat(group->files[i]->path, &st) == -1 || st.st_dev != group->files[i]->dev ||
+                st.st_ino != group->files[i]->ino) {
+                group_remove(group, i);
+            }
+        }
+    }
+    dupes_recount(task);
+}
+
+// 두 파일의 내용이 바이트 단위로 같은지
+static bool same_content(const char *a, const char *b, off_t size) {
+    int fa = open(a, O_RDONLY | O_CLOEXEC);
+    int fb = open(b, O_RDONLY | O_CLOEXEC);
+    char *buffer = malloc(2 * DUPES_READ_BUFFER);
+    bool same = (fa != -1 && fb != -1 && buffer);
+    off_t offset = 0;
+    while (same && offset < size) {
+        size_t len = (size - offset) < DUPES_READ_BUFFER ? (size_t)(size - offset) : DUPES_READ_BUFFER;
+        same = read_exact(fa, buffer, len, offset) && read_exact(fb, buffer + DUPES_READ_BUFFER, len, offset) &&
+               memcmp(buffer, buffer + DUPES_READ_BUFFER, len) == 0;
+        offset += len;
+    }
+    if (fa != -1) close(fa);
+    if (fb != -1) close(fb);
+    free(buffer);
+    return same;
+}
+
+bool dupes_link(DupesTask *task, int ordinal, char *error, size_t error_size) {
+    int g, i;
+    if (!task->finished || !dupes_locate(task, ordinal, &g, &i)) return false;
+    DupesGroup *group = &task->groups[g];
+    DupesFile *target = group->files[i];
+    DupesFile *keep = group->files[i == 0 ? 1 : 0];
+
+    struct stat target_st, keep_st;
+    if (lstat(target->path, &target_st) == -1 || lstat(keep->path, &keep_st) == -1) {
+        snprintf(error, error_size, "파일이 없습니다");
+        dupes_prune(task);
+        return false;
+    }
+    if (target_st.st_dev != keep_st.st_dev) {
+        snprintf(error, error_size, "다른 파일시스템이라 하드 링크를 만들 수 없습니다");
+        return false;
+    }
+    if (target_st.st_ino != keep_st.st_ino) {
+        if (target_st.st_size != group->size || keep_st.st_size != group->size ||
+            !same_content(keep->path, target->path, group->size)) {
+            snprintf(error, error_size, "찾은 뒤에 내용이 바뀌었습니다");
+            return false;
+        }
+
+        // 임시 이름으로 링크를 만든 뒤 rename으로 한 번에 바꿈 (중간에 실패해도 원래 파일은 그대로)
+        char temp[MAX_PATH_LEN + 32];
+        snprintf(temp, sizeof(temp), "%s.finder-link-%d", target->path, (int)getpid());
+        if (link(keep->path, temp) == -1) {
+            snprintf(error, error_size, "하드 링크 실패: %s", strerror(errno));
+            return false;
+        }
+        if (rename(temp, target->path) == -1) {
+            snprintf(error, error_size, "바꾸기 실패: %s", strerror(errno));
+            unlink(temp);
+            return false;
+        }
+    }
+
+    // 이제 공간을 차지하지 않으므로 묶음에서 뺌
+    target->ino = keep_st.st_ino;
+    group_remove(group, i);
+    dupes_recount(task);
+    return true;
+}
@@ -0,0 +1,108 @@
+// dupes.h
+#ifndef DUPES_H
+#define DUPES_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <sys/types.h>
+#include <pthread.h>
+#include "fs.h"
+#include "walk.h"
+
+#define DUPES_EDGE_BYTES 4096          // 2단계에서 읽는 앞/뒤 블록 크기 (이보다 두 배 이하인 파일은 전체를 읽음)
+#define DUPES_READ_BUFFER (256 * 1024) // 전체 해시를 읽는 버퍼 (워커마다 하나)
+#define DUPES_MAX_THREADS 16
+#define DUPES_NOTIFY_MS 100            // 진행 중 화면을 깨우는 최소 간격
+
+// 진행 단계 (크기 → 앞뒤 블록 → 전체 내용 순으로 후보를 좁힘)
+typedef enum {
+    DUPES_STAGE_SCAN = 0,      // 파일 목록과 크기 읽기
+    DUPES_STAGE_EDGES,         // 크기가 같은 파일의 앞/뒤 블록 해시
+    DUPES_STAGE_FULL,          // 앞뒤까지 같은 파일의 전체 해시
+    DUPES_STAGE_DONE
+} DupesStage;
+
+// XXH64 방식의 스트리밍 해시 (32바이트 단위 네 갈래 누적이라 컴파일러가 병렬로 펼침)
+typedef struct {
+    uint64_t v[4];
+    uint64_t total;
+    unsigned char buffer[32];
+    size_t buffered;
+} DupesHash;
+
+typedef struct {
+    char *path;                // 절대 경로
+    off_t size;
+    dev_t dev;
+    ino_t ino;
+    uint64_t edge_hash;        // 앞/뒤 블록 해시
+    uint64_t full_hash;        // 전체 내용 해시
+    bool failed;               // 읽지 못해 후보에서 뺌
+} DupesFile;
+
+// 내용이 같은 파일 묶음 (files의 포인터, 첫 항목이 하드 링크로 바꿀 때 남기는 원본)
+typedef struct {
+    off_t size;
+    DupesFile **files;
+    int count;
+} DupesGroup;
+
+// 하위 디렉토리의 중복 파일 찾기 - 진행 스레드가 병렬 탐색 후 단계마다 남은 후보만 워커들에게 나눠 읽힘
+typedef struct {
+    bool active;               // 결과 화면이 열려 있거나 결과를 들고 있음
+    char root[MAX_PATH_LEN];
+    Walker walker;
+    pthread_t thread;          // 진행 스레드
+    bool thread_started;
+    volatile bool cancel;
+
+    pthread_mutex_t lock;      // 파일 목록 추가와 아래 진행 상황 보호
+    DupesFile *files;
+    int file_count;
+    int file_capacity;
+    DupesStage stage;
+    long stage_done;           // 이번 단계에서 끝낸 파일 수
+    long stage_total;
+    off_t bytes_read;          // 해시하느라 읽은 바이트
+    bool finished;             // 끝남 (취소 포함) - 이후 groups는 메인 스레드만 씀
+    bool cancelled;
+    long last_notify_ms;
+
+    DupesGroup *groups;        // 낭비 크기가 큰 순
+    int group_count;
+    off_t wasted;              // 묶음마다 (개수 - 1) * 크기의 합
+    int duplicate_count;       // 묶음에 든 파일 수
+
+    int selection;             // 결과 화면에서 고른 파일 (묶음 제목 행을 뺀 순번)
+} DupesTask;
+
+// 찾기 시작 (즉시 반환), one_filesystem이면 마운트 지점을 넘지 않음
+bool dupes_start(DupesTask *task, const char *root, bool one_filesystem);
+
+// 진행 취소 (그때까지 확정된 결과는 없음)
+void dupes_cancel(DupesTask *task);
+
+// 멈추고 결과 해제 (active도 끔)
+void dupes_stop(DupesTask *task);
+
+// 읽은 디렉토리 수
+long dupes_dirs_scanned(DupesTask *task);
+
+// 결과의 파일 수 (묶음 제목 행 제외)
+int dupes_file_rows(const DupesTask *task);
+
+// 순번으로 묶음과 그 안의 위치 찾기 (없으면 false)
+bool dupes_locate(const DupesTask *task, int ordinal, int *group, int *index);
+
+// 더 이상 없는 파일을 결과에서 뺌 (삭제한 뒤 호출, 한 개만 남은 묶음도 없앰)
+void dupes_prune(DupesTask *task);
+
+// 고른 파일을 같은 묶음의 원본에 대한 하드 링크로 바꿈 (바꾸기 전에 내용을 바이트 단위로 다시 비교)
+bool dupes_link(DupesTask *task, int ordinal, char *error, size_t error_size);
+
+// 해시 (다른 모듈에서도 쓸 수 있도록 공개)
+void dupes_hash_init(DupesHash *hash);
+void dupes_hash_update(DupesHash *hash, const void *data, size_t len);
+uint64_t dupes_hash_final(const DupesHash *hash);
+
+#endif
@@ -0,0 +1,188 @@
+// event.c
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+#include "event.h"
+#include "fs.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+#include <unistd.h>
+#include <errno.h>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+
+static int g_notify_fd = -1;   // 작업 스레드 → UI 알림
+static int g_inotify_fd = -1;  // 보이는 디렉토리들의 변경 감시
+static int g_watch_wd[EVENT_MAX_WATCHES];
+static char g_watch_path[EVENT_MAX_WATCHES][MAX_PATH_LEN];
+static int g_changed_watches = 0; // 내용이 바뀐 감시 칸 (비트)
+static int g_progress_interval_ms = 1000 / EVENT_DEFAULT_PROGRESS_HZ;
+
+bool event_init() {
+    g_notify_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (g_notify_fd == -1) {
+        return false;
+    }
+
+    // inotify가 없어도 (수동 새로고침으로) 동작은 가능
+    g_inotify_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    for (int i = 0; i < EVENT_MAX_WATCHES; i++) {
+        g_watch_wd[i] = -1;
+        g_watch_path[i][0] = '\0';
+    }
+
+    const char *hz = getenv("FINDER_PROGRESS_HZ");
+    if (hz) {
+        int value = atoi(hz);
+        if (value > 0 && value <= 1000) {
+            g_progress_interval_ms = 1000 / value;
+        }
+    }
+    return true;
+}
+
+void event_cleanup() {
+    if (g_inotify_fd != -1) close(g_inotify_fd);
+    if (g_notify_fd != -1) close(g_notify_fd);
+    g_inotify_fd = -1;
+    g_notify_fd = -1;
+    for (int i = 0; i < EVENT_MAX_WATCHES; i++) {
+        g_watch_wd[i] = -1;
+        g_watch_path[i][0] = '\0';
+    }
+    g_changed_watches = 0;
+}
+
+void notify_ui() {
+    if (g_notify_fd == -1) return;
+    uint64_t one = 1;
+    // 카운터가 가득 찬 경우(EAGAIN)에도 이미 깨울 예정이므로 무시
+    ssize_t written = write(g_notify_fd, &one, sizeof(one));
+    (void)written;
+}
+
+// 읽을 수 있는 만큼 비움
+static void drain_fd(int fd) {
+    char buf[4096];
+    while (read(fd, buf, sizeof(buf)) > 0) {
+    }
+}
+
+static bool has_watch() {
+    for (int i = 0; i < EVENT_MAX_WATCHES; i++) {
+        if (g_watch_wd[i] != -1) return true;
+    }
+    return false;
+}
+
+// inotify 이벤트를 읽어 어느 감시 칸이 바뀌었는지 기록 (같은 디렉토리를 보는 칸은 wd를 공유)
+static int read_inotify_changes() {
+    char buf[4096] __attribute__((aligned(__alignof__(struct inotify_event))));
+    int changed = 0;
+    ssize_t len;
+    while ((len = read(g_inotify_fd, buf, sizeof(buf))) > 0) {
+        for (char *ptr = buf; ptr < buf + len;) {
+            const struct inotify_event *event = (const struct inotify_event *)ptr;
+            for (int i = 0; i < EVENT_MAX_WATCHES; i++) {
+                if (g_watch_wd[i] != -1 && g_watch_wd[i] == event->wd) changed |= 1 << i;
+            }
+            ptr += sizeof(struct inotify_event) + event->len;
+        }
+    }
+    return changed;
+}
+
+int event_wait(int timeout_ms) {
+    struct pollfd fds[3];
+    int count = 0;
+
+    fds[count].fd = STDIN_FILENO;
+    fds[count].events = POLLIN;
+    count++;
+    int notify_index = -1;
+    if (g_notify_fd != -1) {
+        notify_index = count;
+        fds[count].fd = g_notify_fd;
+        fds[count].events = POLLIN;
+        count++;
+    }
+    int inotify_index = -1;
+    if (g_inotify_fd != -1 && has_watch()) {
+        inotify_index = count;
+        fds[count].fd = g_inotify_fd;
+        fds[count].events = POLLIN;
+        count++;
+    }
+
+    int ready = poll(fds, count, timeout_ms);
+    if (ready < 0) {
+        // SIGWINCH 등으로 중단된 경우 - ncurses가 KEY_RESIZE를 넘겨주도록 입력으로 처리
+        return (errno == EINTR) ? EVENT_INPUT : EVENT_TIMER;
+    }
+    if (ready == 0) {
+        return EVENT_TIMER;
+    }
+
+    int events = 0;
+    if (fds[0].revents & (POLLIN | POLLHUP | POLLERR)) {
+        events |= EVENT_INPUT;
+    }
+    if (notify_index >= 0 && (fds[notify_index].revents & POLLIN)) {
+        drain_fd(g_notify_fd);
+        events |= EVENT_NOTIFY;
+    }
+    if (inotify_index >= 0 && (fds[inotify_index].revents & POLLIN)) {
+        int changed = read_inotify_changes();
+        if (changed) {
+            g_changed_watches |= changed;
+            events |= EVENT_FS;
+        }
+    }
+    return events;
+}
+
+int event_take_changed_watches() {
+    int changed = g_changed_watches;
+    g_changed_watches = 0;
+    return changed;
+}
+
+bool event_watch_directory(int slot, const char *path) {
+    if (g_inotify_fd == -1 || slot < 0 || slot >= EVENT_MAX_WATCHES) return false;
+    if (path && g_watch_wd[slot] != -1 && strcmp(g_watch_path[slot], path) == 0) return true;
+
+    // 다른 칸과 같이 쓰는 wd가 아니면 감시 해제 (남은 이벤트는 모르는 wd로 무시됨)
+    int old_wd = g_watch_wd[slot];
+    g_watch_wd[slot] = -1;
+    g_watch_path[slot][0] = '\0';
+    g_changed_watches &= ~(1 << slot);
+    if (old_wd != -1) {
+        bool shared = false;
+        for (int i = 0; i < EVENT_MAX_WATCHES; i++) {
+            if (g_watch_wd[i] == old_wd) shared = true;
+        }
+        if (!shared) inotify_rm_watch(g_inotify_fd, old_wd);
+    }
+    if (!path) return true;
+
+    // 같은 디렉토리를 다시 추가하면 커널이 같은 wd를 돌려줌
+    g_watch_wd[slot] = inotify_add_watch(g_inotify_fd, path,
+                                         IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO |
+                                         IN_CLOSE_WRITE | IN_ATTRIB | IN_ONLYDIR);
+    snprintf(g_watch_path[slot], sizeof(g_watch_path[slot]), "%s", path);
+    return g_watch_wd[slot] != -1;
+}
+
+int event_progress_interval_ms() {
+    return g_progress_interval_ms;
+}
+
+long event_now_ms() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
@@ -0,0 +1,41 @@
+// event.h
+#ifndef EVENT_H
+#define EVENT_H
+
+#include <stdbool.h>
+
+// event_wait()이 돌려주는 깨어난 이유 (여러 개가 함께 설정될 수 있음)
+#define EVENT_INPUT  0x01 // 키 입력 (터미널 크기 변경 포함)
+#define EVENT_NOTIFY 0x02 // 백그라운드 작업이 notify_ui()로 알림
+#define EVENT_FS     0x04 // 감시 중인 디렉토리 내용 변경 (inotify)
+#define EVENT_TIMER  0x08 // 시간 초과
+
+#define EVENT_DEFAULT_PROGRESS_HZ 10 // 진행률 갱신 기본 빈도 (FINDER_PROGRESS_HZ로 변경)
+#define EVENT_FS_RELOAD_MS 250       // 디렉토리 변경 시 목록을 다시 읽는 최소 간격
+#define EVENT_MAX_WATCHES 2          // 동시에 감시하는 디렉토리 수 (분할 화면의 두 목록)
+
+// 이벤트 시스템 초기화 (eventfd, inotify 생성)
+bool event_init();
+
+// 이벤트 시스템 정리
+void event_cleanup();
+
+// UI 스레드 깨우기 (아무 스레드에서나 호출 가능)
+void notify_ui();
+
+// 입력/알림/디렉토리 변경/시간 초과까지 대기 (timeout_ms < 0이면 무한 대기)
+int event_wait(int timeout_ms);
+
+// 감시 칸(0 ~ EVENT_MAX_WATCHES - 1)의 디렉토리 교체 (이미 감시 중인 경로면 아무것도 하지 않음, NULL이면 감시 해제)
+bool event_watch_directory(int slot, const char *path);
+
+// EVENT_FS 이후 내용이 바뀐 감시 칸 (칸 번호별 비트, 읽으면 지워짐)
+int event_take_changed_watches();
+
+// 진행률을 다시 그리는 간격 (밀리초)
+int event_progress_interval_ms();
+
+// 단조 증가 시계 (밀리초)
+long event_now_ms();
+
+#endif
@@ -0,0 +1,373 @@
+// filetype.c
+#include "filetype.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <ctype.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+typedef struct {
+    char label[FILETYPE_MAX_LABEL];
+    bool editable;
+} TypeInfo;
+
+// 기본 종류 (FileType 순서와 같음, 편집 여부는 예전 "source/header/script" 판정과 같음)
+static const TypeInfo g_builtin_types[FILETYPE_BUILTIN_COUNT] = {
+    [FILETYPE_NONE]       = { "일반 파일", false },
+    [FILETYPE_C_SOURCE]   = { "C source", true },
+    [FILETYPE_C_HEADER]   = { "C header", true },
+    [FILETYPE_CPP_SOURCE] = { "C++ source", true },
+    [FILETYPE_CPP_HEADER] = { "C++ header", true },
+    [FILETYPE_PYTHON]     = { "Python source", true },
+    [FILETYPE_JAVA]       = { "Java source", true },
+    [FILETYPE_JS]         = { "JS source", true },
+    [FILETYPE_HTML]       = { "HTML file", false },
+    [FILETYPE_CSS]        = { "CSS file", false },
+    [FILETYPE_PHP]        = { "PHP source", true },
+    [FILETYPE_RUBY]       = { "Ruby source", true },
+    [FILETYPE_GO]         = { "Go source", true },
+    [FILETYPE_RUST]       = { "Rust source", true },
+    [FILETYPE_SHELL]      = { "Shell script", true },
+    [FILETYPE_ASM]        = { "Assembly source", true },
+    [FILETYPE_SWIFT]      = { "Swift source", true },
+    [FILETYPE_KOTLIN]     = { "Kotlin source", true },
+    // 내용으로 판별한 종류는 표시만 바뀌고 Enter 동작(실행 파일이면 실행)은 그대로
+    [FILETYPE_ELF]        = { "ELF 실행 파일", false },
+    [FILETYPE_SCRIPT]     = { "스크립트 (#!)", false },
+    [FILETYPE_PNG]        = { "PNG 이미지", false },
+    [FILETYPE_JPEG]       = { "JPEG 이미지", false },
+    [FILETYPE_GIF]        = { "GIF 이미지", false },
+    [FILETYPE_PDF]        = { "PDF 문서", false },
+    [FILETYPE_ZIP]        = { "ZIP 압축", false },
+    [FILETYPE_GZIP]       = { "gzip 압축", false },
+    [FILETYPE_XZ]         = { "xz 압축", false },
+    [FILETYPE_BZIP2]      = { "bzip2 압축", false },
+    [FILETYPE_ZSTD]       = { "zstd 압축", false },
+    [FILETYPE_TAR]        = { "tar 묶음", false },
+    [FILETYPE_SQLITE]     = { "SQLite DB", false },
+    [FILETYPE_TEXT]       = { "텍스트 파일", false },
+};
+
+typedef struct {
+    const char *ext;
+    int type;
+} ExtDefault;
+
+static const ExtDefault g_default_exts[] = {
+    { "c", FILETYPE_C_SOURCE }, { "h", FILETYPE_C_HEADER },
+    { "cpp", FILETYPE_CPP_SOURCE }, { "cc", FILETYPE_CPP_SOURCE }, { "hpp", FILETYPE_CPP_HEADER },
+    { "py", FILETYPE_PYTHON }, { "java", FILETYPE_JAVA }, { "js", FILETYPE_JS },
+    { "html", FILETYPE_HTML }, { "css", FILETYPE_CSS }, { "php", FILETYPE_PHP },
+    { "rb", FILETYPE_RUBY }, { "go", FILETYPE_GO }, { "rs", FILETYPE_RUST },
+    { "sh", FILETYPE_SHELL }, { "asm", FILETYPE_ASM }, { "s", FILETYPE_ASM },
+    { "swift", FILETYPE_SWIFT }, { "kt", FILETYPE_KOTLIN },
+};
+
+// 완전 해시 표의 칸 (빈 칸은 ext[0] == '\0')
+typedef struct {
+    char ext[FILETYPE_MAX_EXT];
+    unsigned short type;
+} ExtSlot;
+
+// 표를 만들 때 쓰는 (확장자, 종류) 목록
+typedef struct {
+    char ext[FILETYPE_MAX_EXT];
+    int type;
+} ExtPair;
+
+static TypeInfo g_user_types[FILETYPE_MAX_USER];
+static int g_user_type_count = 0;
+
+static ExtSlot *g_slots = NULL;
+static uint32_t g_slot_mask = 0;
+static uint32_t g_seed = 0;
+
+// 내용 판별 캐시
+typedef struct SniffEntry {
+    dev_t dev;
+    ino_t ino;
+    time_t modified;
+    unsigned short type;
+    struct SniffEntry *next;
+} SniffEntry;
+
+static SniffEntry *g_sniff_cache[FILETYPE_CACHE_BUCKETS];
+static int g_sniff_count = 0;
+
+static uint32_t ext_hash(const char *ext, uint32_t seed) {
+    uint32_t h = 2166136261u ^ seed;
+    for (; *ext; ext++) {
+        h ^= (unsigned char)*ext;
+        h *= 16777619u;
+    }
+    h ^= h >> 15;
+    h *= 0x2c1b3c6du;
+    h ^= h >> 12;
+    return h;
+}
+
+// 소문자 확장자 (없거나 너무 길면 false)
+static bool lower_ext(const char *name, char *out) {
+    const char *dot = strrchr(name, '.');
+    if (!dot) return false;
+    size_t len = strlen(dot + 1);
+    if (len == 0 || len >= FILETYPE_MAX_EXT) return false;
+    for (size_t i = 0; i <= len; i++) {
+        out[i] = (char)tolower((unsigned char)dot[1 + i]);
+    }
+    return true;
+}
+
+// 같은 확장자는 나중 것(사용자 목록)으로 바꿈
+static void pair_add(ExtPair *pairs, int *count, int capacity, const char *ext, int type) {
+    for (int i = 0; i < *count; i++) {
+        if (strcmp(pairs[i].ext, ext) == 0) {
+            pairs[i].type = type;
+            return;
+        }
+    }
+    if (*count >= capacity) return;
+    snprintf(pairs[*count].ext, FILETYPE_MAX_EXT, "%s", ext);
+    pairs[*count].type = type;
+    (*count)++;
+}
+
+static char* trim(char *s) {
+    while (isspace((unsigned char)*s)) s++;
+    char *end = s + strlen(s);
+    while (end > s && isspace((unsigned char)end[-1])) *--end = '\0';
+    return s;
+}
+
+// 사용자 연결 목록 읽기 - "확장자[,확장자...] = 종류 이름[, edit]", #은 주석
+static void load_user_types(ExtPair *pairs, int *count, int capacity) {
+    char path[MAX_PATH_LEN];
+    const char *env = getenv("FINDER_TYPES");
+    const char *config = getenv("XDG_CONFIG_HOME");
+    const char *home = getenv("HOME");
+    if (env && env[0] != '\0') {
+        snprintf(path, sizeof(path), "%s", env);
+    } else if (config && config[0] == '/') {
+        snprintf(path, sizeof(path), "%s/finder/types", config);
+    } else if (home && home[0] == '/') {
+        snprintf(path, sizeof(path), "%s/.config/finder/types", home);
+    } else {
+        return;
+    }
+
+    FILE *f = fopen(path, "r");
+    if (!f) return;
+    char line[512];
+    while (fgets(line, sizeof(line), f) && g_user_type_count < FILETYPE_MAX_USER) {
+        char *text = trim(line);
+        if (text[0] == '\0' || text[0] == '#') continue;
+        char *eq = strchr(text, '=');
+        if (!eq) continue;
+        *eq = '\0';
+        char *exts = trim(text);
+        char *label = trim(eq + 1);
+
+        bool editable = false;
+        char *comma = strrchr(label, ',');
+        if (comma && strcmp(trim(comma + 1), "edit") == 0) {
+            editable = true;
+            *comma = '\0';
+            label = trim(label);
+        }
+        if (label[0] == '\0' || exts[0] == '\0') continue;
+
+        int type = FILETYPE_BUILTIN_COUNT + g_user_type_count;
+        TypeInfo *info = &g_user_types[g_user_type_count++];
+        snprintf(info->label, sizeof(info->label), "%s", label);
+        info->editable = editable;
+
+        char *save = NULL;
+        for (char *ext = strtok_r(exts, ",", &save); ext; ext = strtok_r(NULL, ",", &save)) {
+            ext = trim(ext);
+            if (*ext == '.') ext++;
+            char lower[FILETYPE_MAX_EXT];
+            size_t len = strlen(ext);
+            if (len == 0 || len >= FILETYPE_MAX_EXT) continue;
+            for (size_t i = 0; i <= len; i++) lower[i] = (char)tolower((unsigned char)ext[i]);
+            pair_add(pairs, count, capacity, lower, type);
+        }
+    }
+    fclose(f);
+}
+
+// 모든 확장자가 서로 다른 칸에 들어가는 시드를 찾음 (안 되면 표를 두 배로)
+static bool build_perfect_table(const ExtPair *pairs, int count) {
+    uint32_t size = 16;
+    while (size < (uint32_t)count * 2) size <<= 1;
+
+    for (; size <= (1u << 20); size <<= 1) {
+        ExtSlot *slots = calloc(size, sizeof(ExtSlot));
+        if (!slots) return false;
+        for (uint32_t seed = 1; seed <= FILETYPE_SEED_TRIES; seed++) {
+            bool ok = true;
+            for (int i = 0; i < count && ok; i++) {
+                ExtSlot *slot = &slots[ext_hash(pairs[i].ext, seed) & (size - 1)];
+                if (slot->ext[0] != '\0') {
+                    ok = false;
+                } else {
+                    memcpy(slot->ext, pairs[i].ext, FILETYPE_MAX_EXT);
+                    slot->type = (unsigned short)pairs[i].type;
+                }
+            }
+            if (ok) {
+                g_slots = slots;
+                g_slot_mask = size - 1;
+                g_seed = seed;
+                return true;
+            }
+            memset(slots, 0, sizeof(ExtSlot) * size);
+        }
+        free(slots);
+    }
+    return false;
+}
+
+bool init_file_types() {
+    int capacity = (int)(sizeof(g_default_exts) / sizeof(g_default_exts[0])) + FILETYPE_MAX_USER * 8;
+    ExtPair *pairs = malloc(sizeof(ExtPair) * capacity);
+    if (!pairs) return false;
+    int count = 0;
+    for (size_t i = 0; i < sizeof(g_default_exts) / sizeof(g_default_exts[0]); i++) {
+        pair_add(pairs, &count, capacity, g_default_exts[i].ext, g_default_exts[i].type);
+    }
+    load_user_types(pairs, &count, capacity);
+
+    bool ok = build_perfect_table(pairs, count);
+    free(pairs);
+    return ok;
+}
+
+static void clear_sniff_cache() {
+    for (int i = 0; i < FILETYPE_CACHE_BUCKETS; i++) {
+        SniffEntry *e = g_sniff_cache[i];
+        while (e) {
+            SniffEntry *next = e->next;
+            free(e);
+            e = next;
+        }
+        g_sniff_cache[i] = NULL;
+    }
+    g_sniff_count = 0;
+}
+
+void cleanup_file_types() {
+    free(g_slots);
+    g_slots = NULL;
+    g_slot_mask = 0;
+    clear_sniff_cache();
+}
+
+int file_type_from_name(const char *name) {
+    char ext[FILETYPE_MAX_EXT];
+    if (!g_slots || !lower_ext(name, ext)) return FILETYPE_NONE;
+    const ExtSlot *slot = &g_slots[ext_hash(ext, g_seed) & g_slot_mask];
+    return strcmp(slot->ext, ext) == 0 ? slot->type : FILETYPE_NONE;
+}
+
+const char* file_type_label(int type) {
+    if (type >= 0 && type < FILETYPE_BUILTIN_COUNT) return g_builtin_types[type].label;
+    type -= FILETYPE_BUILTIN_COUNT;
+    if (type >= 0 && type < g_user_type_count) return g_user_types[type].label;
+    return g_builtin_types[FILETYPE_NONE].label;
+}
+
+bool file_type_editable(int type) {
+    if (type >= 0 && type < FILETYPE_BUILTIN_COUNT) return g_builtin_types[type].editable;
+    type -= FILETYPE_BUILTIN_COUNT;
+    return type >= 0 && type < g_user_type_count && g_user_types[type].editable;
+}
+
+// 앞부분의 서명으로 종류 판별 (NUL이 없으면 텍스트)
+static int detect_magic(const unsigned char *p, size_t len) {
+    #define MAGIC(sig) (len >= sizeof(sig) - 1 && memcmp(p, sig, sizeof(sig) - 1) == 0)
+    if (MAGIC("\x7f" "ELF")) return FILETYPE_ELF;
+    if (MAGIC("#!")) return FILETYPE_SCRIPT;
+    if (MAGIC("\x89PNG\r\n\x1a\n")) return FILETYPE_PNG;
+    if (MAGIC("\xff\xd8\xff")) return FILETYPE_JPEG;
+    if (MAGIC("GIF87a") || MAGIC("GIF89a")) return FILETYPE_GIF;
+    if (MAGIC("%PDF-")) return FILETYPE_PDF;
+    if (MAGIC("PK\x03\x04") || MAGIC("PK\x05\x06")) return FILETYPE_ZIP;
+    if (MAGIC("\x1f\x8b")) return FILETYPE_GZIP;
+    if (MAGIC("\xfd" "7zXZ")) return FILETYPE_XZ;
+    if (MAGIC("BZh")) return FILETYPE_BZIP2;
+    if (MAGIC("\x28\xb5\x2f\xfd")) return FILETYPE_ZSTD;
+    if (MAGIC("SQLite format 3")) return FILETYPE_SQLITE;
+    #undef MAGIC
+    if (len >= 262 && memcmp(p + 257, "ustar", 5) == 0) return FILETYPE_TAR;
+    if (!memchr(p, '\0', len)) return FILETYPE_TEXT;
+    return FILETYPE_NONE;
+}
+
+static int sniff_path(const char *path) {
+    int fd = open(path, O_RDONLY | O_NOFOLLOW | O_NONBLOCK | O_CLOEXEC);
+    if (fd == -1) return FILETYPE_NONE;
+    unsigned char buffer[FILETYPE_SNIFF_BYTES];
+    ssize_t got = pread(fd, buffer, sizeof(buffer), 0);
+    close(fd);
+    return got > 0 ? detect_magic(buffer, (size_t)got) : FILETYPE_NONE;
+}
+
+static SniffEntry** sniff_bucket(dev_t dev, ino_t ino) {
+    return &g_sniff_cache[(unsigned int)((ino * 31u + dev) % FILETYPE_CACHE_BUCKETS)];
+}
+
+void sniff_file_types(const char *dir, FileEntry files[], int count, int start, int rows) {
+    if (start < 0) start = 0;
+    int end = start + rows;
+    if (end > count) end = count;
+
+    for (int i = start; i < end; i++) {
+        FileEntry *file = &files[i];
+        if (!file->type_pending) continue;
+        file->type_pending = false;
+
+        // 같은 inode를 같은 수정 시각에 이미 읽었으면 그대로
+        SniffEntry **bucket = sniff_bucket(file->dev, file->ino);
+        SniffEntry *found = NULL;
+        for (SniffEntry *e = *bucket; e; e = e->next) {
+            if (e->dev == file->dev && e->ino == file->ino) {
+                found = e;
+                break;
+            }
+        }
+        int type;
+        if (found && found->modified == file->modified) {
+            type = found->type;
+        } else {
+            char path[MAX_PATH_LEN * 2];
+            snprintf(path, sizeof(path), "%s/%s", strcmp(dir, "/") == 0 ? "" : dir, file->name);
+            type = sniff_path(path);
+            if (found) {
+                found->modified = file->modified;
+                found->type = (unsigned short)type;
+            } else {
+                // 너무 커지면 전부 비우고 다시 채움
+                if (g_sniff_count >= FILETYPE_CACHE_MAX_ENTRIES) clear_sniff_cache();
+                SniffEntry *entry = malloc(sizeof(SniffEntry));
+                if (entry) {
+                    entry->dev = file->dev;
+                    entry->ino = file->ino;
+                    entry->modified = file->modified;
+                    entry->type = (unsigned short)type;
+                    entry->next = *bucket;
+                    *bucket = entry;
+                    g_sniff_count++;
+                }
+            }
+        }
+
+        if (type != FILETYPE_NONE) {
+            file->file_type = (unsigned short)type;
+            snprintf(file->type, sizeof(file->type), "%s", file_type_label(type));
+            file->type_width = display_width(file->type, 0, NULL);
+        }
+    }
+}
@@ -0,0 +1,75 @@
+// filetype.h
+#ifndef FILETYPE_H
+#define FILETYPE_H
+
+#include <stdbool.h>
+#include <sys/types.h>
+#include "fs.h"
+
+#define FILETYPE_MAX_EXT 16          // 확장자 최대 길이 (널 포함)
+#define FILETYPE_MAX_LABEL 32        // 종류 이름 최대 길이 (FileEntry.type과 같음)
+#define FILETYPE_MAX_USER 256        // 사용자 연결 목록에서 더할 수 있는 종류 수
+#define FILETYPE_SEED_TRIES 4096     // 표 크기마다 충돌 없는 시드를 찾는 횟수
+#define FILETYPE_SNIFF_BYTES 512     // 내용으로 판별할 때 읽는 앞부분 (tar 헤더 포함)
+#define FILETYPE_CACHE_BUCKETS 1024
+#define FILETYPE_CACHE_MAX_ENTRIES 16384
+
+// 파일 종류 - 확장자 표와 내용 판별 결과, 사용자 연결 목록의 종류는 FILETYPE_BUILTIN_COUNT부터
+typedef enum {
+    FILETYPE_NONE = 0,       // 일반 파일 (알 수 없음)
+    FILETYPE_C_SOURCE,
+    FILETYPE_C_HEADER,
+    FILETYPE_CPP_SOURCE,
+    FILETYPE_CPP_HEADER,
+    FILETYPE_PYTHON,
+    FILETYPE_JAVA,
+    FILETYPE_JS,
+    FILETYPE_HTML,
+    FILETYPE_CSS,
+    FILETYPE_PHP,
+    FILETYPE_RUBY,
+    FILETYPE_GO,
+    FILETYPE_RUST,
+    FILETYPE_SHELL,
+    FILETYPE_ASM,
+    FILETYPE_SWIFT,
+    FILETYPE_KOTLIN,
+    // 내용 앞부분으로 판별 (확장자로 알 수 없는 파일만)
+    FILETYPE_ELF,
+    FILETYPE_SCRIPT,
+    FILETYPE_PNG,
+    FILETYPE_JPEG,
+    FILETYPE_GIF,
+    FILETYPE_PDF,
+    FILETYPE_ZIP,
+    FILETYPE_GZIP,
+    FILETYPE_XZ,
+    FILETYPE_BZIP2,
+    FILETYPE_ZSTD,
+    FILETYPE_TAR,
+    FILETYPE_SQLITE,
+    FILETYPE_TEXT,
+    FILETYPE_BUILTIN_COUNT
+} FileType;
+
+// 확장자 표 준비 - 기본 표에 사용자 연결 목록(FINDER_TYPES, 기본 ~/.config/finder/types)을 더해
+// 충돌 없는 완전 해시 표를 만듦 (목록 형식: "확장자[,확장자...] = 종류 이름[, edit]")
+bool init_file_types();
+
+// 표 해제
+void cleanup_file_types();
+
+// 이름의 확장자로 종류 찾기 (해시 한 번 + 비교 한 번, 모르면 FILETYPE_NONE)
+int file_type_from_name(const char *name);
+
+// 종류 이름 ("C source", "일반 파일" 등)
+const char* file_type_label(int type);
+
+// Enter로 편집기를 여는 종류인지 (소스/헤더/스크립트 확장자와 사용자 목록의 edit)
+bool file_type_editable(int type);
+
+// 보이는 행 [start, start + rows) 중 확장자로 종류를 모르는 일반 파일만 앞부분을 읽어 판별
+// 결과는 (장치, inode, 수정 시각)별로 기억해 같은 파일은 다시 읽지 않음 (메인 스레드 전용)
+void sniff_file_types(const char *dir, FileEntry files[], int count, int start, int rows);
+
+#endif
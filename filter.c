@@ -0,0 +1,318 @@
+// filter.c
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE // memmem
+#endif
+#include "filter.h"
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+
+// 퍼지 찾기 점수
+#define FUZZY_SCORE_MATCH 16       // 맞은 글자 하나
+#define FUZZY_BONUS_BOUNDARY 8     // 이름 시작이나 구분자 바로 뒤
+#define FUZZY_BONUS_CONSECUTIVE 4  // 앞 글자에 이어서 맞음 (이어진 길이만큼, 최대 3배)
+#define FUZZY_PENALTY_GAP_START 3  // 맞은 글자 사이에 다른 글자가 끼기 시작
+#define FUZZY_PENALTY_GAP 1        // 끼어 있는 글자가 이어짐
+
+// ASCII만 소문자로 (UTF-8 다중 바이트 문자는 그대로)
+static void lower_copy(char *dest, const char *src, size_t len) {
+    for (size_t i = 0; i < len; i++) {
+        unsigned char c = (unsigned char)src[i];
+        dest[i] = (c < 0x80) ? (char)tolower(c) : (char)c;
+    }
+}
+
+void name_pool_free(NamePool *pool) {
+    free(pool->pool);
+    free(pool->offsets);
+    free(pool->matches);
+    free(pool->masks);
+    memset(pool, 0, sizeof(NamePool));
+}
+
+// 글자 종류 비트 (a-z, 0-9는 각각 한 비트, 나머지 ASCII는 27개 비트에 나눠 담고 비 ASCII 바이트는 한 비트)
+static uint64_t char_class_bit(unsigned char c) {
+    if (c >= 'a' && c <= 'z') return 1ULL << (c - 'a');
+    if (c >= '0' && c <= '9') return 1ULL << (26 + c - '0');
+    if (c >= 0x80) return 1ULL << 63;
+    return 1ULL << (36 + c % 27);
+}
+
+static uint64_t char_class_mask(const char *s, size_t len) {
+    uint64_t mask = 0;
+    for (size_t i = 0; i < len; i++) {
+        mask |= char_class_bit((unsigned char)s[i]);
+    }
+    return mask;
+}
+
+bool name_pool_build(NamePool *pool, const FileEntry *files, int count) {
+    name_pool_free(pool);
+
+    size_t total = 0;
+    for (int i = 0; i < count; i++) {
+        total += strlen(files[i].name) + 1;
+    }
+
+    pool->pool = malloc(total + 1);
+    pool->offsets = malloc(sizeof(int) * (count + 1));
+    pool->matches = malloc(sizeof(int) * (count > 0 ? count : 1));
+    pool->masks = malloc(sizeof(uint64_t) * (count > 0 ? count : 1));
+    if (!pool->pool || !pool->offsets || !pool->matches || !pool->masks) {
+        name_pool_free(pool);
+        return false;
+    }
+
+    size_t pos = 0;
+    for (int i = 0; i < count; i++) {
+        size_t len = strlen(files[i].name);
+        pool->offsets[i] = (int)pos;
+        lower_copy(pool->pool + pos, files[i].name, len);
+        pool->pool[pos + len] = '\0';
+        pool->masks[i] = char_class_mask(pool->pool + pos, len);
+        pos += len + 1;
+        pool->matches[i] = i;
+    }
+    pool->offsets[count] = (int)pos;
+    pool->pool_size = pos;
+    pool->count = count;
+    pool->match_count = count;
+    return true;
+}
+
+// pool 위치가 속한 항목 (offsets는 오름차순)
+static int entry_at(const NamePool *pool, size_t pos) {
+    int low = 0, high = pool->count - 1;
+    while (low < high) {
+        int mid = (low + high + 1) / 2;
+        if ((size_t)pool->offsets[mid] <= pos) {
+            low = mid;
+        } else {
+            high = mid - 1;
+        }
+    }
+    return low;
+}
+
+int name_pool_search(NamePool *pool, const char *query) {
+    char lowered[FILTER_MAX_QUERY];
+    size_t len = strlen(query);
+    if (len >= sizeof(lowered)) len = sizeof(lowered) - 1;
+    lower_copy(lowered, query, len);
+    lowered[len] = '\0';
+
+    bool refine = !pool->fuzzy && pool->query_len > 0 && len >= pool->query_len &&
+                  memcmp(lowered, pool->query, pool->query_len) == 0;
+
+    if (len == 0) {
+        // 빈 검색어는 모든 항목
+        for (int i = 0; i < pool->count; i++) {
+            pool->matches[i] = i;
+        }
+        pool->match_count = pool->count;
+    } else if (refine) {
+        // 검색어가 길어졌으면 앞선 결과 중에서만 남김
+        int kept = 0;
+        for (int i = 0; i < pool->match_count; i++) {
+            int index = pool->matches[i];
+            const char *name = pool->pool + pool->offsets[index];
+            size_t name_len = pool->offsets[index + 1] - pool->offsets[index] - 1;
+            if (name_len >= len && memmem(name, name_len, lowered, len)) {
+                pool->matches[kept++] = index;
+            }
+        }
+        pool->match_count = kept;
+    } else {
+        // 전체 검색 - 이름별로 따로 찾지 않고 이어 붙인 버퍼 전체를 memmem으로 훑음
+        // 검색어에는 '\0'이 없으므로 일치가 항목 경계를 넘지 않음
+        int kept = 0;
+        const char *cursor = pool->pool;
+        const char *end = pool->pool + pool->pool_size;
+        while (cursor < end) {
+            const char *hit = memmem(cursor, end - cursor, lowered, len);
+            if (!hit) break;
+            int index = entry_at(pool, hit - pool->pool);
+            pool->matches[kept++] = index;
+            cursor = pool->pool + pool->offsets[index + 1]; // 같은 항목의 다른 일치는 건너뜀
+        }
+        pool->match_count = kept;
+    }
+
+    memcpy(pool->query, lowered, len + 1);
+    pool->query_len = len;
+    pool->fuzzy = false;
+    return pool->match_count;
+}
+
+static bool is_name_separator(char c) {
+    return c == '_' || c == '-' || c == '.' || c == ' ';
+}
+
+// 소문자 이름 하나 채점 (맞지 않으면 -1), positions가 있으면 맞은 바이트 위치를 기록
+// 검색어가 처음으로 다 맞는 끝 위치를 찾고, 거기서 거꾸로 가장 짧은 구간을 잡은 뒤 그 구간 안에서 점수를 매김
+static int fuzzy_score(const char *name, size_t name_len, const char *query, size_t query_len, int *positions) {
+    if (query_len == 0) return 0; // 빈 검색어는 모든 항목이 목록 순서대로
+    size_t qi = 0, end = 0;
+    for (size_t i = 0; i < name_len && qi < query_len; i++) {
+        if (name[i] == query[qi]) {
+            qi++;
+            end = i;
+        }
+    }
+    if (qi < query_len) return -1;
+
+    size_t start = end;
+    qi = query_len;
+    for (size_t i = end + 1; i-- > 0;) {
+        if (name[i] == query[qi - 1] && --qi == 0) {
+            start = i;
+            break;
+        }
+    }
+
+    int score = 0, run = 0;
+    bool in_gap = false;
+    qi = 0;
+    for (size_t i = start; i <= end && qi < query_len; i++) {
+        if (name[i] == query[qi]) {
+            score += FUZZY_SCORE_MATCH;
+            if (i == 0 || is_name_separator(name[i - 1])) score += FUZZY_BONUS_BOUNDARY;
+            score += FUZZY_BONUS_CONSECUTIVE * (run < 3 ? run : 3);
+            if (positions) positions[qi] = (int)i;
+            run++;
+            in_gap = false;
+            qi++;
+        } else {
+            score -= in_gap ? FUZZY_PENALTY_GAP : FUZZY_PENALTY_GAP_START;
+            in_gap = true;
+            run = 0;
+        }
+    }
+    return score - (int)(name_len / 8); // 같은 점수면 짧은 이름이 위로
+}
+
+// 점수가 높고, 같으면 목록에서 앞선 쪽이 더 좋은 결과
+static bool fuzzy_better(const FuzzyMatch *a, const FuzzyMatch *b) {
+    return a->score > b->score || (a->score == b->score && a->index < b->index);
+}
+
+// 상위 결과는 크기가 정해진 힙으로 유지 (루트가 가장 나쁜 결과)
+static void heap_sift_down(FuzzyMatch *heap, int size, int i) {
+    while (1) {
+        int left = 2 * i + 1, right = left + 1, worst = i;
+        if (left < size && fuzzy_better(&heap[worst], &heap[left])) worst = left;
+        if (right < size && fuzzy_better(&heap[worst], &heap[right])) worst = right;
+        if (worst == i) break;
+        FuzzyMatch tmp = heap[i];
+        heap[i] = heap[worst];
+        heap[worst] = tmp;
+        i = worst;
+    }
+}
+
+static void heap_push(FuzzyMatch *heap, int *size, int capacity, FuzzyMatch match) {
+    if (*size < capacity) {
+        int i = (*size)++;
+        heap[i] = match;
+        while (i > 0) {
+            int parent = (i - 1) / 2;
+            if (!fuzzy_better(&heap[parent], &heap[i])) break;
+            FuzzyMatch tmp = heap[i];
+            heap[i] = heap[parent];
+            heap[parent] = tmp;
+            i = parent;
+        }
+    } else if (capacity > 0 && fuzzy_better(&match, &heap[0])) {
+        heap[0] = match;
+        heap_sift_down(heap, *size, 0);
+    }
+}
+
+int name_pool_fuzzy(NamePool *pool, const char *query, FuzzyMatch *results, int max_results, int *result_count) {
+    char lowered[FILTER_MAX_QUERY];
+    size_t len = strlen(query);
+    if (len >= sizeof(lowered)) len = sizeof(lowered) - 1;
+    lower_copy(lowered, query, len);
+    lowered[len] = '\0';
+
+    // 검색어 뒤에 글자를 붙였으면 앞선 결과 중에서만 (맞는 항목은 늘어나지 않음)
+    bool refine = pool->fuzzy && len >= pool->query_len &&
+                  memcmp(lowered, pool->query, pool->query_len) == 0;
+    int candidates = refine ? pool->match_count : pool->count;
+    uint64_t query_mask = char_class_mask(lowered, len);
+
+    int kept = 0, heap_size = 0;
+    for (int i = 0; i < candidates; i++) {
+        int index = refine ? pool->matches[i] : i;
+        // 이름에 없는 글자 종류가 검색어에 있으면 채점하지 않음
+        if (query_mask & ~pool->masks[index]) continue;
+
+        const char *name = pool->pool + pool->offsets[index];
+        size_t name_len = pool->offsets[index + 1] - pool->offsets[index] - 1;
+        int score = fuzzy_score(name, name_len, lowered, len, NULL);
+        if (score < 0) continue;
+
+        pool->matches[kept++] = index; // kept <= i 이므로 앞선 결과 위에 그대로 덮어씀
+        FuzzyMatch match = { index, score };
+        heap_push(results, &heap_size, max_results, match);
+    }
+    pool->match_count = kept;
+
+    // 힙에서 가장 나쁜 결과를 차례로 뒤로 보내면 좋은 순서로 정렬됨
+    for (int end = heap_size - 1; end > 0; end--) {
+        FuzzyMatch tmp = results[0];
+        results[0] = results[end];
+        results[end] = tmp;
+        heap_sift_down(results, end, 0);
+    }
+    *result_count = heap_size;
+
+    memcpy(pool->query, lowered, len + 1);
+    pool->query_len = len;
+    pool->fuzzy = true;
+    return kept;
+}
+
+int fuzzy_match_positions(const char *name, const char *query, int *positions, int max_positions) {
+    char lowered_name[MAX_NAME_LEN];
+    char lowered_query[FILTER_MAX_QUERY];
+    int matched[FILTER_MAX_QUERY];
+
+    size_t name_len = strlen(name);
+    if (name_len >= sizeof(lowered_name)) name_len = sizeof(lowered_name) - 1;
+    size_t query_len = strlen(query);
+    if (query_len >= sizeof(lowered_query)) query_len = sizeof(lowered_query) - 1;
+    if (query_len == 0) return 0;
+
+    lower_copy(lowered_name, name, name_len);
+    lower_copy(lowered_query, query, query_len);
+    if (fuzzy_score(lowered_name, name_len, lowered_query, query_len, matched) < 0) return 0;
+
+    int count = (int)query_len < max_positions ? (int)query_len : max_positions;
+    memcpy(positions, matched, sizeof(int) * count);
+    return count;
+}
+
+int name_pool_next_match(const NamePool *pool, int from, int direction) {
+    if (pool->match_count == 0) return -1;
+
+    // matches는 오름차순이므로 from 이상인 첫 위치를 이진 탐색
+    int low = 0, high = pool->match_count;
+    while (low < high) {
+        int mid = (low + high) / 2;
+        if (pool->matches[mid] < from) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+
+    if (direction >= 0) {
+        return pool->matches[low < pool->match_count ? low : 0];
+    }
+    // 위로: from 이하인 마지막 일치
+    if (low < pool->match_count && pool->matches[low] == from) {
+        return from;
+    }
+    return pool->matches[low > 0 ? low - 1 : pool->match_count - 1];
+}
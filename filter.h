@@ -0,0 +1,55 @@
+// filter.h
+#ifndef FILTER_H
+#define FILTER_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "fs.h"
+
+#define FILTER_MAX_QUERY 128 // 검색어 최대 길이 (바이트)
+#define FUZZY_MAX_RESULTS 64 // 퍼지 찾기에서 순위를 매겨 보여 주는 최대 결과 수
+
+// 목록 이름 색인 - 소문자로 바꾼 이름들을 '\0'으로 이어 붙인 하나의 버퍼
+// 전체 검색은 이 버퍼를 한 번에 훑고, 검색어를 늘린 경우에는 앞선 결과 안에서만 다시 확인
+typedef struct {
+    char *pool;            // 소문자 이름들 ("a\0bc\0...")
+    size_t pool_size;
+    int *offsets;          // 항목별 pool 시작 위치 (count + 1개, 마지막은 끝 위치)
+    int count;             // 항목 수
+    int *matches;          // 현재 검색어에 맞는 항목 인덱스 (오름차순)
+    int match_count;
+    uint64_t *masks;       // 항목별 이름에 들어 있는 글자 종류 (퍼지 찾기 사전 거르기)
+    char query[FILTER_MAX_QUERY]; // 현재 검색어 (소문자)
+    size_t query_len;
+    bool fuzzy;            // 현재 결과가 퍼지 찾기 결과인지 (종류가 같을 때만 앞선 결과를 좁혀 씀)
+} NamePool;
+
+// 퍼지 찾기 결과 하나
+typedef struct {
+    int index;             // 목록 인덱스
+    int score;             // 클수록 잘 맞음
+} FuzzyMatch;
+
+// 목록으로 색인 만들기 (이전 내용은 해제, 처음에는 모든 항목이 맞음)
+bool name_pool_build(NamePool *pool, const FileEntry *files, int count);
+
+// 색인 해제
+void name_pool_free(NamePool *pool);
+
+// 검색어 바꾸기 (대소문자 무시 부분 문자열), 맞는 항목 수 반환
+// 앞선 검색어 뒤에 글자를 붙인 경우에는 앞선 결과만 다시 확인
+int name_pool_search(NamePool *pool, const char *query);
+
+// 퍼지 찾기 - 검색어 글자가 순서대로 들어간 이름을 점수 순으로 최대 max_results개 (맞는 항목 수 반환)
+// 이름 시작/구분자 뒤, 연속된 글자에 가산점을 주고 사이에 낀 글자는 감점
+// 글자 종류 마스크로 먼저 거르고, 검색어를 늘린 경우에는 앞선 결과만 다시 채점
+int name_pool_fuzzy(NamePool *pool, const char *query, FuzzyMatch *results, int max_results, int *result_count);
+
+// 이름에서 퍼지 찾기로 맞은 바이트 위치 (강조 표시용), 위치 수 반환 (맞지 않으면 0)
+int fuzzy_match_positions(const char *name, const char *query, int *positions, int max_positions);
+
+// from부터 direction(1: 아래, -1: 위) 방향으로 처음 맞는 항목 (끝에서 반대편으로 넘어감, 없으면 -1)
+int name_pool_next_match(const NamePool *pool, int from, int direction);
+
+#endif
@@ -1,10 +1,17 @@
 // fs.c
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE // renameat2, RENAME_NOREPLACE
+#endif
 #include "fs.h"
+#include "walk.h"
+#include "event.h"
+#include "filetype.h"
 #include <stdio.h>
 #include <stdlib.h>
+#include <stdint.h>
 #include <string.h>
-#include <strings.h>
 #include <time.h>
+#include <wchar.h>
 #include <unistd.h>
 #include <dirent.h>
 #include <sys/stat.h>
@@ -14,82 +21,57 @@
 #include <libgen.h>
 #include <fcntl.h>
 #include <signal.h>
+#include <pwd.h>
+#include <grp.h>
 
 Clipboard g_clipboard = {0};
 CopyTask* g_copy_tasks = NULL;
 pthread_mutex_t g_clipboard_mutex = PTHREAD_MUTEX_INITIALIZER;
 pthread_mutex_t g_tasks_mutex = PTHREAD_MUTEX_INITIALIZER;
 
+// 작업 실행 대기열 (동시에 디스크를 쓰는 작업 수 제한)
+static pthread_mutex_t g_slot_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t g_slot_cond = PTHREAD_COND_INITIALIZER;
+static CopyTask *g_slot_queue = NULL; // 시작을 기다리는 작업 (도착 순)
+static int g_active_tasks = 0;
+static int g_max_active_tasks = TASK_DEFAULT_MAX_ACTIVE;
+
 // SIGINT 핸들러 (Ctrl+C 무시)
 void sigint_handler(int sig) {}
 
-// 파일 확장자를 기반으로 프로그래밍 언어 타입 반환
-static const char* get_programming_language(const char *filename) {
-    const char *ext = strrchr(filename, '.');
-    if (!ext) return NULL; // 확장자가 없는 경우
-
-    ext++; // '.' 다음 문자로 이동
-
-    if (strcasecmp(ext, "c") == 0) return "C source";
-    if (strcasecmp(ext, "h") == 0) return "C header";
-    if (strcasecmp(ext, "cpp") == 0 || strcasecmp(ext, "cc") == 0) return "C++ source";
-    if (strcasecmp(ext, "hpp") == 0) return "C++ header";
-    if (strcasecmp(ext, "py") == 0) return "Python source";
-    if (strcasecmp(ext, "java") == 0) return "Java source";
-    if (strcasecmp(ext, "js") == 0) return "JS source";
-    if (strcasecmp(ext, "html") == 0) return "HTML file";
-    if (strcasecmp(ext, "css") == 0) return "CSS file";
-    if (strcasecmp(ext, "php") == 0) return "PHP source";
-    if (strcasecmp(ext, "rb") == 0) return "Ruby source";
-    if (strcasecmp(ext, "go") == 0) return "Go source";
-    if (strcasecmp(ext, "rs") == 0) return "Rust source";
-    if (strcasecmp(ext, "sh") == 0) return "Shell script";
-    if (strcasecmp(ext, "asm") == 0 || strcasecmp(ext, "s") == 0) return "Assembly source";
-    if (strcasecmp(ext, "swift") == 0) return "Swift source";
-    if (strcasecmp(ext, "kt") == 0) return "Kotlin source";
-
-    return NULL; // 알려진 프로그래밍 언어가 아닌 경우
-}
-
-// 파일 유형을 문자열로 반환
-static void get_file_type(mode_t mode, char *type, size_t size, const char *filename) {
-    // 버퍼 크기 확인
-    if (size < 16) {
-        strncpy(type, "?", size);
-        type[size - 1] = '\0';
-        return;
-    }
-    
-	if (S_ISREG(mode)) {
-        const char *prog_lang = get_programming_language(filename);
-        if (prog_lang) {
-            strncpy(type, prog_lang, size - 1);
-            type[size - 1] = '\0';
-            return;
-        }
-        strcpy(type, "일반 파일");
-    } else if (S_ISDIR(mode)) {
-        strcpy(type, "디렉토리");
-    } else if (S_ISLNK(mode)) {
-        strcpy(type, "심볼릭 링크");
-    } else if (S_ISFIFO(mode)) {
-        strcpy(type, "FIFO");
-    } else if (S_ISSOCK(mode)) {
-        strcpy(type, "소켓");
-    } else if (S_ISBLK(mode)) {
-        strcpy(type, "블록 장치");
-    } else if (S_ISCHR(mode)) {
-        strcpy(type, "문자 장치");
+// 파일 종류 저장 - 일반 파일은 확장자 표로 찾고, 모르면 화면에 보일 때 내용으로 판별하도록 표시
+static void get_file_type(const struct stat *st, FileEntry *file) {
+    file->file_type = FILETYPE_NONE;
+    file->type_pending = false;
+    file->dev = st->st_dev;
+    file->ino = st->st_ino;
+    file->modified = st->st_mtime;
+
+    const char *type;
+    if (S_ISREG(st->st_mode)) {
+        file->file_type = (unsigned short)file_type_from_name(file->name);
+        file->type_pending = file->file_type == FILETYPE_NONE && st->st_size > 0;
+        type = file_type_label(file->file_type);
+    } else if (S_ISDIR(st->st_mode)) {
+        type = "디렉토리";
+    } else if (S_ISLNK(st->st_mode)) {
+        type = "심볼릭 링크";
+    } else if (S_ISFIFO(st->st_mode)) {
+        type = "FIFO";
+    } else if (S_ISSOCK(st->st_mode)) {
+        type = "소켓";
+    } else if (S_ISBLK(st->st_mode)) {
+        type = "블록 장치";
+    } else if (S_ISCHR(st->st_mode)) {
+        type = "문자 장치";
     } else {
-        strcpy(type, "알 수 없음");
+        type = "알 수 없음";
     }
-    
-    // null 종료 문자 보장
-    type[size - 1] = '\0';
+    snprintf(file->type, sizeof(file->type), "%s", type);
 }
 
 // 파일 크기를 읽기 쉬운 형태로 변환 (KB, MB, GB 등)
-static void format_size(off_t size, char *buf, size_t buf_size) {
+void format_size(off_t size, char *buf, size_t buf_size) {
     const char *units[] = {"B", "KB", "MB", "GB", "TB"};
     int i = 0;
     double size_d = size;
@@ -106,44 +88,303 @@ static void format_size(off_t size, char *buf, size_t buf_size) {
     }
 }
 
+// 문자열의 터미널 표시 폭 (한글/CJK는 두 칸)
+// fit_bytes가 있으면 max_cols 칸 안에 들어가는 앞부분의 바이트 수도 계산
+int display_width(const char *s, int max_cols, int *fit_bytes) {
+    mbstate_t state;
+    memset(&state, 0, sizeof(state));
+    size_t len = strlen(s);
+    size_t pos = 0;
+    int width = 0;
+    int fit = -1;
+
+    while (pos < len) {
+        wchar_t wc;
+        size_t n = mbrtowc(&wc, s + pos, len - pos, &state);
+        int w;
+        if (n == (size_t)-1 || n == (size_t)-2) {
+            // 잘못된 바이트는 한 칸으로 보고 다음 바이트부터 다시
+            memset(&state, 0, sizeof(state));
+            n = 1;
+            w = 1;
+        } else {
+            if (n == 0) break;
+            w = wcwidth(wc);
+            if (w < 0) w = (wc < 0x20 || wc == 0x7f) ? 2 : 1; // 제어 문자는 ^X로 표시됨
+        }
+        if (fit < 0 && width + w > max_cols) fit = (int)pos;
+        width += w;
+        pos += n;
+    }
+    if (fit_bytes) *fit_bytes = (fit < 0) ? (int)pos : fit;
+    return width;
+}
+
+// 목록을 읽을 때 표시 폭을 미리 계산 (자르기 위치는 화면에 그릴 때 칸 너비별로 한 번만)
+void set_display_widths(FileEntry *file) {
+    file->name_width = display_width(file->name, 0, NULL);
+    file->type_width = display_width(file->type, 0, NULL);
+    file->name_fit_cols = -1;
+}
+
 // 파일 날짜를 형식화
-static void format_time(time_t mtime, char *buf, size_t buf_size) {
+void format_time(time_t mtime, char *buf, size_t buf_size) {
     struct tm *tm_info = localtime(&mtime);
     strftime(buf, buf_size, "%Y-%m-%d %H:%M", tm_info);
 }
 
-// 디렉토리 크기 계산 함수
-off_t get_directory_size(const char *path) {
-    DIR *dir;
-    struct dirent *entry;
-    struct stat file_stat;
-    char full_path[MAX_PATH_LEN];
-    off_t total_size = 0;
-    
-    if ((dir = opendir(path)) == NULL) {
-        return 0;
+// ================ 디렉토리 크기 계산 및 캐시 ================
+
+#define SIZE_CACHE_BUCKETS 4096
+#define SIZE_CACHE_MAX_ENTRIES (1 << 20)
+
+// (dev, ino, mtime) 기준 디렉토리 크기 캐시 항목
+// 하위 디렉토리가 바뀌어도 위 디렉토리의 mtime은 그대로이므로 전체 합계(size, entries)는
+// 마지막으로 계산한 값일 뿐이고, 크기 계산은 매번 모든 디렉토리의 mtime을 다시 확인하면서
+// 바뀌지 않은 디렉토리의 바로 아래 파일 합계(own_*)만 재사용
+typedef struct SizeCacheEntry {
+    dev_t dev;
+    ino_t ino;
+    struct timespec mtime;
+    off_t size;
+    long entries;        // 하위 항목 수 (디렉토리 포함)
+    off_t own_size;      // 바로 아래 파일들의 바이트 (하위 디렉토리 제외)
+    long own_entries;    // 바로 아래 항목 수
+    struct SizeCacheEntry *next;
+} SizeCacheEntry;
+
+static SizeCacheEntry *g_size_cache[SIZE_CACHE_BUCKETS];
+static int g_size_cache_count = 0;
+static pthread_mutex_t g_size_cache_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+// 백그라운드 크기 계산 작업 (여러 시작 디렉토리의 합계)
+typedef struct {
+    Walker walker;
+    volatile bool *abort;  // 외부에서 중단을 요청하는 플래그 (NULL 가능)
+    pthread_mutex_t lock;  // 시작 디렉토리별 결과 합산 보호
+    off_t result;          // 전체 바이트
+    long entries;          // 전체 하위 항목 수
+    bool has_result;
+    bool started;
+} DirSizeJob;
+
+static unsigned int size_cache_bucket(dev_t dev, ino_t ino) {
+    unsigned long long h = ((unsigned long long)ino * 0x9E3779B97F4A7C15ULL) ^ (unsigned long long)dev;
+    return (unsigned int)((h >> 32) % SIZE_CACHE_BUCKETS);
+}
+
+// 캐시 항목 찾기 (mtime이 바뀌었으면 NULL, g_size_cache_mutex 잡은 상태)
+static SizeCacheEntry* find_size_cache_entry(const struct stat *st) {
+    unsigned int bucket = size_cache_bucket(st->st_dev, st->st_ino);
+    for (SizeCacheEntry *e = g_size_cache[bucket]; e; e = e->next) {
+        if (e->dev == st->st_dev && e->ino == st->st_ino) {
+            if (e->mtime.tv_sec == st->st_mtim.tv_sec && e->mtime.tv_nsec == st->st_mtim.tv_nsec) {
+                return e;
+            }
+            return NULL;
+        }
     }
-    
-    while ((entry = readdir(dir)) != NULL) {
-        if (strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0) {
-            continue;
+    return NULL;
+}
+
+// 마지막으로 계산한 디렉토리 크기 조회 (mtime이 바뀌었으면 실패, entries는 NULL 가능)
+// 더 깊은 곳의 변화는 반영되지 않으므로 목록 표시나 진행률 추정에만 사용
+bool lookup_cached_directory_size(const struct stat *st, off_t *size, long *entries) {
+    pthread_mutex_lock(&g_size_cache_mutex);
+    SizeCacheEntry *e = find_size_cache_entry(st);
+    if (e) {
+        *size = e->size;
+        if (entries) *entries = e->entries;
+    }
+    pthread_mutex_unlock(&g_size_cache_mutex);
+
+    return e != NULL;
+}
+
+// 디렉토리 바로 아래 파일 합계 조회 (크기 계산 탐색 중 사용)
+static bool lookup_cached_own_size(const struct stat *st, off_t *size, long *entries) {
+    pthread_mutex_lock(&g_size_cache_mutex);
+    SizeCacheEntry *e = find_size_cache_entry(st);
+    if (e) {
+        *size = e->own_size;
+        *entries = e->own_entries;
+    }
+    pthread_mutex_unlock(&g_size_cache_mutex);
+
+    return e != NULL;
+}
+
+// 디렉토리 크기를 캐시에 저장 (같은 inode 항목은 갱신)
+static void store_directory_sizes(const struct stat *st, off_t size, long entries,
+                                  off_t own_size, long own_entries) {
+    unsigned int bucket = size_cache_bucket(st->st_dev, st->st_ino);
+
+    pthread_mutex_lock(&g_size_cache_mutex);
+    for (SizeCacheEntry *e = g_size_cache[bucket]; e; e = e->next) {
+        if (e->dev == st->st_dev && e->ino == st->st_ino) {
+            e->mtime = st->st_mtim;
+            e->size = size;
+            e->entries = entries;
+            e->own_size = own_size;
+            e->own_entries = own_entries;
+            pthread_mutex_unlock(&g_size_cache_mutex);
+            return;
         }
-        
-        snprintf(full_path, sizeof(full_path), "%s/%s", path, entry->d_name);
-        
-        if (lstat(full_path, &file_stat) == -1) {
-            continue;
+    }
+
+    // 너무 커지면 전부 비우고 다시 채움
+    if (g_size_cache_count >= SIZE_CACHE_MAX_ENTRIES) {
+        for (int i = 0; i < SIZE_CACHE_BUCKETS; i++) {
+            SizeCacheEntry *e = g_size_cache[i];
+            while (e) {
+                SizeCacheEntry *next = e->next;
+                free(e);
+                e = next;
+            }
+            g_size_cache[i] = NULL;
         }
-        
-        if (S_ISDIR(file_stat.st_mode)) {
-            total_size += get_directory_size(full_path);
+        g_size_cache_count = 0;
+    }
+
+    SizeCacheEntry *entry = malloc(sizeof(SizeCacheEntry));
+    if (entry) {
+        entry->dev = st->st_dev;
+        entry->ino = st->st_ino;
+        entry->mtime = st->st_mtim;
+        entry->size = size;
+        entry->entries = entries;
+        entry->own_size = own_size;
+        entry->own_entries = own_entries;
+        entry->next = g_size_cache[bucket];
+        g_size_cache[bucket] = entry;
+        g_size_cache_count++;
+    }
+    pthread_mutex_unlock(&g_size_cache_mutex);
+}
+
+// 크기 계산용 디렉토리 진입 - mtime이 그대로면 바로 아래 파일은 캐시 값을 쓰고 하위 디렉토리만 찾음
+static bool dir_size_enter(Walker *w, WalkDir *dir, int dirfd) {
+    (void)dirfd;
+
+    DirSizeJob *job = (DirSizeJob*)w->user;
+    if (job->abort && *job->abort) {
+        walker_cancel(w);
+        return false;
+    }
+
+    off_t own_size;
+    long own_entries;
+    if (lookup_cached_own_size(&dir->st, &own_size, &own_entries)) {
+        dir->sum_self[0] = own_size;
+        dir->sum_self[1] = own_entries;
+        dir->data = dir; // 바로 아래 파일은 이미 합산됨
+    }
+    return true;
+}
+
+// 크기 계산용 엔트리 콜백 - 하위 디렉토리는 mtime 확인을 위해 항상 내려감
+static bool dir_size_visit(Walker *w, WalkDir *dir, int dirfd, const char *name,
+                           unsigned char d_type, const struct stat *st) {
+    DirSizeJob *job = (DirSizeJob*)w->user;
+    if (job->abort && *job->abort) {
+        walker_cancel(w);
+        return false;
+    }
+    if (d_type == DT_DIR) {
+        if (!dir->data) dir->sum_self[1]++;
+        return true;
+    }
+    if (dir->data) return false;
+
+    // sum[0] = 바이트, sum[1] = 항목 수 (파일 stat은 바뀐 디렉토리에서만)
+    struct stat file_st;
+    if (!st) {
+        if (fstatat(dirfd, name, &file_st, AT_SYMLINK_NOFOLLOW) == -1) return false;
+        st = &file_st;
+    }
+    dir->sum_self[0] += st->st_size;
+    dir->sum_self[1]++;
+    return false;
+}
+
+// 하위 디렉토리까지 끝나면 결과를 캐시에 저장
+static void dir_size_leave(Walker *w, WalkDir *dir) {
+    if (w->cancel) return; // 중간에 취소된 값은 저장하지 않음
+
+    off_t total = dir->sum_self[0] + dir->sum_children[0];
+    long entries = (long)(dir->sum_self[1] + dir->sum_children[1]);
+    store_directory_sizes(&dir->st, total, entries, dir->sum_self[0], (long)dir->sum_self[1]);
+
+    if (!dir->parent) {
+        DirSizeJob *job = (DirSizeJob*)w->user;
+        pthread_mutex_lock(&job->lock);
+        job->result += total;
+        job->entries += entries;
+        pthread_mutex_unlock(&job->lock);
+    }
+}
+
+// 크기 계산 시작 (모든 디렉토리를 다시 확인하되 바뀌지 않은 디렉토리의 파일은 stat하지 않음)
+static bool dir_size_job_start(DirSizeJob *job, const char *const *paths, int count, volatile bool *abort) {
+    static const WalkOps ops = { dir_size_enter, dir_size_visit, dir_size_leave };
+
+    memset(job, 0, sizeof(DirSizeJob));
+    job->abort = abort;
+    pthread_mutex_init(&job->lock, NULL);
+
+    const char **dirs = malloc(sizeof(char*) * (count > 0 ? count : 1));
+    if (!dirs) {
+        pthread_mutex_destroy(&job->lock);
+        return false;
+    }
+
+    int dir_count = 0;
+    for (int i = 0; i < count; i++) {
+        struct stat st;
+        if (stat(paths[i], &st) == 0 && S_ISDIR(st.st_mode)) {
+            dirs[dir_count++] = paths[i];
+        }
+    }
+
+    if (dir_count > 0) {
+        walker_init(&job->walker, &ops, job);
+        job->walker.need_stat = false; // 파일 크기는 바뀐 디렉토리에서만 visit이 직접 stat
+        if (walker_start_multi(&job->walker, dirs, dir_count)) {
+            job->started = true;
         } else {
-            total_size += file_stat.st_size;
+            walker_destroy(&job->walker);
         }
     }
-    
-    closedir(dir);
-    return total_size;
+    free(dirs);
+
+    if (!job->started) {
+        job->has_result = true;
+    }
+    return true;
+}
+
+// 크기 계산 종료 대기 (cancel이면 중단 요청 후 대기)
+static void dir_size_job_finish(DirSizeJob *job, bool cancel) {
+    if (job->started) {
+        if (cancel) {
+            walker_cancel(&job->walker);
+        }
+        walker_wait(&job->walker);
+        job->has_result = !job->walker.cancel;
+        walker_destroy(&job->walker);
+        job->started = false;
+    }
+    pthread_mutex_destroy(&job->lock);
+}
+
+// 디렉토리 크기 계산 함수 (병렬 탐색 + 캐시)
+off_t get_directory_size(const char *path) {
+    DirSizeJob job;
+    if (!dir_size_job_start(&job, &path, 1, NULL)) {
+        return 0;
+    }
+    dir_size_job_finish(&job, false);
+    return job.has_result ? job.result : 0;
 }
 
 // 복사 작업 찾기 함수
@@ -163,6 +404,81 @@ CopyTask* find_copy_task_by_dest(const char *dest_path) {
     return NULL;
 }
 
+// 목록 캐시 - 분할 화면의 두 목록이 같은 디렉토리를 보거나 방금 본 디렉토리로 돌아가면
+// 항목마다 lstat하지 않고 마지막으로 읽은 목록을 복사 (UI 스레드에서만 사용)
+// 디렉토리 (장치, inode, 수정시각)이 같고 LISTING_CACHE_MAX_AGE_MS 안에 읽은 것만 사용하며,
+// 파일 내용만 바뀐 경우(수정시각 변화 없음)는 inotify나 작업 완료 시 invalidate_file_list로 버림
+typedef struct {
+    char path[MAX_PATH_LEN];
+    dev_t dev;
+    ino_t ino;
+    struct timespec mtime;
+    long loaded_ms;          // 0이면 빈 칸
+    FileEntry *entries;
+    int count;
+} ListingCacheSlot;
+
+static ListingCacheSlot g_listing_cache[LISTING_CACHE_SLOTS];
+
+static bool listing_cache_lookup(const char *path, const struct stat *dir_stat, FileEntry *files, int max_files,
+                                 int *count) {
+    long now_ms = event_now_ms();
+    for (int i = 0; i < LISTING_CACHE_SLOTS; i++) {
+        ListingCacheSlot *slot = &g_listing_cache[i];
+        if (slot->loaded_ms == 0 || strcmp(slot->path, path) != 0) continue;
+        if (slot->dev != dir_stat->st_dev || slot->ino != dir_stat->st_ino ||
+            slot->mtime.tv_sec != dir_stat->st_mtim.tv_sec || slot->mtime.tv_nsec != dir_stat->st_mtim.tv_nsec ||
+            now_ms - slot->loaded_ms > LISTING_CACHE_MAX_AGE_MS || slot->count > max_files) {
+            return false;
+        }
+        memcpy(files, slot->entries, sizeof(FileEntry) * slot->count);
+        *count = slot->count;
+        return true;
+    }
+    return false;
+}
+
+// 같은 경로 칸이 있으면 덮어쓰고, 없으면 가장 오래된 칸을 씀
+static void listing_cache_store(const char *path, const struct stat *dir_stat, const FileEntry *files, int count) {
+    ListingCacheSlot *target = NULL;
+    for (int i = 0; i < LISTING_CACHE_SLOTS && !target; i++) {
+        if (g_listing_cache[i].loaded_ms != 0 && strcmp(g_listing_cache[i].path, path) == 0) {
+            target = &g_listing_cache[i];
+        }
+    }
+    for (int i = 0; i < LISTING_CACHE_SLOTS && !target; i++) {
+        if (g_listing_cache[i].loaded_ms == 0) target = &g_listing_cache[i];
+    }
+    if (!target) {
+        target = &g_listing_cache[0];
+        for (int i = 1; i < LISTING_CACHE_SLOTS; i++) {
+            if (g_listing_cache[i].loaded_ms < target->loaded_ms) target = &g_listing_cache[i];
+        }
+    }
+
+    FileEntry *entries = realloc(target->entries, sizeof(FileEntry) * (count > 0 ? count : 1));
+    if (!entries) {
+        target->loaded_ms = 0;
+        return;
+    }
+    memcpy(entries, files, sizeof(FileEntry) * count);
+    target->entries = entries;
+    target->count = count;
+    snprintf(target->path, sizeof(target->path), "%s", path);
+    target->dev = dir_stat->st_dev;
+    target->ino = dir_stat->st_ino;
+    target->mtime = dir_stat->st_mtim;
+    target->loaded_ms = event_now_ms();
+}
+
+void invalidate_file_list(const char *path) {
+    for (int i = 0; i < LISTING_CACHE_SLOTS; i++) {
+        if (!path || strcmp(g_listing_cache[i].path, path) == 0) {
+            g_listing_cache[i].loaded_ms = 0;
+        }
+    }
+}
+
 // file list 불러오기 
 int get_file_list(const char *path, FileEntry *files, int max_files) {
     DIR *dir;
@@ -170,6 +486,13 @@ int get_file_list(const char *path, FileEntry *files, int max_files) {
     struct stat file_stat;
     char full_path[MAX_PATH_LEN];
     int count = 0;
+
+    // 디렉토리가 그대로면 캐시된 목록 사용 (읽기 전에 확인해, 읽는 도중 바뀌면 다음에 다시 읽음)
+    struct stat dir_stat;
+    bool have_dir_stat = (stat(path, &dir_stat) == 0);
+    if (have_dir_stat && listing_cache_lookup(path, &dir_stat, files, max_files, &count)) {
+        return count;
+    }
     
     if ((dir = opendir(path)) == NULL) {
         perror("opendir 실패");
@@ -197,11 +520,16 @@ int get_file_list(const char *path, FileEntry *files, int max_files) {
         files[count].name[MAX_NAME_LEN - 1] = '\0';
         
         // 파일 종류 저장
-		get_file_type(file_stat.st_mode, files[count].type, sizeof(files[count].type), entry->d_name);
+		get_file_type(&file_stat, &files[count]);
                 
-        // 파일 크기 저장 (디렉토리는 "-"로 표시)
+        // 파일 크기 저장 (디렉토리는 마지막으로 계산한 값, 아니면 "-" - 더 깊은 곳이 바뀌었으면 다음 계산 때 갱신)
+        off_t dir_size;
         if (S_ISDIR(file_stat.st_mode)) {
-            strncpy(files[count].size, "-", sizeof(files[count].size));
+            if (strcmp(entry->d_name, "..") != 0 && lookup_cached_directory_size(&file_stat, &dir_size, NULL)) {
+                format_size(dir_size, files[count].size, sizeof(files[count].size));
+            } else {
+                strncpy(files[count].size, "-", sizeof(files[count].size));
+            }
         } else {
             format_size(file_stat.st_size, files[count].size, sizeof(files[count].size));
         }
@@ -215,6 +543,8 @@ int get_file_list(const char *path, FileEntry *files, int max_files) {
         // 복사 상태 초기화
         files[count].copy_status = COPY_STATUS_NONE;
         files[count].original_size = 0;
+        files[count].is_marked = false;
+        set_display_widths(&files[count]);
         
         count++;
     }
@@ -232,7 +562,10 @@ int get_file_list(const char *path, FileEntry *files, int max_files) {
             break; // ".."은 하나만 있으므로 찾으면 바로 종료
         }
     }
-    
+
+    if (have_dir_stat) {
+        listing_cache_store(path, &dir_stat, files, count);
+    }
     return count;
 }
 
@@ -307,11 +640,16 @@ bool get_file_info(const char *path, FileEntry *file) {
     file->name[MAX_NAME_LEN - 1] = '\0';
     
     // 파일 종류 저장
-	get_file_type(file_stat.st_mode, file->type, sizeof(file->type), file->name);
+	get_file_type(&file_stat, file);
     
     // 파일 크기 저장
+    off_t dir_size;
     if (S_ISDIR(file_stat.st_mode)) {
-        strncpy(file->size, "-", sizeof(file->size));
+        if (lookup_cached_directory_size(&file_stat, &dir_size, NULL)) {
+            format_size(dir_size, file->size, sizeof(file->size));
+        } else {
+            strncpy(file->size, "-", sizeof(file->size));
+        }
     } else {
         format_size(file_stat.st_size, file->size, sizeof(file->size));
     }
@@ -321,6 +659,7 @@ bool get_file_info(const char *path, FileEntry *file) {
     
     // 파일 모드 저장
     file->mode = file_stat.st_mode;
+    set_display_widths(file);
     
     return true;
 }
@@ -337,6 +676,14 @@ bool is_directory(const FileEntry *file) {
 
 // 파일을 편집기로 열기
 bool edit_file(const char *path) {
+    return edit_file_at(path, 0);
+}
+
+// 파일을 편집기로 열고 line번째 줄로 이동 (vim/vi의 +줄 인자)
+bool edit_file_at(const char *path, long line) {
+    char jump[32] = "+";
+    if (line > 0) snprintf(jump, sizeof(jump), "+%ld", line);
+
     pid_t pid = fork();
 
     if (pid == -1) {
@@ -344,6 +691,10 @@ bool edit_file(const char *path) {
         return false;
     } else if (pid == 0) {
         // 자식 프로세스: 먼저 vim을 시도하고, 실패하면 vi 시도
+        if (line > 0) {
+            execlp("vim", "vim", jump, path, NULL);
+            execlp("vi", "vi", jump, path, NULL);
+        }
         execlp("vim", "vim", path, NULL);
         // vim이 실패하면 vi 시도
         execlp("vi", "vi", path, NULL);
@@ -360,6 +711,57 @@ bool edit_file(const char *path) {
 
 // ================ 복사-붙여넣기 관련 함수들 ================
 
+#define COPY_QUEUE_LIMIT 4096  // 복사 대기열 최대 길이 (탐색이 너무 앞서가지 않도록)
+#define COPY_MAX_WORKERS 8
+
+// 디렉토리와 이름을 이어 경로 생성 ("/"로 끝나는 디렉토리 처리)
+static void join_path(char *buf, size_t size, const char *dir, const char *name) {
+    size_t len = strlen(dir);
+    if (len > 0 && dir[len - 1] == '/') {
+        snprintf(buf, size, "%s%s", dir, name);
+    } else {
+        snprintf(buf, size, "%s/%s", dir, name);
+    }
+}
+
+// join_path의 동적 할당 버전 (탐색 중 경로 길이 제한을 받지 않도록)
+static char* join_path_alloc(const char *dir, const char *name) {
+    size_t dir_len = strlen(dir);
+    size_t name_len = strlen(name);
+    char *path = malloc(dir_len + name_len + 2);
+    if (!path) return NULL;
+
+    memcpy(path, dir, dir_len);
+    size_t pos = dir_len;
+    if (pos == 0 || path[pos - 1] != '/') {
+        path[pos++] = '/';
+    }
+    memcpy(path + pos, name, name_len + 1);
+    return path;
+}
+
+// 작업 메모리 해제
+static void free_task(CopyTask *task) {
+    if (!task) return;
+    for (int i = 0; i < task->item_count; i++) {
+        free(task->items[i].name);
+    }
+    free(task->items);
+    pthread_mutex_destroy(&task->progress_mutex);
+    free(task);
+}
+
+// 클립보드 항목 목록 해제 (g_clipboard_mutex 안에서 호출)
+static void clear_clipboard_items() {
+    for (int i = 0; i < g_clipboard.count; i++) {
+        free(g_clipboard.names[i]);
+    }
+    free(g_clipboard.names);
+    g_clipboard.names = NULL;
+    g_clipboard.count = 0;
+    g_clipboard.is_valid = false;
+}
+
 // 클립보드 시스템 초기화
 bool init_clipboard_system() {
     // SIGINT 핸들러 등록하여 Ctrl+C 무시
@@ -367,6 +769,16 @@ bool init_clipboard_system() {
 
     memset(&g_clipboard, 0, sizeof(Clipboard));
     g_copy_tasks = NULL;
+
+    // 동시에 실행할 작업 수 (0이면 제한 없음)
+    const char *max_tasks = getenv("FINDER_MAX_TASKS");
+    if (max_tasks && max_tasks[0] != '\0') {
+        char *end;
+        long value = strtol(max_tasks, &end, 10);
+        if (*end == '\0' && value >= 0 && value <= 1024) {
+            g_max_active_tasks = (int)value;
+        }
+    }
     return true;
 }
 
@@ -374,28 +786,35 @@ bool init_clipboard_system() {
 void cleanup_clipboard_system() {
     pthread_mutex_lock(&g_tasks_mutex);
 
-    // 모든 실행 중인 작업 정리
-    CopyTask* current = g_copy_tasks;
-    while (current) {
+    // 실행 중인 작업에 모두 취소를 요청한 뒤 (각자 정리하고 끝나도록) 기다림
+    for (CopyTask* current = g_copy_tasks; current; current = current->next) {
         if (current->is_running) {
-            pthread_cancel(current->thread_id);
-            pthread_join(current->thread_id, NULL);
+            request_task_cancel(current);
         }
-        pthread_mutex_destroy(&current->progress_mutex);
+    }
+
+    CopyTask* current = g_copy_tasks;
+    while (current) {
+        pthread_join(current->thread_id, NULL);
         CopyTask* next = current->next;
-        free(current);
+        free_task(current);
         current = next;
     }
     g_copy_tasks = NULL;
 
     pthread_mutex_unlock(&g_tasks_mutex);
 
+    pthread_mutex_lock(&g_clipboard_mutex);
+    clear_clipboard_items();
+    pthread_mutex_unlock(&g_clipboard_mutex);
+
     // SIGINT 핸들러 복원
     signal(SIGINT, SIG_DFL);
 }
 
-// 완료된 작업들 정리
-void cleanup_finished_tasks() {
+// 완료된 작업들 정리 (정리한 작업 수 반환)
+int cleanup_finished_tasks() {
+    int finished = 0;
     pthread_mutex_lock(&g_tasks_mutex);
 
     CopyTask** current = &g_copy_tasks;
@@ -404,14 +823,134 @@ void cleanup_finished_tasks() {
             CopyTask* to_remove = *current;
             *current = (*current)->next;
             pthread_join(to_remove->thread_id, NULL);
-            pthread_mutex_destroy(&to_remove->progress_mutex);
-            free(to_remove);
+            free_task(to_remove);
+            finished++;
         } else {
             current = &((*current)->next);
         }
     }
 
     pthread_mutex_unlock(&g_tasks_mutex);
+    return finished;
+}
+
+// 실행 중인 작업이 있는지 확인
+bool has_running_tasks() {
+    pthread_mutex_lock(&g_tasks_mutex);
+    bool running = false;
+    for (CopyTask* current = g_copy_tasks; current && !running; current = current->next) {
+        running = current->is_running;
+    }
+    pthread_mutex_unlock(&g_tasks_mutex);
+    return running;
+}
+
+// 작업 취소 요청
+void request_task_cancel(CopyTask *task) {
+    if (task) {
+        task->cancel_requested = true;
+
+        // 대기열에서 차례를 기다리던 작업도 바로 깨어나 정리하도록
+        pthread_mutex_lock(&g_slot_mutex);
+        pthread_cond_broadcast(&g_slot_cond);
+        pthread_mutex_unlock(&g_slot_mutex);
+    }
+}
+
+// 처리 속도 계산 - 표본은 TASK_RATE_INTERVAL_MS 간격으로만 추가되므로 매 프레임 불러도 됨
+void sample_task_rates(CopyTask *task, long now_ms, TaskRates *rates) {
+    pthread_mutex_lock(&task->progress_mutex);
+    TaskPhase phase = task->phase;
+    bool queued = task->is_queued;
+    bool in_items = (phase == TASK_PHASE_DELETE);
+    off_t done = in_items ? task->files_done : task->copied_size;
+    off_t total = in_items ? task->files_total : task->total_size;
+    pthread_mutex_unlock(&task->progress_mutex);
+
+    // 단계가 바뀌면 단위가 달라지므로 처음부터 다시
+    if (task->rate_count > 0 && task->rate_phase != phase) {
+        task->rate_count = 0;
+        task->rate_next = 0;
+    }
+
+    if (!queued) {
+        int last = (task->rate_next + TASK_RATE_SAMPLES - 1) % TASK_RATE_SAMPLES;
+        if (task->rate_count == 0) {
+            task->rate_phase = phase;
+            task->rate_base_ms = now_ms;
+            task->rate_base_units = done;
+        }
+        if (task->rate_count == 0 || now_ms - task->rate_ms[last] >= TASK_RATE_INTERVAL_MS) {
+            task->rate_ms[task->rate_next] = now_ms;
+            task->rate_units[task->rate_next] = done;
+            task->rate_next = (task->rate_next + 1) % TASK_RATE_SAMPLES;
+            if (task->rate_count < TASK_RATE_SAMPLES) task->rate_count++;
+        }
+    }
+
+    if (!rates) return;
+    rates->in_items = in_items;
+    rates->done = done;
+    rates->total = total;
+    rates->current = 0.0;
+    rates->average = 0.0;
+    rates->eta_sec = -1;
+    if (task->rate_count < 2) return;
+
+    // 가장 오래된 표본과 가장 최근 표본 사이 (최대 표본 수 × 간격)
+    int newest = (task->rate_next + TASK_RATE_SAMPLES - 1) % TASK_RATE_SAMPLES;
+    int oldest = (task->rate_count < TASK_RATE_SAMPLES) ? 0 : task->rate_next;
+    long span_ms = task->rate_ms[newest] - task->rate_ms[oldest];
+    if (span_ms > 0) {
+        rates->current = (double)(task->rate_units[newest] - task->rate_units[oldest]) * 1000.0 / span_ms;
+    }
+    long elapsed_ms = task->rate_ms[newest] - task->rate_base_ms;
+    if (elapsed_ms > 0) {
+        rates->average = (double)(task->rate_units[newest] - task->rate_base_units) * 1000.0 / elapsed_ms;
+    }
+
+    // 남은 시간은 최근 속도 기준 (최근에 진행이 없으면 평균 속도)
+    double rate = rates->current > 0.0 ? rates->current : rates->average;
+    if (total >= 0 && rate > 0.0) {
+        off_t remaining = total - done;
+        rates->eta_sec = remaining > 0 ? (long)(remaining / rate + 0.5) : 0;
+    }
+}
+
+// 작업 스레드 시작 시 실행 차례를 기다림 (먼저 추가된 작업부터)
+// 대기 중 취소되면 차례를 받지 않고 false 반환 - 호출 측은 그대로 정리 단계만 진행
+static bool acquire_task_slot(CopyTask *task) {
+    pthread_mutex_lock(&g_slot_mutex);
+    while (!task->cancel_requested &&
+           (g_slot_queue != task || (g_max_active_tasks > 0 && g_active_tasks >= g_max_active_tasks))) {
+        pthread_cond_wait(&g_slot_cond, &g_slot_mutex);
+    }
+
+    // 대기열에서 빼고 다음 작업이 차례를 확인하도록 깨움
+    for (CopyTask **link = &g_slot_queue; *link; link = &(*link)->queue_next) {
+        if (*link == task) {
+            *link = task->queue_next;
+            break;
+        }
+    }
+    task->queue_next = NULL;
+    bool granted = !task->cancel_requested;
+    if (granted) g_active_tasks++;
+    pthread_cond_broadcast(&g_slot_cond);
+    pthread_mutex_unlock(&g_slot_mutex);
+
+    pthread_mutex_lock(&task->progress_mutex);
+    task->is_queued = false;
+    pthread_mutex_unlock(&task->progress_mutex);
+    notify_ui();
+    return granted;
+}
+
+static void release_task_slot() {
+    pthread_mutex_lock(&g_slot_mutex);
+    g_active_tasks--;
+    pthread_cond_broadcast(&g_slot_cond);
+    pthread_mutex_unlock(&g_slot_mutex);
 }
 
 // 파일 크기 가져오기
@@ -434,54 +973,38 @@ bool should_use_background_copy(const char *path) {
     return S_ISDIR(st.st_mode) || st.st_size > LARGE_FILE_SIZE;
 }
 
-// 고유한 파일명 생성
-char* generate_unique_name(const char *dest_dir, const char *base_name) {
-    static char unique_name[MAX_PATH_LEN];
+// 고유한 파일명 생성 (결과를 out에 저장 - 작업 스레드에서도 사용 가능)
+void generate_unique_name_r(const char *dest_dir, const char *base_name, char *out, size_t out_size) {
     char test_path[MAX_PATH_LEN];
-    
-    // 원본 이름 먼저 복사
-    strcpy(unique_name, base_name);
-    
+
     // 원본 이름 시도
-    snprintf(test_path, sizeof(test_path), "%s/%s", dest_dir, unique_name);
+    snprintf(out, out_size, "%s", base_name);
+    join_path(test_path, sizeof(test_path), dest_dir, out);
     if (access(test_path, F_OK) != 0) {
-        return unique_name;
+        return;
     }
-    
-    // (1), (2), ... 형태로 시도 - 더 안전한 방식
+
+    // (1), (2), ... 형태로 시도 - 확장자가 있으면 파일명(숫자).확장자
+    const char *ext = strrchr(base_name, '.');
+    int stem_len = (ext && ext != base_name) ? (int)(ext - base_name) : (int)strlen(base_name);
+    if (!ext || ext == base_name) ext = "";
+
     for (int i = 1; i < 1000; i++) {
-        const char *ext = strrchr(base_name, '.');
-        if (ext && ext != base_name) {
-            // 확장자가 있는 경우: 파일명(숫자).확장자
-            size_t name_len = ext - base_name;
-            memcpy(unique_name, base_name, name_len);
-            unique_name[name_len] = '\0';
-            strcat(unique_name, "(");
-            
-            char num_str[16];
-            sprintf(num_str, "%d", i);
-            strcat(unique_name, num_str);
-            strcat(unique_name, ")");
-            strcat(unique_name, ext);
-        } else {
-            // 확장자가 없는 경우: 파일명(숫자)
-            strcpy(unique_name, base_name);
-            strcat(unique_name, "(");
-            
-            char num_str[16];
-            sprintf(num_str, "%d", i);
-            strcat(unique_name, num_str);
-            strcat(unique_name, ")");
-        }
-        
-        snprintf(test_path, sizeof(test_path), "%s/%s", dest_dir, unique_name);
+        snprintf(out, out_size, "%.*s(%d)%s", stem_len, base_name, i, ext);
+        join_path(test_path, sizeof(test_path), dest_dir, out);
         if (access(test_path, F_OK) != 0) {
-            return unique_name;
+            return;
         }
     }
-    
+
     // 1000개까지 시도해도 안되면 원본 이름 반환
-    strcpy(unique_name, base_name);
+    snprintf(out, out_size, "%s", base_name);
+}
+
+// 고유한 파일명 생성
+char* generate_unique_name(const char *dest_dir, const char *base_name) {
+    static char unique_name[MAX_PATH_LEN];
+    generate_unique_name_r(dest_dir, base_name, unique_name, sizeof(unique_name));
     return unique_name;
 }
 
@@ -500,11 +1023,10 @@ bool copy_file_sync_with_progress(const char *src, const char *dest, CopyTask* t
 
     char buffer[8192];
     ssize_t bytes_read, bytes_written;
-    off_t total_copied = 0;
 
     while ((bytes_read = read(src_fd, buffer, sizeof(buffer))) > 0) {
         bytes_written = write(dest_fd, buffer, bytes_read);
-        if (bytes_written != bytes_read) {
+        if (bytes_written != bytes_read || (task && task->cancel_requested)) {
             close(src_fd);
             close(dest_fd);
             unlink(dest);
@@ -514,8 +1036,7 @@ bool copy_file_sync_with_progress(const char *src, const char *dest, CopyTask* t
         // 진행률 업데이트
         if (task) {
             pthread_mutex_lock(&task->progress_mutex);
-            total_copied += bytes_written;
-            task->copied_size = total_copied;
+            task->copied_size += bytes_written;
             pthread_mutex_unlock(&task->progress_mutex);
         }
     }
@@ -539,6 +1060,11 @@ bool copy_file_sync(const char *src, const char *dest) {
 
 // 동기 디렉토리 복사
 bool copy_directory_sync(const char *src, const char *dest) {
+    return copy_directory_sync_with_progress(src, dest, NULL);
+}
+
+// 진행률을 추적하는 동기 디렉토리 복사
+bool copy_directory_sync_with_progress(const char *src, const char *dest, CopyTask* task) {
     // 대상 디렉토리 생성
     if (mkdir(dest, 0755) == -1 && errno != EEXIST) {
         return false;
@@ -566,12 +1092,12 @@ bool copy_directory_sync(const char *src, const char *dest) {
         }
 
         if (S_ISDIR(st.st_mode)) {
-            if (!copy_directory_sync(src_path, dest_path)) {
+            if (!copy_directory_sync_with_progress(src_path, dest_path, task)) {
                 closedir(dir);
                 return false;
             }
         } else {
-            if (!copy_file_sync(src_path, dest_path)) {
+            if (!copy_file_sync_with_progress(src_path, dest_path, task)) {
                 closedir(dir);
                 return false;
             }
@@ -582,39 +1108,2238 @@ bool copy_directory_sync(const char *src, const char *dest) {
     return true;
 }
 
-// 백그라운드 복사 스레드 함수
-void* copy_thread_func(void* arg) {
-    CopyTask* task = (CopyTask*)arg;
+// 심볼릭 링크를 링크 그대로 복사 (대상 자리에 있는 빈 예약 파일은 교체)
+static bool copy_symlink_at(int dirfd, const char *name, const char *dest) {
+    char target[MAX_PATH_LEN];
+    ssize_t len = readlinkat(dirfd, name, target, sizeof(target) - 1);
+    if (len < 0) {
+        return false;
+    }
+    target[len] = '\0';
+
+    if (symlink(target, dest) == 0) {
+        return true;
+    }
+    if (errno == EEXIST && unlink(dest) == 0) {
+        return symlink(target, dest) == 0;
+    }
+    return false;
+}
+
+// 장치 파일, FIFO, 소켓을 같은 종류와 권한, 시각으로 다시 만듦 (대상 자리에 있는 빈 예약 파일은 교체)
+// 장치 파일은 권한이 없으면 실패 - 이동이면 그 항목의 원본이 지워지지 않고 남음
+static bool copy_special_at(int dirfd, const char *name, const char *dest) {
+    struct stat st;
+    if (fstatat(dirfd, name, &st, AT_SYMLINK_NOFOLLOW) == -1) {
+        return false;
+    }
+    mode_t mode = st.st_mode & (S_IFMT | 07777);
+    if (mknod(dest, mode, st.st_rdev) == -1 &&
+        (errno != EEXIST || unlink(dest) == -1 || mknod(dest, mode, st.st_rdev) == -1)) {
+        return false;
+    }
+    struct timespec times[2] = { st.st_atim, st.st_mtim };
+    chmod(dest, st.st_mode & 07777); // umask로 빠진 권한
+    utimensat(AT_FDCWD, dest, times, 0);
+    return true;
+}
+
+// 항목 하나를 실패로 표시
+static void mark_item_failed(CopyTask *task, int item_index) {
+    pthread_mutex_lock(&task->progress_mutex);
+    if (item_index >= 0 && item_index < task->item_count) {
+        task->items[item_index].failed = true;
+    }
+    task->failed_count++;
+    pthread_mutex_unlock(&task->progress_mutex);
+}
 
-    bool success;
-    if (task->is_directory) {
-        success = copy_directory_sync(task->source_path, task->dest_path);
+// ---------------- 병렬 복사 엔진 ----------------
+// 탐색기(walker)가 디렉토리를 만들며 파일을 대기열에 넣고,
+// 복사 워커들이 대기열의 파일을 동시에 복사한다.
+
+// 복사할 파일 하나
+typedef struct CopyWork {
+    char *src;
+    char *dest;
+    int item_index;          // 어느 작업 항목에 속하는지
+    struct CopyWork *next;
+} CopyWork;
+
+// 다 채운 뒤 원본의 권한, 소유자, 시각을 붙일 대상 디렉토리
+typedef struct CopyDirMeta {
+    char *dest;
+    struct stat st;
+    struct CopyDirMeta *next;
+} CopyDirMeta;
+
+// 파일 하나를 옮기는 함수 (복사: 새로 쓰기, 동기화: 바뀐 부분만)
+typedef bool (*CopyFileFunc)(const char *src, const char *dest, CopyTask *task);
+
+typedef struct {
+    Walker walker;
+    CopyTask *task;
+    CopyFileFunc copy_file;
+    int *root_items;         // walker 시작 디렉토리 번호 → 작업 항목 번호
+
+    pthread_mutex_t lock;
+    pthread_cond_t not_empty;
+    pthread_cond_t not_full;
+    CopyWork *head;
+    CopyWork *tail;
+    int queued;
+    bool producer_done;      // 더 이상 대기열에 들어올 파일이 없음
+
+    pthread_t workers[COPY_MAX_WORKERS];
+    int nworkers;
+
+    CopyDirMeta *dirs;       // 끝난 디렉토리 (하위가 먼저, lock으로 보호)
+    CopyDirMeta *dirs_tail;
+} CopyEngine;
+
+// 복사할 파일을 대기열에 추가 (src/dest 소유권을 넘겨받음)
+static void copy_engine_push(CopyEngine *engine, char *src, char *dest, int item_index) {
+    CopyWork *work = malloc(sizeof(CopyWork));
+    if (!work || !src || !dest) {
+        free(work);
+        free(src);
+        free(dest);
+        mark_item_failed(engine->task, item_index);
+        return;
+    }
+    work->src = src;
+    work->dest = dest;
+    work->item_index = item_index;
+    work->next = NULL;
+
+    pthread_mutex_lock(&engine->lock);
+    while (engine->queued >= COPY_QUEUE_LIMIT && !engine->task->cancel_requested) {
+        pthread_cond_wait(&engine->not_full, &engine->lock);
+    }
+    if (engine->tail) {
+        engine->tail->next = work;
     } else {
-        success = copy_file_sync_with_progress(task->source_path, task->dest_path, task);
+        engine->head = work;
     }
+    engine->tail = work;
+    engine->queued++;
+    pthread_cond_signal(&engine->not_empty);
+    pthread_mutex_unlock(&engine->lock);
+}
 
-    // 복사 실패 시 임시 파일 삭제
-    if (!success) {
-        if (task->is_directory) {
-            rmdir(task->dest_path);
-        } else {
-            unlink(task->dest_path);
+// 복사 워커 스레드
+static void* copy_engine_worker(void *arg) {
+    CopyEngine *engine = (CopyEngine*)arg;
+    CopyTask *task = engine->task;
+
+    while (1) {
+        pthread_mutex_lock(&engine->lock);
+        while (!engine->head && !engine->producer_done) {
+            pthread_cond_wait(&engine->not_empty, &engine->lock);
+        }
+        CopyWork *work = engine->head;
+        if (!work) {
+            pthread_mutex_unlock(&engine->lock);
+            break;
+        }
+        engine->head = work->next;
+        if (!engine->head) engine->tail = NULL;
+        engine->queued--;
+        pthread_cond_signal(&engine->not_full);
+        pthread_mutex_unlock(&engine->lock);
+
+        // 취소된 뒤에는 남은 대기열만 비움
+        if (!task->cancel_requested &&
+            !engine->copy_file(work->src, work->dest, task) &&
+            !task->cancel_requested) {
+            mark_item_failed(task, work->item_index);
         }
-    }
 
-    // 작업 완료 표시
-    task->is_running = false;
+        free(work->src);
+        free(work->dest);
+        free(work);
+    }
 
     return NULL;
 }
 
-// 특정 파일이 복사 중인지 확인
-bool is_copying_file(const char *file_path) {
-    pthread_mutex_lock(&g_tasks_mutex);
+// 디렉토리에 들어갈 때 대응하는 대상 디렉토리 경로를 기억
+static bool copy_engine_enter(Walker *w, WalkDir *dir, int dirfd) {
+    (void)dirfd;
+    CopyEngine *engine = (CopyEngine*)w->user;
+    CopyTask *task = engine->task;
+
+    if (dir->depth == 0) {
+        int item_index = engine->root_items[dir->root_index];
+        char dest[MAX_PATH_LEN];
+        pthread_mutex_lock(&task->progress_mutex);
+        join_path(dest, sizeof(dest), task->dest_dir, task->items[item_index].dest_name);
+        pthread_mutex_unlock(&task->progress_mutex);
+        dir->data = strdup(dest);
+    } else if (dir->parent->data) {
+        const char *base = strrchr(dir->path, '/');
+        dir->data = join_path_alloc((const char*)dir->parent->data, base ? base + 1 : dir->path);
+    }
 
-    CopyTask* current = g_copy_tasks;
-    while (current) {
-        if (current->is_running) {
+    return dir->data != NULL;
+}
+
+// 엔트리마다 대상 디렉토리를 만들거나 파일을 대기열에 넣음
+static bool copy_engine_visit(Walker *w, WalkDir *dir, int dirfd, const char *name,
+                              unsigned char d_type, const struct stat *st) {
+    (void)st;
+    CopyEngine *engine = (CopyEngine*)w->user;
+    CopyTask *task = engine->task;
+    int item_index = engine->root_items[dir->root_index];
+
+    if (task->cancel_requested) {
+        walker_cancel(w);
+        return false;
+    }
+
+    char *dest = join_path_alloc((const char*)dir->data, name);
+    if (!dest) {
+        mark_item_failed(task, item_index);
+        return false;
+    }
+
+    switch (d_type) {
+        case DT_DIR: {
+            bool ok = (mkdir(dest, 0755) == 0 || errno == EEXIST);
+            if (!ok) mark_item_failed(task, item_index);
+            free(dest);
+            return ok;
+        }
+        case DT_REG:
+            copy_engine_push(engine, join_path_alloc(dir->path, name), dest, item_index);
+            return false;
+        case DT_LNK:
+            if (!copy_symlink_at(dirfd, name, dest)) mark_item_failed(task, item_index);
+            break;
+        default:
+            // 장치 파일, FIFO, 소켓 - 만들지 못하면 실패로 남겨 이동이 원본을 지우지 않도록
+            if (!copy_special_at(dirfd, name, dest)) mark_item_failed(task, item_index);
+            break;
+    }
+
+    free(dest);
+    return false;
+}
+
+// 대상 디렉토리 경로를 넘겨받아 목록에 넣음 - 워커가 아직 그 안에 파일을 만드는 중일 수 있으므로
+// 권한과 시각은 복사가 모두 끝난 뒤 copy_engine_apply_dirs에서 붙임
+static void copy_engine_leave(Walker *w, WalkDir *dir) {
+    CopyEngine *engine = (CopyEngine*)w->user;
+    CopyDirMeta *meta = (dir->data && dir->st.st_ino != 0) ? malloc(sizeof(CopyDirMeta)) : NULL;
+    if (!meta) {
+        free(dir->data);
+        dir->data = NULL;
+        return;
+    }
+    meta->dest = (char*)dir->data;
+    meta->st = dir->st;
+    meta->next = NULL;
+    dir->data = NULL;
+
+    pthread_mutex_lock(&engine->lock);
+    if (engine->dirs_tail) {
+        engine->dirs_tail->next = meta;
+    } else {
+        engine->dirs = meta;
+    }
+    engine->dirs_tail = meta;
+    pthread_mutex_unlock(&engine->lock);
+}
+
+// 원본 디렉토리의 권한, 소유자 (권한이 있을 때만), 시각을 대상에 - 하위부터 붙여
+// 읽기 전용이나 0700 디렉토리도 안쪽을 다 채운 뒤에 닫히고, 이동해도 원본의 메타데이터가 남음
+static void copy_engine_apply_dirs(CopyEngine *engine) {
+    while (engine->dirs) {
+        CopyDirMeta *meta = engine->dirs;
+        engine->dirs = meta->next;
+        if (!engine->task->cancel_requested) {
+            int fd = open(meta->dest, O_RDONLY | O_DIRECTORY | O_NOFOLLOW | O_CLOEXEC);
+            if (fd != -1) {
+                struct timespec times[2] = { meta->st.st_atim, meta->st.st_mtim };
+                if (fchown(fd, meta->st.st_uid, meta->st.st_gid) == -1) {
+                    // 다른 사용자의 디렉토리는 소유자를 바꿀 수 없음 - 권한과 시각만
+                }
+                fchmod(fd, meta->st.st_mode & 07777);
+                futimens(fd, times);
+                close(fd);
+            }
+        }
+        free(meta->dest);
+        free(meta);
+    }
+    engine->dirs_tail = NULL;
+}
+
+static const WalkOps copy_engine_ops = { copy_engine_enter, copy_engine_visit, copy_engine_leave };
+
+// 작업의 (아직 끝나지 않은) 항목들을 병렬로 복사 (ops와 copy_file을 바꿔 동기화에도 씀)
+static void run_copy_engine(CopyTask *task, const WalkOps *ops, CopyFileFunc copy_file) {
+    CopyEngine engine;
+    memset(&engine, 0, sizeof(engine));
+    engine.task = task;
+    engine.copy_file = copy_file;
+    pthread_mutex_init(&engine.lock, NULL);
+    pthread_cond_init(&engine.not_empty, NULL);
+    pthread_cond_init(&engine.not_full, NULL);
+
+    const char **roots = malloc(sizeof(char*) * task->item_count);
+    char **root_paths = malloc(sizeof(char*) * task->item_count);
+    engine.root_items = malloc(sizeof(int) * task->item_count);
+    if (!roots || !root_paths || !engine.root_items) {
+        free(roots);
+        free(root_paths);
+        free(engine.root_items);
+        for (int i = 0; i < task->item_count; i++) mark_item_failed(task, i);
+        return;
+    }
+
+    int nworkers = walker_default_threads();
+    if (nworkers > COPY_MAX_WORKERS) nworkers = COPY_MAX_WORKERS;
+    for (int i = 0; i < nworkers; i++) {
+        if (pthread_create(&engine.workers[engine.nworkers], NULL, copy_engine_worker, &engine) == 0) {
+            engine.nworkers++;
+        }
+    }
+    if (engine.nworkers == 0) {
+        for (int i = 0; i < task->item_count; i++) {
+            if (!task->items[i].done) mark_item_failed(task, i);
+        }
+    }
+
+    // 최상위 파일은 바로 대기열에, 디렉토리는 탐색 시작점으로
+    int nroots = 0;
+    for (int i = 0; i < task->item_count && engine.nworkers > 0 && !task->cancel_requested; i++) {
+        TaskItem *item = &task->items[i];
+        if (item->done || item->failed || !item->created) continue;
+
+        char *src = join_path_alloc(task->source_dir, item->name);
+        char *dest = join_path_alloc(task->dest_dir, item->dest_name);
+        struct stat lst;
+        if (!src || !dest || lstat(src, &lst) == -1) {
+            free(src);
+            free(dest);
+            mark_item_failed(task, i);
+            continue;
+        }
+
+        if (item->is_directory) {
+            root_paths[nroots] = src;
+            roots[nroots] = src;
+            engine.root_items[nroots] = i;
+            nroots++;
+            free(dest);
+        } else if (S_ISLNK(lst.st_mode) && get_file_size(src) < 0) {
+            // 대상이 없는 링크는 링크 자체를 복사
+            if (!copy_symlink_at(AT_FDCWD, src, dest)) mark_item_failed(task, i);
+            free(src);
+            free(dest);
+        } else if (!S_ISREG(lst.st_mode) && !S_ISLNK(lst.st_mode)) {
+            // FIFO 등은 열어 읽으면 멈추므로 같은 종류로 다시 만듦
+            if (!copy_special_at(AT_FDCWD, src, dest)) mark_item_failed(task, i);
+            free(src);
+            free(dest);
+        } else {
+            copy_engine_push(&engine, src, dest, i);
+        }
+    }
+
+    if (nroots > 0) {
+        walker_init(&engine.walker, ops, &engine);
+        engine.walker.need_stat = false; // d_type만으로 충분
+        if (walker_start_multi(&engine.walker, roots, nroots)) {
+            walker_wait(&engine.walker);
+        }
+        walker_destroy(&engine.walker);
+    }
+
+    // 탐색이 끝났으면 워커들이 남은 대기열을 비우고 끝나도록
+    pthread_mutex_lock(&engine.lock);
+    engine.producer_done = true;
+    pthread_cond_broadcast(&engine.not_empty);
+    pthread_mutex_unlock(&engine.lock);
+
+    for (int i = 0; i < engine.nworkers; i++) {
+        pthread_join(engine.workers[i], NULL);
+    }
+    copy_engine_apply_dirs(&engine);
+
+    for (int i = 0; i < nroots; i++) {
+        free(root_paths[i]);
+    }
+    free(roots);
+    free(root_paths);
+    free(engine.root_items);
+    pthread_mutex_destroy(&engine.lock);
+    pthread_cond_destroy(&engine.not_empty);
+    pthread_cond_destroy(&engine.not_full);
+}
+
+// ---------------- 작업 크기 계산 ----------------
+
+// 복사와 동시에 도는 전체 크기 계산
+typedef struct {
+    CopyTask *task;
+    volatile bool abort;
+    pthread_t thread;
+    bool started;
+} TaskSizeRun;
+
+static void* task_size_thread(void *arg) {
+    TaskSizeRun *run = (TaskSizeRun*)arg;
+    CopyTask *task = run->task;
+
+    off_t total = 0;
+    long entries = 0;
+    const char **dirs = malloc(sizeof(char*) * task->item_count);
+    char **paths = malloc(sizeof(char*) * task->item_count);
+    int ndirs = 0;
+    if (!dirs || !paths) {
+        free(dirs);
+        free(paths);
+        return NULL;
+    }
+
+    // 파일은 stat 한 번, 디렉토리는 한 번의 병렬 탐색으로 합산
+    for (int i = 0; i < task->item_count && !run->abort; i++) {
+        TaskItem *item = &task->items[i];
+        if (item->done) continue;
+
+        char *path = join_path_alloc(task->source_dir, item->name);
+        struct stat st;
+        if (!path || stat(path, &st) == -1) {
+            free(path);
+            continue;
+        }
+        entries++;
+        if (S_ISDIR(st.st_mode)) {
+            paths[ndirs] = path;
+            dirs[ndirs++] = path;
+        } else {
+            total += st.st_size;
+            free(path);
+        }
+    }
+
+    bool complete = !run->abort;
+    if (complete && ndirs > 0) {
+        DirSizeJob job;
+        if (dir_size_job_start(&job, dirs, ndirs, &run->abort)) {
+            dir_size_job_finish(&job, false);
+            complete = job.has_result;
+            total += job.result;
+            entries += job.entries;
+        } else {
+            complete = false;
+        }
+    }
+
+    if (complete) {
+        pthread_mutex_lock(&task->progress_mutex);
+        task->total_size = total;
+        task->files_total = entries;
+        pthread_mutex_unlock(&task->progress_mutex);
+    }
+
+    for (int i = 0; i < ndirs; i++) {
+        free(paths[i]);
+    }
+    free(dirs);
+    free(paths);
+    return NULL;
+}
+
+static void task_size_start(TaskSizeRun *run, CopyTask *task) {
+    memset(run, 0, sizeof(TaskSizeRun));
+    run->task = task;
+    run->started = (pthread_create(&run->thread, NULL, task_size_thread, run) == 0);
+}
+
+// 크기 계산 종료 (wait이 아니면 중단 요청)
+static void task_size_finish(TaskSizeRun *run, bool wait) {
+    if (!run->started) return;
+    if (!wait) run->abort = true;
+    pthread_join(run->thread, NULL);
+    run->started = false;
+}
+
+// ---------------- 병렬 삭제 엔진 ----------------
+// 탐색기(walker)가 디렉토리마다 dirfd 기준 unlinkat으로 파일을 지우고,
+// 하위 디렉토리가 모두 끝나면 (post-order) 상위 디렉토리 fd 기준으로 디렉토리 자신을 지운다.
+
+#define DELETE_PROGRESS_BATCH 256 // 진행률 갱신 단위 (파일마다 잠그지 않도록)
+
+typedef struct {
+    CopyTask *task;          // NULL이면 진행률 없이 삭제만
+    bool *root_removed;      // 시작 디렉토리별 삭제 성공 여부
+} DeleteEngine;
+
+static void delete_engine_count(CopyTask *task, long count) {
+    if (!task || count <= 0) return;
+    pthread_mutex_lock(&task->progress_mutex);
+    task->files_done += count;
+    pthread_mutex_unlock(&task->progress_mutex);
+}
+
+// 디렉토리가 아닌 엔트리는 바로 unlinkat, 디렉토리는 하위로 내려감
+static bool delete_engine_visit(Walker *w, WalkDir *dir, int dirfd, const char *name,
+                                unsigned char d_type, const struct stat *st) {
+    (void)st;
+    DeleteEngine *engine = (DeleteEngine*)w->user;
+
+    if (engine->task && engine->task->cancel_requested) {
+        walker_cancel(w);
+        return false;
+    }
+    if (d_type == DT_DIR) {
+        return true;
+    }
+
+    // 실패한 엔트리는 상위 디렉토리의 rmdir 실패로 드러남
+    if (unlinkat(dirfd, name, 0) == 0 &&
+        ++dir->sum_self[0] % DELETE_PROGRESS_BATCH == 0) {
+        delete_engine_count(engine->task, DELETE_PROGRESS_BATCH);
+    }
+    return false;
+}
+
+// 하위 항목이 모두 지워진 뒤 디렉토리 자신 삭제
+static void delete_engine_leave(Walker *w, WalkDir *dir) {
+    DeleteEngine *engine = (DeleteEngine*)w->user;
+
+    long pending_count = (long)(dir->sum_self[0] % DELETE_PROGRESS_BATCH);
+    bool removed = false;
+    if (!w->cancel && dir->parent) {
+        // 상위 디렉토리 fd 기준으로 (경로 중간이 심볼릭 링크로 바뀌어도 다른 곳을 지우지 않도록)
+        int parent_fd = walker_open_parent(dir);
+        removed = (parent_fd != -1 && unlinkat(parent_fd, dir->name, AT_REMOVEDIR) == 0);
+        if (parent_fd != -1) close(parent_fd);
+    } else if (!w->cancel) {
+        removed = (rmdir(dir->path) == 0);
+    }
+    if (removed) pending_count++;
+    delete_engine_count(engine->task, pending_count);
+
+    if (dir->depth == 0) {
+        engine->root_removed[dir->root_index] = removed;
+    }
+}
+
+// 여러 디렉토리를 한 번의 병렬 탐색으로 삭제 (removed[i]에 각 결과 기록)
+static void run_delete_engine(const char *const *roots, int count, CopyTask *task, bool *removed) {
+    static const WalkOps ops = { NULL, delete_engine_visit, delete_engine_leave };
+
+    DeleteEngine engine;
+    engine.task = task;
+    engine.root_removed = removed;
+    for (int i = 0; i < count; i++) {
+        removed[i] = false;
+    }
+
+    Walker walker;
+    walker_init(&walker, &ops, &engine);
+    walker.need_stat = false;      // d_type만으로 충분
+    walker.one_filesystem = true;  // 마운트된 다른 파일시스템은 건드리지 않음
+    if (walker_start_multi(&walker, roots, count)) {
+        walker_wait(&walker);
+    }
+    walker_destroy(&walker);
+}
+
+// 지운 항목 수를 기록하며 경로 하나 삭제 (심볼릭 링크는 링크만 삭제)
+static bool delete_path_with_progress(const char *path, CopyTask *task) {
+    struct stat st;
+    if (lstat(path, &st) == -1) {
+        return false;
+    }
+    if (S_ISDIR(st.st_mode)) {
+        return delete_directory_recursive_with_progress(path, task);
+    }
+    if (unlink(path) != 0) {
+        return false;
+    }
+    delete_engine_count(task, 1);
+    return true;
+}
+
+// 아직 끝나지 않은 항목들을 dir에서 삭제 (디렉토리들은 한 번의 병렬 탐색으로)
+static void run_delete_items(CopyTask *task, const char *dir) {
+    const char **roots = malloc(sizeof(char*) * task->item_count);
+    char **root_paths = malloc(sizeof(char*) * task->item_count);
+    int *root_items = malloc(sizeof(int) * task->item_count);
+    bool *removed = malloc(sizeof(bool) * task->item_count);
+    if (!roots || !root_paths || !root_items || !removed) {
+        free(roots);
+        free(root_paths);
+        free(root_items);
+        free(removed);
+        for (int i = 0; i < task->item_count; i++) {
+            if (!task->items[i].done && !task->items[i].failed) mark_item_failed(task, i);
+        }
+        return;
+    }
+
+    // 디렉토리가 아닌 항목은 바로 삭제, 디렉토리는 탐색 시작점으로
+    int nroots = 0;
+    for (int i = 0; i < task->item_count && !task->cancel_requested; i++) {
+        TaskItem *item = &task->items[i];
+        if (item->done || item->failed) continue;
+
+        char *path = join_path_alloc(dir, item->name);
+        struct stat st;
+        if (!path || lstat(path, &st) == -1) {
+            free(path);
+            mark_item_failed(task, i);
+            continue;
+        }
+
+        if (S_ISDIR(st.st_mode)) {
+            root_paths[nroots] = path;
+            roots[nroots] = path;
+            root_items[nroots] = i;
+            nroots++;
+        } else {
+            if (unlink(path) == 0) {
+                delete_engine_count(task, 1);
+            } else {
+                mark_item_failed(task, i);
+            }
+            free(path);
+        }
+    }
+
+    if (nroots > 0) {
+        run_delete_engine(roots, nroots, task, removed);
+        for (int i = 0; i < nroots; i++) {
+            if (!removed[i] && !task->cancel_requested) {
+                mark_item_failed(task, root_items[i]);
+            }
+            free(root_paths[i]);
+        }
+    }
+
+    free(roots);
+    free(root_paths);
+    free(root_items);
+    free(removed);
+}
+
+// ---------------- 동기화 엔진 ----------------
+// 복사 엔진의 탐색기와 워커를 그대로 쓰되, 대상에 이미 있는 파일은 (크기, 수정 시각)이 같으면 건너뛰고
+// 바뀐 큰 파일은 rsync 방식의 구르는 블록 체크섬으로 기존 대상과 같은 블록을 찾아 달라진 부분만 쓴다.
+
+#define SYNC_DELTA_MIN (4 * 1024 * 1024)     // 양쪽이 이보다 크면 블록 비교로 바뀐 부분만 씀
+#define SYNC_BLOCK_MIN 4096                  // 블록 크기 (대상 크기의 제곱근 근처의 2의 거듭제곱)
+#define SYNC_BLOCK_MAX (128 * 1024)
+#define SYNC_PROGRESS_STEP (8 * 1024 * 1024) // 블록 비교 중 진행률과 취소 확인 간격
+#define SYNC_COMPARE_BUFFER (256 * 1024)     // 내용 비교 모드에서 작은 파일을 읽는 버퍼
+#define SYNC_WINDOW (1024 * 1024)            // 블록 비교에서 한 번에 pread하는 양 (SYNC_BLOCK_MAX의 배수)
+
+// 새 파일을 만드는 명령 하나 (원본의 offset부터 length만큼)
+typedef struct {
+    off_t offset;
+    off_t length;
+    off_t basis;    // 기존 대상 파일에서 가져올 위치 (-1이면 원본 내용을 씀)
+} SyncOp;
+
+typedef struct {
+    SyncOp *ops;
+    int count;
+    int capacity;
+    off_t literal_bytes; // 원본에서 새로 써야 하는 양
+} SyncDelta;
+
+// 명령 추가 (앞 명령과 이어지면 합침)
+static bool sync_delta_add(SyncDelta *delta, off_t offset, off_t length, off_t basis) {
+    if (delta->count > 0) {
+        SyncOp *last = &delta->ops[delta->count - 1];
+        bool contiguous = (last->offset + last->length == offset);
+        if (contiguous && ((basis < 0 && last->basis < 0) ||
+                           (basis >= 0 && last->basis >= 0 && last->basis + last->length == basis))) {
+            last->length += length;
+            if (basis < 0) delta->literal_bytes += length;
+            return true;
+        }
+    }
+    if (delta->count == delta->capacity) {
+        int capacity = delta->capacity ? delta->capacity * 2 : 64;
+        SyncOp *ops = realloc(delta->ops, sizeof(SyncOp) * capacity);
+        if (!ops) return false;
+        delta->ops = ops;
+        delta->capacity = capacity;
+    }
+    delta->ops[delta->count++] = (SyncOp){ offset, length, basis };
+    if (basis < 0) delta->literal_bytes += length;
+    return true;
+}
+
+// 구르는 체크섬 (a: 바이트 합, b: 앞쪽일수록 큰 가중치의 합) - 한 바이트 밀 때 O(1)로 갱신
+static void sync_weak_init(const unsigned char *p, size_t len, uint32_t *a, uint32_t *b) {
+    uint32_t sa = 0, sb = 0;
+    for (size_t i = 0; i < len; i++) {
+        sa += p[i];
+        sb += sa;
+    }
+    *a = sa;
+    *b = sb;
+}
+
+static inline uint32_t sync_weak_value(uint32_t a, uint32_t b) {
+    return (a & 0xffff) | (b << 16);
+}
+
+static inline uint32_t sync_weak_bucket(uint32_t weak, uint32_t mask) {
+    return (weak * 2654435761u) >> 7 & mask;
+}
+
+// fd의 offset부터 length를 모두 읽음 (그 사이에 파일이 줄었거나 읽을 수 없으면 false)
+static bool sync_read_at(int fd, unsigned char *data, size_t length, off_t offset) {
+    while (length > 0) {
+        ssize_t n = pread(fd, data, length, offset);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        data += n;
+        offset += n;
+        length -= n;
+    }
+    return true;
+}
+
+// src를 basis의 블록과 새 내용의 명령열로 나눔 - 양쪽 다 SYNC_WINDOW씩 pread로 읽고, 체크섬이 같은 블록만 대상에서 다시 읽어 비교
+// (mmap과 달리 읽는 중에 파일이 줄어도 이 파일만 실패, 취소되거나 메모리가 없어도 false)
+static bool sync_compute_delta(int src_fd, off_t src_size, int basis_fd, off_t basis_size, CopyTask *task,
+                               SyncDelta *delta) {
+    size_t block = SYNC_BLOCK_MIN;
+    while (block < SYNC_BLOCK_MAX && (off_t)block * (off_t)block < basis_size) block *= 2;
+
+    // 대상의 블록마다 체크섬 (같은 체크섬은 연결 목록으로)
+    int nblocks = (int)(basis_size / (off_t)block);
+    uint32_t mask = 1;
+    while (mask < (uint32_t)nblocks * 2) mask <<= 1;
+    uint32_t *weak = malloc(sizeof(uint32_t) * nblocks);
+    int *next = malloc(sizeof(int) * nblocks);
+    int *heads = malloc(sizeof(int) * mask);
+    unsigned char *window = malloc(SYNC_WINDOW + block); // 원본을 읽는 창 (블록과 다음 한 바이트가 항상 들어감)
+    unsigned char *verify = malloc(block * 2);           // 후보 블록 확인용
+    if (!weak || !next || !heads || !window || !verify) {
+        free(weak);
+        free(next);
+        free(heads);
+        free(window);
+        free(verify);
+        return false;
+    }
+    mask--;
+    memset(heads, 0xff, sizeof(int) * (mask + 1));
+
+    bool ok = true;
+    off_t blocks_end = (off_t)nblocks * (off_t)block;
+    for (off_t base = 0; ok && base < blocks_end; base += SYNC_WINDOW) { // SYNC_WINDOW는 블록 크기의 배수
+        size_t length = blocks_end - base > SYNC_WINDOW ? SYNC_WINDOW : (size_t)(blocks_end - base);
+        ok = !task->cancel_requested && sync_read_at(basis_fd, window, length, base);
+        for (size_t offset = 0; ok && offset < length; offset += block) {
+            uint32_t a, b;
+            sync_weak_init(window + offset, block, &a, &b);
+            weak[(base + offset) / (off_t)block] = sync_weak_value(a, b);
+        }
+    }
+    for (int j = nblocks - 1; ok && j >= 0; j--) {
+        uint32_t bucket = sync_weak_bucket(weak[j], mask);
+        next[j] = heads[bucket];
+        heads[bucket] = j;
+    }
+
+    off_t window_offset = 0; // window[0]의 원본 위치
+    size_t window_length = 0;
+    off_t pos = 0;
+    off_t literal = 0;
+    off_t reported = 0;
+    uint32_t a = 0, b = 0;
+    bool rolling = false;
+    while (ok && pos + (off_t)block <= src_size) {
+        // pos부터 블록과 다음 한 바이트가 창에 없으면 남은 부분을 앞으로 당기고 이어서 읽음
+        off_t need = pos + (off_t)block + 1 <= src_size ? pos + (off_t)block + 1 : src_size;
+        if (need > window_offset + (off_t)window_length) {
+            size_t keep = (size_t)(window_offset + (off_t)window_length - pos);
+            memmove(window, window + (pos - window_offset), keep);
+            size_t want = SYNC_WINDOW + block;
+            if ((off_t)want > src_size - pos) want = (size_t)(src_size - pos);
+            window_offset = pos;
+            window_length = want;
+            if (!sync_read_at(src_fd, window + keep, want - keep, pos + keep)) {
+                ok = false;
+                break;
+            }
+        }
+        const unsigned char *cur = window + (pos - window_offset);
+
+        if (!rolling) {
+            sync_weak_init(cur, block, &a, &b);
+            rolling = true;
+        }
+        uint32_t value = sync_weak_value(a, b);
+        int match = -1;
+        int same_place = (pos % (off_t)block == 0 && pos < blocks_end) ? (int)(pos / (off_t)block) : -1;
+
+        // 같은 위치의 블록을 먼저 (제자리 수정, 뒤에 덧붙인 파일)
+        if (same_place >= 0 && weak[same_place] == value && sync_read_at(basis_fd, verify, block, pos) &&
+            memcmp(cur, verify, block) == 0) {
+            match = same_place;
+        }
+        for (int j = match < 0 ? heads[sync_weak_bucket(value, mask)] : -1; j >= 0; j = next[j]) {
+            if (weak[j] == value && j != same_place &&
+                sync_read_at(basis_fd, verify, block, (off_t)j * block) && memcmp(cur, verify, block) == 0) {
+                match = j;
+                break;
+            }
+        }
+
+        if (match >= 0) {
+            if (pos > literal) ok = ok && sync_delta_add(delta, literal, pos - literal, -1);
+            ok = ok && sync_delta_add(delta, pos, block, (off_t)match * block);
+            pos += block;
+            literal = pos;
+            rolling = false;
+        } else {
+            // 창을 한 바이트 밀기
+            if (pos + (off_t)block < src_size) {
+                uint32_t out = cur[0];
+                uint32_t in = cur[block];
+                a += in - out;
+                b += a - (uint32_t)block * out;
+            }
+            pos++;
+        }
+
+        if (pos - reported >= SYNC_PROGRESS_STEP) {
+            if (task->cancel_requested) ok = false;
+            pthread_mutex_lock(&task->progress_mutex);
+            task->copied_size += pos - reported;
+            pthread_mutex_unlock(&task->progress_mutex);
+            reported = pos;
+        }
+    }
+    if (ok && literal < src_size) {
+        // 블록보다 짧은 끝부분도 같은 위치에 그대로 있으면 다시 쓰지 않음
+        off_t tail = src_size - literal;
+        bool same_tail = (tail < (off_t)block && literal + tail <= basis_size &&
+                          sync_read_at(src_fd, verify + block, tail, literal) &&
+                          sync_read_at(basis_fd, verify, tail, literal) &&
+                          memcmp(verify, verify + block, tail) == 0);
+        ok = sync_delta_add(delta, literal, tail, same_tail ? literal : -1);
+    }
+    if (ok) {
+        pthread_mutex_lock(&task->progress_mutex);
+        task->copied_size += src_size - reported;
+        pthread_mutex_unlock(&task->progress_mutex);
+    }
+
+    free(weak);
+    free(next);
+    free(heads);
+    free(window);
+    free(verify);
+    return ok;
+}
+
+static bool write_all_at(int fd, const unsigned char *data, off_t length, off_t offset) {
+    while (length > 0) {
+        ssize_t n = pwrite(fd, data, length > SYNC_PROGRESS_STEP ? SYNC_PROGRESS_STEP : (size_t)length, offset);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        data += n;
+        offset += n;
+        length -= n;
+    }
+    return true;
+}
+
+// in_fd의 구간을 out_fd로 - 커널 안에서 복사 (reflink를 지원하면 공유), 안 되면 buffer(SYNC_WINDOW)로 읽어 씀
+static bool sync_copy_range(int in_fd, off_t in_offset, int out_fd, off_t out_offset, off_t length,
+                            unsigned char *buffer) {
+    loff_t in = in_offset;
+    loff_t out = out_offset;
+    while (length > 0) {
+        ssize_t n = copy_file_range(in_fd, &in, out_fd, &out, length, 0);
+        if (n <= 0) break;
+        length -= n;
+    }
+    while (length > 0) {
+        ssize_t n = pread(in_fd, buffer, length > SYNC_WINDOW ? SYNC_WINDOW : (size_t)length, in);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0 || !write_all_at(out_fd, buffer, n, out)) return false;
+        in += n;
+        out += n;
+        length -= n;
+    }
+    return true;
+}
+
+// 원본의 권한과 수정 시각을 대상에 (다음 동기화가 (크기, 수정 시각)만으로 건너뛸 수 있도록)
+static void sync_copy_attributes(int fd, const char *path, const struct stat *st) {
+    struct timespec times[2] = { st->st_atim, st->st_mtim };
+    if (fd >= 0) {
+        fchmod(fd, st->st_mode & 07777);
+        futimens(fd, times);
+    } else {
+        chmod(path, st->st_mode & 07777);
+        utimensat(AT_FDCWD, path, times, 0);
+    }
+}
+
+// 대상과 같은 디렉토리의 임시 파일 이름 (rename으로 한 번에 바꾸기 위해)
+static bool sync_temp_path(const char *dest, char *temp, size_t size) {
+    const char *slash = strrchr(dest, '/');
+    int dir_len = slash ? (int)(slash - dest + 1) : 0;
+    snprintf(temp, size, "%.*s.%s.sync-XXXXXX", dir_len, dest, slash ? slash + 1 : dest);
+    int fd = mkstemp(temp);
+    if (fd == -1) return false;
+    close(fd);
+    return true;
+}
+
+// 블록 비교로 바뀐 부분만 쓰기 - 임시 파일에 기존 블록과 새 내용을 짜 넣고 rename으로 교체
+// sync_inplace이고 대상에 다른 하드 링크가 없으며 같은 블록이 모두 제자리면 바뀐 구간만 대상에 바로 덮어씀
+static bool sync_file_delta(const char *src, const char *dest, const struct stat *src_st, CopyTask *task) {
+    int src_fd = open(src, O_RDONLY | O_CLOEXEC);
+    int dest_fd = task->sync_inplace ? open(dest, O_RDWR | O_CLOEXEC) : -1;
+    bool writable = (dest_fd != -1);
+    if (!writable) dest_fd = open(dest, O_RDONLY | O_CLOEXEC);
+    unsigned char *buffer = malloc(SYNC_WINDOW);
+    SyncDelta delta = { 0 };
+
+    // 크기는 연 파일 기준 (검사 뒤에 바뀌었어도 읽는 범위가 실제 파일을 넘지 않도록)
+    struct stat src_now = { 0 }, dest_now = { 0 };
+    bool ok = (src_fd != -1 && dest_fd != -1 && buffer && fstat(src_fd, &src_now) == 0 &&
+               fstat(dest_fd, &dest_now) == 0 && S_ISREG(dest_now.st_mode));
+    if (ok) {
+        posix_fadvise(src_fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+        ok = sync_compute_delta(src_fd, src_now.st_size, dest_fd, dest_now.st_size, task, &delta);
+    }
+
+    bool in_place = true;
+    bool unchanged = (src_now.st_size == dest_now.st_size);
+    for (int i = 0; ok && i < delta.count; i++) {
+        if (delta.ops[i].basis != delta.ops[i].offset) unchanged = false;
+        if (delta.ops[i].basis >= 0 && delta.ops[i].basis != delta.ops[i].offset) in_place = false;
+    }
+
+    if (ok && unchanged) {
+        // 내용이 같으면 아무것도 쓰지 않음
+        sync_copy_attributes(writable ? dest_fd : -1, dest, src_st);
+    } else if (ok && in_place && writable && dest_now.st_nlink == 1) {
+        // 바뀐 구간만 덮어쓰고 길이를 맞춤
+        for (int i = 0; ok && i < delta.count; i++) {
+            SyncOp *op = &delta.ops[i];
+            if (op->basis < 0) ok = sync_copy_range(src_fd, op->offset, dest_fd, op->offset, op->length, buffer);
+        }
+        if (ok && dest_now.st_size != src_now.st_size) ok = (ftruncate(dest_fd, src_now.st_size) == 0);
+        if (ok) sync_copy_attributes(dest_fd, dest, src_st);
+    } else if (ok) {
+        // 기존 블록은 대상에서, 새 내용은 원본에서 가져와 임시 파일에 짬
+        char temp[MAX_PATH_LEN];
+        int temp_fd = -1;
+        ok = sync_temp_path(dest, temp, sizeof(temp)) && (temp_fd = open(temp, O_WRONLY | O_CLOEXEC)) != -1;
+        for (int i = 0; ok && i < delta.count && !task->cancel_requested; i++) {
+            SyncOp *op = &delta.ops[i];
+            if (op->basis < 0) {
+                ok = sync_copy_range(src_fd, op->offset, temp_fd, op->offset, op->length, buffer);
+            } else {
+                ok = sync_copy_range(dest_fd, op->basis, temp_fd, op->offset, op->length, buffer);
+            }
+        }
+        if (ok && task->cancel_requested) ok = false;
+        if (ok) sync_copy_attributes(temp_fd, temp, src_st);
+        if (temp_fd != -1 && close(temp_fd) != 0) ok = false;
+        if (ok) ok = (rename(temp, dest) == 0);
+        if (!ok && temp_fd != -1) unlink(temp);
+    }
+
+    free(delta.ops);
+    free(buffer);
+    if (src_fd != -1) close(src_fd);
+    if (dest_fd != -1) close(dest_fd);
+    return ok;
+}
+
+// 내용 비교 (크기가 같은 작은 파일)
+static bool sync_same_content(const char *src, const char *dest) {
+    int src_fd = open(src, O_RDONLY | O_CLOEXEC);
+    int dest_fd = open(dest, O_RDONLY | O_CLOEXEC);
+    unsigned char *buffer = malloc(SYNC_COMPARE_BUFFER * 2);
+    bool same = (src_fd != -1 && dest_fd != -1 && buffer);
+
+    while (same) {
+        ssize_t n = read(src_fd, buffer, SYNC_COMPARE_BUFFER);
+        if (n <= 0) {
+            same = (n == 0 && read(dest_fd, buffer, 1) == 0);
+            break;
+        }
+        ssize_t got = 0;
+        while (got < n) {
+            ssize_t m = read(dest_fd, buffer + SYNC_COMPARE_BUFFER + got, n - got);
+            if (m <= 0) break;
+            got += m;
+        }
+        same = (got == n && memcmp(buffer, buffer + SYNC_COMPARE_BUFFER, n) == 0);
+    }
+
+    free(buffer);
+    if (src_fd != -1) close(src_fd);
+    if (dest_fd != -1) close(dest_fd);
+    return same;
+}
+
+static void sync_add_progress(CopyTask *task, off_t bytes) {
+    pthread_mutex_lock(&task->progress_mutex);
+    task->copied_size += bytes;
+    pthread_mutex_unlock(&task->progress_mutex);
+}
+
+// 파일 하나 동기화 - 없으면 복사, 같으면 건너뜀, 큰 파일은 바뀐 블록만, 나머지는 임시 파일로 복사 후 교체
+static bool sync_file_with_progress(const char *src, const char *dest, CopyTask *task) {
+    struct stat src_st, dest_st;
+    if (stat(src, &src_st) == -1) return false;
+
+    bool exists = (lstat(dest, &dest_st) == 0);
+    if (exists && !S_ISREG(dest_st.st_mode)) {
+        // 같은 이름의 디렉토리나 링크는 원본 종류로 바꿈
+        if (!delete_path_with_progress(dest, NULL)) return false;
+        exists = false;
+    }
+
+    if (!exists) {
+        if (!copy_file_sync_with_progress(src, dest, task)) return false;
+        sync_copy_attributes(-1, dest, &src_st);
+        return true;
+    }
+
+    if (src_st.st_size == dest_st.st_size) {
+        bool same;
+        if (task->sync_content) {
+            // 큰 파일은 블록 비교가 같은 내용이면 아무것도 쓰지 않으므로 바로 넘김
+            if (src_st.st_size >= SYNC_DELTA_MIN) return sync_file_delta(src, dest, &src_st, task);
+            same = sync_same_content(src, dest);
+        } else {
+            same = (src_st.st_mtime == dest_st.st_mtime);
+        }
+        if (same) {
+            sync_copy_attributes(-1, dest, &src_st);
+            sync_add_progress(task, src_st.st_size);
+            return true;
+        }
+    }
+
+    if (src_st.st_size >= SYNC_DELTA_MIN && dest_st.st_size >= SYNC_DELTA_MIN) {
+        return sync_file_delta(src, dest, &src_st, task);
+    }
+
+    // 작은 파일은 통째로 - 실패하거나 취소되어도 기존 대상은 그대로 남도록 임시 파일에 쓴 뒤 교체
+    char temp[MAX_PATH_LEN];
+    if (!sync_temp_path(dest, temp, sizeof(temp))) return false;
+    if (!copy_file_sync_with_progress(src, temp, task)) {
+        unlink(temp);
+        return false;
+    }
+    sync_copy_attributes(-1, temp, &src_st);
+    if (rename(temp, dest) != 0) {
+        unlink(temp);
+        return false;
+    }
+    return true;
+}
+
+// 심볼릭 링크 동기화 (대상이 같은 링크면 그대로)
+static bool sync_symlink_at(int dirfd, const char *name, const char *dest) {
+    char target[MAX_PATH_LEN];
+    char current[MAX_PATH_LEN];
+    ssize_t len = readlinkat(dirfd, name, target, sizeof(target) - 1);
+    if (len < 0) return false;
+    target[len] = '\0';
+
+    struct stat st;
+    if (lstat(dest, &st) == 0) {
+        if (S_ISLNK(st.st_mode)) {
+            ssize_t current_len = readlink(dest, current, sizeof(current) - 1);
+            if (current_len == len && memcmp(current, target, len) == 0) return true;
+        } else if (S_ISDIR(st.st_mode) && !delete_path_with_progress(dest, NULL)) {
+            return false;
+        }
+    }
+    return copy_symlink_at(dirfd, name, dest);
+}
+
+// 디렉토리에 들어갈 때 대상 경로를 정하고, 지우기를 고른 경우 원본에 없는 대상 항목을 지움
+static bool sync_engine_enter(Walker *w, WalkDir *dir, int dirfd) {
+    if (!copy_engine_enter(w, dir, dirfd)) return false;
+
+    CopyEngine *engine = (CopyEngine*)w->user;
+    CopyTask *task = engine->task;
+    if (!task->sync_delete) return true;
+
+    DIR *d = opendir((const char*)dir->data);
+    if (!d) return true;
+    struct dirent *entry;
+    while ((entry = readdir(d)) != NULL && !task->cancel_requested) {
+        const char *name = entry->d_name;
+        if (name[0] == '.' && (name[1] == '\0' || (name[1] == '.' && name[2] == '\0'))) continue;
+
+        struct stat st;
+        if (fstatat(dirfd, name, &st, AT_SYMLINK_NOFOLLOW) == 0 || errno != ENOENT) continue;
+        char *extra = join_path_alloc((const char*)dir->data, name);
+        if (!extra || !delete_path_with_progress(extra, NULL)) {
+            mark_item_failed(task, engine->root_items[dir->root_index]);
+        }
+        free(extra);
+    }
+    closedir(d);
+    return true;
+}
+
+// 엔트리마다 대상 디렉토리를 맞추고, 바뀌었을 수 있는 파일만 대기열에 넣음
+static bool sync_engine_visit(Walker *w, WalkDir *dir, int dirfd, const char *name,
+                              unsigned char d_type, const struct stat *st) {
+    (void)st;
+    CopyEngine *engine = (CopyEngine*)w->user;
+    CopyTask *task = engine->task;
+    int item_index = engine->root_items[dir->root_index];
+
+    if (task->cancel_requested) {
+        walker_cancel(w);
+        return false;
+    }
+
+    char *dest = join_path_alloc((const char*)dir->data, name);
+    if (!dest) {
+        mark_item_failed(task, item_index);
+        return false;
+    }
+    struct stat dest_st;
+    bool exists = (lstat(dest, &dest_st) == 0);
+
+    switch (d_type) {
+        case DT_DIR: {
+            bool ok = (exists && S_ISDIR(dest_st.st_mode)) ||
+                      ((!exists || unlink(dest) == 0) && mkdir(dest, 0755) == 0);
+            if (!ok) mark_item_failed(task, item_index);
+            free(dest);
+            return ok;
+        }
+        case DT_REG: {
+            // (크기, 수정 시각)이 같은 파일은 워커에 넘기지 않고 여기서 건너뜀
+            struct stat src_st;
+            if (exists && S_ISREG(dest_st.st_mode) && !task->sync_content &&
+                fstatat(dirfd, name, &src_st, AT_SYMLINK_NOFOLLOW) == 0 &&
+                src_st.st_size == dest_st.st_size && src_st.st_mtime == dest_st.st_mtime) {
+                if ((src_st.st_mode & 07777) != (dest_st.st_mode & 07777)) chmod(dest, src_st.st_mode & 07777);
+                sync_add_progress(task, src_st.st_size);
+                free(dest);
+                return false;
+            }
+            copy_engine_push(engine, join_path_alloc(dir->path, name), dest, item_index);
+            return false;
+        }
+        case DT_LNK:
+            if (!sync_symlink_at(dirfd, name, dest)) mark_item_failed(task, item_index);
+            break;
+        default:
+            break; // 장치 파일, FIFO, 소켓은 복사하지 않음
+    }
+
+    free(dest);
+    return false;
+}
+
+static const WalkOps sync_engine_ops = { sync_engine_enter, sync_engine_visit, copy_engine_leave };
+
+// ---------------- tar 묶기 엔진 ----------------
+// 탐색기(walker)가 찾은 항목을 순서 있는 대기열에 넣고, 읽기 워커들이 앞쪽의 일반 파일을
+// 미리 읽어 두는 동안 쓰기 스레드 하나가 대기열 순서대로 헤더와 내용을 tar 파일에 쓴다.
+// 디렉토리 항목은 그 디렉토리를 읽기 전에 들어가므로 항상 하위 항목보다 앞에 놓인다.
+
+#define PACK_BUFFER_LIMIT (1024 * 1024)        // 이보다 작은 파일은 워커가 내용을 메모리에 미리 읽음
+#define PACK_READAHEAD_BYTES (32 * 1024 * 1024) // 미리 읽어 둔 내용의 합 (큰 파일은 PACK_BUFFER_LIMIT로 셈)
+#define PACK_WRITE_BUFFER (1024 * 1024)        // 헤더와 작은 파일을 모아 쓰는 버퍼
+#define PACK_COPY_RANGE_MIN (64 * 1024)        // 남은 내용이 이만큼 이상이면 copy_file_range
+#define PACK_COPY_CHUNK (8 * 1024 * 1024)      // copy_file_range 한 번의 양 (취소와 진행률 확인 간격)
+
+typedef enum {
+    PACK_ENTRY_WAITING = 0,  // 아직 아무도 읽지 않음
+    PACK_ENTRY_READING,      // 워커(또는 쓰기 스레드)가 여는 중
+    PACK_ENTRY_READY         // 내용을 읽었거나 열어 둠
+} PackEntryState;
+
+// 묶을 항목 하나 (대기열 순서 = tar 안의 순서)
+typedef struct PackEntry {
+    char *path;              // 원본 경로
+    char *name;              // tar 안의 경로 (디렉토리는 끝에 '/')
+    char *link;              // 심볼릭 링크 대상
+    struct stat st;
+    int item_index;          // 어느 작업 항목에 속하는지
+    PackEntryState state;    // 일반 파일만 사용 (lock으로 보호)
+    unsigned char *data;     // 작은 파일: 미리 읽은 내용
+    size_t data_len;
+    int fd;                  // 큰 파일: 열어 둔 파일 (쓰기 스레드가 copy_file_range로 복사)
+    int error;               // 열기/읽기 실패 errno
+    size_t charge;           // 미리 읽기 예산에서 차지하는 양
+    struct PackEntry *next;
+} PackEntry;
+
+typedef struct {
+    Walker walker;
+    CopyTask *task;
+    int *root_items;         // walker 시작 디렉토리 번호 → 작업 항목 번호
+    dev_t out_dev;           // 만드는 tar 파일 자신 (묶는 디렉토리 안에 있으면 건너뜀)
+    ino_t out_ino;
+
+    pthread_mutex_t lock;
+    pthread_cond_t not_full;  // 탐색기: 대기열에 자리가 남
+    pthread_cond_t work;      // 읽기 워커: 새 항목이나 예산이 생김
+    pthread_cond_t ready;     // 쓰기 스레드: 맨 앞 항목이 준비됨
+    PackEntry *head;
+    PackEntry *tail;
+    PackEntry *scan;          // 읽기 워커가 아직 살펴보지 않은 첫 항목
+    int queued;
+    size_t buffered;          // 미리 읽기 예산 사용량
+    bool producer_done;
+    volatile bool abort;      // 쓰기 실패 - 모두 멈춤
+
+    // 쓰기 스레드 전용
+    int out_fd;
+    unsigned char *out_buf;
+    size_t out_used;
+    bool no_copy_range;       // copy_file_range를 쓸 수 없는 조합 (다시 시도하지 않음)
+    bool finished;            // 끝 표시까지 썼음
+    uid_t uname_uid;          // 마지막으로 찾은 사용자/그룹 이름
+    gid_t gname_gid;
+    char uname[32];
+    char gname[32];
+    bool uname_valid;
+    bool gname_valid;
+
+    pthread_t writer;
+    bool writer_started;
+    pthread_t workers[COPY_MAX_WORKERS];
+    int nworkers;
+} PackEngine;
+
+static bool pack_should_stop(PackEngine *engine) {
+    return engine->abort || engine->task->cancel_requested;
+}
+
+// 모든 스레드를 깨워 멈추게 함
+static void pack_engine_abort(PackEngine *engine) {
+    pthread_mutex_lock(&engine->lock);
+    engine->abort = true;
+    pthread_cond_broadcast(&engine->not_full);
+    pthread_cond_broadcast(&engine->work);
+    pthread_cond_broadcast(&engine->ready);
+    pthread_mutex_unlock(&engine->lock);
+}
+
+static void pack_free_entry(PackEntry *entry) {
+    if (entry->fd >= 0) close(entry->fd);
+    free(entry->data);
+    free(entry->path);
+    free(entry->name);
+    free(entry->link);
+    free(entry);
+}
+
+// 대기열 끝에 추가 (path/name/link 소유권을 넘겨받음, 멈춘 뒤면 버리고 false)
+static bool pack_engine_push(PackEngine *engine, char *path, char *name, char *link,
+                             const struct stat *st, int item_index) {
+    PackEntry *entry = calloc(1, sizeof(PackEntry));
+    if (!entry || !path || !name) {
+        free(entry);
+        free(path);
+        free(name);
+        free(link);
+        mark_item_failed(engine->task, item_index);
+        return false;
+    }
+    entry->path = path;
+    entry->name = name;
+    entry->link = link;
+    entry->st = *st;
+    entry->item_index = item_index;
+    entry->fd = -1;
+
+    pthread_mutex_lock(&engine->lock);
+    while (engine->queued >= COPY_QUEUE_LIMIT && !pack_should_stop(engine)) {
+        pthread_cond_wait(&engine->not_full, &engine->lock);
+    }
+    if (pack_should_stop(engine)) {
+        pthread_mutex_unlock(&engine->lock);
+        pack_free_entry(entry);
+        return false;
+    }
+    if (engine->tail) {
+        engine->tail->next = entry;
+    } else {
+        engine->head = entry;
+    }
+    engine->tail = entry;
+    if (!engine->scan) engine->scan = entry;
+    engine->queued++;
+    pthread_cond_broadcast(&engine->work);
+    pthread_cond_signal(&engine->ready);
+    pthread_mutex_unlock(&engine->lock);
+    return true;
+}
+
+// 파일을 열고, 작은 파일이면 내용까지 읽음 (prefetch가 아니면 열기만)
+static void pack_open_entry(PackEntry *entry, bool prefetch) {
+    int fd = open(entry->path, O_RDONLY | O_NOFOLLOW | O_CLOEXEC);
+    if (fd == -1) {
+        entry->error = errno;
+        return;
+    }
+
+    if (!prefetch || entry->st.st_size > PACK_BUFFER_LIMIT) {
+        // 큰 파일은 앞부분만 페이지 캐시로 당겨 두고 쓰기 스레드가 커널 안에서 복사
+        if (prefetch) {
+            posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+            readahead(fd, 0, PACK_BUFFER_LIMIT);
+        }
+        entry->fd = fd;
+        return;
+    }
+
+    // 헤더에 적은 크기보다 커졌는지도 알 수 있게 한 바이트 더 읽음
+    size_t capacity = (size_t)entry->st.st_size + 1;
+    entry->data = malloc(capacity);
+    if (!entry->data) {
+        entry->error = ENOMEM;
+        close(fd);
+        return;
+    }
+    while (entry->data_len < capacity) {
+        ssize_t n = read(fd, entry->data + entry->data_len, capacity - entry->data_len);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            entry->error = errno;
+            break;
+        }
+        if (n == 0) break;
+        entry->data_len += (size_t)n;
+    }
+    close(fd);
+}
+
+// 읽기 워커 - 대기열 앞쪽의 일반 파일을 예산 안에서 미리 읽음
+static void* pack_engine_worker(void *arg) {
+    PackEngine *engine = (PackEngine*)arg;
+
+    while (1) {
+        PackEntry *entry = NULL;
+        pthread_mutex_lock(&engine->lock);
+        while (!pack_should_stop(engine)) {
+            while (engine->scan && (!S_ISREG(engine->scan->st.st_mode) ||
+                                    engine->scan->state != PACK_ENTRY_WAITING)) {
+                engine->scan = engine->scan->next;
+            }
+            if (engine->scan) {
+                off_t size = engine->scan->st.st_size;
+                size_t charge = size < PACK_BUFFER_LIMIT ? (size_t)size : PACK_BUFFER_LIMIT;
+                if (engine->buffered == 0 || engine->buffered + charge <= PACK_READAHEAD_BYTES) {
+                    entry = engine->scan;
+                    entry->state = PACK_ENTRY_READING;
+                    entry->charge = charge;
+                    engine->buffered += charge;
+                    engine->scan = entry->next;
+                    break;
+                }
+            } else if (engine->producer_done) {
+                break;
+            }
+            pthread_cond_wait(&engine->work, &engine->lock);
+        }
+        pthread_mutex_unlock(&engine->lock);
+        if (!entry) break;
+
+        pack_open_entry(entry, true);
+
+        pthread_mutex_lock(&engine->lock);
+        entry->state = PACK_ENTRY_READY;
+        pthread_cond_signal(&engine->ready);
+        pthread_mutex_unlock(&engine->lock);
+    }
+    return NULL;
+}
+
+// 쓰기 버퍼 비우기
+static bool pack_flush(PackEngine *engine) {
+    size_t done = 0;
+    while (done < engine->out_used) {
+        ssize_t n = write(engine->out_fd, engine->out_buf + done, engine->out_used - done);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        done += (size_t)n;
+    }
+    engine->out_used = 0;
+    return true;
+}
+
+// 버퍼에 쓰기 (data가 NULL이면 0으로 채움)
+static bool pack_put(PackEngine *engine, const void *data, size_t len) {
+    const unsigned char *p = (const unsigned char*)data;
+    while (len > 0) {
+        if (engine->out_used == PACK_WRITE_BUFFER && !pack_flush(engine)) return false;
+        size_t n = PACK_WRITE_BUFFER - engine->out_used;
+        if (n > len) n = len;
+        if (p) {
+            memcpy(engine->out_buf + engine->out_used, p, n);
+            p += n;
+        } else {
+            memset(engine->out_buf + engine->out_used, 0, n);
+        }
+        engine->out_used += n;
+        len -= n;
+    }
+    return true;
+}
+
+static void pack_add_progress(CopyTask *task, off_t bytes) {
+    pthread_mutex_lock(&task->progress_mutex);
+    task->copied_size += bytes;
+    pthread_mutex_unlock(&task->progress_mutex);
+}
+
+// 8진수 칸 채우기 (칸에 들어가지 않으면 0을 쓰고 false - 크기는 pax 레코드로 대신함)
+static bool tar_octal(char *field, size_t len, unsigned long long value) {
+    int digits = (int)len - 1;
+    if (digits * 3 < 64 && value >> (digits * 3)) {
+        snprintf(field, len, "%0*o", digits, 0);
+        return false;
+    }
+    snprintf(field, len, "%0*llo", digits, value);
+    return true;
+}
+
+// pax 레코드 하나 추가 ("길이 키=값\n", 길이는 자기 자신의 자릿수 포함)
+static void pax_append(char *buf, size_t *used, const char *key, const char *value) {
+    size_t body = strlen(key) + strlen(value) + 3;
+    size_t total = body + 1;
+    for (int digits = 1; ; digits++) {
+        total = body + digits;
+        int actual = 0;
+        for (size_t n = total; n > 0; n /= 10) actual++;
+        if (actual == digits) break;
+    }
+    *used += (size_t)sprintf(buf + *used, "%zu %s=%s\n", total, key, value);
+}
+
+// ustar 이름 칸에 넣기 - 100바이트를 넘으면 '/'에서 나눠 prefix 칸(155바이트)을 씀
+static bool tar_split_name(const char *name, char *header) {
+    size_t len = strlen(name);
+    if (len <= 100) {
+        memcpy(header, name, len);
+        return true;
+    }
+    size_t start = len - 101;
+    for (size_t i = start; i < len && i <= 155; i++) {
+        if (name[i] == '/' && i > 0 && len - i - 1 > 0) {
+            memcpy(header + 345, name, i);
+            memcpy(header, name + i + 1, len - i - 1);
+            return true;
+        }
+    }
+    return false;
+}
+
+// 사용자/그룹 이름 (바로 앞과 같은 번호면 다시 찾지 않음)
+static void pack_owner_names(PackEngine *engine, const struct stat *st) {
+    if (!engine->uname_valid || engine->uname_uid != st->st_uid) {
+        struct passwd pw, *found = NULL;
+        char buf[1024];
+        engine->uname[0] = '\0';
+        if (getpwuid_r(st->st_uid, &pw, buf, sizeof(buf), &found) == 0 && found) {
+            snprintf(engine->uname, sizeof(engine->uname), "%s", found->pw_name);
+        }
+        engine->uname_uid = st->st_uid;
+        engine->uname_valid = true;
+    }
+    if (!engine->gname_valid || engine->gname_gid != st->st_gid) {
+        struct group gr, *found = NULL;
+        char buf[1024];
+        engine->gname[0] = '\0';
+        if (getgrgid_r(st->st_gid, &gr, buf, sizeof(buf), &found) == 0 && found) {
+            snprintf(engine->gname, sizeof(engine->gname), "%s", found->gr_name);
+        }
+        engine->gname_gid = st->st_gid;
+        engine->gname_valid = true;
+    }
+}
+
+static void tar_checksum(char *header) {
+    memset(header + 148, ' ', 8);
+    unsigned int sum = 0;
+    for (int i = 0; i < 512; i++) sum += (unsigned char)header[i];
+    snprintf(header + 148, 8, "%06o", sum);
+    header[155] = ' ';
+}
+
+// 항목의 헤더 쓰기 (ustar 칸에 들어가지 않는 경로, 링크 대상, 크기는 앞에 pax 헤더로)
+static bool pack_write_header(PackEngine *engine, const PackEntry *entry, off_t size) {
+    char header[512];
+    memset(header, 0, sizeof(header));
+
+    char typeflag = '0';
+    if (S_ISDIR(entry->st.st_mode)) typeflag = '5';
+    else if (S_ISLNK(entry->st.st_mode)) typeflag = '2';
+
+    bool need_path = !tar_split_name(entry->name, header);
+    if (need_path) memcpy(header, entry->name, 100);
+    bool need_link = entry->link && strlen(entry->link) > 100;
+    if (entry->link) memcpy(header + 157, entry->link, need_link ? 100 : strlen(entry->link));
+
+    tar_octal(header + 100, 8, entry->st.st_mode & 07777);
+    tar_octal(header + 108, 8, entry->st.st_uid);
+    tar_octal(header + 116, 8, entry->st.st_gid);
+    bool need_size = !tar_octal(header + 124, 12, (unsigned long long)size);
+    tar_octal(header + 136, 12, entry->st.st_mtime > 0 ? (unsigned long long)entry->st.st_mtime : 0);
+    header[156] = typeflag;
+    memcpy(header + 257, "ustar", 6);
+    memcpy(header + 263, "00", 2);
+    pack_owner_names(engine, &entry->st);
+    memcpy(header + 265, engine->uname, strnlen(engine->uname, 31));
+    memcpy(header + 297, engine->gname, strnlen(engine->gname, 31));
+    tar_checksum(header);
+
+    if (need_path || need_link || need_size) {
+        size_t capacity = strlen(entry->name) + (entry->link ? strlen(entry->link) : 0) + 96;
+        char *records = malloc(capacity);
+        if (!records) return false;
+        size_t used = 0;
+        if (need_path) pax_append(records, &used, "path", entry->name);
+        if (need_link) pax_append(records, &used, "linkpath", entry->link);
+        if (need_size) {
+            char value[32];
+            snprintf(value, sizeof(value), "%lld", (long long)size);
+            pax_append(records, &used, "size", value);
+        }
+
+        char pax[512];
+        memset(pax, 0, sizeof(pax));
+        snprintf(pax, 100, "././@PaxHeader");
+        tar_octal(pax + 100, 8, 0644);
+        tar_octal(pax + 108, 8, 0);
+        tar_octal(pax + 116, 8, 0);
+        tar_octal(pax + 124, 12, used);
+        tar_octal(pax + 136, 12, 0);
+        pax[156] = 'x';
+        memcpy(pax + 257, "ustar", 6);
+        memcpy(pax + 263, "00", 2);
+        tar_checksum(pax);
+
+        bool ok = pack_put(engine, pax, sizeof(pax)) && pack_put(engine, records, used) &&
+                  pack_put(engine, NULL, (512 - used % 512) % 512);
+        free(records);
+        if (!ok) return false;
+    }
+    return pack_put(engine, header, sizeof(header));
+}
+
+// 열어 둔 파일의 내용 쓰기 - 커널이 허용하면 copy_file_range, 아니면 쓰기 버퍼로 읽음
+// 반환: 쓴 내용의 길이 (파일이 줄었으면 size보다 작음), 쓰기 실패면 -1
+static off_t pack_copy_fd(PackEngine *engine, int fd, off_t size) {
+    CopyTask *task = engine->task;
+    off_t done = 0;
+
+    while (done < size && !task->cancel_requested) {
+        off_t remaining = size - done;
+        if (!engine->no_copy_range && remaining >= PACK_COPY_RANGE_MIN) {
+            if (!pack_flush(engine)) return -1;
+            loff_t in_offset = done;
+            size_t chunk = remaining > PACK_COPY_CHUNK ? PACK_COPY_CHUNK : (size_t)remaining;
+            ssize_t n = copy_file_range(fd, &in_offset, engine->out_fd, NULL, chunk, 0);
+            if (n > 0) {
+                done += n;
+                pack_add_progress(task, n);
+                continue;
+            }
+            if (n == 0) break;
+            if (errno == EINTR) continue;
+            if (errno != EXDEV && errno != EINVAL && errno != ENOSYS && errno != EOPNOTSUPP &&
+                errno != EBADF) {
+                break; // 원본 읽기 실패
+            }
+            engine->no_copy_range = true;
+        }
+
+        if (engine->out_used == PACK_WRITE_BUFFER && !pack_flush(engine)) return -1;
+        size_t space = PACK_WRITE_BUFFER - engine->out_used;
+        if ((off_t)space > remaining) space = (size_t)remaining;
+        ssize_t n = pread(fd, engine->out_buf + engine->out_used, space, done);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) break;
+        engine->out_used += (size_t)n;
+        done += n;
+        pack_add_progress(task, n);
+    }
+    return done;
+}
+
+// 항목 하나 쓰기 (false면 tar 파일 쓰기 실패)
+static bool pack_write_entry(PackEngine *engine, PackEntry *entry) {
+    CopyTask *task = engine->task;
+
+    if (!S_ISREG(entry->st.st_mode)) {
+        return pack_write_header(engine, entry, 0);
+    }
+
+    // 열 수 없는 파일은 헤더도 쓰지 않고 건너뜀
+    if (entry->error && !entry->data) {
+        mark_item_failed(task, entry->item_index);
+        return true;
+    }
+
+    off_t size = entry->st.st_size;
+    if (!pack_write_header(engine, entry, size)) return false;
+
+    off_t written;
+    bool changed;
+    if (entry->data) {
+        written = (off_t)entry->data_len < size ? (off_t)entry->data_len : size;
+        if (!pack_put(engine, entry->data, (size_t)written)) return false;
+        pack_add_progress(task, written);
+        changed = (off_t)entry->data_len != size || entry->error;
+    } else {
+        written = pack_copy_fd(engine, entry->fd, size);
+        if (written < 0) return false;
+        char probe;
+        changed = written < size || pread(entry->fd, &probe, 1, size) > 0;
+    }
+
+    // 읽는 동안 바뀐 파일은 헤더의 크기에 맞춰 0으로 채우고 실패로 셈 (tar 구조는 유지)
+    if (changed && !task->cancel_requested) mark_item_failed(task, entry->item_index);
+    if (written < size && !pack_put(engine, NULL, (size_t)(size - written))) return false;
+    return pack_put(engine, NULL, (size_t)((512 - size % 512) % 512));
+}
+
+// 쓰기 스레드 - 대기열 맨 앞 항목이 준비되는 대로 순서대로 씀
+static void* pack_engine_writer(void *arg) {
+    PackEngine *engine = (PackEngine*)arg;
+
+    while (1) {
+        pthread_mutex_lock(&engine->lock);
+        PackEntry *entry = NULL;
+        while (!pack_should_stop(engine)) {
+            entry = engine->head;
+            if (!entry) {
+                if (engine->producer_done) break;
+            } else if (!S_ISREG(entry->st.st_mode) || entry->state != PACK_ENTRY_READING) {
+                break;
+            }
+            entry = NULL;
+            pthread_cond_wait(&engine->ready, &engine->lock);
+        }
+        if (!entry) {
+            pthread_mutex_unlock(&engine->lock);
+            break;
+        }
+
+        // 워커가 아직 잡지 않은 파일이면 기다리지 않고 직접 엶
+        bool claim = S_ISREG(entry->st.st_mode) && entry->state == PACK_ENTRY_WAITING;
+        if (claim) entry->state = PACK_ENTRY_READING;
+        engine->head = entry->next;
+        if (!engine->head) engine->tail = NULL;
+        if (engine->scan == entry) engine->scan = entry->next;
+        engine->queued--;
+        pthread_cond_signal(&engine->not_full);
+        pthread_mutex_unlock(&engine->lock);
+
+        if (claim) pack_open_entry(entry, false);
+        bool ok = pack_write_entry(engine, entry);
+
+        pthread_mutex_lock(&engine->lock);
+        engine->buffered -= entry->charge;
+        pthread_cond_broadcast(&engine->work);
+        pthread_mutex_unlock(&engine->lock);
+        pack_free_entry(entry);
+
+        if (!ok) {
+            pack_engine_abort(engine);
+            return NULL;
+        }
+    }
+
+    // 끝 표시 (0으로 채운 블록 두 개)
+    if (!pack_should_stop(engine)) {
+        if (pack_put(engine, NULL, 1024) && pack_flush(engine)) {
+            engine->finished = true;
+        } else {
+            pack_engine_abort(engine);
+        }
+    }
+    return NULL;
+}
+
+// 심볼릭 링크 대상 읽기 (동적 할당)
+static char* read_link_alloc(int dirfd, const char *name, off_t size_hint) {
+    size_t size = size_hint > 0 ? (size_t)size_hint + 1 : MAX_PATH_LEN;
+    char *target = malloc(size);
+    if (!target) return NULL;
+    ssize_t len = readlinkat(dirfd, name, target, size - 1);
+    if (len < 0) {
+        free(target);
+        return NULL;
+    }
+    target[len] = '\0';
+    return target;
+}
+
+// tar 안의 경로 ("상위/이름", 디렉토리는 끝에 '/')
+static char* pack_member_name(const char *prefix, const char *name, bool directory) {
+    size_t prefix_len = prefix ? strlen(prefix) : 0;
+    size_t name_len = strlen(name);
+    char *member = malloc(prefix_len + name_len + 3);
+    if (!member) return NULL;
+    size_t pos = 0;
+    if (prefix_len > 0) {
+        memcpy(member, prefix, prefix_len);
+        pos = prefix_len;
+        member[pos++] = '/';
+    }
+    memcpy(member + pos, name, name_len);
+    pos += name_len;
+    if (directory) member[pos++] = '/';
+    member[pos] = '\0';
+    return member;
+}
+
+// 시작 디렉토리의 tar 안 경로를 기억 (하위 디렉토리는 visit에서 child_data로 넘김)
+static bool pack_engine_enter(Walker *w, WalkDir *dir, int dirfd) {
+    (void)dirfd;
+    PackEngine *engine = (PackEngine*)w->user;
+    if (dir->depth == 0) {
+        dir->data = strdup(engine->task->items[engine->root_items[dir->root_index]].name);
+    }
+    return dir->data != NULL;
+}
+
+// 엔트리마다 대기열에 추가 (장치 파일, FIFO, 소켓은 넣지 않음)
+static bool pack_engine_visit(Walker *w, WalkDir *dir, int dirfd, const char *name,
+                              unsigned char d_type, const struct stat *st) {
+    (void)d_type;
+    PackEngine *engine = (PackEngine*)w->user;
+    int item_index = engine->root_items[dir->root_index];
+
+    if (pack_should_stop(engine)) {
+        walker_cancel(w);
+        return false;
+    }
+    if (!st || !(S_ISDIR(st->st_mode) || S_ISREG(st->st_mode) || S_ISLNK(st->st_mode))) return false;
+    if (st->st_dev == engine->out_dev && st->st_ino == engine->out_ino) return false;
+
+    bool directory = S_ISDIR(st->st_mode);
+    char *link = NULL;
+    if (S_ISLNK(st->st_mode)) {
+        link = read_link_alloc(dirfd, name, st->st_size);
+        if (!link) {
+            mark_item_failed(engine->task, item_index);
+            return false;
+        }
+    }
+    if (directory) {
+        dir->child_data = pack_member_name((const char*)dir->data, name, false);
+        if (!dir->child_data) {
+            free(link);
+            mark_item_failed(engine->task, item_index);
+            return false;
+        }
+    }
+
+    bool pushed = pack_engine_push(engine, join_path_alloc(dir->path, name),
+                                   pack_member_name((const char*)dir->data, name, directory), link, st, item_index);
+    if (directory && !pushed) {
+        free(dir->child_data);
+        dir->child_data = NULL;
+    }
+    return directory && pushed;
+}
+
+static void pack_engine_leave(Walker *w, WalkDir *dir) {
+    (void)w;
+    free(dir->data);
+    dir->data = NULL;
+}
+
+// 작업 항목들을 out_fd에 tar로 묶음 (끝 표시까지 썼으면 true)
+static bool run_pack_engine(CopyTask *task, int out_fd) {
+    static const WalkOps ops = { pack_engine_enter, pack_engine_visit, pack_engine_leave };
+
+    PackEngine engine;
+    memset(&engine, 0, sizeof(engine));
+    engine.task = task;
+    engine.out_fd = out_fd;
+    struct stat out_st;
+    if (fstat(out_fd, &out_st) == 0) {
+        engine.out_dev = out_st.st_dev;
+        engine.out_ino = out_st.st_ino;
+    }
+
+    const char **roots = malloc(sizeof(char*) * task->item_count);
+    char **root_paths = malloc(sizeof(char*) * task->item_count);
+    engine.root_items = malloc(sizeof(int) * task->item_count);
+    engine.out_buf = malloc(PACK_WRITE_BUFFER);
+    if (!roots || !root_paths || !engine.root_items || !engine.out_buf) {
+        free(roots);
+        free(root_paths);
+        free(engine.root_items);
+        free(engine.out_buf);
+        return false;
+    }
+    pthread_mutex_init(&engine.lock, NULL);
+    pthread_cond_init(&engine.not_full, NULL);
+    pthread_cond_init(&engine.work, NULL);
+    pthread_cond_init(&engine.ready, NULL);
+
+    engine.writer_started = (pthread_create(&engine.writer, NULL, pack_engine_writer, &engine) == 0);
+    int nworkers = walker_default_threads();
+    if (nworkers > COPY_MAX_WORKERS) nworkers = COPY_MAX_WORKERS;
+    for (int i = 0; i < nworkers && engine.writer_started; i++) {
+        if (pthread_create(&engine.workers[engine.nworkers], NULL, pack_engine_worker, &engine) == 0) {
+            engine.nworkers++;
+        }
+    }
+
+    // 최상위 항목은 선택한 순서대로 (심볼릭 링크는 따라가지 않고 링크로), 디렉토리는 탐색 시작점으로
+    int nroots = 0;
+    for (int i = 0; i < task->item_count && engine.writer_started && !pack_should_stop(&engine); i++) {
+        TaskItem *item = &task->items[i];
+        char *src = join_path_alloc(task->source_dir, item->name);
+        struct stat st;
+        if (!src || lstat(src, &st) == -1) {
+            free(src);
+            mark_item_failed(task, i);
+            continue;
+        }
+        if (!(S_ISDIR(st.st_mode) || S_ISREG(st.st_mode) || S_ISLNK(st.st_mode))) {
+            free(src);
+            continue;
+        }
+
+        char *link = NULL;
+        if (S_ISLNK(st.st_mode) && !(link = read_link_alloc(AT_FDCWD, src, st.st_size))) {
+            free(src);
+            mark_item_failed(task, i);
+            continue;
+        }
+        if (S_ISDIR(st.st_mode)) {
+            root_paths[nroots] = strdup(src);
+            if (!root_paths[nroots]) {
+                free(src);
+                mark_item_failed(task, i);
+                continue;
+            }
+            roots[nroots] = root_paths[nroots];
+            engine.root_items[nroots] = i;
+            nroots++;
+        }
+        pack_engine_push(&engine, src, pack_member_name(NULL, item->name, S_ISDIR(st.st_mode)), link, &st, i);
+    }
+
+    if (nroots > 0 && !pack_should_stop(&engine)) {
+        walker_init(&engine.walker, &ops, &engine);
+        if (walker_start_multi(&engine.walker, roots, nroots)) {
+            walker_wait(&engine.walker);
+        }
+        walker_destroy(&engine.walker);
+    }
+
+    // 더 들어올 항목이 없음 - 쓰기 스레드가 대기열을 비우고 끝 표시를 씀
+    pthread_mutex_lock(&engine.lock);
+    engine.producer_done = true;
+    pthread_cond_broadcast(&engine.work);
+    pthread_cond_broadcast(&engine.ready);
+    pthread_mutex_unlock(&engine.lock);
+
+    if (engine.writer_started) pthread_join(engine.writer, NULL);
+    pack_engine_abort(&engine); // 쓰기가 끝났으니 남은 워커는 더 읽지 않음
+    for (int i = 0; i < engine.nworkers; i++) {
+        pthread_join(engine.workers[i], NULL);
+    }
+
+    // 취소나 실패로 남은 항목 정리
+    while (engine.head) {
+        PackEntry *next = engine.head->next;
+        pack_free_entry(engine.head);
+        engine.head = next;
+    }
+
+    bool finished = engine.finished && !task->cancel_requested;
+    for (int i = 0; i < nroots; i++) {
+        free(root_paths[i]);
+    }
+    free(roots);
+    free(root_paths);
+    free(engine.root_items);
+    free(engine.out_buf);
+    pthread_mutex_destroy(&engine.lock);
+    pthread_cond_destroy(&engine.not_full);
+    pthread_cond_destroy(&engine.work);
+    pthread_cond_destroy(&engine.ready);
+    return finished;
+}
+
+// ---------------- 작업 스레드 ----------------
+
+// 대상 이름을 정하고 빈 파일/디렉토리를 미리 만들어 둠 (목록에 바로 보이고 이름 충돌도 막음)
+static bool reserve_destination(CopyTask *task, int item_index) {
+    TaskItem *item = &task->items[item_index];
+    char name[MAX_NAME_LEN];
+    char path[MAX_PATH_LEN];
+
+    for (int attempt = 0; attempt < 8; attempt++) {
+        generate_unique_name_r(task->dest_dir, item->name, name, sizeof(name));
+        join_path(path, sizeof(path), task->dest_dir, name);
+
+        int result;
+        if (item->is_directory) {
+            result = mkdir(path, 0755);
+        } else {
+            int fd = open(path, O_CREAT | O_EXCL | O_WRONLY, 0644);
+            result = (fd >= 0) ? close(fd) : -1;
+        }
+
+        if (result == 0) {
+            pthread_mutex_lock(&task->progress_mutex);
+            strcpy(item->dest_name, name);
+            item->created = true;
+            pthread_mutex_unlock(&task->progress_mutex);
+
+            if (task->item_count == 1) {
+                strcpy(task->dest_path, path);
+                strcpy(task->dest_name, name);
+            }
+            return true;
+        }
+        if (errno != EEXIST) {
+            return false;
+        }
+    }
+    return false;
+}
+
+// 백그라운드 복사/이동 스레드 함수
+void* copy_thread_func(void* arg) {
+    CopyTask* task = (CopyTask*)arg;
+    bool has_slot = acquire_task_slot(task);
+
+    // 1) 이동: 같은 파일시스템에 있는 항목은 rename 한 번으로 끝냄
+    if (task->type == TASK_TYPE_MOVE) {
+        for (int i = 0; i < task->item_count && !task->cancel_requested; i++) {
+            TaskItem *item = &task->items[i];
+            if (item->created) continue; // 이미 rename이 EXDEV로 실패해 예약된 항목
+
+            char src[MAX_PATH_LEN];
+            char moved_name[MAX_NAME_LEN];
+            join_path(src, sizeof(src), task->source_dir, item->name);
+            int result = move_by_rename(src, task->dest_dir, item->name, moved_name, sizeof(moved_name));
+
+            pthread_mutex_lock(&task->progress_mutex);
+            if (result == 0) {
+                strcpy(item->dest_name, moved_name);
+                item->done = true;
+            } else if (result != EXDEV) {
+                item->failed = true;
+                task->failed_count++;
+            }
+            pthread_mutex_unlock(&task->progress_mutex);
+        }
+    }
+
+    // 2) 남은 항목의 대상 자리 확보
+    for (int i = 0; i < task->item_count && !task->cancel_requested; i++) {
+        TaskItem *item = &task->items[i];
+        if (item->done || item->failed || item->created) continue;
+        if (!reserve_destination(task, i)) {
+            mark_item_failed(task, i);
+        }
+    }
+
+    // 3) 전체 크기 계산과 병렬 복사를 동시에 진행
+    TaskSizeRun size_run;
+    task_size_start(&size_run, task);
+    run_copy_engine(task, &copy_engine_ops, copy_file_sync_with_progress);
+    // 이동 작업은 삭제 단계 진행률에 항목 수가 필요하므로 끝까지 기다림
+    task_size_finish(&size_run, task->type == TASK_TYPE_MOVE && !task->cancel_requested);
+
+    // 4) 취소되었거나 실패한 항목의 (불완전한) 대상 삭제
+    for (int i = 0; i < task->item_count; i++) {
+        TaskItem *item = &task->items[i];
+        if (item->created && !item->done && (task->cancel_requested || item->failed)) {
+            char dest[MAX_PATH_LEN];
+            join_path(dest, sizeof(dest), task->dest_dir, item->dest_name);
+            delete_path_with_progress(dest, NULL);
+        }
+    }
+
+    // 5) 이동 작업이면 복사가 끝난 항목들의 원본 삭제 단계로 진행
+    if (task->type == TASK_TYPE_MOVE && !task->cancel_requested) {
+        pthread_mutex_lock(&task->progress_mutex);
+        task->phase = TASK_PHASE_DELETE;
+        task->files_done = 0;
+        pthread_mutex_unlock(&task->progress_mutex);
+        notify_ui();
+
+        run_delete_items(task, task->source_dir);
+    }
+
+    if (has_slot) release_task_slot();
+
+    // 작업 완료 표시 후 UI가 바로 정리하도록 알림
+    task->is_running = false;
+    notify_ui();
+
+    return NULL;
+}
+
+// 백그라운드 삭제 스레드 함수
+static void* delete_thread_func(void* arg) {
+    CopyTask* task = (CopyTask*)arg;
+    if (!acquire_task_slot(task)) {
+        // 시작 전에 취소됨 - 아무것도 지우지 않음
+        task->is_running = false;
+        notify_ui();
+        return NULL;
+    }
+
+    // 전체 항목 수는 크기 캐시에 있을 때만 미리 알 수 있음 (마지막 계산 값이라 진행률 추정에만 사용)
+    long total = 0;
+    for (int i = 0; i < task->item_count && total >= 0; i++) {
+        char path[MAX_PATH_LEN];
+        struct stat st;
+        off_t size;
+        long entries;
+        join_path(path, sizeof(path), task->source_dir, task->items[i].name);
+        if (lstat(path, &st) == -1) continue;
+        if (!S_ISDIR(st.st_mode)) {
+            total++;
+        } else if (lookup_cached_directory_size(&st, &size, &entries)) {
+            total += entries + 1;
+        } else {
+            total = -1;
+        }
+    }
+    pthread_mutex_lock(&task->progress_mutex);
+    task->files_total = total;
+    pthread_mutex_unlock(&task->progress_mutex);
+
+    run_delete_items(task, task->source_dir);
+
+    release_task_slot();
+    task->is_running = false;
+    notify_ui();
+    return NULL;
+}
+
+// 백그라운드 동기화 스레드 함수 (대상 이름은 원본과 같고, 실패하거나 취소되어도 대상은 지우지 않음)
+static void* sync_thread_func(void* arg) {
+    CopyTask* task = (CopyTask*)arg;
+    if (!acquire_task_slot(task)) {
+        task->is_running = false;
+        notify_ui();
+        return NULL;
+    }
+
+    // 최상위 디렉토리는 대상에 같은 이름의 디렉토리를 맞춰 둠 (파일은 워커가 비교)
+    for (int i = 0; i < task->item_count && !task->cancel_requested; i++) {
+        TaskItem *item = &task->items[i];
+        char dest[MAX_PATH_LEN];
+        struct stat st;
+        join_path(dest, sizeof(dest), task->dest_dir, item->name);
+        if (item->is_directory) {
+            bool exists = (lstat(dest, &st) == 0);
+            bool ok = (exists && S_ISDIR(st.st_mode)) ||
+                      ((!exists || delete_path_with_progress(dest, NULL)) && mkdir(dest, 0755) == 0);
+            if (!ok) {
+                mark_item_failed(task, i);
+                continue;
+            }
+        }
+        pthread_mutex_lock(&task->progress_mutex);
+        snprintf(item->dest_name, sizeof(item->dest_name), "%s", item->name);
+        item->created = true;
+        pthread_mutex_unlock(&task->progress_mutex);
+    }
+
+    TaskSizeRun size_run;
+    task_size_start(&size_run, task);
+    run_copy_engine(task, &sync_engine_ops, sync_file_with_progress);
+    task_size_finish(&size_run, false);
+
+    release_task_slot();
+    task->is_running = false;
+    notify_ui();
+    return NULL;
+}
+
+// tar 파일 자리 확보 (이름이 겹치면 고유한 이름) - 열린 파일 반환, 실패하면 -1
+static int reserve_pack_output(CopyTask *task) {
+    char name[MAX_NAME_LEN];
+    char path[MAX_PATH_LEN];
+
+    for (int attempt = 0; attempt < 8; attempt++) {
+        generate_unique_name_r(task->dest_dir, task->dest_name, name, sizeof(name));
+        join_path(path, sizeof(path), task->dest_dir, name);
+
+        int fd = open(path, O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC, 0644);
+        if (fd >= 0) {
+            strcpy(task->dest_path, path);
+            strcpy(task->dest_name, name);
+            return fd;
+        }
+        if (errno != EEXIST) {
+            return -1;
+        }
+    }
+    return -1;
+}
+
+// 백그라운드 tar 묶기 스레드 함수
+static void* pack_thread_func(void* arg) {
+    CopyTask* task = (CopyTask*)arg;
+    if (!acquire_task_slot(task)) {
+        // 시작 전에 취소됨 - 아무것도 만들지 않음
+        task->is_running = false;
+        notify_ui();
+        return NULL;
+    }
+
+    int out_fd = reserve_pack_output(task);
+    if (out_fd == -1) {
+        mark_item_failed(task, -1);
+    } else {
+        // 전체 크기 계산과 묶기를 동시에 진행
+        TaskSizeRun size_run;
+        task_size_start(&size_run, task);
+        bool finished = run_pack_engine(task, out_fd);
+        task_size_finish(&size_run, false);
+
+        // 취소되었거나 쓰지 못한 (불완전한) tar 파일은 남기지 않음
+        if (close(out_fd) != 0) finished = false;
+        if (!finished) {
+            unlink(task->dest_path);
+            if (!task->cancel_requested) mark_item_failed(task, -1);
+        }
+    }
+
+    release_task_slot();
+    task->is_running = false;
+    notify_ui();
+    return NULL;
+}
+
+// 작업 생성 (항목 이름은 복사해서 보관)
+static CopyTask* create_task(TaskType type, const char *source_dir, const char *const *names,
+                             int count, const char *dest_dir) {
+    CopyTask *task = calloc(1, sizeof(CopyTask));
+    if (!task) return NULL;
+
+    task->items = calloc(count, sizeof(TaskItem));
+    if (!task->items || pthread_mutex_init(&task->progress_mutex, NULL) != 0) {
+        free(task->items);
+        free(task);
+        return NULL;
+    }
+    task->item_count = count;
+
+    for (int i = 0; i < count; i++) {
+        task->items[i].name = strdup(names[i]);
+        if (!task->items[i].name) {
+            task->item_count = i;
+            free_task(task);
+            return NULL;
+        }
+
+        char path[MAX_PATH_LEN];
+        struct stat st;
+        join_path(path, sizeof(path), source_dir, names[i]);
+        task->items[i].is_directory = (stat(path, &st) == 0 && S_ISDIR(st.st_mode));
+    }
+
+    task->type = type;
+    task->phase = (type == TASK_TYPE_DELETE) ? TASK_PHASE_DELETE : TASK_PHASE_COPY;
+    task->total_size = -1;
+    task->files_total = -1;
+    strncpy(task->source_dir, source_dir, sizeof(task->source_dir) - 1);
+    if (dest_dir) {
+        strncpy(task->dest_dir, dest_dir, sizeof(task->dest_dir) - 1);
+    }
+
+    if (count == 1) {
+        join_path(task->source_path, sizeof(task->source_path), source_dir, names[0]);
+        strncpy(task->dest_name, names[0], sizeof(task->dest_name) - 1);
+        task->is_directory = task->items[0].is_directory;
+    } else {
+        snprintf(task->dest_name, sizeof(task->dest_name), "%d개 항목", count);
+    }
+    return task;
+}
+
+// 작업 스레드를 시작하고 작업 목록에 추가
+static bool launch_task(CopyTask *task, void *(*thread_func)(void*)) {
+    task->is_running = true;
+
+    // 실행 대기열 끝에 추가 (앞선 작업이 많으면 스레드가 차례를 기다림)
+    pthread_mutex_lock(&g_slot_mutex);
+    CopyTask **tail = &g_slot_queue;
+    while (*tail) tail = &(*tail)->queue_next;
+    *tail = task;
+    task->is_queued = (tail != &g_slot_queue ||
+                       (g_max_active_tasks > 0 && g_active_tasks >= g_max_active_tasks));
+    pthread_mutex_unlock(&g_slot_mutex);
+
+    if (pthread_create(&task->thread_id, NULL, thread_func, task) != 0) {
+        pthread_mutex_lock(&g_slot_mutex);
+        for (CopyTask **link = &g_slot_queue; *link; link = &(*link)->queue_next) {
+            if (*link == task) {
+                *link = task->queue_next;
+                break;
+            }
+        }
+        pthread_cond_broadcast(&g_slot_cond);
+        pthread_mutex_unlock(&g_slot_mutex);
+        return false;
+    }
+
+    static unsigned int next_task_id = 0;
+    pthread_mutex_lock(&g_tasks_mutex);
+    task->id = ++next_task_id;
+    task->next = g_copy_tasks;
+    g_copy_tasks = task;
+    pthread_mutex_unlock(&g_tasks_mutex);
+    return true;
+}
+
+// 번호로 실행 중인 작업 찾기
+CopyTask* find_running_task(unsigned int id) {
+    for (CopyTask* current = g_copy_tasks; current; current = current->next) {
+        if (current->id == id && current->is_running) {
+            return current;
+        }
+    }
+    return NULL;
+}
+
+// 특정 파일이 복사 중인지 확인
+bool is_copying_file(const char *file_path) {
+    pthread_mutex_lock(&g_tasks_mutex);
+
+    CopyTask* current = g_copy_tasks;
+    while (current) {
+        if (current->is_running) {
             if (strcmp(current->dest_path, file_path) == 0) {
                 pthread_mutex_unlock(&g_tasks_mutex);
                 return true;
@@ -627,6 +3352,12 @@ bool is_copying_file(const char *file_path) {
     return false;
 }
 
+static int compare_entry_names(const void *a, const void *b) {
+    const FileEntry *fa = *(const FileEntry* const*)a;
+    const FileEntry *fb = *(const FileEntry* const*)b;
+    return strcmp(fa->name, fb->name);
+}
+
 // 파일 목록의 복사 상태 업데이트
 void update_file_copy_status(FileEntry *files, int file_count, const char *current_path) {
     pthread_mutex_lock(&g_tasks_mutex);
@@ -637,94 +3368,206 @@ void update_file_copy_status(FileEntry *files, int file_count, const char *curre
         files[i].original_size = 0;
     }
 
+    if (!g_copy_tasks || file_count <= 0) {
+        pthread_mutex_unlock(&g_tasks_mutex);
+        return;
+    }
+
+    // 일괄 작업 항목을 빨리 찾도록 이름순 색인 생성
+    FileEntry **sorted = malloc(sizeof(FileEntry*) * file_count);
+    if (!sorted) {
+        pthread_mutex_unlock(&g_tasks_mutex);
+        return;
+    }
+    for (int i = 0; i < file_count; i++) {
+        sorted[i] = &files[i];
+    }
+    qsort(sorted, file_count, sizeof(FileEntry*), compare_entry_names);
+
     // 실행 중인 작업들과 비교
-    CopyTask* current = g_copy_tasks;
-    while (current) {
-        if (current->is_running) {
-            // 현재 디렉토리에 있는 파일인지 확인
-            char task_dir[MAX_PATH_LEN];
-            strcpy(task_dir, current->dest_path);
-            char *last_slash = strrchr(task_dir, '/');
-            if (last_slash) {
-                *last_slash = '\0';  // 디렉토리 부분만 남김
-
-                // 현재 디렉토리와 일치하는지 확인
-                if (strcmp(task_dir, current_path) == 0) {
-                    char *task_filename = last_slash + 1;
-
-                    // 파일 목록에서 해당 파일 찾기
-                    for (int i = 0; i < file_count; i++) {
-                        if (strcmp(files[i].name, task_filename) == 0) {
-                            files[i].copy_status = COPY_STATUS_IN_PROGRESS;
-                            files[i].original_size = current->total_size;
-                            
-                            // 복사 중인 파일은 원본 크기로 표시
-                            if (current->is_directory) {
-                                strncpy(files[i].size, "-", sizeof(files[i].size));
-                            } else {
-                                format_size(current->total_size, files[i].size, sizeof(files[i].size));
-                            }
-                            break;
-                        }
-                    }
+    for (CopyTask* current = g_copy_tasks; current; current = current->next) {
+        if (!current->is_running) continue;
+
+        // 복사/이동은 대상 디렉토리, 삭제는 원본 디렉토리에서 표시
+        bool deleting = (current->type == TASK_TYPE_DELETE);
+        const char *task_dir = deleting ? current->source_dir : current->dest_dir;
+        if (strcmp(task_dir, current_path) != 0) continue;
+
+        // 묶기는 만들고 있는 tar 파일 하나만
+        if (current->type == TASK_TYPE_PACK) {
+            FileEntry key_entry;
+            FileEntry *key = &key_entry;
+            snprintf(key_entry.name, sizeof(key_entry.name), "%s", current->dest_name);
+            FileEntry **found = bsearch(&key, sorted, file_count, sizeof(FileEntry*), compare_entry_names);
+            if (found) (*found)->copy_status = COPY_STATUS_IN_PROGRESS;
+            continue;
+        }
+
+        pthread_mutex_lock(&current->progress_mutex);
+        off_t total_size = current->total_size;
+        for (int i = 0; i < current->item_count; i++) {
+            TaskItem *item = &current->items[i];
+            const char *name = deleting ? item->name : item->dest_name;
+            if (item->done || name[0] == '\0') continue;
+
+            FileEntry key_entry;
+            FileEntry *key = &key_entry;
+            strncpy(key_entry.name, name, sizeof(key_entry.name) - 1);
+            key_entry.name[sizeof(key_entry.name) - 1] = '\0';
+            FileEntry **found = bsearch(&key, sorted, file_count, sizeof(FileEntry*), compare_entry_names);
+            if (!found) continue;
+
+            (*found)->copy_status = COPY_STATUS_IN_PROGRESS;
+
+            // 단일 항목 복사 중인 파일은 원본 크기로 표시 (디렉토리는 계산이 끝난 뒤부터)
+            if (!deleting && current->item_count == 1) {
+                (*found)->original_size = total_size;
+                if (total_size < 0) {
+                    strncpy((*found)->size, "-", sizeof((*found)->size));
+                } else {
+                    format_size(total_size, (*found)->size, sizeof((*found)->size));
                 }
             }
         }
-        current = current->next;
+        pthread_mutex_unlock(&current->progress_mutex);
     }
 
+    free(sorted);
     pthread_mutex_unlock(&g_tasks_mutex);
 }
 
-// 클립보드에 복사
-bool copy_to_clipboard(const char *file_path) {
-    // ".." 복사 방지 - basename 문제 해결
-    const char *last_slash = strrchr(file_path, '/');
-    const char *filename;
-    if (last_slash) {
-        filename = last_slash + 1;
-    } else {
-        filename = file_path;
-    }
-    
-    if (strcmp(filename, "..") == 0) {
-        return false;
-    }
-    
-    pthread_mutex_lock(&g_clipboard_mutex);
-
+// 클립보드에 여러 항목 저장 (cut이면 붙여넣기 시 원본을 옮김)
+static bool set_clipboard_items(const char *source_dir, const char *const *names, int count, bool cut) {
     // 절대 경로로 변환
-    char abs_path[MAX_PATH_LEN];
-    if (file_path[0] != '/') {
+    char abs_dir[MAX_PATH_LEN];
+    if (source_dir[0] != '/') {
         char cwd[MAX_PATH_LEN];
-        if (getcwd(cwd, sizeof(cwd))) {
-            snprintf(abs_path, sizeof(abs_path), "%s/%s", cwd, file_path);
-        } else {
-            pthread_mutex_unlock(&g_clipboard_mutex);
+        if (!getcwd(cwd, sizeof(cwd))) {
             return false;
         }
+        join_path(abs_dir, sizeof(abs_dir), cwd, source_dir);
     } else {
-        strncpy(abs_path, file_path, sizeof(abs_path) - 1);
-        abs_path[sizeof(abs_path) - 1] = '\0';
+        strncpy(abs_dir, source_dir, sizeof(abs_dir) - 1);
+        abs_dir[sizeof(abs_dir) - 1] = '\0';
     }
 
-    // 파일/디렉토리 존재 확인
-    struct stat st;
-    if (stat(abs_path, &st) == -1) {
-        pthread_mutex_unlock(&g_clipboard_mutex);
+    char **valid_names = malloc(sizeof(char*) * (count > 0 ? count : 1));
+    if (!valid_names) return false;
+
+    // ".." 복사 방지 및 파일/디렉토리 존재 확인
+    int valid_count = 0;
+    bool first_is_directory = false;
+    for (int i = 0; i < count; i++) {
+        if (strcmp(names[i], "..") == 0 || strcmp(names[i], ".") == 0) {
+            continue;
+        }
+        char path[MAX_PATH_LEN];
+        struct stat st;
+        join_path(path, sizeof(path), abs_dir, names[i]);
+        if (stat(path, &st) == -1) {
+            continue;
+        }
+        valid_names[valid_count] = strdup(names[i]);
+        if (!valid_names[valid_count]) continue;
+        if (valid_count == 0) {
+            first_is_directory = S_ISDIR(st.st_mode);
+        }
+        valid_count++;
+    }
+
+    if (valid_count == 0) {
+        free(valid_names);
         return false;
     }
 
+    pthread_mutex_lock(&g_clipboard_mutex);
+    clear_clipboard_items();
+
     // 클립보드에 저장
-    strncpy(g_clipboard.source_path, abs_path, sizeof(g_clipboard.source_path) - 1);
-    g_clipboard.source_path[sizeof(g_clipboard.source_path) - 1] = '\0';
+    strcpy(g_clipboard.source_dir, abs_dir);
+    join_path(g_clipboard.source_path, sizeof(g_clipboard.source_path), abs_dir, valid_names[0]);
+    g_clipboard.names = valid_names;
+    g_clipboard.count = valid_count;
     g_clipboard.is_valid = true;
-    g_clipboard.is_directory = S_ISDIR(st.st_mode);
+    g_clipboard.is_directory = first_is_directory;
+    g_clipboard.is_cut = cut;
 
     pthread_mutex_unlock(&g_clipboard_mutex);
     return true;
 }
 
+// 경로 하나를 클립보드에 저장
+static bool set_clipboard(const char *file_path, bool cut) {
+    char dir[MAX_PATH_LEN];
+    const char *last_slash = strrchr(file_path, '/');
+    const char *filename;
+
+    if (last_slash) {
+        filename = last_slash + 1;
+        size_t dir_len = (size_t)(last_slash - file_path);
+        if (dir_len == 0) dir_len = 1; // "/name"
+        if (dir_len >= sizeof(dir)) return false;
+        memcpy(dir, file_path, dir_len);
+        dir[dir_len] = '\0';
+    } else {
+        filename = file_path;
+        strcpy(dir, ".");
+    }
+
+    return set_clipboard_items(dir, &filename, 1, cut);
+}
+
+// 클립보드에 복사
+bool copy_to_clipboard(const char *file_path) {
+    return set_clipboard(file_path, false);
+}
+
+// 클립보드에 잘라내기 (붙여넣기 시 이동)
+bool cut_to_clipboard(const char *file_path) {
+    return set_clipboard(file_path, true);
+}
+
+// 선택한 여러 항목을 클립보드에 복사/잘라내기
+bool copy_selection_to_clipboard(const char *source_dir, const char *const *names, int count, bool cut) {
+    return set_clipboard_items(source_dir, names, count, cut);
+}
+
+// 대상이 이미 있으면 실패하는 rename (RENAME_NOREPLACE 미지원 파일시스템은 확인 후 rename)
+static int rename_noreplace(const char *src, const char *dest) {
+    if (renameat2(AT_FDCWD, src, AT_FDCWD, dest, RENAME_NOREPLACE) == 0) {
+        return 0;
+    }
+    if (errno != ENOSYS && errno != EINVAL) {
+        return -1;
+    }
+
+    if (faccessat(AT_FDCWD, dest, F_OK, AT_SYMLINK_NOFOLLOW) == 0) {
+        errno = EEXIST;
+        return -1;
+    }
+    return rename(src, dest);
+}
+
+// 같은 파일시스템 안에서 rename 한 번으로 이동 (성공 시 0, 실패 시 errno 반환)
+int move_by_rename(const char *src, const char *dest_dir, const char *base_name,
+                   char *out_name, size_t out_size) {
+    char dest_path[MAX_PATH_LEN];
+
+    for (int attempt = 0; attempt < 8; attempt++) {
+        generate_unique_name_r(dest_dir, base_name, out_name, out_size);
+        join_path(dest_path, sizeof(dest_path), dest_dir, out_name);
+
+        if (rename_noreplace(src, dest_path) == 0) {
+            return 0;
+        }
+        if (errno != EEXIST) {
+            return errno;
+        }
+        // 이름을 확인한 뒤 다른 프로세스가 먼저 만든 경우 - 다시 시도
+    }
+    return EEXIST;
+}
+
 // 클립보드에서 붙여넣기 - 즉시 업데이트 지원
 bool paste_from_clipboard(const char *dest_dir) {
     pthread_mutex_lock(&g_clipboard_mutex);
@@ -734,94 +3577,94 @@ bool paste_from_clipboard(const char *dest_dir) {
         return false;
     }
 
-    // 원본 파일 이름 추출 - 안전한 방식
-    const char *last_slash = strrchr(g_clipboard.source_path, '/');
-    const char *base_name;
-    if (last_slash) {
-        base_name = last_slash + 1;
-    } else {
-        base_name = g_clipboard.source_path;
+    // 같은 디렉토리로 잘라내기 붙여넣기는 옮길 것이 없음
+    if (g_clipboard.is_cut && strcmp(g_clipboard.source_dir, dest_dir) == 0) {
+        pthread_mutex_unlock(&g_clipboard_mutex);
+        return true;
+    }
+
+    TaskType type = g_clipboard.is_cut ? TASK_TYPE_MOVE : TASK_TYPE_COPY;
+
+    // 여러 항목은 이름 결정, rename, 복사 모두 하나의 백그라운드 작업에서 처리
+    if (g_clipboard.count > 1) {
+        CopyTask *task = create_task(type, g_clipboard.source_dir, (const char *const *)g_clipboard.names,
+                                     g_clipboard.count, dest_dir);
+        if (!task || !launch_task(task, copy_thread_func)) {
+            free_task(task);
+            pthread_mutex_unlock(&g_clipboard_mutex);
+            return false;
+        }
+        // 이동 작업이 시작되면 원본은 곧 사라지므로 클립보드 비움
+        if (g_clipboard.is_cut) {
+            clear_clipboard_items();
+        }
+        pthread_mutex_unlock(&g_clipboard_mutex);
+        return true;
+    }
+
+    const char *base_name = g_clipboard.names[0];
+
+    // 잘라내기: 같은 파일시스템이면 rename 한 번으로 끝냄
+    if (g_clipboard.is_cut) {
+        char moved_name[MAX_NAME_LEN];
+        int rename_result = move_by_rename(g_clipboard.source_path, dest_dir, base_name,
+                                           moved_name, sizeof(moved_name));
+        if (rename_result == 0) {
+            clear_clipboard_items();
+            pthread_mutex_unlock(&g_clipboard_mutex);
+            return true;
+        }
+        if (rename_result != EXDEV) {
+            pthread_mutex_unlock(&g_clipboard_mutex);
+            return false;
+        }
+        // 다른 장치 - 복사 후 원본 삭제로 진행
     }
-    
-    char *unique_name = generate_unique_name(dest_dir, base_name);
-    
-    char dest_path[MAX_PATH_LEN];
-    snprintf(dest_path, sizeof(dest_path), "%s/%s", dest_dir, unique_name);
 
     bool use_background = should_use_background_copy(g_clipboard.source_path);
 
     if (use_background) {
-        // 백그라운드 복사 작업 생성
-        CopyTask* task = malloc(sizeof(CopyTask));
+        // 백그라운드 작업 생성 - 대상 자리를 먼저 만들어 목록에 바로 보이도록
+        CopyTask* task = create_task(type, g_clipboard.source_dir, (const char *const *)g_clipboard.names,
+                                     1, dest_dir);
         if (!task) {
             pthread_mutex_unlock(&g_clipboard_mutex);
             return false;
         }
 
-        strcpy(task->source_path, g_clipboard.source_path);
-        strcpy(task->dest_path, dest_path);
-        strcpy(task->dest_dir, dest_dir);
-        strcpy(task->dest_name, unique_name);
-        task->is_directory = g_clipboard.is_directory;
-        task->is_running = true;
-        
-        // 원본 크기 계산
-        if (task->is_directory) {
-            task->total_size = get_directory_size(g_clipboard.source_path);
-        } else {
-            task->total_size = get_file_size(g_clipboard.source_path);
-        }
-        task->copied_size = 0;
-        
-        // 진행률 뮤텍스 초기화
-        if (pthread_mutex_init(&task->progress_mutex, NULL) != 0) {
-            free(task);
+        if (!reserve_destination(task, 0)) {
+            free_task(task);
             pthread_mutex_unlock(&g_clipboard_mutex);
             return false;
         }
 
-        // 즉시 임시 파일 생성 (빈 파일/디렉토리) - 더 확실한 생성
-        if (task->is_directory) {
-            if (mkdir(dest_path, 0755) != 0 && errno != EEXIST) {
-                pthread_mutex_destroy(&task->progress_mutex);
-                free(task);
-                pthread_mutex_unlock(&g_clipboard_mutex);
-                return false;
-            }
-        } else {
-            int fd = open(dest_path, O_CREAT | O_WRONLY | O_TRUNC, 0644);
-            if (fd < 0) {
-                pthread_mutex_destroy(&task->progress_mutex);
-                free(task);
-                pthread_mutex_unlock(&g_clipboard_mutex);
-                return false;
-            }
-            close(fd);
+        // 원본 크기 - 디렉토리는 작업 스레드가 백그라운드로 계산 (-1 = 계산 중)
+        if (!task->is_directory) {
+            task->total_size = get_file_size(g_clipboard.source_path);
+            task->files_total = 1;
         }
 
         // 스레드 생성
-        if (pthread_create(&task->thread_id, NULL, copy_thread_func, task) != 0) {
+        if (!launch_task(task, copy_thread_func)) {
             // 임시 파일 삭제
-            if (task->is_directory) {
-                rmdir(dest_path);
-            } else {
-                unlink(dest_path);
-            }
-            pthread_mutex_destroy(&task->progress_mutex);
-            free(task);
+            delete_path_with_progress(task->dest_path, NULL);
+            free_task(task);
             pthread_mutex_unlock(&g_clipboard_mutex);
             return false;
         }
 
-        // 작업 목록에 추가
-        pthread_mutex_lock(&g_tasks_mutex);
-        task->next = g_copy_tasks;
-        g_copy_tasks = task;
-        pthread_mutex_unlock(&g_tasks_mutex);
+        // 이동 작업이 시작되면 원본은 곧 사라지므로 클립보드 비움
+        if (g_clipboard.is_cut) {
+            clear_clipboard_items();
+        }
 
         pthread_mutex_unlock(&g_clipboard_mutex);
         return true;
     } else {
+        char *unique_name = generate_unique_name(dest_dir, base_name);
+        char dest_path[MAX_PATH_LEN];
+        join_path(dest_path, sizeof(dest_path), dest_dir, unique_name);
+
         // 동기 복사
         bool success;
         if (g_clipboard.is_directory) {
@@ -830,21 +3673,117 @@ bool paste_from_clipboard(const char *dest_dir) {
             success = copy_file_sync(g_clipboard.source_path, dest_path);
         }
 
+        // 다른 장치로의 작은 이동 - 복사가 끝나면 원본 삭제
+        if (success && g_clipboard.is_cut) {
+            success = delete_file(g_clipboard.source_path);
+            if (success) {
+                clear_clipboard_items();
+            }
+        }
+
         pthread_mutex_unlock(&g_clipboard_mutex);
         return success;
     }
 }
 
+// 다른 디렉토리로 복사/이동을 클립보드를 거치지 않고 바로 백그라운드 작업으로 시작
+bool start_transfer_task(const char *source_dir, const char *const *names, int count,
+                         const char *dest_dir, bool move) {
+    if (count <= 0) return false;
+
+    // 같은 디렉토리로 이동은 옮길 것이 없음
+    if (move && strcmp(source_dir, dest_dir) == 0) return true;
+
+    CopyTask *task = create_task(move ? TASK_TYPE_MOVE : TASK_TYPE_COPY, source_dir, names, count, dest_dir);
+    if (!task) return false;
+    if (count == 1 && !task->is_directory) {
+        task->total_size = get_file_size(task->source_path);
+        task->files_total = 1;
+    }
+    if (!launch_task(task, copy_thread_func)) {
+        free_task(task);
+        return false;
+    }
+    return true;
+}
+
+// 여러 항목 삭제를 하나의 백그라운드 작업으로 시작
+bool start_delete_task(const char *source_dir, const char *const *names, int count) {
+    if (count <= 0) return false;
+
+    CopyTask *task = create_task(TASK_TYPE_DELETE, source_dir, names, count, NULL);
+    if (!task) return false;
+
+    if (!launch_task(task, delete_thread_func)) {
+        free_task(task);
+        return false;
+    }
+    return true;
+}
+
+// 항목들을 dest_dir의 같은 이름으로 동기화하는 백그라운드 작업 시작
+bool start_sync_task(const char *source_dir, const char *const *names, int count, const char *dest_dir,
+                     bool delete_extra) {
+    if (count <= 0 || strcmp(source_dir, dest_dir) == 0) return false;
+
+    CopyTask *task = create_task(TASK_TYPE_SYNC, source_dir, names, count, dest_dir);
+    if (!task) return false;
+    task->sync_delete = delete_extra;
+    const char *content = getenv("FINDER_SYNC_CONTENT");
+    task->sync_content = (content && strcmp(content, "1") == 0);
+    const char *inplace = getenv("FINDER_SYNC_INPLACE");
+    task->sync_inplace = (inplace && strcmp(inplace, "1") == 0);
+    if (count == 1) {
+        join_path(task->dest_path, sizeof(task->dest_path), dest_dir, names[0]);
+        if (!task->is_directory) {
+            task->total_size = get_file_size(task->source_path);
+            task->files_total = 1;
+        }
+    }
+
+    if (!launch_task(task, sync_thread_func)) {
+        free_task(task);
+        return false;
+    }
+    return true;
+}
+
+// 여러 항목을 dest_dir의 tar 파일 하나로 묶는 백그라운드 작업 시작
+// (항목이 하나면 "이름.tar", 여러 개면 "원본 디렉토리 이름.tar")
+bool start_pack_task(const char *source_dir, const char *const *names, int count, const char *dest_dir) {
+    if (count <= 0) return false;
+
+    CopyTask *task = create_task(TASK_TYPE_PACK, source_dir, names, count, dest_dir);
+    if (!task) return false;
+
+    const char *base = names[0];
+    if (count > 1) {
+        base = strrchr(source_dir, '/');
+        base = (base && base[1] != '\0') ? base + 1 : "archive";
+    }
+    snprintf(task->dest_name, sizeof(task->dest_name), "%.*s.tar", MAX_NAME_LEN - 5, base);
+    if (count == 1 && !task->is_directory) {
+        task->total_size = get_file_size(task->source_path);
+        task->files_total = 1;
+    }
+
+    if (!launch_task(task, pack_thread_func)) {
+        free_task(task);
+        return false;
+    }
+    return true;
+}
+
 // 파일 삭제 함수
 bool delete_file(const char *path) {
-    // 파일이 존재하는지 확인
-    if (access(path, F_OK) != 0) {
+    // 파일이 존재하는지 확인 (심볼릭 링크는 따라가지 않고 링크 자체를 삭제)
+    struct stat st;
+    if (lstat(path, &st) != 0) {
         return false; // 파일이 존재하지 않음
     }
 
     // 파일이 실제로 디렉토리인지 확인
-    struct stat st;
-    if (stat(path, &st) == 0 && S_ISDIR(st.st_mode)) {
+    if (S_ISDIR(st.st_mode)) {
         return delete_directory_recursive(path); // 디렉토리면 재귀적으로 삭제
     }
 
@@ -858,51 +3797,24 @@ bool delete_file(const char *path) {
 
 // 디렉토리 재귀적으로 삭제하는 함수
 bool delete_directory_recursive(const char *path) {
-    DIR *dir;
-    struct dirent *entry;
-    char full_path[MAX_PATH_LEN];
-    
+    return delete_directory_recursive_with_progress(path, NULL);
+}
+
+// 지운 항목 수를 작업에 기록하며 디렉토리 재귀 삭제 (병렬 삭제 엔진 사용)
+bool delete_directory_recursive_with_progress(const char *path, CopyTask *task) {
     // ".." 디렉토리는 삭제 불가능 처리
     const char *last_part = strrchr(path, '/');
     if (last_part && strcmp(last_part + 1, "..") == 0) {
         return false;
     }
 
-    // 디렉토리 열기
-    dir = opendir(path);
-    if (!dir) {
+    // 심볼릭 링크를 따라가 대상 디렉토리의 내용을 지우지 않도록
+    struct stat st;
+    if (lstat(path, &st) == -1 || !S_ISDIR(st.st_mode)) {
         return false;
     }
 
-    // 디렉토리 내 모든 파일/디렉토리 순회하며 삭제
-    while ((entry = readdir(dir)) != NULL) {
-        if (strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0) {
-            continue; // . 과 .. 건너뛰기
-        }
-
-        snprintf(full_path, sizeof(full_path), "%s/%s", path, entry->d_name);
-        
-        // 디렉토리면 재귀 호출
-        if (entry->d_type == DT_DIR) {
-            if (!delete_directory_recursive(full_path)) {
-                closedir(dir);
-                return false; // 하위 디렉토리 삭제 실패
-            }
-        } else {
-            // 일반 파일 삭제
-            if (unlink(full_path) != 0) {
-                closedir(dir);
-                return false; // 파일 삭제 실패
-            }
-        }
-    }
-
-    closedir(dir);
-    
-    // 비어있는 디렉토리 삭제
-    if (rmdir(path) != 0) {
-        return false; // 디렉토리 삭제 실패
-    }
-
-    return true; // 성공
+    bool removed = false;
+    run_delete_engine(&path, 1, task, &removed);
+    return removed;
 }
@@ -5,11 +5,17 @@
 #include <stdbool.h>
 #include <sys/types.h>
 #include <pthread.h>
+#include <sys/stat.h>
 
 #define MAX_FILES 1024
 #define MAX_NAME_LEN 256
 #define MAX_PATH_LEN 1024
 #define LARGE_FILE_SIZE (100 * 1024 * 1024) // 100MB
+#define TASK_DEFAULT_MAX_ACTIVE 0  // 동시에 실행하는 작업 수 (FINDER_MAX_TASKS로 제한, 0이면 제한 없음)
+#define TASK_RATE_SAMPLES 20       // 처리 속도 표본 수 (표본 간격과 곱하면 이동 평균 창 길이)
+#define TASK_RATE_INTERVAL_MS 250  // 처리 속도 표본 간격
+#define LISTING_CACHE_SLOTS 4           // 기억하는 디렉토리 목록 수 (분할 화면의 두 목록과 최근에 본 디렉토리)
+#define LISTING_CACHE_MAX_AGE_MS 5000   // 캐시된 목록을 다시 쓰는 최대 시간
 
 // 복사 상태를 나타내는 열거형
 typedef enum {
@@ -27,39 +33,116 @@ typedef struct {
     mode_t mode;              // 파일 모드
     CopyStatus copy_status;   // 복사 상태 추가
     off_t original_size;      // 복사 중일 때 원본 파일 크기 저장용 추가
+    bool is_marked;           // 다중 선택으로 표시된 항목인지
+    int name_width;           // 이름의 화면 표시 폭 (한글/CJK는 글자당 두 칸, 목록을 읽을 때 계산)
+    int type_width;           // 종류 문자열의 표시 폭
+    int name_fit_cols;        // name_fit_bytes를 계산한 이름 칸 너비 (-1: 아직 계산 안 함)
+    int name_fit_bytes;       // 이름 칸에 들어가는 앞부분의 바이트 수
+    unsigned short file_type; // 일반 파일의 종류 (filetype.h의 FileType, 사용자 종류 포함)
+    bool type_pending;        // 확장자로 모르는 일반 파일이라 내용으로 판별할 차례를 기다림
+    dev_t dev;                // 내용 판별 캐시의 키
+    ino_t ino;
+    time_t modified;          // 수정 시각 (바뀌면 다시 판별)
 } FileEntry;
 
 // 클립보드 구조체
 typedef struct {
-    char source_path[MAX_PATH_LEN];  // 복사할 파일/디렉토리의 절대 경로
+    char source_path[MAX_PATH_LEN];  // 복사할 파일/디렉토리의 절대 경로 (여러 항목이면 첫 항목)
+    char source_dir[MAX_PATH_LEN];   // 항목들이 들어 있는 디렉토리
+    char **names;                    // 항목 이름들
+    int count;                       // 항목 수
     bool is_valid;                   // 클립보드에 유효한 데이터가 있는지
-    bool is_directory;               // 복사 대상이 디렉토리인지 여부
+    bool is_directory;               // 복사 대상이 디렉토리인지 여부 (첫 항목 기준)
+    bool is_cut;                     // 잘라내기(이동)인지 여부
 } Clipboard;
 
-// 백그라운드 복사 작업 정보
+// 백그라운드 작업 종류
+typedef enum {
+    TASK_TYPE_COPY = 0,   // 복사
+    TASK_TYPE_MOVE = 1,   // 이동 (같은 장치는 rename, 다른 장치는 복사 후 원본 삭제)
+    TASK_TYPE_DELETE = 2, // 삭제
+    TASK_TYPE_PACK = 3,   // tar 파일로 묶기 (원본은 그대로)
+    TASK_TYPE_SYNC = 4    // 동기화 (바뀐 파일만 복사, 원본은 그대로)
+} TaskType;
+
+// 작업 항목 하나 (원본 디렉토리 기준 이름)
+typedef struct {
+    char *name;                      // 원본 이름
+    char dest_name[MAX_NAME_LEN];    // 대상 이름 (""이면 아직 정해지지 않음, progress_mutex로 보호)
+    bool is_directory;               // 디렉토리인지 (심볼릭 링크는 따라감)
+    bool created;                    // 이 작업이 대상을 만들었는지
+    bool done;                       // rename으로 이미 끝난 항목
+    bool failed;                     // 실패한 항목 (이동이면 원본을 지우지 않음)
+} TaskItem;
+
+// 작업 진행 단계
+typedef enum {
+    TASK_PHASE_COPY = 0,  // 데이터 복사 중
+    TASK_PHASE_DELETE = 1 // 원본 삭제 중
+} TaskPhase;
+
+// 백그라운드 작업 정보 (복사/이동/삭제, 여러 항목을 한 작업으로 처리)
 typedef struct CopyTask {
     char source_path[MAX_PATH_LEN];
     char dest_path[MAX_PATH_LEN];
     char dest_dir[MAX_PATH_LEN];     // 대상 디렉토리 추가
-    char dest_name[MAX_NAME_LEN];    // 대상 파일명 추가
+    char dest_name[MAX_NAME_LEN];    // 대상 파일명 추가 (여러 항목이면 "N개 항목")
+    char source_dir[MAX_PATH_LEN];   // 항목들이 들어 있는 디렉토리
+    TaskItem *items;                 // 작업 항목들
+    int item_count;                  // 항목 수
     bool is_directory;
+    TaskType type;                   // 작업 종류
+    bool sync_delete;                // 동기화: 원본에 없는 대상 항목 삭제
+    bool sync_content;               // 동기화: 크기가 같으면 수정 시각 대신 내용으로 비교
+    bool sync_inplace;               // 동기화: 다른 하드 링크가 없는 대상은 바뀐 구간만 제자리에 덮어씀
+    TaskPhase phase;                 // 현재 단계 (progress_mutex로 보호)
     pthread_t thread_id;
     bool is_running;
-    off_t total_size;                // 원본 파일/디렉토리 총 크기 추가
+    volatile bool cancel_requested;  // 취소 요청 (작업 스레드가 확인 후 스스로 정리)
+    off_t total_size;                // 원본 파일/디렉토리 총 크기 (-1: 계산 중)
     off_t copied_size;               // 현재까지 복사된 크기 추가
+    long files_total;                // 전체 항목 수 (-1: 계산 중)
+    long files_done;                 // 삭제 단계에서 지운 항목 수
+    long failed_count;               // 실패한 파일 수
+    bool is_queued;                  // 실행 차례를 기다리는 중 (progress_mutex로 보호)
+    unsigned int id;                 // 작업 번호 (작업이 정리된 뒤에도 가리키지 않도록 포인터 대신 사용)
     pthread_mutex_t progress_mutex;  // 진행률 보호용 뮤텍스 추가
+
+    // 처리 속도 표본 (UI 스레드에서만 사용)
+    long rate_ms[TASK_RATE_SAMPLES];
+    off_t rate_units[TASK_RATE_SAMPLES]; // 복사 단계는 바이트, 삭제 단계는 항목 수
+    int rate_count;
+    int rate_next;
+    TaskPhase rate_phase;
+    long rate_base_ms;               // 현재 단계의 첫 표본 (평균 속도 기준)
+    off_t rate_base_units;
+
+    struct CopyTask* queue_next;     // 실행 대기열 연결
     struct CopyTask* next;  // 연결 리스트로 여러 작업 관리
 } CopyTask;
 
+// 작업 처리 속도 (sample_task_rates 결과)
+typedef struct {
+    bool in_items;     // 단위가 항목 수인지 (삭제 단계), 아니면 바이트
+    off_t done;        // 현재 단계에서 처리한 양
+    off_t total;       // 현재 단계의 전체 양 (-1: 계산 중)
+    double current;    // 최근 창의 초당 처리량
+    double average;    // 단계 시작 이후 초당 처리량
+    long eta_sec;      // 남은 시간 (-1: 알 수 없음)
+} TaskRates;
+
 // 전역 클립보드 및 작업 목록
 extern Clipboard g_clipboard;
 extern CopyTask* g_copy_tasks;
 extern pthread_mutex_t g_clipboard_mutex;
 extern pthread_mutex_t g_tasks_mutex;
 
-// 파일 목록 가져오기 함수
+// 파일 목록 가져오기 함수 (디렉토리가 바뀌지 않았으면 최근에 읽은 목록을 재사용)
 int get_file_list(const char *path, FileEntry *files, int max_files);
 
+// 캐시된 목록 버리기 (NULL이면 전부) - 디렉토리 수정시각이 바뀌지 않는 변경(파일 내용, 크기 계산 완료 등)을 알았을 때
+void invalidate_file_list(const char *path);
+
 // 경로 이동 함수
 bool change_directory(const char *path);
 
@@ -84,20 +167,60 @@ bool is_directory(const FileEntry *file);
 // 파일을 편집기로 여는 함수
 bool edit_file(const char *path);
 
+// 파일을 편집기로 열고 해당 줄로 이동 (line <= 0이면 edit_file과 같음)
+bool edit_file_at(const char *path, long line);
+
 // 파일이나 디렉토리 삭제하는 함수
 bool delete_file(const char *path);
 bool delete_directory_recursive(const char *path);
+bool delete_directory_recursive_with_progress(const char *path, CopyTask *task);
 
 // 복사-붙여넣기 관련 함수들
 bool copy_to_clipboard(const char *file_path);
+bool cut_to_clipboard(const char *file_path);
+bool copy_selection_to_clipboard(const char *source_dir, const char *const *names, int count, bool cut);
 bool paste_from_clipboard(const char *dest_dir);
 bool init_clipboard_system();
 void cleanup_clipboard_system();
-void cleanup_finished_tasks();
+int cleanup_finished_tasks(); // 정리한 작업 수 반환
+bool has_running_tasks();
 char* generate_unique_name(const char *dest_dir, const char *base_name);
+void generate_unique_name_r(const char *dest_dir, const char *base_name, char *out, size_t out_size);
+
+// 같은 파일시스템 안에서 rename 한 번으로 이동 (이름이 겹치면 고유한 이름 사용)
+// 성공 시 0과 함께 out_name에 최종 이름, 실패 시 errno 반환 (다른 장치면 EXDEV)
+int move_by_rename(const char *src, const char *dest_dir, const char *base_name,
+                   char *out_name, size_t out_size);
+
+// 다른 디렉토리로 복사/이동을 클립보드를 거치지 않고 바로 백그라운드 작업으로 시작 (분할 화면)
+bool start_transfer_task(const char *source_dir, const char *const *names, int count,
+                         const char *dest_dir, bool move);
+
+// 여러 항목 삭제를 하나의 백그라운드 작업으로 시작
+bool start_delete_task(const char *source_dir, const char *const *names, int count);
+
+// 항목들을 dest_dir의 같은 이름으로 동기화 - 바뀐 파일만 복사하고, 큰 파일은 바뀐 블록만 씀
+// (delete_extra면 원본에 없는 대상 항목을 지움, FINDER_SYNC_CONTENT=1이면 크기가 같을 때 내용으로 비교,
+// FINDER_SYNC_INPLACE=1이면 하드 링크가 하나뿐인 큰 파일은 임시 파일 없이 바뀐 구간만 덮어씀)
+bool start_sync_task(const char *source_dir, const char *const *names, int count, const char *dest_dir,
+                     bool delete_extra);
+
+// 여러 항목을 dest_dir의 tar 파일 하나로 묶는 백그라운드 작업 시작 (이름이 겹치면 고유한 이름)
+bool start_pack_task(const char *source_dir, const char *const *names, int count, const char *dest_dir);
+
+// 작업 취소 요청 (작업 스레드가 정리 후 종료)
+void request_task_cancel(CopyTask *task);
+
+// 번호로 실행 중인 작업 찾기 (g_tasks_mutex 안에서 호출, 이미 끝났으면 NULL)
+CopyTask* find_running_task(unsigned int id);
+
+// 진행률 표본을 추가하고 처리 속도와 남은 시간 계산 (UI 스레드, g_tasks_mutex 안에서 호출)
+void sample_task_rates(CopyTask *task, long now_ms, TaskRates *rates);
 off_t get_file_size(const char *path);
 bool copy_file_sync(const char *src, const char *dest);
 bool copy_directory_sync(const char *src, const char *dest);
+bool copy_file_sync_with_progress(const char *src, const char *dest, CopyTask* task);
+bool copy_directory_sync_with_progress(const char *src, const char *dest, CopyTask* task);
 void* copy_thread_func(void* arg);
 bool should_use_background_copy(const char *path);
 
@@ -107,6 +230,17 @@ bool is_copying_file(const char *file_path);
 
 // 새로 추가된 함수들
 off_t get_directory_size(const char *path);
+void format_size(off_t size, char *buf, size_t buf_size);
+void format_time(time_t mtime, char *buf, size_t buf_size);
+
+// 이름과 종류 문자열의 표시 폭 계산 (목록 항목을 직접 채울 때)
+void set_display_widths(FileEntry *file);
+
+// 문자열의 터미널 표시 폭 (fit_bytes가 있으면 max_cols 칸에 들어가는 바이트 수도 계산)
+int display_width(const char *s, int max_cols, int *fit_bytes);
+
+// 마지막으로 계산한 디렉토리 크기 ((dev, ino, mtime) 기준, 더 깊은 곳의 변화는 반영되지 않음)
+bool lookup_cached_directory_size(const struct stat *st, off_t *size, long *entries);
 CopyTask* find_copy_task_by_dest(const char *dest_path);
 
 #endif
@@ -0,0 +1,237 @@
+// grep.c
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE // memmem, memrchr
+#endif
+#include "grep.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+bool grep_compile(GrepPattern *pattern, const char *text) {
+    memset(pattern, 0, sizeof(GrepPattern));
+    size_t len = strlen(text);
+    if (len == 0 || len >= sizeof(pattern->needle)) return false;
+
+    // 대문자가 하나라도 있으면 그대로, 없으면 대소문자 무시
+    pattern->ignore_case = true;
+    for (size_t i = 0; i < len; i++) {
+        if (isupper((unsigned char)text[i])) pattern->ignore_case = false;
+    }
+    memcpy(pattern->needle, text, len);
+    pattern->len = len;
+    return true;
+}
+
+// a 또는 b가 처음 나오는 위치 - SSE2면 16바이트씩 두 값과 한 번에 비교
+static const char* find_either(const char *p, const char *end, char a, char b) {
+    if (a == b) return memchr(p, a, end - p);
+#ifdef __SSE2__
+    __m128i va = _mm_set1_epi8(a);
+    __m128i vb = _mm_set1_epi8(b);
+    while (end - p >= 16) {
+        __m128i chunk = _mm_loadu_si128((const __m128i*)p);
+        int mask = _mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(chunk, va), _mm_cmpeq_epi8(chunk, vb)));
+        if (mask) return p + __builtin_ctz(mask);
+        p += 16;
+    }
+#endif
+    for (; p < end; p++) {
+        if (*p == a || *p == b) return p;
+    }
+    return NULL;
+}
+
+// 대소문자를 무시하고 비교 (ASCII만, 찾을 내용은 이미 소문자)
+static bool equal_folded(const char *data, const char *needle, size_t len) {
+    for (size_t i = 0; i < len; i++) {
+        if (tolower((unsigned char)data[i]) != (unsigned char)needle[i]) return false;
+    }
+    return true;
+}
+
+// data 안에서 처음 맞는 위치
+static const char* find_match(const GrepPattern *pattern, const char *data, const char *end) {
+    if ((size_t)(end - data) < pattern->len) return NULL;
+    if (!pattern->ignore_case) {
+        // glibc memmem은 two-way 알고리즘 (짧은 찾을 내용은 SIMD)
+        return memmem(data, end - data, pattern->needle, pattern->len);
+    }
+
+    // 첫 글자의 대/소문자를 함께 찾고, 후보에서만 나머지를 비교
+    char lower = pattern->needle[0];
+    char upper = (char)toupper((unsigned char)lower);
+    const char *last = end - pattern->len;
+    const char *p = data;
+    while (p <= last) {
+        p = find_either(p, last + 1, lower, upper);
+        if (!p) return NULL;
+        if (equal_folded(p + 1, pattern->needle + 1, pattern->len - 1)) return p;
+        p++;
+    }
+    return NULL;
+}
+
+// 결과로 보일 줄 내용 - 긴 줄은 맞은 위치 조금 앞부터, 탭과 제어 문자는 바꿈
+static size_t line_text(const char *line, const char *line_end, const char *match, char *out) {
+    const char *start = line;
+    if (match - line > GREP_MAX_TEXT / 2) {
+        start = match - GREP_CONTEXT_BEFORE;
+        while (start < match && ((unsigned char)*start & 0xC0) == 0x80) start++; // UTF-8 글자 중간에서 시작하지 않도록
+    }
+    size_t len = 0;
+    for (const char *p = start; p < line_end && len < GREP_MAX_TEXT; p++) {
+        unsigned char c = (unsigned char)*p;
+        if (c == '\r') continue;
+        out[len++] = (c == '\t') ? ' ' : (c < 0x20 || c == 0x7f) ? '.' : (char)c;
+    }
+    out[len] = '\0';
+    return len;
+}
+
+// 한 버퍼에서 맞는 줄마다 콜백 (한 줄은 한 번만), *line은 data 첫 줄의 번호이며 끝나면 다음 줄 번호로
+// 콜백이 그만 찾으라고 하면 false
+static bool grep_data(const GrepPattern *pattern, const char *data, size_t size, long *line, long *matches,
+                      GrepLineFn on_line, void *user) {
+    const char *end = data + size;
+    const char *p = data;
+    const char *counted = data; // 여기까지의 줄 수를 line에 셈
+    char text[GREP_MAX_TEXT + 1];
+
+    while (p < end) {
+        const char *match = find_match(pattern, p, end);
+        if (!match) break;
+
+        // 맞은 위치까지 줄바꿈 수 (memchr로 건너뜀)
+        const char *nl;
+        while ((nl = memchr(counted, '\n', match - counted)) != NULL) {
+            (*line)++;
+            counted = nl + 1;
+        }
+        const char *line_start = counted;
+        const char *line_end = memchr(match, '\n', end - match);
+        if (!line_end) line_end = end;
+
+        size_t len = line_text(line_start, line_end, match, text);
+        (*matches)++;
+        if (!on_line(user, *line, text, len)) return false;
+        if (line_end == end) return true; // 마지막 줄 (줄바꿈 없음)
+
+        // 다음 줄부터
+        p = line_end + 1;
+        counted = p;
+        (*line)++;
+    }
+    // 남은 줄바꿈도 세어 다음 조각의 줄 번호를 맞춤
+    const char *nl;
+    while (counted < end && (nl = memchr(counted, '\n', end - counted)) != NULL) {
+        (*line)++;
+        counted = nl + 1;
+    }
+    return true;
+}
+
+// 파일을 GREP_CHUNK씩 pread로 읽어 줄 단위로 찾음 - 마지막 줄바꿈 뒤의 덜 읽은 줄은 다음 조각 앞에 붙이고,
+// 조각 전체가 한 줄이면 찾을 내용 길이 - 1 바이트만 겹쳐 남김 (mmap과 달리 읽는 중에 파일이 줄어도 그 파일만 끝남)
+long grep_file(const GrepPattern *pattern, const char *path, GrepBuffer *buffer, GrepLineFn on_line, void *user) {
+    // FIFO나 장치가 열리며 멈추지 않도록 O_NONBLOCK, 심볼릭 링크는 따라가지 않음
+    int fd = open(path, O_RDONLY | O_NOFOLLOW | O_NONBLOCK | O_CLOEXEC);
+    if (fd == -1) return -1;
+    struct stat st;
+    if (fstat(fd, &st) == -1 || !S_ISREG(st.st_mode)) {
+        close(fd);
+        return -1;
+    }
+    if (st.st_size == 0 || (size_t)st.st_size < pattern->len) {
+        close(fd);
+        return 0;
+    }
+
+    size_t want = st.st_size < GREP_CHUNK ? (size_t)st.st_size : GREP_CHUNK;
+    if (buffer->size < want) {
+        char *grown = realloc(buffer->data, want);
+        if (!grown) {
+            close(fd);
+            return -1;
+        }
+        buffer->data = grown;
+        buffer->size = want;
+    }
+    if (st.st_size > GREP_CHUNK) posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+
+    char *data = buffer->data;
+    off_t offset = 0;          // 다음에 읽을 위치 (찾기 시작할 때의 크기까지만)
+    size_t carry = 0;          // 앞 조각에서 넘어온 바이트 (data 앞부분)
+    long line = 1;
+    long matches = 0;
+    bool skip_line = false;    // 이미 보고한 긴 줄의 나머지를 건너뛰는 중
+    bool first = true;
+
+    while (1) {
+        size_t filled = carry;
+        while (filled < want && offset < st.st_size) {
+            size_t room = want - filled;
+            if ((off_t)room > st.st_size - offset) room = (size_t)(st.st_size - offset);
+            ssize_t got = pread(fd, data + filled, room, offset);
+            if (got == -1 && errno == EINTR) continue;
+            if (got <= 0) {
+                offset = st.st_size; // 그 사이에 줄었거나 읽을 수 없으면 읽은 데까지만
+                break;
+            }
+            filled += got;
+            offset += got;
+        }
+        bool eof = (offset >= st.st_size);
+        if (filled == 0) break;
+
+        if (first) { // 앞부분에 NUL이 있으면 바이너리
+            size_t sniff = filled < GREP_SNIFF_BYTES ? filled : GREP_SNIFF_BYTES;
+            if (memchr(data, '\0', sniff)) break;
+            first = false;
+        }
+
+        // 이번에 찾을 구간: 끝까지 읽었으면 전부, 아니면 마지막 줄바꿈까지
+        const char *last_nl = eof ? NULL : memrchr(data, '\n', filled);
+        size_t usable = eof ? filled : (last_nl ? (size_t)(last_nl - data) + 1 : 0);
+        const char *start = data;
+
+        if (usable == 0) {
+            // 조각 전체가 한 줄의 중간 - 맞으면 그 줄을 보고하고 나머지는 건너뜀
+            if (!skip_line) {
+                long found = matches;
+                bool more = grep_data(pattern, data, filled, &line, &matches, on_line, user);
+                if (!more) break;
+                skip_line = (matches > found);
+            }
+            carry = (!skip_line && pattern->len > 1) ? pattern->len - 1 : 0;
+            if (carry > filled) carry = filled;
+            memmove(data, data + filled - carry, carry);
+            continue;
+        }
+        if (skip_line) {
+            const char *nl = memchr(data, '\n', usable);
+            start = nl ? nl + 1 : data + usable; // usable은 줄바꿈으로 끝나므로 항상 찾음
+            line++;
+            skip_line = false;
+        }
+        if (!grep_data(pattern, start, data + usable - start, &line, &matches, on_line, user)) break;
+        if (eof) break;
+        carry = filled - usable;
+        memmove(data, data + usable, carry);
+    }
+    close(fd);
+    return matches;
+}
+
+void grep_buffer_free(GrepBuffer *buffer) {
+    free(buffer->data);
+    buffer->data = NULL;
+    buffer->size = 0;
+}
@@ -0,0 +1,39 @@
+// grep.h
+#ifndef GREP_H
+#define GREP_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#define GREP_MAX_PATTERN 256          // 찾을 내용 최대 길이 (바이트)
+#define GREP_CHUNK (1024 * 1024)      // 한 번에 pread하는 크기 (줄 단위로 이어 붙여 찾음, 워커마다 재사용)
+#define GREP_SNIFF_BYTES 8192         // 앞부분에 NUL이 있으면 바이너리로 보고 건너뜀
+#define GREP_MAX_TEXT 200             // 결과로 보관하는 줄 내용 최대 길이
+#define GREP_CONTEXT_BEFORE 32        // 긴 줄에서 맞은 위치 앞으로 남기는 바이트
+
+// 찾을 내용 (그대로의 글자열, 대문자가 없으면 대소문자 무시)
+typedef struct {
+    char needle[GREP_MAX_PATTERN];
+    size_t len;
+    bool ignore_case;
+} GrepPattern;
+
+// 파일을 나눠 읽는 버퍼 (워커마다 하나를 재사용)
+typedef struct {
+    char *data;
+    size_t size;
+} GrepBuffer;
+
+// 맞은 줄 하나 (text는 탭/제어 문자를 바꾼 일부), false를 반환하면 이 파일을 그만 찾음
+typedef bool (*GrepLineFn)(void *user, long line, const char *text, size_t len);
+
+// 찾을 내용 준비 (비어 있거나 너무 길면 false)
+bool grep_compile(GrepPattern *pattern, const char *text);
+
+// 파일 하나에서 찾기 - 맞은 줄 수, 열 수 없으면 -1 (바이너리는 0)
+long grep_file(const GrepPattern *pattern, const char *path, GrepBuffer *buffer, GrepLineFn on_line, void *user);
+
+// 버퍼 해제
+void grep_buffer_free(GrepBuffer *buffer);
+
+#endif
@@ -0,0 +1,1201 @@
+// index.c
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+#include "index.h"
+#include "walk.h"
+#include "event.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <time.h>
+#include <unistd.h>
+#include <dirent.h>
+#include <limits.h>
+#include <pthread.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+
+#define INDEX_WATCH_MASK (IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO | IN_ONLYDIR | IN_DONT_FOLLOW | IN_EXCL_UNLINK)
+
+// 파일로 쓸 항목 (경로는 색인 루트 기준)
+typedef struct {
+    const char *path;
+    unsigned char type;
+} IndexItem;
+
+typedef struct {
+    IndexItem *items;
+    size_t count;
+    size_t capacity;
+} ItemList;
+
+// 매핑된 색인 파일
+typedef struct {
+    void *map;
+    size_t size;
+    const IndexHeader *header;
+    const IndexEntry *entries;
+    const IndexTrigram *trigrams;
+    const uint32_t *postings;
+    const char *strings;
+    const char *lower;
+    uint8_t *removed;              // 매핑 이후 지워진 항목 (항목 번호별 비트)
+} IndexMap;
+
+// 색인 내용 - 조회는 메인 스레드, 변경은 색인 스레드(와 그 탐색 워커)만 하므로 변경과 조회만 잠금
+static pthread_mutex_t g_index_mutex = PTHREAD_MUTEX_INITIALIZER;
+static IndexMap g_map;
+static ItemList g_added;           // 매핑 이후 생긴 항목 (경로는 malloc, 지워지면 NULL)
+static int *g_added_slots;         // g_added 경로 해시 (-1: 빈 칸, -2: 지운 칸)
+static size_t g_added_slot_count;
+static long g_changes;             // 파일에 저장하지 않은 변경 수
+static long g_last_change_ms;
+
+static bool g_index_started = false;
+static pthread_t g_index_thread;
+static volatile bool g_index_stop = false;
+static bool g_need_rebuild = false; // inotify 대기열이 넘쳐 변경을 놓침
+static bool g_verified = false;     // 이번 세션에서 확인했거나 다시 만든 색인 (아니면 찾기는 탐색으로, g_index_mutex로 보호)
+static int g_wake_fd = -1;
+static int g_inotify_fd = -1;
+static long g_refresh_sec = INDEX_DEFAULT_REFRESH;
+
+static char g_root[PATH_MAX];      // 색인 루트 (실제 경로)
+static size_t g_root_len;
+static dev_t g_root_dev;
+static ino_t g_root_ino;
+static char g_index_dir[PATH_MAX]; // 색인 파일이 있는 디렉토리 (저장할 때마다 바뀌므로 색인하지 않음)
+static char g_index_file[PATH_MAX];
+
+// 감시 중인 디렉토리 (wd → 상대 경로), 탐색 워커들이 함께 추가하므로 따로 잠금
+static pthread_mutex_t g_watch_mutex = PTHREAD_MUTEX_INITIALIZER;
+static char **g_watch_paths;
+static int g_watch_capacity;
+static int g_watch_count;
+static int g_watch_limit = INDEX_MAX_WATCHES; // 이번 실행의 감시 한도 (커널 한도의 일부만)
+static char **g_unwatched;         // 감시하지 못한 디렉토리 (상대 경로) - 그 아래를 찾으면 탐색으로 돌림
+static int g_unwatched_count;
+static bool g_watch_incomplete;    // 감시하지 못한 디렉토리가 너무 많아 전부 기억하지 못함
+static long g_watch_failures;      // 감시 실패 누적 수 (재구성 동안 실패가 없었는지 확인)
+
+// 소문자로 복사 (ASCII만, 이름 검색 색인과 같은 규칙)
+static void lower_copy(char *dest, const char *src, size_t len) {
+    for (size_t i = 0; i < len; i++) {
+        unsigned char c = (unsigned char)src[i];
+        dest[i] = (c < 0x80) ? (char)tolower(c) : (char)c;
+    }
+}
+
+static uint64_t hash_string(const char *s) {
+    uint64_t hash = 1469598103934665603ULL; // FNV-1a
+    for (; *s; s++) {
+        hash ^= (unsigned char)*s;
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+// 절대 경로 → 색인 루트 기준 상대 경로
+static const char* relative_of(const char *path) {
+    const char *relative = path + g_root_len;
+    while (*relative == '/') relative++;
+    return relative;
+}
+
+// 상대 경로 → 절대 경로
+static void full_path(const char *relative, char *out, size_t size) {
+    if (relative[0] == '\0') {
+        snprintf(out, size, "%s", g_root);
+    } else if (g_root_len == 1) {
+        snprintf(out, size, "/%s", relative);
+    } else {
+        snprintf(out, size, "%s/%s", g_root, relative);
+    }
+}
+
+static char* join_relative(const char *dir, const char *name) {
+    size_t dir_len = strlen(dir);
+    size_t name_len = strlen(name);
+    char *path = malloc(dir_len + name_len + 2);
+    if (!path) return NULL;
+    if (dir_len > 0) {
+        memcpy(path, dir, dir_len);
+        path[dir_len++] = '/';
+    }
+    memcpy(path + dir_len, name, name_len + 1);
+    return path;
+}
+
+static bool item_list_add(ItemList *list, const char *path, unsigned char type) {
+    if (list->count == list->capacity) {
+        size_t capacity = list->capacity ? list->capacity * 2 : 1024;
+        IndexItem *grown = realloc(list->items, capacity * sizeof(IndexItem));
+        if (!grown) return false;
+        list->items = grown;
+        list->capacity = capacity;
+    }
+    list->items[list->count].path = path;
+    list->items[list->count].type = type;
+    list->count++;
+    return true;
+}
+
+// ---- 색인 파일 쓰기 ----
+
+// 트라이그램 개수를 세는 해시 칸
+typedef struct {
+    uint32_t trigram;
+    uint32_t count;
+    uint32_t last;     // 마지막으로 센 항목 번호 + 1 (한 이름 안의 같은 트라이그램은 한 번만)
+    uint32_t table;    // 정렬된 표에서의 위치
+    bool used;
+} TrigramSlot;
+
+typedef struct {
+    TrigramSlot *slots;
+    size_t capacity;
+    size_t used;
+} TrigramTable;
+
+static TrigramSlot* trigram_slot(TrigramTable *table, uint32_t trigram, bool insert) {
+    if (insert && (table->used + 1) * 2 > table->capacity) {
+        size_t capacity = table->capacity ? table->capacity * 2 : 4096;
+        TrigramSlot *slots = calloc(capacity, sizeof(TrigramSlot));
+        if (!slots) return NULL;
+        for (size_t i = 0; i < table->capacity; i++) {
+            if (!table->slots[i].used) continue;
+            size_t pos = (table->slots[i].trigram * 2654435761U) & (capacity - 1);
+            while (slots[pos].used) pos = (pos + 1) & (capacity - 1);
+            slots[pos] = table->slots[i];
+        }
+        free(table->slots);
+        table->slots = slots;
+        table->capacity = capacity;
+    }
+    if (table->capacity == 0) return NULL;
+
+    size_t pos = (trigram * 2654435761U) & (table->capacity - 1);
+    while (table->slots[pos].used) {
+        if (table->slots[pos].trigram == trigram) return &table->slots[pos];
+        pos = (pos + 1) & (table->capacity - 1);
+    }
+    if (!insert) return NULL;
+    table->slots[pos].used = true;
+    table->slots[pos].trigram = trigram;
+    table->used++;
+    return &table->slots[pos];
+}
+
+static int compare_items(const void *a, const void *b) {
+    return strcmp(((const IndexItem*)a)->path, ((const IndexItem*)b)->path);
+}
+
+static int compare_trigrams(const void *a, const void *b) {
+    uint32_t x = ((const IndexTrigram*)a)->trigram;
+    uint32_t y = ((const IndexTrigram*)b)->trigram;
+    return (x > y) - (x < y);
+}
+
+// 같은 경로가 두 번 들어온 경우 (탐색 중 이동 등) 뒤의 것은 건너뜀 (정렬된 뒤)
+static bool is_duplicate(const ItemList *list, size_t i) {
+    return i > 0 && strcmp(list->items[i - 1].path, list->items[i].path) == 0;
+}
+
+static const char* item_name(const char *path) {
+    const char *slash = strrchr(path, '/');
+    return slash ? slash + 1 : path;
+}
+
+// 소문자 이름 길이 (이름은 NAME_MAX를 넘지 않지만 lower 버퍼 크기에 맞춰 한 번 더 제한)
+static size_t lower_length(const char *name) {
+    size_t len = strlen(name);
+    return len > NAME_MAX ? NAME_MAX : len;
+}
+
+// 소문자 이름의 i번째 바이트부터 세 바이트
+static uint32_t trigram_at(const char *lower, size_t i) {
+    return ((uint32_t)(unsigned char)lower[i] << 16) | ((uint32_t)(unsigned char)lower[i + 1] << 8) |
+           (uint32_t)(unsigned char)lower[i + 2];
+}
+
+// 항목을 경로순으로 정렬해 임시 파일에 쓰고 rename으로 교체 (list의 순서가 바뀜)
+static bool write_index(ItemList *list) {
+    qsort(list->items, list->count, sizeof(IndexItem), compare_items);
+
+    uint64_t entry_count = 0, strings_size = 0, lower_size = 0;
+    for (size_t i = 0; i < list->count; i++) {
+        if (is_duplicate(list, i)) continue;
+        entry_count++;
+        strings_size += strlen(list->items[i].path) + 1;
+        lower_size += lower_length(item_name(list->items[i].path)) + 1;
+    }
+    if (entry_count >= UINT32_MAX || strings_size >= UINT32_MAX || lower_size >= UINT32_MAX) return false;
+
+    // 1) 트라이그램별 항목 수
+    TrigramTable table = {0};
+    char lower[NAME_MAX + 1];
+    uint32_t id = 0;
+    bool ok = true;
+    for (size_t i = 0; i < list->count && ok; i++) {
+        if (is_duplicate(list, i)) continue;
+        const char *name = item_name(list->items[i].path);
+        size_t len = lower_length(name);
+        lower_copy(lower, name, len);
+        for (size_t k = 0; k + 3 <= len; k++) {
+            TrigramSlot *slot = trigram_slot(&table, trigram_at(lower, k), true);
+            if (!slot) {
+                ok = false;
+                break;
+            }
+            if (slot->last == id + 1) continue;
+            slot->last = id + 1;
+            slot->count++;
+        }
+        id++;
+    }
+
+    // 2) 트라이그램 표 정렬과 번호 목록 위치
+    IndexTrigram *trigrams = ok ? malloc(sizeof(IndexTrigram) * (table.used ? table.used : 1)) : NULL;
+    uint64_t posting_count = 0;
+    size_t trigram_count = 0;
+    if (trigrams) {
+        for (size_t i = 0; i < table.capacity; i++) {
+            if (!table.slots[i].used) continue;
+            trigrams[trigram_count].trigram = table.slots[i].trigram;
+            trigrams[trigram_count].count = table.slots[i].count;
+            trigram_count++;
+        }
+        qsort(trigrams, trigram_count, sizeof(IndexTrigram), compare_trigrams);
+        for (size_t i = 0; i < trigram_count; i++) {
+            trigrams[i].first = (uint32_t)posting_count;
+            posting_count += trigrams[i].count;
+            TrigramSlot *slot = trigram_slot(&table, trigrams[i].trigram, false);
+            slot->table = (uint32_t)i;
+            slot->count = 0; // 3)에서 채운 수로 다시 씀
+            slot->last = 0;
+        }
+    }
+
+    // 3) 번호 목록 채우기 (항목 번호 순서대로 넣으므로 목록마다 오름차순)
+    uint32_t *postings = (trigrams && posting_count < UINT32_MAX) ? malloc(sizeof(uint32_t) * (posting_count ? posting_count : 1)) : NULL;
+    if (postings) {
+        id = 0;
+        for (size_t i = 0; i < list->count; i++) {
+            if (is_duplicate(list, i)) continue;
+            const char *name = item_name(list->items[i].path);
+            size_t len = lower_length(name);
+            lower_copy(lower, name, len);
+            for (size_t k = 0; k + 3 <= len; k++) {
+                TrigramSlot *slot = trigram_slot(&table, trigram_at(lower, k), false);
+                if (slot->last == id + 1) continue;
+                slot->last = id + 1;
+                postings[trigrams[slot->table].first + slot->count++] = id;
+            }
+            id++;
+        }
+    }
+    free(table.slots);
+    if (!postings) {
+        free(trigrams);
+        return false;
+    }
+
+    // 4) 헤더 | 항목 | 트라이그램 표 | 번호 목록 | 경로 | 소문자 이름
+    IndexHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, INDEX_MAGIC, sizeof(header.magic));
+    header.version = INDEX_VERSION;
+    header.entry_count = (uint32_t)entry_count;
+    header.trigram_count = (uint32_t)trigram_count;
+    header.posting_count = (uint32_t)posting_count;
+    header.built_at = (int64_t)time(NULL);
+    header.root_dev = (uint64_t)g_root_dev;
+    header.root_ino = (uint64_t)g_root_ino;
+    header.entries_offset = sizeof(IndexHeader);
+    header.trigrams_offset = header.entries_offset + entry_count * sizeof(IndexEntry);
+    header.postings_offset = header.trigrams_offset + trigram_count * sizeof(IndexTrigram);
+    header.strings_offset = header.postings_offset + posting_count * sizeof(uint32_t);
+    header.strings_size = strings_size;
+    header.lower_offset = header.strings_offset + strings_size;
+    header.lower_size = lower_size;
+    snprintf(header.root, sizeof(header.root), "%s", g_root);
+
+    char temp_path[PATH_MAX + 32];
+    snprintf(temp_path, sizeof(temp_path), "%s.tmp.%d", g_index_file, (int)getpid());
+    FILE *out = fopen(temp_path, "wbe");
+    if (!out) {
+        free(trigrams);
+        free(postings);
+        return false;
+    }
+
+    ok = (fwrite(&header, sizeof(header), 1, out) == 1);
+    uint32_t string_pos = 0, lower_pos = 0;
+    for (size_t i = 0; i < list->count && ok; i++) {
+        if (is_duplicate(list, i)) continue;
+        const char *path = list->items[i].path;
+        IndexEntry entry = {0};
+        entry.path = string_pos;
+        entry.name = string_pos + (uint32_t)(item_name(path) - path);
+        entry.lower = lower_pos;
+        entry.type = list->items[i].type;
+        string_pos += (uint32_t)strlen(path) + 1;
+        lower_pos += (uint32_t)lower_length(item_name(path)) + 1;
+        ok = (fwrite(&entry, sizeof(entry), 1, out) == 1);
+    }
+    if (ok && trigram_count > 0) ok = (fwrite(trigrams, sizeof(IndexTrigram), trigram_count, out) == trigram_count);
+    if (ok && posting_count > 0) ok = (fwrite(postings, sizeof(uint32_t), posting_count, out) == posting_count);
+    for (size_t i = 0; i < list->count && ok; i++) {
+        if (is_duplicate(list, i)) continue;
+        ok = (fputs(list->items[i].path, out) >= 0 && fputc('\0', out) != EOF);
+    }
+    for (size_t i = 0; i < list->count && ok; i++) {
+        if (is_duplicate(list, i)) continue;
+        const char *name = item_name(list->items[i].path);
+        size_t len = lower_length(name);
+        lower_copy(lower, name, len);
+        lower[len] = '\0';
+        ok = (fwrite(lower, 1, len + 1, out) == len + 1);
+    }
+    free(trigrams);
+    free(postings);
+
+    if (fclose(out) != 0) ok = false;
+    if (ok && rename(temp_path, g_index_file) != 0) ok = false;
+    if (!ok) unlink(temp_path);
+    return ok;
+}
+
+// ---- 색인 파일 읽기 ----
+
+static void unmap_index(IndexMap *map) {
+    if (map->map) munmap(map->map, map->size);
+    free(map->removed);
+    memset(map, 0, sizeof(IndexMap));
+}
+
+// 색인 파일 매핑 - 다른 루트의 것이거나 손상되었으면 false (잘못된 위치를 읽지 않도록 한 번 훑어 확인)
+static bool map_index_file(IndexMap *out) {
+    memset(out, 0, sizeof(IndexMap));
+    int fd = open(g_index_file, O_RDONLY | O_CLOEXEC);
+    if (fd == -1) return false;
+    struct stat st;
+    if (fstat(fd, &st) == -1 || (size_t)st.st_size < sizeof(IndexHeader)) {
+        close(fd);
+        return false;
+    }
+    void *map = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) return false;
+
+    const IndexHeader *header = map;
+    uint64_t size = (uint64_t)st.st_size;
+    bool ok = memcmp(header->magic, INDEX_MAGIC, sizeof(header->magic)) == 0 &&
+              header->version == INDEX_VERSION &&
+              strncmp(header->root, g_root, sizeof(header->root)) == 0 &&
+              header->root_dev == (uint64_t)g_root_dev && header->root_ino == (uint64_t)g_root_ino &&
+              header->entries_offset == sizeof(IndexHeader) &&
+              header->trigrams_offset == header->entries_offset + (uint64_t)header->entry_count * sizeof(IndexEntry) &&
+              header->postings_offset == header->trigrams_offset + (uint64_t)header->trigram_count * sizeof(IndexTrigram) &&
+              header->strings_offset == header->postings_offset + (uint64_t)header->posting_count * sizeof(uint32_t) &&
+              header->lower_offset == header->strings_offset + header->strings_size &&
+              header->lower_offset + header->lower_size == size &&
+              header->strings_size > 0 && header->lower_size > 0;
+
+    if (ok) {
+        out->map = map;
+        out->size = size;
+        out->header = header;
+        out->entries = (const IndexEntry*)((const char*)map + header->entries_offset);
+        out->trigrams = (const IndexTrigram*)((const char*)map + header->trigrams_offset);
+        out->postings = (const uint32_t*)((const char*)map + header->postings_offset);
+        out->strings = (const char*)map + header->strings_offset;
+        out->lower = (const char*)map + header->lower_offset;
+        ok = out->strings[header->strings_size - 1] == '\0' && out->lower[header->lower_size - 1] == '\0';
+    }
+    for (uint32_t i = 0; ok && i < header->entry_count; i++) {
+        const IndexEntry *e = &out->entries[i];
+        ok = e->path < header->strings_size && e->name >= e->path && e->name < header->strings_size &&
+             e->lower < header->lower_size;
+    }
+    for (uint32_t i = 0; ok && i < header->trigram_count; i++) {
+        ok = (uint64_t)out->trigrams[i].first + out->trigrams[i].count <= header->posting_count;
+    }
+    for (uint32_t i = 0; ok && i < header->posting_count; i++) {
+        ok = out->postings[i] < header->entry_count;
+    }
+    if (ok) {
+        out->removed = calloc(header->entry_count / 8 + 1, 1);
+        ok = (out->removed != NULL);
+    }
+    if (!ok) {
+        munmap(map, st.st_size);
+        memset(out, 0, sizeof(IndexMap));
+        return false;
+    }
+    return true;
+}
+
+static const char* entry_path(const IndexMap *map, uint32_t id) {
+    return map->strings + map->entries[id].path;
+}
+
+// key 이상인 첫 경로의 항목 번호
+static uint32_t base_lower_bound(const char *key) {
+    uint32_t lo = 0, hi = g_map.header->entry_count;
+    while (lo < hi) {
+        uint32_t mid = lo + (hi - lo) / 2;
+        if (strcmp(entry_path(&g_map, mid), key) < 0) lo = mid + 1;
+        else hi = mid;
+    }
+    return lo;
+}
+
+// 경로가 같은 항목 (없으면 -1, g_index_mutex 안에서 호출)
+static long base_find(const char *path) {
+    if (!g_map.map) return -1;
+    uint32_t id = base_lower_bound(path);
+    if (id < g_map.header->entry_count && strcmp(entry_path(&g_map, id), path) == 0) return id;
+    return -1;
+}
+
+static const IndexTrigram* find_trigram(uint32_t trigram) {
+    uint32_t lo = 0, hi = g_map.header->trigram_count;
+    while (lo < hi) {
+        uint32_t mid = lo + (hi - lo) / 2;
+        if (g_map.trigrams[mid].trigram < trigram) lo = mid + 1;
+        else hi = mid;
+    }
+    if (lo < g_map.header->trigram_count && g_map.trigrams[lo].trigram == trigram) return &g_map.trigrams[lo];
+    return NULL;
+}
+
+static bool is_removed(uint32_t id) {
+    return (g_map.removed[id / 8] >> (id % 8)) & 1;
+}
+
+static void set_removed(uint32_t id, bool removed) {
+    if (removed) g_map.removed[id / 8] |= (uint8_t)(1 << (id % 8));
+    else g_map.removed[id / 8] &= (uint8_t)~(1 << (id % 8));
+}
+
+// ---- 변경분 (g_index_mutex 안에서) ----
+
+static long added_find(const char *path) {
+    if (g_added_slot_count == 0) return -1;
+    size_t pos = hash_string(path) & (g_added_slot_count - 1);
+    while (g_added_slots[pos] != -1) {
+        int i = g_added_slots[pos];
+        if (i >= 0 && strcmp(g_added.items[i].path, path) == 0) return (long)pos;
+        pos = (pos + 1) & (g_added_slot_count - 1);
+    }
+    return -1;
+}
+
+// 해시를 다시 만듦 (지워진 칸 정리 겸)
+static bool added_rehash(size_t slot_count) {
+    int *slots = malloc(sizeof(int) * slot_count);
+    if (!slots) return false;
+    for (size_t i = 0; i < slot_count; i++) slots[i] = -1;
+    for (size_t i = 0; i < g_added.count; i++) {
+        if (!g_added.items[i].path) continue;
+        size_t pos = hash_string(g_added.items[i].path) & (slot_count - 1);
+        while (slots[pos] != -1) pos = (pos + 1) & (slot_count - 1);
+        slots[pos] = (int)i;
+    }
+    free(g_added_slots);
+    g_added_slots = slots;
+    g_added_slot_count = slot_count;
+    return true;
+}
+
+static void added_remove_at(long slot) {
+    int i = g_added_slots[slot];
+    free((char*)g_added.items[i].path);
+    g_added.items[i].path = NULL;
+    g_added_slots[slot] = -2;
+}
+
+static void clear_added() {
+    for (size_t i = 0; i < g_added.count; i++) {
+        free((char*)g_added.items[i].path);
+    }
+    free(g_added.items);
+    free(g_added_slots);
+    memset(&g_added, 0, sizeof(g_added));
+    g_added_slots = NULL;
+    g_added_slot_count = 0;
+}
+
+// 항목 추가 (path의 소유권을 넘겨받음)
+static void index_add(char *path, unsigned char type) {
+    pthread_mutex_lock(&g_index_mutex);
+    long id = base_find(path);
+    if (id >= 0) {
+        if (is_removed((uint32_t)id)) {
+            set_removed((uint32_t)id, false);
+            g_changes++;
+        }
+        free(path);
+    } else if (added_find(path) >= 0) {
+        free(path);
+    } else {
+        if ((g_added.count + 1) * 2 > g_added_slot_count) {
+            added_rehash(g_added_slot_count ? g_added_slot_count * 2 : 1024);
+        }
+        if (g_added_slot_count > (g_added.count + 1) && item_list_add(&g_added, path, type)) {
+            size_t pos = hash_string(path) & (g_added_slot_count - 1);
+            while (g_added_slots[pos] >= 0) pos = (pos + 1) & (g_added_slot_count - 1);
+            g_added_slots[pos] = (int)(g_added.count - 1);
+            g_changes++;
+        } else {
+            free(path);
+        }
+    }
+    g_last_change_ms = event_now_ms();
+    pthread_mutex_unlock(&g_index_mutex);
+}
+
+// 항목 삭제 (디렉토리면 아래 항목도 모두)
+static void index_remove(const char *path, bool is_dir) {
+    size_t len = strlen(path);
+    char *prefix = malloc(len + 2);
+    if (!prefix) return;
+    memcpy(prefix, path, len);
+    memcpy(prefix + len, "/", 2);
+
+    pthread_mutex_lock(&g_index_mutex);
+    long id = base_find(path);
+    if (id >= 0) set_removed((uint32_t)id, true);
+    if (is_dir && g_map.map) {
+        // 경로순 정렬이므로 "dir/"로 시작하는 항목은 연속됨
+        uint32_t lo = base_lower_bound(prefix);
+        prefix[len] = '0'; // '/' 바로 다음 글자
+        uint32_t hi = base_lower_bound(prefix);
+        prefix[len] = '/';
+        for (uint32_t i = lo; i < hi; i++) set_removed(i, true);
+    }
+
+    long slot = added_find(path);
+    if (slot >= 0) added_remove_at(slot);
+    if (is_dir) {
+        for (size_t i = 0; i < g_added.count; i++) {
+            if (g_added.items[i].path && strncmp(g_added.items[i].path, prefix, len + 1) == 0) {
+                added_remove_at(added_find(g_added.items[i].path));
+            }
+        }
+    }
+    g_changes++;
+    g_last_change_ms = event_now_ms();
+    pthread_mutex_unlock(&g_index_mutex);
+    free(prefix);
+}
+
+// 새로 만든 색인으로 교체 (변경분은 새 색인에 들어 있으므로 버림)
+static void swap_in(IndexMap *fresh) {
+    pthread_mutex_lock(&g_index_mutex);
+    unmap_index(&g_map);
+    clear_added();
+    g_map = *fresh;
+    g_changes = 0;
+    pthread_mutex_unlock(&g_index_mutex);
+}
+
+// ---- 감시 ----
+
+// 감시하지 못한 디렉토리 기억 (g_watch_mutex 안에서) - 이후 이 디렉토리의 변경은 색인에 들어가지 않음
+static void mark_unwatched(const char *relative) {
+    g_watch_failures++;
+    for (int i = 0; i < g_unwatched_count; i++) {
+        if (strcmp(g_unwatched[i], relative) == 0) return;
+    }
+    char *copy = (g_unwatched_count < INDEX_MAX_UNWATCHED) ? strdup(relative) : NULL;
+    if (!copy) {
+        g_watch_incomplete = true;
+        return;
+    }
+    if (!g_unwatched) {
+        g_unwatched = malloc(sizeof(char*) * INDEX_MAX_UNWATCHED);
+        if (!g_unwatched) {
+            free(copy);
+            g_watch_incomplete = true;
+            return;
+        }
+    }
+    g_unwatched[g_unwatched_count++] = copy;
+}
+
+// 나중에 감시를 시작한 디렉토리는 목록에서 뺌 (g_watch_mutex 안에서)
+static void clear_unwatched(const char *relative) {
+    for (int i = 0; i < g_unwatched_count; i++) {
+        if (strcmp(g_unwatched[i], relative) == 0) {
+            free(g_unwatched[i]);
+            g_unwatched[i] = g_unwatched[--g_unwatched_count];
+            return;
+        }
+    }
+}
+
+static void forget_unwatched() {
+    for (int i = 0; i < g_unwatched_count; i++) {
+        free(g_unwatched[i]);
+    }
+    free(g_unwatched);
+    g_unwatched = NULL;
+    g_unwatched_count = 0;
+    g_watch_incomplete = false;
+}
+
+// prefix("a/b/" 또는 "") 아래 전체가 감시되고 있는지
+static bool fully_watched(const char *prefix) {
+    size_t prefix_len = strlen(prefix);
+    pthread_mutex_lock(&g_watch_mutex);
+    bool complete = !g_watch_incomplete;
+    for (int i = 0; i < g_unwatched_count && complete; i++) {
+        const char *path = g_unwatched[i];
+        // 디렉토리 자신("a/b")이거나 그 아래("a/b/...")면 불완전
+        if (prefix_len == 0 || strncmp(path, prefix, prefix_len) == 0 ||
+            (strncmp(path, prefix, prefix_len - 1) == 0 && path[prefix_len - 1] == '\0')) {
+            complete = false;
+        }
+    }
+    pthread_mutex_unlock(&g_watch_mutex);
+    return complete;
+}
+
+static void watch_directory(const char *relative) {
+    char path[PATH_MAX];
+    full_path(relative, path, sizeof(path));
+
+    pthread_mutex_lock(&g_watch_mutex);
+    bool full = (g_watch_count >= g_watch_limit);
+    if (full || g_inotify_fd == -1) mark_unwatched(relative);
+    pthread_mutex_unlock(&g_watch_mutex);
+    if (full || g_inotify_fd == -1) return;
+
+    int wd = inotify_add_watch(g_inotify_fd, path, INDEX_WATCH_MASK);
+    if (wd < 0) { // 감시 한도(ENOSPC) 등 - 이 디렉토리 아래는 다음 재구성 때까지 탐색으로 찾음
+        pthread_mutex_lock(&g_watch_mutex);
+        mark_unwatched(relative);
+        pthread_mutex_unlock(&g_watch_mutex);
+        return;
+    }
+
+    pthread_mutex_lock(&g_watch_mutex);
+    clear_unwatched(relative);
+    if (wd >= g_watch_capacity) {
+        int capacity = g_watch_capacity ? g_watch_capacity : 1024;
+        while (capacity <= wd) capacity *= 2;
+        char **grown = realloc(g_watch_paths, sizeof(char*) * capacity);
+        if (grown) {
+            memset(grown + g_watch_capacity, 0, sizeof(char*) * (capacity - g_watch_capacity));
+            g_watch_paths = grown;
+            g_watch_capacity = capacity;
+        }
+    }
+    if (wd < g_watch_capacity) {
+        if (g_watch_paths[wd]) {
+            free(g_watch_paths[wd]);
+        } else {
+            g_watch_count++;
+        }
+        g_watch_paths[wd] = strdup(relative);
+    }
+    pthread_mutex_unlock(&g_watch_mutex);
+}
+
+// 밖으로 옮겨진 디렉토리 아래의 감시 해제 (같은 wd로 들어오는 이후 이벤트를 옛 경로로 해석하지 않도록)
+static void unwatch_prefix(const char *relative) {
+    size_t len = strlen(relative);
+    pthread_mutex_lock(&g_watch_mutex);
+    for (int wd = 0; wd < g_watch_capacity; wd++) {
+        const char *path = g_watch_paths[wd];
+        if (!path || strncmp(path, relative, len) != 0 || (path[len] != '\0' && path[len] != '/')) continue;
+        inotify_rm_watch(g_inotify_fd, wd);
+        free(g_watch_paths[wd]);
+        g_watch_paths[wd] = NULL;
+        g_watch_count--;
+    }
+    pthread_mutex_unlock(&g_watch_mutex);
+}
+
+// 색인을 만든 뒤(built_at 이후)에 내용이 바뀌었거나 없어진 디렉토리인지 - 세션 사이의 변경은 inotify가 모르므로
+// (같은 초도 바뀐 것으로 봄)
+static bool changed_since_build(const char *relative) {
+    char path[PATH_MAX];
+    struct stat st;
+    full_path(relative, path, sizeof(path));
+    return lstat(path, &st) == -1 || !S_ISDIR(st.st_mode) || (int64_t)st.st_mtime >= g_map.header->built_at;
+}
+
+// 매핑한 색인의 디렉토리들을 확인하며 감시 (다시 탐색하지 않고 시작할 때)
+// 색인 이후 바뀐 디렉토리가 하나라도 있으면 false (다시 만들어야 함)
+static bool watch_mapped_directories() {
+    // 감시를 먼저 걸고 확인 (확인과 감시 사이의 변경도 놓치지 않도록)
+    if (!g_map.map) return false;
+    watch_directory("");
+    if (changed_since_build("")) return false;
+    uint32_t count = g_map.header->entry_count;
+    for (uint32_t i = 0; i < count && !g_index_stop; i++) {
+        if (g_map.entries[i].type != DT_DIR) continue;
+        const char *path = entry_path(&g_map, i);
+        watch_directory(path);
+        if (changed_since_build(path)) return false;
+    }
+    return !g_index_stop;
+}
+
+// ---- 탐색 ----
+
+typedef struct {
+    ItemList *list;          // NULL이면 변경분에 바로 추가 (실행 중 새로 생긴 하위 트리)
+    pthread_mutex_t lock;
+} Crawl;
+
+static bool crawl_enter_dir(Walker *w, WalkDir *dir, int dirfd) {
+    (void)dirfd;
+    if (g_index_stop) {
+        walker_cancel(w);
+        return false;
+    }
+    if (strcmp(dir->path, g_index_dir) == 0) return false;
+    watch_directory(relative_of(dir->path));
+    return true;
+}
+
+static bool crawl_visit(Walker *w, WalkDir *dir, int dirfd, const char *name,
+                        unsigned char d_type, const struct stat *st) {
+    (void)dirfd;
+    (void)st;
+    Crawl *crawl = (Crawl*)w->user;
+    char *path = join_relative(relative_of(dir->path), name);
+    if (!path) return true;
+
+    if (crawl->list) {
+        pthread_mutex_lock(&crawl->lock);
+        bool added = item_list_add(crawl->list, path, d_type);
+        pthread_mutex_unlock(&crawl->lock);
+        if (!added) free(path);
+    } else {
+        index_add(path, d_type);
+    }
+    return true;
+}
+
+// 디렉토리 아래 전체 탐색 (이름과 d_type만, 같은 파일시스템 안), 취소되면 false
+static bool crawl_tree(const char *path, ItemList *list) {
+    Crawl crawl = { .list = list };
+    pthread_mutex_init(&crawl.lock, NULL);
+    WalkOps ops = { .enter_dir = crawl_enter_dir, .visit = crawl_visit };
+    Walker walker;
+    walker_init(&walker, &ops, &crawl);
+    walker.need_stat = false;
+    walker.one_filesystem = true;
+    walker.nthreads = INDEX_CRAWL_THREADS;
+    bool ok = walker_run(&walker, path) && !walker.cancel;
+    walker_destroy(&walker);
+    pthread_mutex_destroy(&crawl.lock);
+    return ok;
+}
+
+// 처음부터 다시 만들기 - 탐색하는 동안에는 이전 색인으로 계속 답함
+static void rebuild_index() {
+    ItemList list = {0};
+    IndexMap fresh;
+    pthread_mutex_lock(&g_watch_mutex);
+    long failures = g_watch_failures;
+    pthread_mutex_unlock(&g_watch_mutex);
+    bool crawled = crawl_tree(g_root, &list);
+    if (crawled && write_index(&list) && map_index_file(&fresh)) {
+        swap_in(&fresh);
+        pthread_mutex_lock(&g_index_mutex);
+        g_verified = true;
+        pthread_mutex_unlock(&g_index_mutex);
+    }
+    // 모든 디렉토리를 다시 감시했으면 예전에 감시하지 못한 디렉토리 목록은 필요 없음 (그 사이 지워진 것 포함)
+    pthread_mutex_lock(&g_watch_mutex);
+    if (crawled && g_watch_failures == failures) forget_unwatched();
+    pthread_mutex_unlock(&g_watch_mutex);
+    for (size_t i = 0; i < list.count; i++) {
+        free((char*)list.items[i].path);
+    }
+    free(list.items);
+    g_need_rebuild = false;
+}
+
+// 변경분을 합쳐 새 파일로 (탐색 없이)
+static void save_merged() {
+    ItemList list = {0};
+    bool ok = true;
+    uint32_t count = g_map.map ? g_map.header->entry_count : 0;
+    for (uint32_t i = 0; i < count && ok; i++) {
+        if (!is_removed(i)) ok = item_list_add(&list, entry_path(&g_map, i), g_map.entries[i].type);
+    }
+    for (size_t i = 0; i < g_added.count && ok; i++) {
+        if (g_added.items[i].path) ok = item_list_add(&list, g_added.items[i].path, g_added.items[i].type);
+    }
+
+    IndexMap fresh;
+    if (ok && write_index(&list) && map_index_file(&fresh)) {
+        swap_in(&fresh);
+    } else {
+        g_last_change_ms = event_now_ms(); // 저장하지 못했으면 조금 뒤에 다시
+    }
+    free(list.items);
+}
+
+// ---- inotify ----
+
+static unsigned char type_of(const char *relative) {
+    char path[PATH_MAX];
+    struct stat st;
+    full_path(relative, path, sizeof(path));
+    if (lstat(path, &st) == -1) return DT_UNKNOWN;
+    if (S_ISDIR(st.st_mode)) return DT_DIR;
+    if (S_ISLNK(st.st_mode)) return DT_LNK;
+    if (S_ISREG(st.st_mode)) return DT_REG;
+    return DT_UNKNOWN;
+}
+
+static void apply_event(const struct inotify_event *event) {
+    if (event->mask & IN_Q_OVERFLOW) {
+        g_need_rebuild = true; // 놓친 변경이 있으므로 다시 탐색
+        return;
+    }
+
+    char dir[PATH_MAX];
+    bool known = false;
+    pthread_mutex_lock(&g_watch_mutex);
+    if (event->wd >= 0 && event->wd < g_watch_capacity && g_watch_paths[event->wd]) {
+        snprintf(dir, sizeof(dir), "%s", g_watch_paths[event->wd]);
+        known = true;
+        if (event->mask & IN_IGNORED) {
+            free(g_watch_paths[event->wd]);
+            g_watch_paths[event->wd] = NULL;
+            g_watch_count--;
+        }
+    }
+    pthread_mutex_unlock(&g_watch_mutex);
+    if (!known || event->len == 0 || event->name[0] == '\0') return;
+
+    char *path = join_relative(dir, event->name);
+    if (!path) return;
+    bool is_dir = (event->mask & IN_ISDIR) != 0;
+
+    if (event->mask & (IN_CREATE | IN_MOVED_TO)) {
+        char full[PATH_MAX];
+        full_path(path, full, sizeof(full));
+        if (!is_dir) {
+            index_add(strdup(path), type_of(path));
+        } else if (strcmp(full, g_index_dir) != 0) {
+            // 옮겨 오거나 감시를 시작하기 전에 안에 만든 항목도 있을 수 있으므로 하위 트리를 탐색
+            index_add(strdup(path), DT_DIR);
+            crawl_tree(full, NULL);
+        }
+    } else if (event->mask & (IN_DELETE | IN_MOVED_FROM)) {
+        index_remove(path, is_dir);
+        if (is_dir && (event->mask & IN_MOVED_FROM)) {
+            unwatch_prefix(path);
+        }
+    }
+    free(path);
+}
+
+static void read_events() {
+    char buffer[64 * 1024] __attribute__((aligned(__alignof__(struct inotify_event))));
+    while (1) {
+        ssize_t len = read(g_inotify_fd, buffer, sizeof(buffer));
+        if (len <= 0) break;
+        for (char *p = buffer; p < buffer + len;) {
+            const struct inotify_event *event = (const struct inotify_event*)p;
+            apply_event(event);
+            p += sizeof(struct inotify_event) + event->len;
+        }
+    }
+}
+
+// 색인 스레드 - 낮은 우선순위로 만들고 감시하다가, 변경이 멈추면 합쳐 저장
+static void* index_thread(void *arg) {
+    (void)arg;
+    pid_t tid = (pid_t)syscall(SYS_gettid);
+    setpriority(PRIO_PROCESS, tid, 19);
+#ifdef SYS_ioprio_set
+    syscall(SYS_ioprio_set, 1 /* IOPRIO_WHO_PROCESS */, tid, 3 << 13 /* IOPRIO_CLASS_IDLE */);
+#endif
+
+    // 저장된 색인은 디렉토리 수정 시각으로 확인한 뒤에만 씀 (그 전까지 찾기는 탐색으로)
+    bool fresh = g_map.map && time(NULL) - (time_t)g_map.header->built_at < g_refresh_sec;
+    if (fresh && watch_mapped_directories()) {
+        pthread_mutex_lock(&g_index_mutex);
+        g_verified = true;
+        pthread_mutex_unlock(&g_index_mutex);
+    } else {
+        fresh = false;
+        rebuild_index();
+    }
+
+    // 오래 켜 둔 세션도 색인이 g_refresh_sec보다 오래되면 다시 만듦 (0이면 시작할 때만)
+    time_t refresh_due = 0;
+    if (g_refresh_sec > 0) {
+        refresh_due = (fresh ? (time_t)g_map.header->built_at : time(NULL)) + g_refresh_sec;
+    }
+
+    while (!g_index_stop) {
+        int timeout_ms = -1;
+        if (g_changes > 0) {
+            long wait = INDEX_SAVE_DELAY_MS - (event_now_ms() - g_last_change_ms);
+            timeout_ms = wait > 0 ? (int)wait : 0;
+        }
+        if (refresh_due != 0) {
+            long wait = (long)(refresh_due - time(NULL)) * 1000;
+            if (wait < 0) wait = 0;
+            if (wait > INT_MAX) wait = INT_MAX;
+            if (timeout_ms < 0 || wait < timeout_ms) timeout_ms = (int)wait;
+        }
+        struct pollfd fds[2] = {
+            { .fd = g_inotify_fd, .events = POLLIN },
+            { .fd = g_wake_fd, .events = POLLIN }
+        };
+        int ready = poll(fds, 2, timeout_ms);
+        if (g_index_stop) break;
+        if (ready > 0 && (fds[0].revents & POLLIN)) {
+            read_events();
+        }
+
+        if (refresh_due != 0 && time(NULL) >= refresh_due) {
+            g_need_rebuild = true;
+        }
+        if (g_need_rebuild) {
+            rebuild_index();
+            if (refresh_due != 0) refresh_due = time(NULL) + g_refresh_sec;
+        } else if (g_changes >= INDEX_COMPACT_CHANGES ||
+                   (g_changes > 0 && event_now_ms() - g_last_change_ms >= INDEX_SAVE_DELAY_MS)) {
+            save_merged();
+        }
+    }
+
+    if (g_changes > 0) {
+        save_merged();
+    }
+    return NULL;
+}
+
+// ---- 공개 함수 ----
+
+// 캐시 디렉토리 ($XDG_CACHE_HOME/finder 또는 ~/.cache/finder) 준비
+static bool prepare_index_dir() {
+    char base[PATH_MAX];
+    const char *cache = getenv("XDG_CACHE_HOME");
+    const char *home = getenv("HOME");
+    if (cache && cache[0] == '/') {
+        snprintf(base, sizeof(base), "%s", cache);
+    } else if (home && home[0] == '/') {
+        snprintf(base, sizeof(base), "%s/.cache", home);
+    } else {
+        return false;
+    }
+    if (mkdir(base, 0700) != 0 && errno != EEXIST) return false;
+
+    char dir[PATH_MAX + 8];
+    snprintf(dir, sizeof(dir), "%s/finder", base);
+    if (mkdir(dir, 0700) != 0 && errno != EEXIST) return false;
+    return realpath(dir, g_index_dir) != NULL;
+}
+
+// 사용자별 inotify 감시 한도 중 이 실행이 쓸 몫 (다른 도구와 다른 finder 인스턴스가 쓸 자리를 남김)
+static int watch_limit() {
+    int limit = INDEX_MAX_WATCHES;
+    FILE *f = fopen("/proc/sys/fs/inotify/max_user_watches", "r");
+    if (f) {
+        long system_limit;
+        if (fscanf(f, "%ld", &system_limit) == 1 && system_limit / INDEX_WATCH_SHARE < limit) {
+            limit = (int)(system_limit / INDEX_WATCH_SHARE);
+        }
+        fclose(f);
+    }
+    return limit;
+}
+
+bool init_index_system() {
+    // 홈 전체를 탐색하고 감시하므로 켤 때만 (FINDER_INDEX=1)
+    const char *enabled = getenv("FINDER_INDEX");
+    if (!enabled || strcmp(enabled, "1") != 0) return true;
+    g_watch_limit = watch_limit();
+
+    const char *refresh = getenv("FINDER_INDEX_REFRESH");
+    if (refresh && refresh[0] != '\0') {
+        char *end;
+        long value = strtol(refresh, &end, 10);
+        if (*end == '\0' && value >= 0) g_refresh_sec = value;
+    }
+
+    const char *root = getenv("FINDER_INDEX_ROOT");
+    if (!root || root[0] == '\0') root = getenv("HOME");
+    struct stat st;
+    if (!root || !realpath(root, g_root) || stat(g_root, &st) == -1 || !S_ISDIR(st.st_mode)) {
+        return false;
+    }
+    g_root_len = strlen(g_root);
+    g_root_dev = st.st_dev;
+    g_root_ino = st.st_ino;
+
+    if (!prepare_index_dir()) return false;
+    snprintf(g_index_file, sizeof(g_index_file), "%s/index-%016llx", g_index_dir,
+             (unsigned long long)hash_string(g_root));
+
+    // 시작할 때는 매핑만 (다시 만들지는 색인 스레드가 판단)
+    map_index_file(&g_map);
+
+    g_inotify_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    g_wake_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    g_index_stop = false;
+    g_index_started = (pthread_create(&g_index_thread, NULL, index_thread, NULL) == 0);
+    return g_index_started;
+}
+
+void cleanup_index_system() {
+    if (!g_index_started) return;
+    g_index_stop = true;
+    uint64_t one = 1;
+    ssize_t written = write(g_wake_fd, &one, sizeof(one));
+    (void)written;
+    pthread_join(g_index_thread, NULL);
+    g_index_started = false;
+    g_verified = false;
+
+    unmap_index(&g_map);
+    clear_added();
+    for (int i = 0; i < g_watch_capacity; i++) {
+        free(g_watch_paths[i]);
+    }
+    free(g_watch_paths);
+    g_watch_paths = NULL;
+    g_watch_capacity = 0;
+    g_watch_count = 0;
+    forget_unwatched();
+    g_watch_failures = 0;
+    if (g_inotify_fd != -1) close(g_inotify_fd);
+    if (g_wake_fd != -1) close(g_wake_fd);
+    g_inotify_fd = -1;
+    g_wake_fd = -1;
+}
+
+// 항목 하나 확인 후 결과로 (더 받을 수 없으면 false)
+static bool lookup_entry(const char *path, const char *lower_name, unsigned char type, size_t prefix_len,
+                         const char *literal, int max_depth, IndexMatchFn match, IndexHitFn hit,
+                         void *user, int *found, int max_hits) {
+    if (literal[0] != '\0' && !strstr(lower_name, literal)) return true;
+    const char *relative = path + prefix_len;
+    if (max_depth >= 0) {
+        int depth = 0;
+        for (const char *p = relative; *p; p++) {
+            if (*p == '/' && ++depth > max_depth) return true;
+        }
+    }
+    if (!match(user, item_name(path))) return true;
+    hit(user, relative, type);
+    return ++(*found) < max_hits;
+}
+
+int index_lookup(const char *dir, const char *literal, int max_depth, IndexMatchFn match,
+                 IndexHitFn hit, void *user, int max_hits) {
+    if (!g_index_started) return -1;
+
+    // 색인 루트 기준 접두어 ("a/b/", 루트면 "")
+    char prefix[PATH_MAX + 2];
+    if (strcmp(dir, g_root) == 0) {
+        prefix[0] = '\0';
+    } else if (strncmp(dir, g_root, g_root_len) == 0 && (dir[g_root_len] == '/' || g_root_len == 1)) {
+        snprintf(prefix, sizeof(prefix), "%s/", relative_of(dir));
+    } else {
+        return -1;
+    }
+    // 다른 파일시스템(마운트 지점 아래)과 색인하지 않는 캐시 디렉토리는 색인으로 답할 수 없음
+    struct stat st;
+    if (stat(dir, &st) == -1 || st.st_dev != g_root_dev) return -1;
+    size_t index_dir_len = strlen(g_index_dir);
+    if (strncmp(dir, g_index_dir, index_dir_len) == 0 && (dir[index_dir_len] == '\0' || dir[index_dir_len] == '/')) {
+        return -1;
+    }
+
+    // 변경을 감시하지 못한 디렉토리가 아래에 있으면 새로 생긴 항목을 놓칠 수 있으므로 탐색으로
+    if (!fully_watched(prefix)) return -1;
+
+    pthread_mutex_lock(&g_index_mutex);
+    if (!g_map.map || !g_verified) {
+        pthread_mutex_unlock(&g_index_mutex);
+        return -1;
+    }
+
+    size_t prefix_len = strlen(prefix);
+    uint32_t lo = 0, hi = g_map.header->entry_count;
+    if (prefix_len > 0) {
+        lo = base_lower_bound(prefix);
+        prefix[prefix_len - 1] = '0'; // '/' 바로 다음 글자
+        hi = base_lower_bound(prefix);
+        prefix[prefix_len - 1] = '/';
+    }
+
+    // 검색어의 트라이그램 중 항목이 가장 적은 것의 번호 목록만 확인
+    size_t literal_len = strlen(literal);
+    const uint32_t *candidates = NULL;
+    uint32_t candidate_count = 0;
+    bool use_postings = literal_len >= 3;
+    for (size_t i = 0; use_postings && i + 3 <= literal_len; i++) {
+        const IndexTrigram *trigram = find_trigram(trigram_at(literal, i));
+        if (!trigram) {
+            candidates = NULL;
+            candidate_count = 0;
+            break;
+        }
+        if (!candidates || trigram->count < candidate_count) {
+            candidates = g_map.postings + trigram->first;
+            candidate_count = trigram->count;
+        }
+    }
+
+    int found = 0;
+    bool more = max_hits > 0;
+    if (use_postings) {
+        for (uint32_t k = 0; k < candidate_count && more; k++) {
+            uint32_t id = candidates[k];
+            if (id < lo) continue;
+            if (id >= hi) break; // 번호 목록은 오름차순 (= 경로순)
+            if (is_removed(id)) continue;
+            const IndexEntry *e = &g_map.entries[id];
+            more = lookup_entry(g_map.strings + e->path, g_map.lower + e->lower, e->type, prefix_len,
+                                literal, max_depth, match, hit, user, &found, max_hits);
+        }
+    } else {
+        for (uint32_t id = lo; id < hi && more; id++) {
+            if (is_removed(id)) continue;
+            const IndexEntry *e = &g_map.entries[id];
+            more = lookup_entry(g_map.strings + e->path, g_map.lower + e->lower, e->type, prefix_len,
+                                literal, max_depth, match, hit, user, &found, max_hits);
+        }
+    }
+
+    // 매핑 이후 생긴 항목
+    for (size_t i = 0; i < g_added.count && more; i++) {
+        const char *path = g_added.items[i].path;
+        if (!path || strncmp(path, prefix, prefix_len) != 0) continue;
+        const char *name = item_name(path);
+        char lower_name[NAME_MAX + 1];
+        size_t len = lower_length(name);
+        lower_copy(lower_name, name, len);
+        lower_name[len] = '\0';
+        more = lookup_entry(path, lower_name, g_added.items[i].type, prefix_len, literal, max_depth,
+                            match, hit, user, &found, max_hits);
+    }
+    pthread_mutex_unlock(&g_index_mutex);
+    return found;
+}
@@ -0,0 +1,74 @@
+// index.h
+#ifndef INDEX_H
+#define INDEX_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define INDEX_MAGIC "FNDIDX01"
+#define INDEX_VERSION 1
+#define INDEX_DEFAULT_REFRESH 3600   // 색인이 이보다 오래되면 (초) 백그라운드에서 다시 만듦 (FINDER_INDEX_REFRESH, 0이면 시작할 때마다)
+#define INDEX_MAX_WATCHES 8192       // 변경을 감시하는 최대 디렉토리 수 (넘으면 그 아래는 색인으로 답하지 않음)
+#define INDEX_WATCH_SHARE 8          // 커널의 사용자별 감시 한도(max_user_watches) 중 이 분의 1까지만 씀
+#define INDEX_MAX_UNWATCHED 256      // 감시하지 못한 디렉토리를 따로 기억하는 수 (넘으면 색인 전체를 불완전으로 봄)
+#define INDEX_SAVE_DELAY_MS 10000    // 변경이 있고 이만큼 조용하면 변경분을 합쳐 파일로 저장
+#define INDEX_COMPACT_CHANGES 20000  // 변경분이 이만큼 쌓이면 바로 합쳐 저장
+#define INDEX_CRAWL_THREADS 4        // 색인 탐색 워커 수 (백그라운드 작업이므로 적게)
+
+// 파일 이름 색인 - 색인 루트(FINDER_INDEX_ROOT, 기본 홈) 아래 모든 경로를 한 파일에 저장하고 mmap으로 읽음
+// 파일 구조: 헤더 | 항목(경로순 정렬) | 트라이그램 표(정렬) | 항목 번호 목록 | 경로 문자열 | 소문자 이름
+// 시작할 때는 기존 파일을 매핑하고 디렉토리 수정 시각으로 확인만 하며 (바뀐 곳이 있으면 다시 만듦), 실행 중의 변경은 inotify로 받아 메모리의 변경분에 반영
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t entry_count;
+    uint32_t trigram_count;
+    uint32_t posting_count;
+    int64_t built_at;            // 만든 시각 (time())
+    uint64_t root_dev;
+    uint64_t root_ino;
+    uint64_t entries_offset;
+    uint64_t trigrams_offset;
+    uint64_t postings_offset;
+    uint64_t strings_offset;
+    uint64_t strings_size;
+    uint64_t lower_offset;
+    uint64_t lower_size;
+    char root[1024];
+} IndexHeader;
+
+typedef struct {
+    uint32_t path;               // 경로 문자열 위치 (색인 루트 기준 상대 경로)
+    uint32_t name;               // 이름이 시작하는 위치 (경로 안)
+    uint32_t lower;              // 소문자 이름 위치
+    uint8_t type;                // d_type
+    uint8_t reserved[3];
+} IndexEntry;
+
+typedef struct {
+    uint32_t trigram;            // 소문자 이름의 연속된 세 바이트
+    uint32_t first;              // 항목 번호 목록에서의 시작 위치
+    uint32_t count;              // 이 트라이그램이 들어 있는 항목 수 (번호는 오름차순)
+} IndexTrigram;
+
+// 이름 확인 (true면 결과에 넣음)
+typedef bool (*IndexMatchFn)(void *user, const char *name);
+
+// 맞는 항목 하나 (relative_path는 찾기 시작한 디렉토리 기준)
+typedef void (*IndexHitFn)(void *user, const char *relative_path, unsigned char d_type);
+
+// 색인 시스템 시작 (기존 색인을 매핑하고 백그라운드 스레드가 감시/재구성), FINDER_INDEX=1일 때만 켬
+bool init_index_system();
+
+// 색인 스레드 종료 (저장하지 않은 변경분은 파일에 합침)
+void cleanup_index_system();
+
+// dir 아래에서 이름 찾기 - literal(소문자)이 3바이트 이상이면 트라이그램으로 후보를 좁힘
+// 색인이 아직 없거나 이번 세션에서 확인되지 않았거나 dir이 색인 범위 밖(다른 파일시스템 포함)이거나 그 아래에 변경을 감시하지 못한 디렉토리가 있으면 -1,
+// 아니면 찾은 수
+// max_depth < 0이면 깊이 제한 없음, 콜백은 색인 잠금 안에서 호출됨
+int index_lookup(const char *dir, const char *literal, int max_depth, IndexMatchFn match,
+                 IndexHitFn hit, void *user, int max_hits);
+
+#endif
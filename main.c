@@ -5,9 +5,366 @@
 #include <locale.h>
 #include <unistd.h>
 #include <sys/wait.h>
+#include <fnmatch.h>
 
 #include "ui.h"
 #include "fs.h"
+#include "trash.h"
+#include "event.h"
+#include "filter.h"
+#include "preview.h"
+#include "search.h"
+#include "usage.h"
+#include "dupes.h"
+#include "compare.h"
+#include "index.h"
+#include "filetype.h"
+#include "archive.h"
+
+// 표시된 항목 수 세기
+static int count_marked(const FileEntry *files, int file_count) {
+    int count = 0;
+    for (int i = 0; i < file_count; i++) {
+        if (files[i].is_marked) count++;
+    }
+    return count;
+}
+
+// 표시된 항목 이름 모으기 (names는 file_count 이상 크기)
+static int collect_marked(FileEntry *files, int file_count, const char **names) {
+    int count = 0;
+    for (int i = 0; i < file_count; i++) {
+        if (files[i].is_marked) names[count++] = files[i].name;
+    }
+    return count;
+}
+
+// 모든 표시 해제
+static void clear_marks(FileEntry *files, int file_count) {
+    for (int i = 0; i < file_count; i++) {
+        files[i].is_marked = false;
+    }
+}
+
+// 검색어 입력 상태 (/: 이름으로 이동, f: 목록 거르기)
+typedef enum {
+    INPUT_NONE = 0,
+    INPUT_JUMP,     // 입력할 때마다 맞는 항목으로 선택 이동
+    INPUT_FILTER    // 입력할 때마다 목록을 맞는 항목으로 좁힘
+} InputMode;
+
+// 목록 필터 - 켜져 있으면 files에는 맞는 항목만 들어 있고 전체 목록은 따로 보관
+static FileEntry g_full_listing[MAX_FILES];
+static int g_full_count = 0;
+static int g_filter_map[MAX_FILES];    // files 인덱스 → 전체 목록 인덱스
+static int g_filter_shown = 0;         // g_filter_map이 유효한 항목 수
+static NamePool g_filter_pool;
+static bool g_filter_active = false;
+static char g_filter_query[FILTER_MAX_QUERY];
+
+// 필터 결과로 files 채우기 (".."은 항상 남기고, 표시(mark)는 전체 목록에 되돌려 놓은 뒤 옮김)
+static int apply_filter(FileEntry *files) {
+    for (int i = 0; i < g_filter_shown; i++) {
+        g_full_listing[g_filter_map[i]].is_marked = files[i].is_marked;
+    }
+
+    int count = 0;
+    int next_match = 0;
+    for (int i = 0; i < g_full_count; i++) {
+        bool matched = (next_match < g_filter_pool.match_count && g_filter_pool.matches[next_match] == i);
+        if (matched) next_match++;
+        if (matched || strcmp(g_full_listing[i].name, "..") == 0) {
+            files[count] = g_full_listing[i];
+            g_filter_map[count] = i;
+            count++;
+        }
+    }
+    g_filter_shown = count;
+    return count;
+}
+
+// 필터 시작 (현재 목록을 전체 목록으로 보관하고 이름 색인 생성)
+static void start_filter(const FileEntry *files, int file_count) {
+    if (g_filter_active) return;
+    memcpy(g_full_listing, files, sizeof(FileEntry) * file_count);
+    g_full_count = file_count;
+    for (int i = 0; i < file_count; i++) {
+        g_filter_map[i] = i;
+    }
+    g_filter_shown = file_count;
+    g_filter_query[0] = '\0';
+    name_pool_build(&g_filter_pool, g_full_listing, g_full_count);
+    g_filter_active = true;
+}
+
+// 필터 해제 - 전체 목록으로 되돌림 (목록 크기 반환)
+static int clear_filter(FileEntry *files, int file_count) {
+    if (!g_filter_active) return file_count;
+    for (int i = 0; i < g_filter_shown; i++) {
+        g_full_listing[g_filter_map[i]].is_marked = files[i].is_marked;
+    }
+    memcpy(files, g_full_listing, sizeof(FileEntry) * g_full_count);
+    name_pool_free(&g_filter_pool);
+    g_filter_active = false;
+    g_filter_query[0] = '\0';
+    return g_full_count;
+}
+
+// 디렉토리 목록 읽기 (필터가 켜져 있으면 전체 목록을 읽은 뒤 같은 검색어로 다시 거름)
+static int load_listing(const char *path, FileEntry *files) {
+    if (!g_filter_active) {
+        return get_file_list(path, files, MAX_FILES);
+    }
+    g_full_count = get_file_list(path, g_full_listing, MAX_FILES);
+    g_filter_shown = 0; // 새 목록이므로 이전 표시를 옮기지 않음
+    name_pool_build(&g_filter_pool, g_full_listing, g_full_count);
+    name_pool_search(&g_filter_pool, g_filter_query);
+    return apply_filter(files);
+}
+
+// 이름으로 항목 찾기 (없으면 -1)
+static int find_entry(const FileEntry *files, int file_count, const char *name) {
+    for (int i = 0; i < file_count; i++) {
+        if (strcmp(files[i].name, name) == 0) return i;
+    }
+    return -1;
+}
+
+// 퍼지 찾기 (Ctrl+F) - 현재 목록 전체를 채점해 상위 결과만 순위대로 보여 줌
+typedef struct {
+    bool active;
+    NamePool pool;                          // 현재 목록 기준 이름 색인
+    char query[FILTER_MAX_QUERY];
+    size_t len;
+    FuzzyMatch results[FUZZY_MAX_RESULTS];  // 점수 순 상위 결과
+    int result_count;
+    int match_count;                        // 맞는 전체 항목 수
+    int selection;                          // results 안에서의 선택
+} FuzzyFinder;
+
+// 검색어가 바뀌었거나 목록을 다시 읽었으면 다시 채점
+static void refresh_fuzzy(FuzzyFinder *finder) {
+    finder->match_count = name_pool_fuzzy(&finder->pool, finder->query, finder->results,
+                                          FUZZY_MAX_RESULTS, &finder->result_count);
+    if (finder->selection >= finder->result_count) {
+        finder->selection = finder->result_count > 0 ? finder->result_count - 1 : 0;
+    }
+}
+
+static bool open_fuzzy(FuzzyFinder *finder, const FileEntry *files, int file_count) {
+    if (!name_pool_build(&finder->pool, files, file_count)) return false;
+    finder->active = true;
+    finder->query[0] = '\0';
+    finder->len = 0;
+    finder->selection = 0;
+    refresh_fuzzy(finder);
+    return true;
+}
+
+static void close_fuzzy(FuzzyFinder *finder) {
+    finder->active = false;
+    name_pool_free(&finder->pool);
+}
+
+// 목록을 다시 읽되 표시(mark)는 이름 기준으로 유지 (filtered면 켜져 있는 필터를 다시 적용)
+static int reload_file_list(const char *path, FileEntry *files, int file_count, bool filtered) {
+    static FileEntry previous[MAX_FILES];
+    int marked = count_marked(files, file_count);
+    if (marked > 0) {
+        memcpy(previous, files, sizeof(FileEntry) * file_count);
+    }
+
+    int new_count = filtered ? load_listing(path, files) : get_file_list(path, files, MAX_FILES);
+    for (int i = 0; marked > 0 && i < file_count; i++) {
+        if (!previous[i].is_marked) continue;
+        for (int j = 0; j < new_count; j++) {
+            if (strcmp(previous[i].name, files[j].name) == 0) {
+                files[j].is_marked = true;
+                break;
+            }
+        }
+    }
+    return new_count;
+}
+
+// 분할 화면 (s: 켜기/끄기, Tab: 칸 전환)
+// 활성 칸은 메인 루프의 변수들(files, current_path, ...)을 그대로 쓰고, 다른 칸은 Pane에 보관했다가 Tab으로 맞바꿈
+// 두 칸의 목록은 get_file_list의 목록 캐시를 함께 쓰므로 같은 디렉토리를 두 번 읽지 않음
+typedef struct {
+    FileEntry *files;
+    int file_count;
+    int selection;
+    int scroll_offset;
+    char path[MAX_PATH_LEN];
+    char disk_free[32];
+    bool dirty;            // 다시 읽어야 함 (inotify, 작업 완료)
+} Pane;
+
+static FileEntry g_pane_files[2][MAX_FILES];
+
+// 보관 중인 칸 다시 읽기 (표시는 이름 기준으로 유지, 필터는 활성 칸에만 있음)
+static void reload_pane(Pane *pane) {
+    pane->file_count = reload_file_list(pane->path, pane->files, pane->file_count, false);
+    if (pane->file_count < 0) pane->file_count = 0;
+    if (pane->selection >= pane->file_count) {
+        pane->selection = pane->file_count > 0 ? pane->file_count - 1 : 0;
+    }
+    update_file_copy_status(pane->files, pane->file_count, pane->path);
+    get_disk_free_space(pane->path, pane->disk_free, sizeof(pane->disk_free));
+    pane->dirty = false;
+}
+
+// 압축 파일 보기 - 목록을 압축 안의 디렉토리로 바꿔 보여 줌 (current_path는 압축 파일이 있는 디렉토리 그대로)
+// 오르내리기와 표시, 꺼내기만 받고 디스크의 파일을 바꾸거나 현재 경로를 쓰는 키는 막음
+typedef struct {
+    bool active;
+    Archive *archive;
+    char name[MAX_NAME_LEN];            // 압축 파일 이름 (나올 때 이 항목을 선택)
+    char prefix[MAX_PATH_LEN];          // 압축 안의 현재 디렉토리 ("" 또는 "a/b/")
+    char shown_path[MAX_PATH_LEN * 2];  // 푸터와 칸 제목에 보일 경로 ("/x/a.tar:/a/b")
+} ArchiveView;
+
+// 압축 안의 현재 디렉토리 목록 읽기
+static int load_archive_listing(ArchiveView *view, const char *current_path, FileEntry *files) {
+    int len = (int)strlen(view->prefix);
+    snprintf(view->shown_path, sizeof(view->shown_path), "%s/%s:/%.*s",
+             strcmp(current_path, "/") == 0 ? "" : current_path, view->name, len > 0 ? len - 1 : 0, view->prefix);
+    return archive_list(view->archive, view->prefix, files, MAX_FILES);
+}
+
+static void close_archive_view(ArchiveView *view) {
+    if (!view->active) return;
+    archive_release(view->archive);
+    memset(view, 0, sizeof(ArchiveView));
+}
+
+// 표시한 항목(없으면 선택한 항목)의 압축 안 경로 (".." 제외, 돌려준 문자열은 호출한 쪽이 해제)
+static int collect_archive_members(const ArchiveView *view, const FileEntry *files, int file_count, int selection,
+                                   char **out) {
+    int count = 0;
+    bool any_marked = count_marked((FileEntry*)files, file_count) > 0;
+    for (int i = 0; i < file_count; i++) {
+        if (any_marked ? !files[i].is_marked : i != selection) continue;
+        if (strcmp(files[i].name, "..") == 0) continue;
+        size_t size = strlen(view->prefix) + strlen(files[i].name) + 1;
+        out[count] = malloc(size);
+        if (!out[count]) break;
+        snprintf(out[count], size, "%s%s", view->prefix, files[i].name);
+        count++;
+    }
+    return count;
+}
+
+// 진행률 패널에 보일 작업 (g_tasks_mutex 안에서 호출)
+// 실행 중인 작업을 우선 표시하고, 모두 대기 중이면 대기 중인 작업 표시
+static CopyTask* shown_task() {
+    CopyTask* shown = NULL;
+    for (CopyTask* task = g_copy_tasks; task; task = task->next) {
+        if (task->is_running && (!shown || (shown->is_queued && !task->is_queued))) {
+            shown = task;
+        }
+    }
+    return shown;
+}
+
+// 대화상자 응답을 기다리는 동작 (대화상자는 메인 루프가 키를 넘겨 주며 진행)
+typedef enum {
+    PENDING_NONE = 0,
+    PENDING_MARK_PATTERN,   // 패턴으로 표시 (*)
+    PENDING_DELETE,         // 삭제 또는 휴지통으로 이동 확인
+    PENDING_DELETE_FORCE,   // 휴지통으로 옮기지 못한 항목을 바로 삭제할지 확인
+    PENDING_CANCEL_TASK,    // 백그라운드 작업 취소 확인
+    PENDING_SEARCH,         // 하위 디렉토리에서 이름 찾기 (F)
+    PENDING_GREP,           // 하위 디렉토리에서 내용 찾기 (G)
+    PENDING_DUPES_LINK,     // 중복 파일을 하드 링크로 바꿀지 확인
+    PENDING_SYNC_MIRROR     // 대상에만 있는 항목을 지우는 동기화 확인
+} PendingKind;
+
+typedef struct {
+    PendingKind kind;
+    char dir[MAX_PATH_LEN];   // 항목들이 있는 디렉토리
+    char dest[MAX_PATH_LEN];  // 동기화 대상 디렉토리
+    char **names;             // 대상 항목 (확인하는 동안 목록이 다시 읽혀도 되도록 복사해 둠)
+    int count;
+    bool use_trash;           // 휴지통으로 이동
+    bool single_file;         // 표시 없이 선택한 파일 하나 (백그라운드 작업 없이 바로 삭제)
+    unsigned int task_id;     // 취소할 작업 번호
+    int dupes_file;           // 하드 링크로 바꿀 중복 파일 (결과 화면의 순번)
+} PendingAction;
+
+static void clear_pending(PendingAction *pending) {
+    for (int i = 0; i < pending->count; i++) {
+        free(pending->names[i]);
+    }
+    free(pending->names);
+    memset(pending, 0, sizeof(PendingAction));
+}
+
+static bool set_pending_items(PendingAction *pending, const char *dir, const char *const *names, int count) {
+    clear_pending(pending);
+    pending->names = calloc(count, sizeof(char*));
+    if (!pending->names) return false;
+    for (int i = 0; i < count; i++) {
+        pending->names[i] = strdup(names[i]);
+        if (!pending->names[i]) {
+            clear_pending(pending);
+            return false;
+        }
+        pending->count++;
+    }
+    snprintf(pending->dir, sizeof(pending->dir), "%s", dir);
+    return true;
+}
+
+// 휴지통으로 옮기고 옮기지 못한 항목만 남김 (남은 항목 수 반환)
+static int trash_pending_items(PendingAction *pending) {
+    int remaining = 0;
+    for (int i = 0; i < pending->count; i++) {
+        char full_path[MAX_PATH_LEN];
+        snprintf(full_path, sizeof(full_path), "%s/%s", pending->dir, pending->names[i]);
+        if (trash_file(full_path) != 0) {
+            pending->names[remaining++] = pending->names[i];
+        } else {
+            free(pending->names[i]);
+        }
+    }
+    pending->count = remaining;
+    return remaining;
+}
+
+// 바로 삭제 - 파일 하나는 즉시, 그 외에는 진행률/취소가 가능한 백그라운드 작업으로
+static bool delete_pending_items(const PendingAction *pending) {
+    if (pending->count == 0) return true;
+    if (pending->single_file && pending->count == 1) {
+        char full_path[MAX_PATH_LEN];
+        snprintf(full_path, sizeof(full_path), "%s/%s", pending->dir, pending->names[0]);
+        return delete_file(full_path);
+    }
+    return start_delete_task(pending->dir, (const char *const *)pending->names, pending->count);
+}
+
+// 작업 취소 - 작업 스레드가 스스로 멈추고 불완전한 대상을 정리함
+// (이동의 원본 삭제 단계에서는 대상이 유일한 온전한 사본이므로 보존)
+static void cancel_task_by_id(unsigned int id) {
+    pthread_mutex_lock(&g_tasks_mutex);
+    CopyTask *task = find_running_task(id);
+    if (task) {
+        request_task_cancel(task);
+
+        const char *cancel_msg = "복사 작업 취소됨";
+        if (task->type == TASK_TYPE_MOVE) {
+            cancel_msg = "이동 작업 취소됨";
+        } else if (task->type == TASK_TYPE_DELETE) {
+            cancel_msg = "삭제 작업 취소됨";
+        } else if (task->type == TASK_TYPE_PACK) {
+            cancel_msg = "묶기 작업 취소됨";
+        } else if (task->type == TASK_TYPE_SYNC) {
+            cancel_msg = "동기화 작업 취소됨";
+        }
+        ui_display_temporary_message(cancel_msg, false);
+    }
+    pthread_mutex_unlock(&g_tasks_mutex);
+}
 
 int main() {
     setlocale(LC_ALL, ""); // 로케일 설정
@@ -18,54 +375,1002 @@ int main() {
         return 1;
     }
     
+    // 휴지통 초기화 (백그라운드 정리 스레드 시작)
+    init_trash_system();
+
+    // 파일 이름 색인 (기존 색인은 매핑만 하고, 만들기와 변경 감시는 백그라운드에서)
+    init_index_system();
+
+    // 파일 종류 표 (확장자 완전 해시 표, 사용자 연결 목록 포함)
+    if (!init_file_types()) {
+        fprintf(stderr, "파일 종류 표를 만들지 못했습니다 - 모든 파일을 일반 파일로 표시합니다\n");
+    }
+
+    // 이벤트 시스템 초기화 (작업 알림 eventfd, 디렉토리 감시 inotify)
+    if (!event_init()) {
+        fprintf(stderr, "이벤트 시스템 초기화 실패\n");
+        cleanup_trash_system();
+        cleanup_clipboard_system();
+        return 1;
+    }
+
     init_ui(); // ncurses 및 윈도우 초기화
 
     int current_selection = 0;
     int scroll_offset = 0;
+    int mark_anchor = -1; // 범위 표시(r)의 시작 위치
     int ch;
     
-    // 파일 목록 저장을 위한 배열 및 현재 경로/디스크 정보를 위한 버퍼
-    FileEntry files[MAX_FILES];
+    // 파일 목록 저장을 위한 배열 및 현재 경로/디스크 정보를 위한 버퍼 (분할 화면이면 활성 칸의 목록)
+    FileEntry *files = g_pane_files[0];
     int file_count = 0;
     char current_path[MAX_PATH_LEN];
     char disk_free[32];
     
     // 초기 상태로 현재 디렉토리의 파일 정보 로드
     get_current_path(current_path, sizeof(current_path));
-    file_count = get_file_list(current_path, files, MAX_FILES);
+    file_count = load_listing(current_path, files);
     get_disk_free_space(current_path, disk_free, sizeof(disk_free));
 
-    // getch를 비블로킹 모드로 설정 (복사 작업 완료 시 UI 업데이트를 위해)
+    // getch를 비블로킹 모드로 설정 (입력이 없으면 event_wait에서 대기)
     nodelay(stdscr, TRUE);
 
+    bool tasks_dirty = true;   // 작업 상태를 다시 확인해야 함 (알림, 진행률 주기, 키 입력 후)
+    bool listing_dirty = false; // 디렉토리 내용이 바뀜 (inotify)
+    long last_reload_ms = 0;
+    int progress_interval_ms = event_progress_interval_ms();
+    PendingAction pending = {0}; // 열린 대화상자가 확인되면 실행할 동작
+    bool show_dashboard = false; // 작업 대시보드(t) 표시 중
+    int dashboard_selection = 0;
+    int dashboard_count = 0;
+    InputMode input_mode = INPUT_NONE; // 검색어 입력 중인지
+    char input_query[FILTER_MAX_QUERY] = "";
+    size_t input_len = 0;
+    int jump_origin = 0;               // 이동 검색을 시작한 위치 (ESC로 되돌아감)
+    NamePool jump_pool = {0};          // 이동 검색용 이름 색인 (현재 목록 기준)
+    FuzzyFinder fuzzy = {0};           // 퍼지 찾기 (열려 있으면 목록 영역을 대신함)
+    bool split_view = false;           // 분할 화면 (s)
+    int active_side = 0;               // 활성 칸 (0: 왼쪽, 1: 오른쪽)
+    Pane other = { .files = g_pane_files[1] }; // 분할 화면의 다른 칸
+    bool show_preview = false;         // 미리보기 칸 (p) - 분할 화면의 오른쪽 칸 자리에 표시
+    Preview preview;
+    preview_init(&preview);
+    char preview_target[MAX_PATH_LEN] = ""; // 미리보기할 경로 (선택이 바뀌면 바로 바뀜)
+    long preview_due_ms = 0;           // 이 시각이 되면 preview_target을 엶 (0이면 예약 없음)
+    SearchTask search = {0};           // 하위 디렉토리 찾기 (열려 있으면 목록 영역을 대신함)
+    UsageTask usage = {0};             // 디스크 사용량 트리 (g로 목록에 돌아가도 같은 디렉토리면 다시 씀)
+    bool show_usage = false;           // 사용량 화면이 목록 영역을 대신함
+    DupesTask dupes = {0};             // 중복 파일 찾기 (g로 목록에 돌아가도 같은 디렉토리면 다시 씀)
+    bool show_dupes = false;           // 중복 파일 화면이 목록 영역을 대신함
+    CompareTask compare = {0};         // 분할 화면 두 칸의 디렉토리 비교 (같은 두 디렉토리면 다시 씀)
+    bool show_compare = false;         // 비교 화면이 목록 영역을 대신함
+    ArchiveView archive = {0};         // 압축 파일 안을 보는 중이면 목록이 압축 안의 디렉토리
+    ArchiveTask archive_load = {0};    // 압축 파일 색인 만들기 (끝나면 압축 안으로 들어감)
+    ArchiveTask archive_extract = {0}; // 압축 안의 항목 꺼내기
+
     while(1) {
-        // 완료된 백그라운드 작업들 정리
-        cleanup_finished_tasks();
-        
-        // 복사 상태 업데이트
-        update_file_copy_status(files, file_count, current_path);
+        // 보이는 디렉토리 감시 (칸 번호 = 감시 칸, 경로가 바뀐 경우에만 교체)
+        event_watch_directory(active_side, current_path);
+        event_watch_directory(1 - active_side, split_view ? other.path : NULL);
+
+        if (tasks_dirty) {
+            // 완료된 백그라운드 작업들 정리 (끝난 작업이 있으면 목록 갱신)
+            if (cleanup_finished_tasks() > 0) {
+                // 끝난 작업이 만든 파일의 최종 크기는 디렉토리 수정시각으로 알 수 없으므로 캐시도 버림
+                invalidate_file_list(NULL);
+                listing_dirty = true;
+                other.dirty = split_view;
+                last_reload_ms = 0;
+            }
+        }
+
+        // 압축 파일 색인이 다 만들어졌으면 그 디렉토리의 목록을 보고 있을 때만 압축 안으로 들어감 (아니면 캐시에만 둠)
+        if (archive_load.active) {
+            pthread_mutex_lock(&archive_load.lock);
+            bool loaded = archive_load.finished;
+            pthread_mutex_unlock(&archive_load.lock);
+            if (loaded) {
+                char message[sizeof(archive_load.message)];
+                char archive_path[MAX_PATH_LEN];
+                bool cancelled = archive_load.cancel;
+                snprintf(message, sizeof(message), "%s", archive_load.message);
+                snprintf(archive_path, sizeof(archive_path), "%s", archive_load.path);
+                Archive *opened = NULL;
+                archive_task_stop(&archive_load, &opened);
+
+                char *slash = strrchr(archive_path, '/');
+                char archive_dir[MAX_PATH_LEN] = "";
+                if (slash) {
+                    snprintf(archive_dir, sizeof(archive_dir), "%.*s",
+                             slash == archive_path ? 1 : (int)(slash - archive_path), archive_path);
+                }
+                bool listing_shown = !archive.active && !search.active && !show_usage && !show_dupes &&
+                                     !show_compare &&
+                                     !fuzzy.active && !show_dashboard && input_mode == INPUT_NONE;
+                if (opened && listing_shown && strcmp(archive_dir, current_path) == 0) {
+                    clear_filter(files, file_count);
+                    if (show_preview) { // 미리보기는 디스크의 경로를 읽으므로 끔
+                        show_preview = false;
+                        preview_close(&preview);
+                        preview_target[0] = '\0';
+                        preview_due_ms = 0;
+                        ui_set_split(split_view);
+                    }
+                    archive.active = true;
+                    archive.archive = opened;
+                    snprintf(archive.name, sizeof(archive.name), "%s", slash + 1);
+                    archive.prefix[0] = '\0';
+                    file_count = load_archive_listing(&archive, current_path, files);
+                    current_selection = 0;
+                    scroll_offset = 0;
+                    mark_anchor = -1;
+                } else if (opened) {
+                    archive_release(opened);
+                    ui_display_temporary_message("압축 파일 목록을 읽었습니다 - 다시 Enter로 열기", false);
+                } else if (!cancelled) {
+                    ui_display_temporary_message(message, true);
+                }
+            }
+        }
+
+        // 꺼내기가 끝났으면 결과를 알리고 목록에 반영
+        if (archive_extract.active) {
+            pthread_mutex_lock(&archive_extract.lock);
+            bool extracted = archive_extract.finished;
+            pthread_mutex_unlock(&archive_extract.lock);
+            if (extracted) {
+                ui_display_temporary_message(archive_extract.message, !archive_extract.ok);
+                archive_task_stop(&archive_extract, NULL);
+                invalidate_file_list(current_path);
+                listing_dirty = true;
+            }
+        }
+
+        // 디렉토리 변경은 모아서 일정 간격으로만 다시 읽음 (압축 안을 보는 동안은 나올 때 읽음)
+        long now_ms = event_now_ms();
+        if ((listing_dirty || other.dirty) && now_ms - last_reload_ms >= EVENT_FS_RELOAD_MS) {
+            if (listing_dirty && !archive.active) {
+                file_count = reload_file_list(current_path, files, file_count, true);
+                if (current_selection >= file_count) {
+                    current_selection = file_count > 0 ? file_count - 1 : 0;
+                }
+                if (input_mode == INPUT_JUMP) {
+                    // 항목 위치가 바뀌었으므로 이동 검색 색인도 새 목록으로
+                    name_pool_build(&jump_pool, files, file_count);
+                    name_pool_search(&jump_pool, input_query);
+                }
+                if (fuzzy.active) {
+                    // 결과는 목록 인덱스를 가리키므로 새 목록으로 다시 채점
+                    if (name_pool_build(&fuzzy.pool, files, file_count)) {
+                        refresh_fuzzy(&fuzzy);
+                    } else {
+                        close_fuzzy(&fuzzy);
+                    }
+                }
+                get_disk_free_space(current_path, disk_free, sizeof(disk_free));
+                if (show_preview && preview.loaded) {
+                    preview_reload(&preview); // 보던 파일이 바뀌었을 수 있음 (위치는 유지)
+                }
+            }
+            // 같은 디렉토리면 위에서 읽은 목록이 캐시에서 그대로 쓰임
+            if (other.dirty && split_view) {
+                reload_pane(&other);
+            }
+            other.dirty = false;
+            listing_dirty = false;
+            last_reload_ms = now_ms;
+            tasks_dirty = true; // 새 목록에 복사 상태 다시 표시
+        }
+
+        if (tasks_dirty) {
+            // 복사 상태 업데이트
+            if (!archive.active) update_file_copy_status(files, file_count, current_path);
+            tasks_dirty = false;
+        }
         
-        // 파일 목록 및 푸터 표시
-        display_files(files, file_count, current_selection, scroll_offset);
-        display_footer(current_path, file_count, disk_free);
+        // 미리보기 - 선택이 바뀌면 바로 열지 않고 잠시 멈출 때까지 기다림 (빠르게 스크롤하는 동안은 열지 않음)
+        if (show_preview) {
+            char selected_path[MAX_PATH_LEN] = "";
+            if (current_selection < file_count) {
+                snprintf(selected_path, sizeof(selected_path), "%s/%s", current_path, files[current_selection].name);
+            }
+            if (strcmp(selected_path, preview_target) != 0) {
+                snprintf(preview_target, sizeof(preview_target), "%s", selected_path);
+                preview_close(&preview);
+                preview.message[0] = '\0';
+                preview_due_ms = now_ms + PREVIEW_DEBOUNCE_MS;
+            }
+            if (preview_due_ms != 0 && event_now_ms() >= preview_due_ms) {
+                preview_open(&preview, preview_target);
+                preview_due_ms = 0;
+            }
+        }
+
+        // 푸터에 보일 검색어/필터 상태
+        char footer_status[FILTER_MAX_QUERY + 32] = "";
+        if (input_mode == INPUT_JUMP) {
+            snprintf(footer_status, sizeof(footer_status), "찾기: %s_ (%d개)", input_query, jump_pool.match_count);
+        } else if (input_mode == INPUT_FILTER) {
+            snprintf(footer_status, sizeof(footer_status), "필터: %s_", input_query);
+        } else if (g_filter_active) {
+            snprintf(footer_status, sizeof(footer_status), "필터: %s (f: 수정)", g_filter_query);
+        } else if (archive_load.active || archive_extract.active) {
+            ArchiveTask *running = archive_extract.active ? &archive_extract : &archive_load;
+            pthread_mutex_lock(&running->lock);
+            int percent = running->total > 0 ? (int)(running->done * 100 / running->total) : 0;
+            pthread_mutex_unlock(&running->lock);
+            snprintf(footer_status, sizeof(footer_status), "%s %d%% (ESC: 취소)",
+                     running == &archive_extract ? "꺼내는 중" : "압축 목록 읽는 중", percent);
+        }
+        const char *shown_path = archive.active ? archive.shown_path : current_path;
+
+        if (show_dashboard) {
+            // 작업 대시보드가 목록 영역을 대신함
+            pthread_mutex_lock(&g_tasks_mutex);
+            ui_display_copy_progress(NULL);
+            dashboard_count = ui_display_task_dashboard(g_copy_tasks, dashboard_selection);
+            pthread_mutex_unlock(&g_tasks_mutex);
+            if (dashboard_selection >= dashboard_count && dashboard_count > 0) {
+                dashboard_selection = dashboard_count - 1;
+            }
+            display_footer(shown_path, file_count, disk_free, count_marked(files, file_count), footer_status);
+        } else if (fuzzy.active) {
+            // 퍼지 찾기 결과가 목록 영역을 대신함 (진행률 패널은 그대로)
+            pthread_mutex_lock(&g_tasks_mutex);
+            ui_display_copy_progress(shown_task());
+            pthread_mutex_unlock(&g_tasks_mutex);
+            ui_display_fuzzy_finder(files, fuzzy.query, fuzzy.results, fuzzy.result_count,
+                                    fuzzy.match_count, file_count, fuzzy.selection);
+            display_footer(shown_path, file_count, disk_free, count_marked(files, file_count), footer_status);
+        } else if (search.active) {
+            // 찾은 항목이 늘어나는 대로 목록 영역에 보여 줌
+            pthread_mutex_lock(&g_tasks_mutex);
+            ui_display_copy_progress(shown_task());
+            pthread_mutex_unlock(&g_tasks_mutex);
+            long dirs_scanned = search_dirs_scanned(&search);
+            pthread_mutex_lock(&search.lock);
+            ui_display_search_results(&search, dirs_scanned);
+            pthread_mutex_unlock(&search.lock);
+            display_footer(shown_path, file_count, disk_free, count_marked(files, file_count), footer_status);
+        } else if (show_usage) {
+            // 사용량 탐색 진행 상황 또는 메모리의 트리
+            pthread_mutex_lock(&g_tasks_mutex);
+            ui_display_copy_progress(shown_task());
+            pthread_mutex_unlock(&g_tasks_mutex);
+            long dirs_scanned = usage_dirs_scanned(&usage);
+            pthread_mutex_lock(&usage.lock);
+            ui_display_usage(&usage, dirs_scanned);
+            pthread_mutex_unlock(&usage.lock);
+            display_footer(shown_path, file_count, disk_free, count_marked(files, file_count), footer_status);
+        } else if (show_dupes) {
+            // 단계별 진행 상황 또는 중복 묶음
+            pthread_mutex_lock(&g_tasks_mutex);
+            ui_display_copy_progress(shown_task());
+            pthread_mutex_unlock(&g_tasks_mutex);
+            long dirs_scanned = dupes_dirs_scanned(&dupes);
+            pthread_mutex_lock(&dupes.lock);
+            ui_display_dupes(&dupes, dirs_scanned);
+            pthread_mutex_unlock(&dupes.lock);
+            display_footer(shown_path, file_count, disk_free, count_marked(files, file_count), footer_status);
+        } else if (show_compare) {
+            // 양쪽 탐색과 내용 비교 진행 상황 또는 합친 트리
+            pthread_mutex_lock(&g_tasks_mutex);
+            ui_display_copy_progress(shown_task());
+            pthread_mutex_unlock(&g_tasks_mutex);
+            long dirs_scanned = compare_dirs_scanned(&compare);
+            pthread_mutex_lock(&compare.lock);
+            ui_display_compare(&compare, dirs_scanned);
+            pthread_mutex_unlock(&compare.lock);
+            display_footer(shown_path, file_count, disk_free, count_marked(files, file_count), footer_status);
+        } else {
+            // 복사 작업 진행률 패널 (목록 높이가 바뀌므로 목록보다 먼저 갱신)
+            pthread_mutex_lock(&g_tasks_mutex);
+            ui_display_copy_progress(shown_task()); // 없으면 패널 숨김
+            pthread_mutex_unlock(&g_tasks_mutex);
+
+            // 패널 때문에 목록이 줄었거나 검색으로 선택이 옮겨졌으면 선택 항목이 보이도록 스크롤 조정
+            int visible_rows = ui_list_height();
+            if (visible_rows > 0 && current_selection >= scroll_offset + visible_rows) {
+                scroll_offset = current_selection - visible_rows + 1;
+            }
+            if (current_selection < scroll_offset) {
+                scroll_offset = current_selection;
+            }
+
+            // 확장자로 종류를 모르는 파일은 보이는 행만 내용 앞부분으로 판별
+            sniff_file_types(current_path, files, file_count, scroll_offset, visible_rows);
 
-        // 복사 작업 진행률 표시
-        pthread_mutex_lock(&g_tasks_mutex);
-        CopyTask* current = g_copy_tasks;
-        while (current) {
-            if (current->is_running) {
-                ui_display_copy_progress(current);
-                break; // 첫 번째 진행 중인 작업만 표시
+            // 파일 목록 및 푸터 표시 (바뀐 행만 다시 그림)
+            if (split_view) {
+                if (visible_rows > 0 && other.selection >= other.scroll_offset + visible_rows) {
+                    other.scroll_offset = other.selection - visible_rows + 1;
+                }
+                if (other.selection < other.scroll_offset) {
+                    other.scroll_offset = other.selection;
+                }
+                sniff_file_types(other.path, other.files, other.file_count, other.scroll_offset, visible_rows);
+                display_files_split(active_side, files, file_count, current_selection, scroll_offset,
+                                    shown_path, true);
+                display_files_split(1 - active_side, other.files, other.file_count, other.selection,
+                                    other.scroll_offset, other.path, false);
+            } else if (show_preview) {
+                display_files_split(0, files, file_count, current_selection, scroll_offset, current_path, true);
+                const char *name = strrchr(preview_target, '/');
+                ui_display_preview(&preview, name ? name + 1 : preview_target);
+            } else {
+                display_files(files, file_count, current_selection, scroll_offset);
             }
-            current = current->next;
+            display_footer(shown_path, file_count, disk_free, count_marked(files, file_count), footer_status);
         }
-        pthread_mutex_unlock(&g_tasks_mutex);
+
+        // 대화상자와 임시 메시지는 맨 위에 (열려 있어도 진행률과 목록은 계속 갱신)
+        ui_display_overlays();
+
+        // 이번 프레임에서 바뀐 내용을 한 번에 화면으로 내보냄
+        refresh_screen();
 
         ch = getch(); // 사용자 입력 받기 (비블로킹 모드)
 
-        // 입력이 없으면 (ERR 반환) 짧은 대기 후 다시 루프
+        // 입력이 없으면 입력, 작업 알림, 디렉토리 변경, 진행률 주기 중 하나가 올 때까지 대기
         if (ch == ERR) {
-            usleep(50000); // 50ms 대기 (UI 업데이트 주기)
+            int timeout_ms = -1;
+            if (has_running_tasks()) {
+                timeout_ms = progress_interval_ms; // 진행률은 정해진 빈도로만 다시 그림
+            }
+            if (search.active) { // 맞는 항목이 없어도 읽은 디렉토리/파일 수는 갱신
+                pthread_mutex_lock(&search.lock);
+                bool searching = !search.finished;
+                pthread_mutex_unlock(&search.lock);
+                if (searching) timeout_ms = progress_interval_ms;
+            }
+            if (show_usage) { // 사용량 탐색 중에는 읽은 항목 수와 크기를 갱신
+                pthread_mutex_lock(&usage.lock);
+                bool scanning = !usage.finished;
+                pthread_mutex_unlock(&usage.lock);
+                if (scanning) timeout_ms = progress_interval_ms;
+            }
+            if (show_dupes) { // 중복 찾기 중에는 단계별 진행 수를 갱신
+                pthread_mutex_lock(&dupes.lock);
+                bool hashing = !dupes.finished;
+                pthread_mutex_unlock(&dupes.lock);
+                if (hashing) timeout_ms = progress_interval_ms;
+            }
+            if (show_compare) { // 비교 중에는 읽은 항목 수와 내용 비교 진행 수를 갱신
+                pthread_mutex_lock(&compare.lock);
+                bool comparing = !compare.finished;
+                pthread_mutex_unlock(&compare.lock);
+                if (comparing) timeout_ms = progress_interval_ms;
+            }
+            if (archive_load.active || archive_extract.active) { // 압축 목록 읽기/꺼내기 진행률
+                timeout_ms = progress_interval_ms;
+            }
+            if (listing_dirty || other.dirty) {
+                int reload_wait = (int)(EVENT_FS_RELOAD_MS - (event_now_ms() - last_reload_ms));
+                if (reload_wait < 0) reload_wait = 0;
+                if (timeout_ms < 0 || reload_wait < timeout_ms) timeout_ms = reload_wait;
+            }
+            if (preview_due_ms != 0) { // 미리보기를 열 시각
+                int preview_wait = (int)(preview_due_ms - event_now_ms());
+                if (preview_wait < 0) preview_wait = 0;
+                if (timeout_ms < 0 || preview_wait < timeout_ms) timeout_ms = preview_wait;
+            }
+            int toast_wait = ui_toast_remaining_ms(); // 임시 메시지가 사라질 때 다시 그림
+            if (toast_wait >= 0 && (timeout_ms < 0 || toast_wait < timeout_ms)) {
+                timeout_ms = toast_wait;
+            }
+
+            int events = event_wait(timeout_ms);
+            if (events & (EVENT_NOTIFY | EVENT_TIMER)) {
+                tasks_dirty = true;
+            }
+            if (events & EVENT_FS) {
+                // 바뀐 디렉토리의 캐시된 목록은 버리고 다시 읽음
+                int changed = event_take_changed_watches();
+                if (changed & (1 << active_side)) {
+                    invalidate_file_list(current_path);
+                    listing_dirty = true;
+                }
+                if (split_view && (changed & (1 << (1 - active_side)))) {
+                    invalidate_file_list(other.path);
+                    other.dirty = true;
+                }
+            }
+            continue;
+        }
+
+        // 키 입력으로 작업이 시작/취소되었을 수 있음
+        tasks_dirty = true;
+
+        // 대화상자가 열려 있으면 키를 넘기고, 응답이 나오면 기다리던 동작 실행
+        if (ui_modal_active() && ch != KEY_RESIZE) {
+            ModalResult result = ui_modal_handle_key(ch);
+            if (result == MODAL_PENDING) continue;
+            bool accepted = (result == MODAL_ACCEPTED);
+            bool deleted = false;
+
+            switch (pending.kind) {
+                case PENDING_MARK_PATTERN: // 패턴으로 표시 (예: *.c)
+                    if (accepted && ui_modal_input()[0] != '\0') {
+                        for (int i = 0; i < file_count; i++) {
+                            if (strcmp(files[i].name, "..") != 0 && fnmatch(ui_modal_input(), files[i].name, 0) == 0) {
+                                files[i].is_marked = true;
+                            }
+                        }
+                    }
+                    break;
+
+                case PENDING_DELETE:
+                    if (!accepted) break;
+                    deleted = true;
+                    clear_marks(files, file_count);
+                    mark_anchor = -1;
+
+                    // 휴지통으로 옮기기 - 같은 파일시스템 안의 rename이므로 즉시 끝남
+                    if (pending.use_trash) {
+                        if (trash_pending_items(&pending) > 0) {
+                            char confirm_msg[MAX_PATH_LEN + 50];
+                            snprintf(confirm_msg, sizeof(confirm_msg), "휴지통으로 옮길 수 없는 %d개 항목을 바로 삭제하시겠습니까?", pending.count);
+                            ui_show_confirmation_dialog(confirm_msg);
+                            pending.kind = PENDING_DELETE_FORCE; // 남은 항목은 다음 응답까지 보관
+                        }
+                    } else if (!delete_pending_items(&pending)) {
+                        ui_display_temporary_message("삭제 실패", true);
+                    }
+                    break;
+
+                case PENDING_DELETE_FORCE:
+                    if (!accepted) break;
+                    deleted = true;
+                    if (!delete_pending_items(&pending)) {
+                        ui_display_temporary_message("삭제 실패", true);
+                    }
+                    break;
+
+                case PENDING_CANCEL_TASK:
+                    if (accepted) {
+                        cancel_task_by_id(pending.task_id);
+                    }
+                    break;
+
+                case PENDING_SEARCH:
+                    if (accepted && ui_modal_input()[0] != '\0') {
+                        int max_depth;
+                        bool one_filesystem;
+                        char error[128];
+                        search_default_limits(&max_depth, &one_filesystem);
+                        search_stop(&search);
+                        if (!search_start(&search, current_path, ui_modal_input(), max_depth, one_filesystem,
+                                          error, sizeof(error))) {
+                            char message[160];
+                            snprintf(message, sizeof(message), "잘못된 패턴: %s", error);
+                            ui_display_temporary_message(message, true);
+                        }
+                    }
+                    break;
+
+                case PENDING_GREP:
+                    if (accepted && ui_modal_input()[0] != '\0') {
+                        int max_depth;
+                        bool one_filesystem;
+                        char error[128];
+                        search_default_limits(&max_depth, &one_filesystem);
+                        search_stop(&search);
+                        if (!search_start_content(&search, current_path, ui_modal_input(), max_depth, one_filesystem,
+                                                  error, sizeof(error))) {
+                            ui_display_temporary_message(error, true);
+                        }
+                    }
+                    break;
+
+                case PENDING_DUPES_LINK:
+                    if (accepted) {
+                        char error[160];
+                        if (dupes_link(&dupes, pending.dupes_file, error, sizeof(error))) {
+                            ui_display_temporary_message("하드 링크로 바꿈", false);
+                        } else {
+                            ui_display_temporary_message(error, true);
+                        }
+                    }
+                    break;
+
+                case PENDING_SYNC_MIRROR:
+                    if (accepted) {
+                        if (start_sync_task(pending.dir, (const char *const *)pending.names, pending.count,
+                                            pending.dest, true)) {
+                            clear_marks(files, file_count);
+                            mark_anchor = -1;
+                            other.dirty = true;
+                        } else {
+                            ui_display_temporary_message("동기화 실패", true);
+                        }
+                    }
+                    break;
+
+                default:
+                    break;
+            }
+            if (!ui_modal_active()) {
+                clear_pending(&pending);
+            }
+
+            if (deleted) {
+                dupes_prune(&dupes); // 중복 화면에서 지운 파일은 결과에서 뺌
+
+                // 파일 목록 다시 불러오기
+                file_count = load_listing(current_path, files);
+                get_disk_free_space(current_path, disk_free, sizeof(disk_free));
+
+                // 선택된 항목이 마지막 항목이었고, 삭제되었다면 인덱스 조정
+                if (current_selection >= file_count) {
+                    current_selection = file_count - 1;
+                    if (current_selection < 0) current_selection = 0;
+                }
+            }
+            continue;
+        }
+
+        // 검색어 입력 중 - 글자를 붙일 때마다 앞선 결과 안에서만 다시 찾음
+        if (input_mode != INPUT_NONE && ch != KEY_RESIZE) {
+            bool query_changed = false;
+            bool handled = true;
+
+            if (ch == 27) { // ESC: 이동은 시작 위치로, 필터는 해제
+                if (input_mode == INPUT_JUMP) {
+                    current_selection = jump_origin;
+                } else {
+                    const char *selected = (current_selection < file_count) ? files[current_selection].name : "";
+                    char selected_name[MAX_NAME_LEN];
+                    snprintf(selected_name, sizeof(selected_name), "%s", selected);
+                    file_count = clear_filter(files, file_count);
+                    int index = find_entry(files, file_count, selected_name);
+                    current_selection = index >= 0 ? index : 0;
+                }
+                input_mode = INPUT_NONE;
+            } else if (ch == '\n' || ch == KEY_ENTER) { // Enter: 현재 결과 유지
+                if (input_mode == INPUT_FILTER && input_len == 0) {
+                    file_count = clear_filter(files, file_count);
+                }
+                input_mode = INPUT_NONE;
+            } else if (ch == KEY_BACKSPACE || ch == 127 || ch == 8) {
+                if (input_len > 0) {
+                    input_query[--input_len] = '\0';
+                    query_changed = true;
+                }
+            } else if (input_mode == INPUT_JUMP && (ch == KEY_DOWN || ch == KEY_UP || ch == 14 || ch == 16)) {
+                // 다음/이전 일치 항목 (Ctrl+N / Ctrl+P)
+                int direction = (ch == KEY_DOWN || ch == 14) ? 1 : -1;
+                int next = name_pool_next_match(&jump_pool, current_selection + direction, direction);
+                if (next >= 0) current_selection = next;
+            } else if (ch >= 32 && ch < 256 && input_len + 1 < sizeof(input_query)) {
+                input_query[input_len++] = (char)ch;
+                input_query[input_len] = '\0';
+                query_changed = true;
+            } else {
+                // 그 밖의 키는 입력을 끝내고 평소처럼 처리
+                input_mode = INPUT_NONE;
+                handled = false;
+            }
+
+            if (query_changed && input_mode == INPUT_JUMP) {
+                name_pool_search(&jump_pool, input_query);
+                int next = name_pool_next_match(&jump_pool, jump_origin, 1);
+                if (next >= 0) current_selection = next;
+            } else if (query_changed && input_mode == INPUT_FILTER) {
+                // 선택한 항목이 결과에 남아 있으면 그대로, 아니면 첫 결과
+                char selected_name[MAX_NAME_LEN] = "";
+                if (current_selection < file_count) {
+                    snprintf(selected_name, sizeof(selected_name), "%s", files[current_selection].name);
+                }
+                snprintf(g_filter_query, sizeof(g_filter_query), "%s", input_query);
+                name_pool_search(&g_filter_pool, g_filter_query);
+                file_count = apply_filter(files);
+                int index = find_entry(files, file_count, selected_name);
+                if (index < 0 || strcmp(selected_name, "..") == 0) {
+                    index = (file_count > 1 && strcmp(files[0].name, "..") == 0) ? 1 : 0;
+                }
+                current_selection = index;
+                scroll_offset = 0;
+            }
+
+            if (input_mode == INPUT_NONE) {
+                name_pool_free(&jump_pool);
+            }
+            if (handled) continue;
+        }
+
+        // 퍼지 찾기 - 글자를 붙이면 앞선 결과만 다시 채점, Enter로 선택한 항목으로 이동
+        if (fuzzy.active && ch != KEY_RESIZE) {
+            bool query_changed = false;
+            if (ch == 27) {
+                close_fuzzy(&fuzzy);
+            } else if (ch == '\n' || ch == KEY_ENTER) {
+                if (fuzzy.selection < fuzzy.result_count) {
+                    current_selection = fuzzy.results[fuzzy.selection].index;
+                }
+                close_fuzzy(&fuzzy);
+            } else if (ch == KEY_UP || ch == 16) { // ↑ / Ctrl+P
+                if (fuzzy.selection > 0) fuzzy.selection--;
+            } else if (ch == KEY_DOWN || ch == 14) { // ↓ / Ctrl+N
+                if (fuzzy.selection < fuzzy.result_count - 1) fuzzy.selection++;
+            } else if (ch == KEY_BACKSPACE || ch == 127 || ch == 8) {
+                if (fuzzy.len > 0) {
+                    fuzzy.query[--fuzzy.len] = '\0';
+                    query_changed = true;
+                }
+            } else if (ch >= 32 && ch < 256 && fuzzy.len + 1 < sizeof(fuzzy.query)) {
+                fuzzy.query[fuzzy.len++] = (char)ch;
+                fuzzy.query[fuzzy.len] = '\0';
+                query_changed = true;
+            }
+            if (query_changed) {
+                fuzzy.selection = 0; // 검색어가 바뀌면 가장 잘 맞는 결과부터
+                refresh_fuzzy(&fuzzy);
+            }
+            continue;
+        }
+
+        // 하위 디렉토리 찾기 결과 - 찾는 동안에도 고를 수 있고, Enter로 그 항목이 있는 디렉토리로 이동
+        // 내용 찾기 결과는 Enter로 맞은 줄을 편집기로 열고, 닫은 뒤에는 결과 화면으로 돌아옴
+        if (search.active && ch != KEY_RESIZE) {
+            char target[MAX_PATH_LEN] = "";
+            long target_line = 0;
+            pthread_mutex_lock(&search.lock);
+            int hit_count = search.hit_count;
+            if ((ch == '\n' || ch == KEY_ENTER) && search.selection < hit_count) {
+                search_hit_path(&search, &search.hits[search.selection], target, sizeof(target));
+                target_line = search.hits[search.selection].line;
+            }
+            pthread_mutex_unlock(&search.lock);
+
+            int page = ui_list_height() - 2; // 제목 두 줄을 뺀 결과 행 수
+            if (page < 1) page = 1;
+            if (ch == 27) {
+                search_stop(&search);
+            } else if (ch == 'x') {
+                search_cancel(&search);
+            } else if (ch == KEY_UP || ch == 16) { // ↑ / Ctrl+P
+                if (search.selection > 0) search.selection--;
+            } else if (ch == KEY_DOWN || ch == 14) { // ↓ / Ctrl+N
+                if (search.selection < hit_count - 1) search.selection++;
+            } else if (ch == KEY_PPAGE) {
+                search.selection = search.selection > page ? search.selection - page : 0;
+            } else if (ch == KEY_NPAGE) {
+                search.selection += page;
+                if (search.selection > hit_count - 1) search.selection = hit_count > 0 ? hit_count - 1 : 0;
+            } else if (ch == KEY_HOME) {
+                search.selection = 0;
+            } else if (ch == KEY_END) {
+                search.selection = hit_count > 0 ? hit_count - 1 : 0;
+            } else if (target[0] != '\0' && search.kind == SEARCH_CONTENT) {
+                close_ui();
+                bool edited = edit_file_at(target, target_line);
+                init_ui();
+                if (!edited) {
+                    ui_display_temporary_message("파일 편집 실패", true);
+                }
+            } else if (target[0] != '\0') {
+                search_stop(&search);
+                char *slash = strrchr(target, '/');
+                const char *name = slash + 1;
+                if (slash == target) slash++; // "/name"이면 디렉토리는 "/"
+                char dir[MAX_PATH_LEN];
+                snprintf(dir, sizeof(dir), "%.*s", (int)(slash - target), target);
+
+                if (change_directory(dir)) {
+                    clear_filter(files, file_count);
+                    get_current_path(current_path, sizeof(current_path));
+                    file_count = load_listing(current_path, files);
+                    get_disk_free_space(current_path, disk_free, sizeof(disk_free));
+                    int index = find_entry(files, file_count, name);
+                    current_selection = index >= 0 ? index : 0;
+                    scroll_offset = 0;
+                } else {
+                    ui_display_temporary_message("디렉토리로 이동할 수 없습니다", true);
+                }
+            }
+            continue;
+        }
+
+        // 디스크 사용량 - 탐색이 끝나면 메모리의 트리 안에서 오르내리며 다시 읽지 않음
+        if (show_usage && ch != KEY_RESIZE) {
+            pthread_mutex_lock(&usage.lock);
+            bool finished = usage.finished;
+            pthread_mutex_unlock(&usage.lock);
+
+            UsageNode *node = usage.current;
+            int count = finished ? node->child_count : 0;
+            UsageNode *selected = (usage.selection < count) ? node->children[usage.selection] : NULL;
+            int page = ui_list_height() - 2; // 제목 두 줄을 뺀 행 수
+            if (page < 1) page = 1;
+
+            if (ch == 27) {
+                usage_stop(&usage);
+                show_usage = false;
+            } else if (ch == 'x') {
+                usage_cancel(&usage);
+            } else if (!finished) {
+                // 탐색 중에는 멈추기와 닫기만
+            } else if (ch == KEY_UP || ch == 16) { // ↑ / Ctrl+P
+                if (usage.selection > 0) usage.selection--;
+            } else if (ch == KEY_DOWN || ch == 14) { // ↓ / Ctrl+N
+                if (usage.selection < count - 1) usage.selection++;
+            } else if (ch == KEY_PPAGE) {
+                usage.selection = usage.selection > page ? usage.selection - page : 0;
+            } else if (ch == KEY_NPAGE) {
+                usage.selection += page;
+                if (usage.selection > count - 1) usage.selection = count > 0 ? count - 1 : 0;
+            } else if (ch == KEY_HOME) {
+                usage.selection = 0;
+            } else if (ch == KEY_END) {
+                usage.selection = count > 0 ? count - 1 : 0;
+            } else if (ch == '\n' || ch == KEY_ENTER || ch == KEY_RIGHT || ch == 'l') {
+                if (selected && selected->d_type == DT_DIR) {
+                    usage.current = selected;
+                    usage.selection = 0;
+                    usage_sort(usage.current, usage.by_apparent);
+                }
+            } else if (ch == KEY_LEFT || ch == 'h' || ch == KEY_BACKSPACE || ch == 127 || ch == 8) {
+                if (node->parent) {
+                    usage.current = node->parent;
+                    usage_sort(usage.current, usage.by_apparent);
+                    usage.selection = 0;
+                    for (int i = 0; i < usage.current->child_count; i++) {
+                        if (usage.current->children[i] == node) usage.selection = i;
+                    }
+                }
+            } else if (ch == 'a') {
+                usage.by_apparent = !usage.by_apparent;
+                usage_sort(node, usage.by_apparent);
+                for (int i = 0; i < count; i++) {
+                    if (node->children[i] == selected) usage.selection = i;
+                }
+            } else if (ch == 'r') {
+                char root[MAX_PATH_LEN];
+                int max_depth;
+                bool one_filesystem;
+                snprintf(root, sizeof(root), "%s", usage.root);
+                search_default_limits(&max_depth, &one_filesystem);
+                usage_stop(&usage);
+                show_usage = usage_start(&usage, root, one_filesystem);
+            } else if (ch == 'g') {
+                // 트리는 남겨 두고 목록에서 선택한 항목을 보여 줌
+                char dir[MAX_PATH_LEN];
+                usage_node_path(&usage, node, dir, sizeof(dir));
+                show_usage = false;
+                if (change_directory(dir)) {
+                    clear_filter(files, file_count);
+                    get_current_path(current_path, sizeof(current_path));
+                    file_count = load_listing(current_path, files);
+                    get_disk_free_space(current_path, disk_free, sizeof(disk_free));
+                    int index = selected ? find_entry(files, file_count, selected->name) : -1;
+                    current_selection = index >= 0 ? index : 0;
+                    scroll_offset = 0;
+                } else {
+                    ui_display_temporary_message("디렉토리로 이동할 수 없습니다", true);
+                }
+            }
+            continue;
+        }
+
+        // 중복 파일 - 찾은 묶음 안의 파일을 골라 지우거나 하드 링크로 바꿈 (삭제는 목록의 d/D와 같은 확인을 거침)
+        if (show_dupes && ch != KEY_RESIZE) {
+            pthread_mutex_lock(&dupes.lock);
+            bool finished = dupes.finished;
+            pthread_mutex_unlock(&dupes.lock);
+
+            int count = finished ? dupes_file_rows(&dupes) : 0;
+            int group = 0, index = 0;
+            const DupesFile *selected = NULL;
+            if (dupes_locate(&dupes, dupes.selection, &group, &index)) {
+                selected = dupes.groups[group].files[index];
+            }
+            int page = ui_list_height() - 2;
+            if (page < 1) page = 1;
+
+            if (ch == 27) {
+                dupes_stop(&dupes);
+                show_dupes = false;
+            } else if (ch == 'x') {
+                dupes_cancel(&dupes);
+            } else if (!finished) {
+                // 찾는 중에는 멈추기와 닫기만
+            } else if (ch == KEY_UP || ch == 16) { // ↑ / Ctrl+P
+                if (dupes.selection > 0) dupes.selection--;
+            } else if (ch == KEY_DOWN || ch == 14) { // ↓ / Ctrl+N
+                if (dupes.selection < count - 1) dupes.selection++;
+            } else if (ch == KEY_PPAGE) {
+                dupes.selection = dupes.selection > page ? dupes.selection - page : 0;
+            } else if (ch == KEY_NPAGE) {
+                dupes.selection += page;
+                if (dupes.selection > count - 1) dupes.selection = count > 0 ? count - 1 : 0;
+            } else if (ch == KEY_HOME) {
+                dupes.selection = 0;
+            } else if (ch == KEY_END) {
+                dupes.selection = count > 0 ? count - 1 : 0;
+            } else if (ch == 'r') {
+                char root[MAX_PATH_LEN];
+                int max_depth;
+                bool one_filesystem;
+                snprintf(root, sizeof(root), "%s", dupes.root);
+                search_default_limits(&max_depth, &one_filesystem);
+                dupes_stop(&dupes);
+                show_dupes = dupes_start(&dupes, root, one_filesystem);
+            } else if (selected && (ch == 'd' || ch == 'D')) {
+                char dir[MAX_PATH_LEN];
+                snprintf(dir, sizeof(dir), "%s", selected->path);
+                char *slash = strrchr(dir, '/');
+                if (slash) {
+                    const char *name = selected->path + (slash - dir) + 1;
+                    if (slash == dir) slash++; // "/name"이면 디렉토리는 "/"
+                    *slash = '\0';
+                    bool use_trash = (ch == 'd') && trash_enabled() && !is_in_trash(dir);
+                    if (set_pending_items(&pending, dir, &name, 1)) {
+                        char confirm_msg[MAX_PATH_LEN + 50];
+                        pending.single_file = true;
+                        pending.use_trash = use_trash;
+                        pending.kind = PENDING_DELETE;
+                        snprintf(confirm_msg, sizeof(confirm_msg), use_trash ? "'%s'를 휴지통으로 옮기시겠습니까?"
+                                                                              : "파일 '%s'를 삭제하시겠습니까?", name);
+                        ui_show_confirmation_dialog(confirm_msg);
+                    }
+                }
+            } else if (selected && ch == 'l') {
+                char confirm_msg[MAX_PATH_LEN + 80];
+                clear_pending(&pending);
+                pending.kind = PENDING_DUPES_LINK;
+                pending.dupes_file = dupes.selection;
+                const char *name = strrchr(selected->path, '/');
+                snprintf(confirm_msg, sizeof(confirm_msg), "'%s'를 같은 내용의 원본에 대한 하드 링크로 바꾸시겠습니까?",
+                         name ? name + 1 : selected->path);
+                ui_show_confirmation_dialog(confirm_msg);
+            } else if (selected && (ch == 'g' || ch == '\n' || ch == KEY_ENTER)) {
+                // 결과는 남겨 두고 목록에서 그 파일을 보여 줌
+                char target[MAX_PATH_LEN];
+                snprintf(target, sizeof(target), "%s", selected->path);
+                char *slash = strrchr(target, '/');
+                const char *name = slash + 1;
+                if (slash == target) slash++;
+                char dir[MAX_PATH_LEN];
+                snprintf(dir, sizeof(dir), "%.*s", (int)(slash - target), target);
+                show_dupes = false;
+                if (change_directory(dir)) {
+                    clear_filter(files, file_count);
+                    get_current_path(current_path, sizeof(current_path));
+                    file_count = load_listing(current_path, files);
+                    get_disk_free_space(current_path, disk_free, sizeof(disk_free));
+                    int found = find_entry(files, file_count, name);
+                    current_selection = found >= 0 ? found : 0;
+                    scroll_offset = 0;
+                } else {
+                    ui_display_temporary_message("디렉토리로 이동할 수 없습니다", true);
+                }
+            }
+            continue;
+        }
+
+        // 디렉토리 비교 - 합친 트리 안에서 오르내리며 차이를 봄 (g로 두 칸을 보고 있는 디렉토리로 옮김)
+        if (show_compare && ch != KEY_RESIZE) {
+            pthread_mutex_lock(&compare.lock);
+            bool finished = compare.finished;
+            pthread_mutex_unlock(&compare.lock);
+
+            CompareNode *node = compare.current;
+            int count = (finished && node) ? compare_row_count(&compare) : 0;
+            CompareNode *selected = count > 0 ? compare_row(&compare, compare.selection) : NULL;
+            int page = ui_list_height() - 2;
+            if (page < 1) page = 1;
+
+            if (ch == 27) {
+                compare_stop(&compare);
+                show_compare = false;
+            } else if (ch == 'x') {
+                compare_cancel(&compare);
+            } else if (!finished) {
+                // 비교 중에는 멈추기와 닫기만
+            } else if (ch == 'r' || ch == 'c') { // c: 크기가 같은 파일을 내용으로 비교할지 바꿔 다시 비교
+                char left[MAX_PATH_LEN], right[MAX_PATH_LEN];
+                int max_depth;
+                bool one_filesystem;
+                bool content = (ch == 'c') ? !compare.content : compare.content;
+                bool show_same = compare.show_same;
+                snprintf(left, sizeof(left), "%s", compare.root[0]);
+                snprintf(right, sizeof(right), "%s", compare.root[1]);
+                search_default_limits(&max_depth, &one_filesystem);
+                compare_stop(&compare);
+                show_compare = compare_start(&compare, left, right, content, one_filesystem);
+                compare.show_same = show_same;
+            } else if (!node) {
+                // 멈춘 뒤에는 결과가 없음
+            } else if (ch == KEY_UP || ch == 16) { // ↑ / Ctrl+P
+                if (compare.selection > 0) compare.selection--;
+            } else if (ch == KEY_DOWN || ch == 14) { // ↓ / Ctrl+N
+                if (compare.selection < count - 1) compare.selection++;
+            } else if (ch == KEY_PPAGE) {
+                compare.selection = compare.selection > page ? compare.selection - page : 0;
+            } else if (ch == KEY_NPAGE) {
+                compare.selection += page;
+                if (compare.selection > count - 1) compare.selection = count > 0 ? count - 1 : 0;
+            } else if (ch == KEY_HOME) {
+                compare.selection = 0;
+            } else if (ch == KEY_END) {
+                compare.selection = count > 0 ? count - 1 : 0;
+            } else if (ch == '\n' || ch == KEY_ENTER || ch == KEY_RIGHT || ch == 'l') {
+                if (selected && (selected->type[0] == DT_DIR || selected->type[1] == DT_DIR)) {
+                    compare.current = selected;
+                    compare.selection = 0;
+                }
+            } else if (ch == KEY_LEFT || ch == 'h' || ch == KEY_BACKSPACE || ch == 127 || ch == 8) {
+                if (node->parent) {
+                    compare.current = node->parent;
+                    int row = compare_row_of(&compare, node);
+                    compare.selection = row >= 0 ? row : 0;
+                }
+            } else if (ch == 'a') {
+                compare.show_same = !compare.show_same;
+                int row = selected ? compare_row_of(&compare, selected) : -1;
+                compare.selection = row >= 0 ? row : 0;
+            } else if (ch == 'g') {
+                // 결과는 남겨 두고 두 칸을 보고 있는 디렉토리로 옮김 (한쪽에 없는 디렉토리면 그 칸은 그대로)
+                char dirs[2][MAX_PATH_LEN];
+                for (int side = 0; side < 2; side++) {
+                    compare_node_path(&compare, node, side, dirs[side], sizeof(dirs[side]));
+                }
+                const char *name = selected ? selected->name : NULL;
+                show_compare = false;
+                if (split_view && node->type[1] == DT_DIR) {
+                    snprintf(other.path, sizeof(other.path), "%s", dirs[1]);
+                    other.file_count = 0;
+                    other.scroll_offset = 0;
+                    reload_pane(&other);
+                    int found = name ? find_entry(other.files, other.file_count, name) : -1;
+                    other.selection = found >= 0 ? found : 0;
+                }
+                if (node->type[0] == DT_DIR) {
+                    if (change_directory(dirs[0])) {
+                        clear_filter(files, file_count);
+                        get_current_path(current_path, sizeof(current_path));
+                        file_count = load_listing(current_path, files);
+                        get_disk_free_space(current_path, disk_free, sizeof(disk_free));
+                        int found = name ? find_entry(files, file_count, name) : -1;
+                        current_selection = found >= 0 ? found : 0;
+                        scroll_offset = 0;
+                    } else {
+                        ui_display_temporary_message("디렉토리로 이동할 수 없습니다", true);
+                    }
+                }
+            }
+            continue;
+        }
+
+        // 작업 대시보드에서는 작업 선택/취소와 닫기만 처리
+        if (show_dashboard && ch != KEY_RESIZE && ch != 'q' && ch != 'Q') {
+            if (ch == 't' || ch == 27) {
+                show_dashboard = false;
+            } else if (ch == KEY_UP && dashboard_selection > 0) {
+                dashboard_selection--;
+            } else if (ch == KEY_DOWN && dashboard_selection < dashboard_count - 1) {
+                dashboard_selection++;
+            } else if (ch == 'x') {
+                pthread_mutex_lock(&g_tasks_mutex);
+                int index = 0;
+                for (CopyTask* task = g_copy_tasks; task; task = task->next) {
+                    if (!task->is_running) continue;
+                    if (index++ == dashboard_selection) {
+                        clear_pending(&pending);
+                        pending.kind = PENDING_CANCEL_TASK;
+                        pending.task_id = task->id;
+                        ui_confirm_cancel_copy(task->dest_name);
+                        break;
+                    }
+                }
+                pthread_mutex_unlock(&g_tasks_mutex);
+            }
+            continue;
+        }
+
+        // ESC - 압축 꺼내기나 목록 읽기가 진행 중이면 먼저 그것을 취소
+        if (ch == 27 && (archive_extract.active || archive_load.active)) {
+            archive_task_cancel(archive_extract.active ? &archive_extract : &archive_load);
             continue;
         }
 
@@ -73,6 +1378,116 @@ int main() {
             break; // 'q' 입력 시 종료
         }
 
+        // 압축 파일 보기 - Enter로 오르내리고 e로 꺼냄, ESC나 맨 위의 ".."로 나옴
+        if (archive.active && ch != KEY_RESIZE) {
+            bool handled = true;
+            FileEntry *selected_file = (current_selection < file_count) ? &files[current_selection] : NULL;
+            bool enter = (ch == '\n' || ch == KEY_ENTER) && selected_file;
+
+            if (ch == 27 || (enter && strcmp(selected_file->name, "..") == 0)) {
+                char name[MAX_NAME_LEN];
+                clear_filter(files, file_count);
+                if (ch == 27 || archive.prefix[0] == '\0') {
+                    // 압축 밖으로 - 압축 파일을 선택
+                    snprintf(name, sizeof(name), "%s", archive.name);
+                    close_archive_view(&archive);
+                    file_count = load_listing(current_path, files);
+                    get_disk_free_space(current_path, disk_free, sizeof(disk_free));
+                } else {
+                    // 한 단계 위로 - 나온 디렉토리를 선택
+                    archive.prefix[strlen(archive.prefix) - 1] = '\0';
+                    char *slash = strrchr(archive.prefix, '/');
+                    snprintf(name, sizeof(name), "%s", slash ? slash + 1 : archive.prefix);
+                    if (slash) {
+                        slash[1] = '\0';
+                    } else {
+                        archive.prefix[0] = '\0';
+                    }
+                    file_count = load_archive_listing(&archive, current_path, files);
+                }
+                int index = find_entry(files, file_count, name);
+                current_selection = index >= 0 ? index : 0;
+                scroll_offset = 0;
+                mark_anchor = -1;
+            } else if (enter && S_ISDIR(selected_file->mode)) {
+                size_t len = strlen(archive.prefix);
+                if (len + strlen(selected_file->name) + 2 < sizeof(archive.prefix)) {
+                    snprintf(archive.prefix + len, sizeof(archive.prefix) - len, "%s/", selected_file->name);
+                    clear_filter(files, file_count);
+                    file_count = load_archive_listing(&archive, current_path, files);
+                    current_selection = 0;
+                    scroll_offset = 0;
+                    mark_anchor = -1;
+                }
+            } else if (enter && S_ISREG(selected_file->mode) && file_type_editable(selected_file->file_type)) {
+                // 임시 디렉토리에 그 항목만 꺼내 편집기로 엶 (고친 내용은 압축에 들어가지 않음)
+                const char *tmp = getenv("TMPDIR");
+                char temp_dir[MAX_PATH_LEN];
+                char member[MAX_PATH_LEN * 2];
+                char error[256];
+                snprintf(temp_dir, sizeof(temp_dir), "%s/finder-XXXXXX", tmp && tmp[0] == '/' ? tmp : "/tmp");
+                snprintf(member, sizeof(member), "%s%s", archive.prefix, selected_file->name);
+                if (!mkdtemp(temp_dir)) {
+                    ui_display_temporary_message("임시 디렉토리를 만들 수 없음", true);
+                } else {
+                    char temp_path[MAX_PATH_LEN * 2];
+                    snprintf(temp_path, sizeof(temp_path), "%s/%s", temp_dir, selected_file->name);
+                    if (archive_extract_file(archive.archive, archive_find(archive.archive, member), temp_path,
+                                             error, sizeof(error))) {
+                        close_ui();
+                        edit_file(temp_path);
+                        init_ui();
+                        unlink(temp_path);
+                    } else {
+                        ui_display_temporary_message(error, true);
+                    }
+                    rmdir(temp_dir);
+                }
+            } else if (enter) {
+                ui_display_temporary_message("e: 압축 파일이 있는 디렉토리로 꺼내기", false);
+            } else if (ch == 'e') {
+                // 표시한 항목(없으면 선택한 항목)을 압축 파일이 있는 디렉토리로 꺼냄
+                char **members = malloc(sizeof(char*) * (file_count > 0 ? file_count : 1));
+                int count = members ? collect_archive_members(&archive, files, file_count, current_selection, members) : 0;
+                if (archive_extract.active) {
+                    ui_display_temporary_message("이미 꺼내는 중입니다", true);
+                } else if (count > 0) {
+                    if (archive_extract_start(&archive_extract, archive.archive, (const char *const *)members, count,
+                                              current_path)) {
+                        clear_marks(files, file_count);
+                        mark_anchor = -1;
+                    } else {
+                        ui_display_temporary_message("꺼내기를 시작할 수 없음", true);
+                    }
+                }
+                for (int i = 0; i < count; i++) {
+                    free(members[i]);
+                }
+                free(members);
+            } else if (ch == KEY_UP || ch == KEY_DOWN || ch == KEY_PPAGE || ch == KEY_NPAGE || ch == KEY_HOME ||
+                       ch == KEY_END || ch == '/' || ch == 'f' || ch == 6 || ch == ' ' || ch == 'r' ||
+                       ch == '*' || ch == 'u' || ch == 't') {
+                handled = false; // 이동, 찾기, 표시, 작업 대시보드는 목록과 같음
+            } else {
+                ui_display_temporary_message("압축 안에서는 쓸 수 없는 키 (e: 꺼내기, ESC: 나가기)", false);
+            }
+            if (handled) continue;
+        }
+
+        // Ctrl+C / Ctrl+X - 표시된 항목이 있으면 표시된 항목 전체를 클립보드에
+        if ((ch == 3 || ch == 24) && count_marked(files, file_count) > 0) {
+            const char **names = malloc(sizeof(char*) * file_count);
+            int marked = names ? collect_marked(files, file_count, names) : 0;
+            if (!names || !copy_selection_to_clipboard(current_path, names, marked, ch == 24)) {
+                ui_display_temporary_message(ch == 24 ? "잘라내기 실패" : "복사 실패", true);
+            } else {
+                clear_marks(files, file_count);
+                mark_anchor = -1;
+            }
+            free(names);
+            continue;
+        }
+
         // Ctrl+C 처리 (복사)
         if (ch == 3) { // Ctrl+C의 ASCII 코드
             if (current_selection >= 0 && current_selection < file_count) {
@@ -90,6 +1505,18 @@ int main() {
             continue;
         }
         
+        // Ctrl+X 처리 (잘라내기 - 붙여넣기 시 이동)
+        if (ch == 24) { // Ctrl+X의 ASCII 코드
+            if (current_selection >= 0 && current_selection < file_count) {
+                char selected_path[MAX_PATH_LEN];
+                snprintf(selected_path, sizeof(selected_path), "%s/%s", current_path, files[current_selection].name);
+                if (!cut_to_clipboard(selected_path)) {
+                    ui_display_temporary_message("잘라내기 실패", true);
+                }
+            }
+            continue;
+        }
+
         // Ctrl+V 처리 (붙여넣기)
         if (ch == 22) { // Ctrl+V의 ASCII 코드
             if (paste_from_clipboard(current_path)) {
@@ -98,7 +1525,7 @@ int main() {
 				// update_file_copy_status(files, file_count, current_path);
 
                 // ui_display_temporary_message("붙여넣기 시작", false);
-                file_count = get_file_list(current_path, files, MAX_FILES);
+                file_count = load_listing(current_path, files);
                 update_file_copy_status(files, file_count, current_path);
             } else {
                 ui_display_temporary_message("붙여넣기 실패", true);
@@ -109,9 +1536,7 @@ int main() {
         // 터미널 크기 변경 이벤트 처리
         if (ch == KEY_RESIZE) {
             resize_ui();
-            int screen_rows, screen_cols;
-            getmaxyx(stdscr, screen_rows, screen_cols);
-            int main_content_display_height = (screen_rows - FOOTER_TOTAL_HEIGHT) - 1;
+            int main_content_display_height = ui_list_height();
 
             // 화면 크기 변경 후 선택 및 스크롤 위치 조정
             if (current_selection >= file_count) {
@@ -147,9 +1572,7 @@ int main() {
             case KEY_DOWN:
                 if (current_selection < file_count - 1) {
                     current_selection++;
-                    int screen_rows, screen_cols;
-                    getmaxyx(stdscr, screen_rows, screen_cols);
-                    int main_content_display_height = (screen_rows - FOOTER_TOTAL_HEIGHT) - 1;
+                    int main_content_display_height = ui_list_height();
                     if (main_content_display_height < 0) main_content_display_height = 0;
 
                     // 현재 선택이 화면 아래로 벗어나면 스크롤
@@ -161,9 +1584,7 @@ int main() {
                 
             case KEY_PPAGE: // Page Up
                 {
-                    int screen_rows, screen_cols;
-                    getmaxyx(stdscr, screen_rows, screen_cols);
-                    int main_content_display_height = (screen_rows - FOOTER_TOTAL_HEIGHT) - 1;
+                    int main_content_display_height = ui_list_height();
                     if (main_content_display_height < 0) main_content_display_height = 0;
 
                     current_selection -= main_content_display_height;
@@ -175,9 +1596,7 @@ int main() {
                 
             case KEY_NPAGE: // Page Down
                 {
-                    int screen_rows, screen_cols;
-                    getmaxyx(stdscr, screen_rows, screen_cols);
-                    int main_content_display_height = (screen_rows - FOOTER_TOTAL_HEIGHT) - 1;
+                    int main_content_display_height = ui_list_height();
                     if (main_content_display_height < 0) main_content_display_height = 0;
 
                     current_selection += main_content_display_height;
@@ -199,9 +1618,7 @@ int main() {
                 
             case KEY_END:
                 {
-                    int screen_rows, screen_cols;
-                    getmaxyx(stdscr, screen_rows, screen_cols);
-                    int main_content_display_height = (screen_rows - FOOTER_TOTAL_HEIGHT) - 1;
+                    int main_content_display_height = ui_list_height();
                     if (main_content_display_height < 0) main_content_display_height = 0;
 
                     current_selection = file_count - 1;
@@ -225,9 +1642,10 @@ int main() {
                     if (is_directory(selected_file)) {
                         // 디렉토리인 경우 해당 디렉토리로 이동
                         if (change_directory(selected_path)) {
-                            // 디렉토리 변경 성공 - 새 경로의 파일 목록 가져오기
+                            // 디렉토리 변경 성공 - 새 경로의 파일 목록 가져오기 (필터는 해제)
+                            clear_filter(files, file_count);
                             get_current_path(current_path, sizeof(current_path));
-                            file_count = get_file_list(current_path, files, MAX_FILES);
+                            file_count = load_listing(current_path, files);
                             get_disk_free_space(current_path, disk_free, sizeof(disk_free));
 
                             // 선택 및 스크롤 위치 초기화
@@ -239,9 +1657,15 @@ int main() {
                             clrtoeol();
                             refresh();
                         }
-                    } else if (strstr(selected_file->type, "source") != NULL ||
-                            strstr(selected_file->type, "header") != NULL ||
-                            strstr(selected_file->type, "script") != NULL) {
+                    } else if ((selected_file->file_type == FILETYPE_TAR || selected_file->file_type == FILETYPE_GZIP ||
+                                selected_file->file_type == FILETYPE_ZIP) &&
+                               archive_detect(selected_path) != ARCHIVE_NONE) {
+                        // 압축 파일 - 색인을 백그라운드에서 만들고 (같은 파일을 연 적이 있으면 바로) 가상 디렉토리로 엶
+                        archive_task_stop(&archive_load, NULL);
+                        if (!archive_load_start(&archive_load, selected_path)) {
+                            ui_display_temporary_message("압축 파일을 열 수 없음", true);
+                        }
+                    } else if (file_type_editable(selected_file->file_type)) {
                         // 프로그래밍 언어 파일인 경우 편집기 호출
                         close_ui(); // ncurses 종료
                         if (edit_file(selected_path)) {
@@ -250,7 +1674,7 @@ int main() {
 
                             // 파일 목록 갱신 (편집 후 변경 사항 반영)
                             get_current_path(current_path, sizeof(current_path));
-                            file_count = get_file_list(current_path, files, MAX_FILES);
+                            file_count = load_listing(current_path, files);
                             get_disk_free_space(current_path, disk_free, sizeof(disk_free));
                         } else {
                             // 편집 실패
@@ -267,7 +1691,7 @@ int main() {
                             init_ui();
                             // 파일 목록 갱신 (실행 후 변경 사항 반영)
                             get_current_path(current_path, sizeof(current_path));
-                            file_count = get_file_list(current_path, files, MAX_FILES);
+                            file_count = load_listing(current_path, files);
                             get_disk_free_space(current_path, disk_free, sizeof(disk_free));
                         } else {
                             // 실행 실패
@@ -287,109 +1711,381 @@ int main() {
                 
             case '.': // 상위 디렉토리로 이동 (옵션)
                 if (change_directory("..")) {
+                    clear_filter(files, file_count);
                     get_current_path(current_path, sizeof(current_path));
-                    file_count = get_file_list(current_path, files, MAX_FILES);
+                    file_count = load_listing(current_path, files);
                     get_disk_free_space(current_path, disk_free, sizeof(disk_free));
                     current_selection = 0;
                     scroll_offset = 0;
                 }
                 break;
                 
-            case 'd':
-            case 'D':
+            case ' ': // 표시 토글 후 다음 항목으로
                 if (current_selection >= 0 && current_selection < file_count) {
-                    // 현재 선택된 파일/디렉토리의 전체 경로 생성
-                    char full_path[MAX_PATH_LEN];
-                    snprintf(full_path, sizeof(full_path), "%s/%s", current_path, files[current_selection].name);
-                    
-                    // ".." 디렉토리는 삭제 불가
-                    if (strcmp(files[current_selection].name, "..") == 0) {
-                        ui_display_temporary_message("상위 디렉토리는 삭제할 수 없습니다.", true);
-                        break;
+                    if (strcmp(files[current_selection].name, "..") != 0) {
+                        files[current_selection].is_marked = !files[current_selection].is_marked;
+                    }
+                    mark_anchor = current_selection;
+                    if (current_selection < file_count - 1) {
+                        current_selection++;
+                        int main_content_display_height = ui_list_height();
+                        if (main_content_display_height > 0 && current_selection >= scroll_offset + main_content_display_height) {
+                            scroll_offset = current_selection - main_content_display_height + 1;
+                        }
                     }
-                    
+                }
+                break;
+
+            case 'r': // 마지막으로 표시한 위치부터 현재 위치까지 표시
+                if (current_selection >= 0 && current_selection < file_count) {
+                    int from = (mark_anchor >= 0 && mark_anchor < file_count) ? mark_anchor : current_selection;
+                    int lo = from < current_selection ? from : current_selection;
+                    int hi = from < current_selection ? current_selection : from;
+                    for (int i = lo; i <= hi; i++) {
+                        if (strcmp(files[i].name, "..") != 0) files[i].is_marked = true;
+                    }
+                    mark_anchor = current_selection;
+                }
+                break;
+
+            case '*': // 패턴으로 표시 (예: *.c)
+                clear_pending(&pending);
+                pending.kind = PENDING_MARK_PATTERN;
+                ui_prompt_input("표시할 패턴 (예: *.c)");
+                break;
+
+            case 'u': // 표시 모두 해제
+                clear_marks(files, file_count);
+                mark_anchor = -1;
+                break;
+
+            case 'd': // 휴지통으로 이동 (휴지통을 쓰지 않거나 휴지통 안이면 바로 삭제)
+            case 'D': // 휴지통을 거치지 않고 바로 삭제
+                {
+                    bool use_trash = (ch == 'd') && trash_enabled() && !is_in_trash(current_path);
+
+                    // 표시된 항목이 있으면 표시된 항목 전체에 적용
+                    int count = count_marked(files, file_count);
                     char confirm_msg[MAX_PATH_LEN + 50];
-                    if (is_directory(&files[current_selection])) {
-                        snprintf(confirm_msg, sizeof(confirm_msg), "디렉토리 '%s'를 삭제하시겠습니까?", files[current_selection].name);
+
+                    if (count > 0) {
+                        const char **names = malloc(sizeof(char*) * file_count);
+                        if (!names) break;
+                        count = collect_marked(files, file_count, names);
+                        bool stored = set_pending_items(&pending, current_path, names, count);
+                        free(names);
+                        if (!stored) break;
+                        snprintf(confirm_msg, sizeof(confirm_msg), use_trash ? "표시된 %d개 항목을 휴지통으로 옮기시겠습니까?"
+                                                                              : "표시된 %d개 항목을 삭제하시겠습니까?", count);
                     } else {
-                        snprintf(confirm_msg, sizeof(confirm_msg), "파일 '%s'를 삭제하시겠습니까?", files[current_selection].name);
-                    }
-                    
-                    // 사용자에게 삭제 확인 요청
-                    if (ui_show_confirmation_dialog(confirm_msg)) {
-                        // 사용자가 확인한 경우, 삭제 진행
-                        if (delete_file(full_path)) {
-                            // ui_display_temporary_message("삭제 완료", false);
-                            
-                            // 파일 목록 다시 불러오기
-                            file_count = get_file_list(current_path, files, MAX_FILES);
-                            
-                            // 선택된 항목이 마지막 항목이었고, 삭제되었다면 인덱스 조정
-                            if (current_selection >= file_count) {
-                                current_selection = file_count - 1;
-                                if (current_selection < 0) current_selection = 0;
-                            }
-                            
-                            // 파일 목록 다시 표시
-                            display_files(files, file_count, current_selection, scroll_offset);
-                            
-                            // 푸터 정보 업데이트
-                            char disk_free[32];
-                            get_disk_free_space(current_path, disk_free, sizeof(disk_free));
-                            display_footer(current_path, file_count, disk_free);
+                        if (current_selection < 0 || current_selection >= file_count) break;
+
+                        // ".." 디렉토리는 삭제 불가
+                        if (strcmp(files[current_selection].name, "..") == 0) {
+                            ui_display_temporary_message("상위 디렉토리는 삭제할 수 없습니다.", true);
+                            break;
+                        }
+
+                        const char *name = files[current_selection].name;
+                        if (!set_pending_items(&pending, current_path, &name, 1)) break;
+                        pending.single_file = !is_directory(&files[current_selection]);
+                        if (use_trash) {
+                            snprintf(confirm_msg, sizeof(confirm_msg), "'%s'를 휴지통으로 옮기시겠습니까?", name);
+                        } else if (is_directory(&files[current_selection])) {
+                            snprintf(confirm_msg, sizeof(confirm_msg), "디렉토리 '%s'를 삭제하시겠습니까?", name);
                         } else {
-                            ui_display_temporary_message("삭제 실패", true);
+                            snprintf(confirm_msg, sizeof(confirm_msg), "파일 '%s'를 삭제하시겠습니까?", name);
                         }
                     }
+
+                    // 사용자에게 삭제 확인 요청 (응답은 메인 루프에서 처리)
+                    pending.kind = PENDING_DELETE;
+                    pending.use_trash = use_trash;
+                    ui_show_confirmation_dialog(confirm_msg);
                 }
                 break;
-        }
-        
-        // ESC 키 처리 (복사 작업 취소)
-        if (ch == 27) { // ESC의 ASCII 코드
-            pthread_mutex_lock(&g_tasks_mutex);
-            CopyTask* current = g_copy_tasks;
-            bool found_running_task = false;
-            
-            while (current) {
-                if (current->is_running) {
-                    found_running_task = true;
-                    if (ui_confirm_cancel_copy(current->dest_name)) {
-                        pthread_cancel(current->thread_id);
-                        pthread_join(current->thread_id, NULL);
-                        
-                        // 대상 파일 삭제
-                        if (current->is_directory) {
-                            delete_directory_recursive(current->dest_path);
+
+            case 'z': // 휴지통에서 복원 (휴지통 안에서는 선택한 항목, 그 외에는 가장 최근에 옮긴 항목)
+                {
+                    bool restored;
+                    if (is_in_trash(current_path) && current_selection >= 0 && current_selection < file_count &&
+                        strcmp(files[current_selection].name, "..") != 0) {
+                        char trashed_path[MAX_PATH_LEN];
+                        snprintf(trashed_path, sizeof(trashed_path), "%s/%s", current_path, files[current_selection].name);
+                        restored = trash_restore(trashed_path, NULL, 0);
+                    } else {
+                        restored = trash_restore_last(NULL, 0);
+                    }
+
+                    if (restored) {
+                        file_count = reload_file_list(current_path, files, file_count, true);
+                        if (current_selection >= file_count) {
+                            current_selection = file_count > 0 ? file_count - 1 : 0;
+                        }
+                    } else {
+                        ui_display_temporary_message("복원할 항목이 없습니다", true);
+                    }
+                }
+                break;
+
+            case 'P': // 표시한 항목(없으면 선택한 항목)을 현재 디렉토리의 tar 파일 하나로 묶기
+                {
+                    const char **names = malloc(sizeof(char*) * (file_count > 0 ? file_count : 1));
+                    int count = names ? collect_marked(files, file_count, names) : 0;
+                    if (names && count == 0 && current_selection < file_count &&
+                        strcmp(files[current_selection].name, "..") != 0) {
+                        names[count++] = files[current_selection].name;
+                    }
+                    if (count > 0) {
+                        if (start_pack_task(current_path, names, count, current_path)) {
+                            clear_marks(files, file_count);
+                            mark_anchor = -1;
+                            listing_dirty = true;
+                        } else {
+                            ui_display_temporary_message("묶기 실패", true);
+                        }
+                    }
+                    free(names);
+                }
+                break;
+
+            case '/': // 이름으로 이동 (입력할 때마다 맞는 항목으로)
+                if (name_pool_build(&jump_pool, files, file_count)) {
+                    input_mode = INPUT_JUMP;
+                    input_query[0] = '\0';
+                    input_len = 0;
+                    jump_origin = current_selection;
+                }
+                break;
+
+            case 'f': // 목록 거르기 (이미 켜져 있으면 검색어 수정)
+                start_filter(files, file_count);
+                input_mode = INPUT_FILTER;
+                snprintf(input_query, sizeof(input_query), "%s", g_filter_query);
+                input_len = strlen(input_query);
+                break;
+
+            case 6: // Ctrl+F - 퍼지 찾기 (글자가 순서대로 들어간 이름을 점수 순으로)
+                if (!open_fuzzy(&fuzzy, files, file_count)) {
+                    ui_display_temporary_message("메모리 부족", true);
+                }
+                break;
+
+            case 'F': // 하위 디렉토리까지 이름 찾기 (glob 또는 re:로 시작하는 정규식)
+                clear_pending(&pending);
+                pending.kind = PENDING_SEARCH;
+                ui_prompt_input("찾을 이름 (예: *.c, 이름 일부, re:^main)");
+                break;
+
+            case 'G': // 하위 디렉토리의 파일 내용 찾기 (대문자가 없으면 대소문자 무시)
+                clear_pending(&pending);
+                pending.kind = PENDING_GREP;
+                ui_prompt_input("찾을 내용");
+                break;
+
+            case 'U': // 디스크 사용량 (같은 디렉토리를 이미 읽었으면 그 트리를 다시 보여 줌)
+                if (!usage.active || strcmp(usage.root, current_path) != 0) {
+                    int max_depth;
+                    bool one_filesystem;
+                    search_default_limits(&max_depth, &one_filesystem);
+                    usage_stop(&usage);
+                    if (!usage_start(&usage, current_path, one_filesystem)) {
+                        ui_display_temporary_message("디스크 사용량을 읽을 수 없습니다", true);
+                        break;
+                    }
+                }
+                show_usage = true;
+                break;
+
+            case 'K': // 중복 파일 찾기 (같은 디렉토리에서 이미 찾았으면 그 결과를 다시 보여 줌)
+                if (!dupes.active || strcmp(dupes.root, current_path) != 0) {
+                    int max_depth;
+                    bool one_filesystem;
+                    search_default_limits(&max_depth, &one_filesystem);
+                    dupes_stop(&dupes);
+                    if (!dupes_start(&dupes, current_path, one_filesystem)) {
+                        ui_display_temporary_message("중복 파일 찾기를 시작할 수 없습니다", true);
+                        break;
+                    }
+                }
+                show_dupes = true;
+                break;
+
+            case 't': // 작업 대시보드 (모든 작업의 처리량과 남은 시간)
+                show_dashboard = true;
+                dashboard_selection = 0;
+                break;
+
+            case 'p': // 미리보기 칸 켜기/끄기 (분할 화면과 같은 자리를 쓰므로 분할 화면은 끔)
+                show_preview = !show_preview;
+                if (show_preview) {
+                    split_view = false;
+                    active_side = 0;
+                    preview_target[0] = '\0'; // 다음 프레임에 선택한 파일로 예약
+                } else {
+                    preview_close(&preview);
+                    preview_target[0] = '\0';
+                    preview_due_ms = 0;
+                }
+                ui_set_split(show_preview);
+                break;
+
+            case '[': // 미리보기 한 화면 위로
+            case ']': // 미리보기 한 화면 아래로
+                if (show_preview) {
+                    int rows = ui_list_height();
+                    preview_scroll(&preview, ch == ']' ? rows : -rows, ui_preview_bytes_per_row());
+                }
+                break;
+
+            case 'H': // 미리보기 텍스트/16진수 전환
+                if (show_preview) {
+                    preview_toggle_hex(&preview);
+                }
+                break;
+
+            case 's': // 분할 화면 켜기/끄기
+                if (show_preview) { // 미리보기 자리에 다른 칸을 엶
+                    show_preview = false;
+                    preview_close(&preview);
+                    preview_target[0] = '\0';
+                    preview_due_ms = 0;
+                }
+                split_view = !split_view;
+                if (split_view) {
+                    // 다른 칸은 같은 디렉토리로 시작 (방금 읽은 목록이 캐시에 있으므로 다시 읽지 않음)
+                    snprintf(other.path, sizeof(other.path), "%s", current_path);
+                    other.file_count = 0;
+                    other.selection = 0;
+                    other.scroll_offset = 0;
+                    reload_pane(&other);
+                } else {
+                    active_side = 0; // 남는 칸이 전체 너비를 씀
+                }
+                ui_set_split(split_view);
+                break;
+
+            case '\t': // 분할 화면에서 다른 칸으로 (필터는 활성 칸에만 있으므로 해제)
+                if (split_view) {
+                    file_count = clear_filter(files, file_count);
+                    Pane current = { .files = files, .file_count = file_count, .selection = current_selection,
+                                     .scroll_offset = scroll_offset, .dirty = listing_dirty };
+                    snprintf(current.path, sizeof(current.path), "%s", current_path);
+                    snprintf(current.disk_free, sizeof(current.disk_free), "%s", disk_free);
+
+                    files = other.files;
+                    file_count = other.file_count;
+                    current_selection = other.selection;
+                    scroll_offset = other.scroll_offset;
+                    listing_dirty = other.dirty;
+                    snprintf(current_path, sizeof(current_path), "%s", other.path);
+                    snprintf(disk_free, sizeof(disk_free), "%s", other.disk_free);
+                    other = current;
+
+                    active_side = 1 - active_side;
+                    mark_anchor = -1;
+                    change_directory(current_path); // 실행/편집은 현재 디렉토리 기준
+                }
+                break;
+
+            case KEY_F(5): // 분할 화면 - 표시한 항목(없으면 선택한 항목)을 다른 칸의 디렉토리로 복사
+            case KEY_F(6): // 분할 화면 - 다른 칸의 디렉토리로 이동
+                if (split_view) {
+                    bool move = (ch == KEY_F(6));
+                    const char **names = malloc(sizeof(char*) * (file_count > 0 ? file_count : 1));
+                    int count = names ? collect_marked(files, file_count, names) : 0;
+                    if (names && count == 0 && current_selection < file_count &&
+                        strcmp(files[current_selection].name, "..") != 0) {
+                        names[count++] = files[current_selection].name;
+                    }
+                    if (count > 0) {
+                        // 클립보드를 거치지 않고 바로 백그라운드 작업으로
+                        if (start_transfer_task(current_path, names, count, other.path, move)) {
+                            clear_marks(files, file_count);
+                            mark_anchor = -1;
+                            other.dirty = true;
+                            listing_dirty = move;
+                        } else {
+                            ui_display_temporary_message(move ? "이동 실패" : "복사 실패", true);
+                        }
+                    }
+                    free(names);
+                }
+                break;
+
+            case KEY_F(7): // 분할 화면 - 다른 칸의 같은 이름으로 동기화 (바뀐 파일만 복사)
+            case KEY_F(8): // 분할 화면 - 미러 (원본에 없는 대상 항목도 삭제, 확인 필요)
+                if (split_view) {
+                    const char **names = malloc(sizeof(char*) * (file_count > 0 ? file_count : 1));
+                    int count = names ? collect_marked(files, file_count, names) : 0;
+                    if (names && count == 0 && current_selection < file_count &&
+                        strcmp(files[current_selection].name, "..") != 0) {
+                        names[count++] = files[current_selection].name;
+                    }
+                    if (count > 0 && strcmp(current_path, other.path) == 0) {
+                        ui_display_temporary_message("두 칸이 같은 디렉토리입니다", true);
+                    } else if (count > 0 && ch == KEY_F(8)) {
+                        if (set_pending_items(&pending, current_path, names, count)) {
+                            char confirm_msg[MAX_PATH_LEN + 80];
+                            snprintf(confirm_msg, sizeof(confirm_msg),
+                                     "%d개 항목을 %s에 맞추고 원본에 없는 항목은 지우시겠습니까?", count, other.path);
+                            snprintf(pending.dest, sizeof(pending.dest), "%s", other.path);
+                            pending.kind = PENDING_SYNC_MIRROR;
+                            ui_show_confirmation_dialog(confirm_msg);
+                        }
+                    } else if (count > 0) {
+                        if (start_sync_task(current_path, names, count, other.path, false)) {
+                            clear_marks(files, file_count);
+                            mark_anchor = -1;
+                            other.dirty = true;
                         } else {
-                            unlink(current->dest_path);
+                            ui_display_temporary_message("동기화 실패", true);
                         }
-                        
-                        current->is_running = false;
-                        ui_display_temporary_message("복사 작업 취소됨", false);
-                        
-                        // 파일 목록 갱신
-                        file_count = get_file_list(current_path, files, MAX_FILES);
+                    }
+                    free(names);
+                }
+                break;
+
+            case '=': // 분할 화면 - 두 칸의 디렉토리 비교 (같은 두 디렉토리를 이미 비교했으면 그 결과를 다시 보여 줌)
+                if (split_view) {
+                    if (strcmp(current_path, other.path) == 0) {
+                        ui_display_temporary_message("두 칸이 같은 디렉토리입니다", true);
                         break;
                     }
+                    if (!compare.active || strcmp(compare.root[0], current_path) != 0 ||
+                        strcmp(compare.root[1], other.path) != 0) {
+                        int max_depth;
+                        bool one_filesystem;
+                        search_default_limits(&max_depth, &one_filesystem);
+                        compare_stop(&compare);
+                        if (!compare_start(&compare, current_path, other.path, false, one_filesystem)) {
+                            ui_display_temporary_message("디렉토리 비교를 시작할 수 없습니다", true);
+                            break;
+                        }
+                    }
+                    show_compare = true;
                 }
-                current = current->next;
+                break;
+        }
+        
+        // ESC 키 처리 (진행률 패널에 보이는 작업 취소)
+        if (ch == 27) { // ESC의 ASCII 코드
+            pthread_mutex_lock(&g_tasks_mutex);
+            CopyTask* current = shown_task();
+            if (current) {
+                clear_pending(&pending);
+                pending.kind = PENDING_CANCEL_TASK;
+                pending.task_id = current->id;
+                ui_confirm_cancel_copy(current->dest_name);
             }
-            
             pthread_mutex_unlock(&g_tasks_mutex);
-            
-            if (!found_running_task) {
-                // 일반 ESC 키 처리 - 추가적인 동작 정의 가능
-            }
             continue;
         }
         
         // 스크롤 오프셋과 선택 범위 유효성 검사
         if (scroll_offset < 0) scroll_offset = 0;
         if (file_count > 0) {
-            int screen_rows, screen_cols;
-            getmaxyx(stdscr, screen_rows, screen_cols);
-            int main_content_display_height = (screen_rows - FOOTER_TOTAL_HEIGHT) - 1;
+            int main_content_display_height = ui_list_height();
             if (main_content_display_height < 0) main_content_display_height = 0;
 
             int max_scroll_offset = file_count - main_content_display_height;
@@ -405,7 +2101,24 @@ int main() {
         if (current_selection < 0) current_selection = 0;
     }
 
+    clear_pending(&pending);
+    name_pool_free(&jump_pool);
+    close_fuzzy(&fuzzy);
+    preview_close(&preview);
+    search_stop(&search);
+    usage_stop(&usage);
+    dupes_stop(&dupes);
+    compare_stop(&compare);
+    archive_task_stop(&archive_load, NULL);
+    archive_task_stop(&archive_extract, NULL);
+    close_archive_view(&archive);
+    cleanup_archives(); // 압축 파일 색인 캐시 해제
+    clear_filter(files, file_count);
     cleanup_clipboard_system(); // 클립보드 시스템 정리
+    cleanup_trash_system(); // 휴지통 정리 스레드 종료
+    cleanup_index_system(); // 색인 스레드 종료 (변경분 저장)
+    cleanup_file_types(); // 확장자 표와 내용 판별 캐시 해제
+    event_cleanup(); // eventfd, inotify 닫기
     close_ui(); // ncurses 종료 및 윈도우 정리
 
     printf("Finder 프로그램이 종료되었습니다.\n");
@@ -0,0 +1,285 @@
+// preview.c
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE // memrchr
+#endif
+#include "preview.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <unistd.h>
+#include <wchar.h>
+#include <sys/stat.h>
+
+void preview_init(Preview *preview) {
+    memset(preview, 0, sizeof(Preview));
+    preview->fd = -1;
+}
+
+void preview_close(Preview *preview) {
+    if (preview->fd != -1) close(preview->fd);
+    free(preview->window);
+    preview->window = NULL;
+    preview->window_len = 0;
+    preview->fd = -1;
+    preview->size = 0;
+    preview->virtual_size = false;
+    preview->loaded = false;
+}
+
+// off부터 len바이트를 읽을 수 있는 포인터 (avail에 실제로 읽을 수 있는 양)
+// 창 밖이면 pread로 창을 옮겨 읽음 (뒤로 스크롤할 때를 위해 조금 앞에서부터)
+static const unsigned char* preview_data(Preview *preview, off_t off, size_t len, size_t *avail) {
+    *avail = 0;
+    if (off < 0 || off >= preview->size) return NULL;
+    if ((off_t)len > preview->size - off) len = preview->size - off;
+
+    if (!preview->window || off < preview->window_offset ||
+        off + (off_t)len > preview->window_offset + (off_t)preview->window_len) {
+        if (!preview->window) {
+            preview->window = malloc(PREVIEW_WINDOW);
+            if (!preview->window) return NULL;
+        }
+        off_t start = off - (off < PREVIEW_WINDOW / 4 ? off : PREVIEW_WINDOW / 4);
+        ssize_t got = pread(preview->fd, preview->window, PREVIEW_WINDOW, start);
+        if (got < 0) got = 0;
+        preview->window_offset = start;
+        preview->window_len = got;
+    }
+
+    off_t in_window = off - preview->window_offset;
+    if (in_window >= (off_t)preview->window_len) return NULL;
+    size_t left = preview->window_len - in_window;
+    *avail = len < left ? len : left;
+    return preview->window + in_window;
+}
+
+// 앞부분에 NUL이 있거나 제어 문자가 많으면 바이너리로 봄
+static bool sniff_binary(Preview *preview) {
+    size_t avail;
+    const unsigned char *data = preview_data(preview, 0, PREVIEW_SNIFF_BYTES, &avail);
+    if (!data) return false;
+    size_t control = 0;
+    for (size_t i = 0; i < avail; i++) {
+        unsigned char c = data[i];
+        if (c == 0) return true;
+        if (c < 0x20 && c != '\n' && c != '\r' && c != '\t' && c != '\f' && c != 0x1b) control++;
+    }
+    return control * 10 > avail;
+}
+
+bool preview_open(Preview *preview, const char *path) {
+    preview_close(preview);
+    snprintf(preview->path, sizeof(preview->path), "%s", path);
+    preview->top = 0;
+    preview->hex = false;
+    preview->is_binary = false;
+    preview->message[0] = '\0';
+
+    // FIFO나 장치는 열기만 해도 멈출 수 있으므로 일반 파일만
+    struct stat st;
+    if (stat(path, &st) == -1) {
+        snprintf(preview->message, sizeof(preview->message), "열 수 없음: %s", strerror(errno));
+        return false;
+    }
+    if (S_ISDIR(st.st_mode)) {
+        snprintf(preview->message, sizeof(preview->message), "디렉토리");
+        return false;
+    }
+    if (!S_ISREG(st.st_mode)) {
+        snprintf(preview->message, sizeof(preview->message), "미리보기를 지원하지 않는 파일 종류");
+        return false;
+    }
+
+    preview->fd = open(path, O_RDONLY | O_NONBLOCK | O_CLOEXEC);
+    if (preview->fd == -1) {
+        snprintf(preview->message, sizeof(preview->message), "열 수 없음: %s", strerror(errno));
+        return false;
+    }
+    preview->size = st.st_size;
+
+    if (st.st_size > 0) {
+        // 보이는 줄 주변만 읽으므로 미리 읽기는 하지 않음
+        posix_fadvise(preview->fd, 0, 0, POSIX_FADV_RANDOM);
+    } else {
+        // 크기가 0으로 보이는 가상 파일(/proc, /sys)은 첫 창을 읽어 본 만큼을 크기로
+        preview->size = PREVIEW_WINDOW;
+        size_t avail;
+        preview_data(preview, 0, PREVIEW_WINDOW, &avail);
+        preview->size = preview->window_len;
+        preview->virtual_size = true;
+    }
+
+    preview->loaded = true;
+    preview->is_binary = sniff_binary(preview);
+    preview->hex = preview->is_binary;
+    if (preview->size == 0) {
+        snprintf(preview->message, sizeof(preview->message), "빈 파일");
+    }
+    return true;
+}
+
+void preview_reload(Preview *preview) {
+    if (preview->path[0] == '\0') return;
+    char path[MAX_PATH_LEN];
+    snprintf(path, sizeof(path), "%s", preview->path);
+    off_t top = preview->top;
+    bool hex = preview->hex;
+    bool was_loaded = preview->loaded;
+
+    if (!preview_open(preview, path) || !was_loaded) return;
+    preview->hex = hex;
+    preview->top = (top < preview->size) ? top : 0;
+}
+
+void preview_validate(Preview *preview) {
+    if (!preview->loaded || preview->virtual_size) return;
+    struct stat st;
+    if (fstat(preview->fd, &st) == 0 && st.st_size < preview->size) {
+        preview_reload(preview);
+    }
+}
+
+int preview_text_line(Preview *preview, off_t start, char *out, size_t out_size, int max_cols, off_t *next) {
+    size_t avail;
+    const unsigned char *data = preview_data(preview, start, PREVIEW_MAX_LINE, &avail);
+    if (!data || avail == 0 || out_size == 0) return -1;
+
+    const unsigned char *newline = memchr(data, '\n', avail);
+    size_t line_len = newline ? (size_t)(newline - data) : avail;
+    *next = start + line_len + (newline ? 1 : 0);
+
+    mbstate_t state;
+    memset(&state, 0, sizeof(state));
+    size_t pos = 0, used = 0;
+    int cols = 0;
+    while (pos < line_len && cols < max_cols && used + MB_LEN_MAX + 1 < out_size) {
+        unsigned char c = data[pos];
+        if (c == '\t') {
+            // 탭은 칸 기준 8칸 단위 공백으로 (ncurses가 창 기준으로 펼치지 않도록)
+            int spaces = 8 - cols % 8;
+            while (spaces-- > 0 && cols < max_cols && used + 1 < out_size) {
+                out[used++] = ' ';
+                cols++;
+            }
+            pos++;
+            continue;
+        }
+        if (c < 0x80) {
+            out[used++] = (c < 0x20 || c == 0x7f) ? '.' : (char)c;
+            cols++;
+            pos++;
+            continue;
+        }
+
+        wchar_t wc;
+        size_t n = mbrtowc(&wc, (const char *)data + pos, line_len - pos, &state);
+        if (n == (size_t)-1 || n == (size_t)-2 || n == 0) {
+            // 잘못된 바이트나 조각 경계에서 잘린 글자
+            memset(&state, 0, sizeof(state));
+            out[used++] = '?';
+            cols++;
+            pos++;
+            continue;
+        }
+        int width = wcwidth(wc);
+        if (width < 0) {
+            out[used++] = '?';
+            cols++;
+            pos += n;
+            continue;
+        }
+        if (cols + width > max_cols) break;
+        memcpy(out + used, data + pos, n);
+        used += n;
+        cols += width;
+        pos += n;
+    }
+    out[used] = '\0';
+    return (int)used;
+}
+
+int preview_hex_line(Preview *preview, off_t offset, int bytes_per_row, char *out, size_t out_size) {
+    size_t avail;
+    const unsigned char *data = preview_data(preview, offset, bytes_per_row, &avail);
+    if (!data || avail == 0) return -1;
+
+    int used = snprintf(out, out_size, "%010llx ", (unsigned long long)offset);
+    for (int i = 0; i < bytes_per_row && used < (int)out_size; i++) {
+        if (i % 8 == 0) used += snprintf(out + used, out_size - used, " ");
+        if ((size_t)i < avail) {
+            used += snprintf(out + used, out_size - used, "%02x ", data[i]);
+        } else {
+            used += snprintf(out + used, out_size - used, "   ");
+        }
+    }
+    if (used < (int)out_size) used += snprintf(out + used, out_size - used, " |");
+    for (size_t i = 0; i < avail && used + 2 < (int)out_size; i++) {
+        out[used++] = (data[i] >= 0x20 && data[i] < 0x7f) ? (char)data[i] : '.';
+    }
+    if (used + 2 <= (int)out_size) {
+        out[used++] = '|';
+        out[used] = '\0';
+    }
+    return used;
+}
+
+// 다음 줄 위치 (파일 끝이면 start 그대로)
+static off_t next_line(Preview *preview, off_t start) {
+    size_t avail;
+    const unsigned char *data = preview_data(preview, start, PREVIEW_MAX_LINE, &avail);
+    if (!data || avail == 0) return start;
+    const unsigned char *newline = memchr(data, '\n', avail);
+    off_t next = start + (newline ? (newline - data) + 1 : (off_t)avail);
+    return next < preview->size ? next : start;
+}
+
+// 이전 줄 위치 - 거꾸로 최대 PREVIEW_MAX_LINE바이트만 찾음 (더 긴 줄은 조각 단위로)
+static off_t prev_line(Preview *preview, off_t start) {
+    if (start <= 0) return 0;
+    off_t end = start - 1; // 바로 앞 줄의 '\n'
+    off_t begin = end > PREVIEW_MAX_LINE ? end - PREVIEW_MAX_LINE : 0;
+    if (end == begin) return begin;
+
+    size_t avail;
+    const unsigned char *data = preview_data(preview, begin, end - begin, &avail);
+    if (!data) return begin;
+    const unsigned char *newline = memrchr(data, '\n', avail);
+    if (newline) return begin + (newline - data) + 1;
+    return begin;
+}
+
+void preview_scroll(Preview *preview, int lines, int bytes_per_row) {
+    if (!preview->loaded || preview->size == 0) return;
+
+    if (preview->hex) {
+        off_t last_row = (preview->size - 1) / bytes_per_row * bytes_per_row;
+        off_t top = preview->top + (off_t)lines * bytes_per_row;
+        if (top > last_row) top = last_row;
+        if (top < 0) top = 0;
+        preview->top = top;
+        return;
+    }
+
+    for (; lines > 0; lines--) {
+        off_t next = next_line(preview, preview->top);
+        if (next == preview->top) break;
+        preview->top = next;
+    }
+    for (; lines < 0 && preview->top > 0; lines++) {
+        preview->top = prev_line(preview, preview->top);
+    }
+}
+
+void preview_toggle_hex(Preview *preview) {
+    if (!preview->loaded) return;
+    preview->hex = !preview->hex;
+    if (preview->hex) {
+        preview->top -= preview->top % 16; // 16진수 보기는 16바이트 경계에서 시작
+    } else if (preview->top > 0) {
+        // 텍스트 보기는 줄 시작에서
+        preview->top = prev_line(preview, preview->top + 1);
+    }
+}
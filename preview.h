@@ -0,0 +1,60 @@
+// preview.h
+#ifndef PREVIEW_H
+#define PREVIEW_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <sys/types.h>
+#include "fs.h"
+
+#define PREVIEW_DEBOUNCE_MS 150        // 선택이 이만큼 멈춰 있어야 파일을 엶 (빠르게 스크롤할 때 열지 않음)
+#define PREVIEW_WINDOW (256 * 1024)    // 보이는 부분 주변을 pread로 읽는 창 크기 (창 밖으로 스크롤하면 옮겨 읽음)
+#define PREVIEW_MAX_LINE 4096          // 한 줄로 보는 최대 바이트 (더 긴 줄은 조각으로 나눠 보여 줌)
+#define PREVIEW_SNIFF_BYTES 8192       // 바이너리인지 판단할 때 보는 앞부분
+
+// 선택한 파일 미리보기 - 화면에 보이는 부분 주변의 창만 pread로 읽음
+// 큰 파일도 여는 비용은 같고, 보는 중에 파일이 줄어도 (잘린 로그 등) 짧게 읽힐 뿐 SIGBUS가 나지 않음
+typedef struct {
+    char path[MAX_PATH_LEN];
+    bool loaded;               // 파일을 열었는지 (아니면 message를 보여 줌)
+    int fd;
+    off_t size;
+    bool virtual_size;         // 크기가 0으로 보여 첫 창을 읽은 만큼을 크기로 쓰는 파일 (/proc, /sys)
+    unsigned char *window;     // pread 창
+    off_t window_offset;
+    size_t window_len;
+    bool is_binary;
+    bool hex;                  // 16진수로 보기 (바이너리면 기본)
+    off_t top;                 // 화면 첫 줄의 바이트 위치
+    char message[128];         // 열 수 없거나 일반 파일이 아닐 때의 설명
+} Preview;
+
+// 미리보기 상태 초기화 (열린 파일 없음)
+void preview_init(Preview *preview);
+
+// 파일 열기 (이전 파일은 닫음), 일반 파일이 아니거나 열 수 없으면 false와 함께 message 설정
+bool preview_open(Preview *preview, const char *path);
+
+// 같은 파일을 다시 열되 보던 위치와 보기 방식 유지 (파일 내용이 바뀌었을 때)
+void preview_reload(Preview *preview);
+
+// 열린 파일 닫기
+void preview_close(Preview *preview);
+
+// 그리기 전에 호출 - 파일이 줄었으면 (잘린 로그 등) 다시 열어 크기와 창을 맞춤
+void preview_validate(Preview *preview);
+
+// 텍스트 한 줄을 화면에 그릴 수 있는 문자열로 (탭은 공백, 제어 문자는 '.', 최대 max_cols 칸)
+// next에 다음 줄 위치, 파일 끝이면 -1 반환
+int preview_text_line(Preview *preview, off_t start, char *out, size_t out_size, int max_cols, off_t *next);
+
+// 16진수 보기 한 줄 (위치, 바이트, ASCII), 파일 끝이면 -1 반환
+int preview_hex_line(Preview *preview, off_t offset, int bytes_per_row, char *out, size_t out_size);
+
+// 화면 위치를 lines줄만큼 이동 (음수면 위로), 16진수 보기는 bytes_per_row 단위
+void preview_scroll(Preview *preview, int lines, int bytes_per_row);
+
+// 텍스트/16진수 보기 전환
+void preview_toggle_hex(Preview *preview);
+
+#endif
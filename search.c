@@ -0,0 +1,438 @@
+// search.c
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE // FNM_CASEFOLD
+#endif
+#include "search.h"
+#include "event.h"
+#include "index.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <dirent.h>
+#include <ctype.h>
+#include <fnmatch.h>
+
+void search_default_limits(int *max_depth, bool *one_filesystem) {
+    *max_depth = -1;
+    *one_filesystem = true;
+
+    const char *depth = getenv("FINDER_SEARCH_DEPTH");
+    if (depth && depth[0] != '\0') {
+        char *end;
+        long value = strtol(depth, &end, 10);
+        if (*end == '\0' && value >= 0 && value <= 4096) {
+            *max_depth = (int)value;
+        }
+    }
+    const char *xdev = getenv("FINDER_SEARCH_XDEV");
+    if (xdev && strcmp(xdev, "1") == 0) {
+        *one_filesystem = false;
+    }
+}
+
+static bool search_matches(SearchTask *task, const char *name) {
+    if (task->use_regex) {
+        return regexec(&task->regex, name, 0, NULL, 0) == 0;
+    }
+    return fnmatch(task->glob, name, FNM_CASEFOLD) == 0;
+}
+
+// 결과에 추가 (path와 text의 소유권을 넘겨받음, 가득 차면 탐색을 멈춤)
+// 너무 자주 깨우지 않도록 간격을 두고 화면에 알림
+static void search_push_hit(SearchTask *task, char *path, unsigned char d_type, long line, char *text) {
+    bool full = false;
+    bool wake = false;
+    pthread_mutex_lock(&task->lock);
+    if (task->hit_count == task->hit_capacity) {
+        int capacity = task->hit_capacity ? task->hit_capacity * 2 : 256;
+        if (capacity > SEARCH_MAX_RESULTS) capacity = SEARCH_MAX_RESULTS;
+        SearchHit *grown = realloc(task->hits, sizeof(SearchHit) * capacity);
+        if (grown) {
+            task->hits = grown;
+            task->hit_capacity = capacity;
+        }
+    }
+    if (task->hit_count < task->hit_capacity) {
+        SearchHit *hit = &task->hits[task->hit_count++];
+        hit->path = path;
+        hit->d_type = d_type;
+        hit->line = line;
+        hit->text = text;
+        path = NULL;
+        text = NULL;
+    }
+    if (task->hit_count >= SEARCH_MAX_RESULTS) {
+        task->truncated = true;
+        full = true;
+    }
+    long now = event_now_ms();
+    if (now - task->last_notify_ms >= SEARCH_NOTIFY_MS) {
+        task->last_notify_ms = now;
+        wake = true;
+    }
+    pthread_mutex_unlock(&task->lock);
+
+    free(path);
+    free(text);
+    if (full) search_cancel(task);
+    if (wake) notify_ui();
+}
+
+// 시작 디렉토리 기준 상대 경로 (malloc)
+static char* search_relative_path(SearchTask *task, WalkDir *dir, const char *name) {
+    const char *relative = dir->path + task->root_len;
+    while (*relative == '/') relative++;
+    size_t relative_len = strlen(relative);
+    size_t name_len = strlen(name);
+
+    char *path = malloc(relative_len + name_len + 2);
+    if (!path) return NULL;
+    if (relative_len > 0) {
+        memcpy(path, relative, relative_len);
+        path[relative_len++] = '/';
+    }
+    memcpy(path + relative_len, name, name_len + 1);
+    return path;
+}
+
+static bool search_index_match(void *user, const char *name) {
+    return search_matches((SearchTask*)user, name);
+}
+
+static void search_index_hit(void *user, const char *relative_path, unsigned char d_type) {
+    char *path = strdup(relative_path);
+    if (path) search_push_hit((SearchTask*)user, path, d_type, 0, NULL);
+}
+
+// 이름에 반드시 들어 있어야 하는 가장 긴 글자열 (소문자, 색인 후보를 좁히는 데 씀)
+// 정규식은 확인하지 않고 빈 문자열 (색인 전체를 이름으로 확인)
+static void search_literal(const SearchTask *task, char *out, size_t size) {
+    out[0] = '\0';
+    if (task->use_regex || size == 0) return;
+
+    const char *best = NULL;
+    size_t best_len = 0;
+    const char *p = task->glob;
+    while (*p) {
+        if (*p == '*' || *p == '?') {
+            p++;
+        } else if (*p == '[') {
+            // 문자 집합은 건너뜀 ("[]...]"처럼 ]로 시작하는 경우 포함)
+            p++;
+            if (*p == '!' || *p == '^') p++;
+            if (*p == ']') p++;
+            while (*p && *p != ']') p++;
+            if (*p) p++;
+        } else {
+            const char *start = p;
+            while (*p && *p != '*' && *p != '?' && *p != '[' && *p != '\\') p++;
+            if ((size_t)(p - start) > best_len) {
+                best = start;
+                best_len = p - start;
+            }
+            if (*p == '\\') {
+                p++;
+                if (*p) p++;
+            }
+        }
+    }
+    if (best_len >= size) best_len = size - 1;
+    for (size_t i = 0; i < best_len; i++) {
+        unsigned char c = (unsigned char)best[i];
+        out[i] = (c < 0x80) ? (char)tolower(c) : (char)c;
+    }
+    out[best_len] = '\0';
+}
+
+static bool search_visit(Walker *w, WalkDir *dir, int dirfd, const char *name,
+                         unsigned char d_type, const struct stat *st) {
+    (void)dirfd;
+    (void)st;
+    SearchTask *task = (SearchTask*)w->user;
+    if (search_matches(task, name)) {
+        char *path = search_relative_path(task, dir, name);
+        if (path) search_push_hit(task, path, d_type, 0, NULL);
+    }
+    return true;
+}
+
+// 내용 찾기: 일반 파일을 대기열에 넣음 (가득 차면 워커가 비울 때까지 기다림)
+static bool grep_visit(Walker *w, WalkDir *dir, int dirfd, const char *name,
+                       unsigned char d_type, const struct stat *st) {
+    (void)dirfd;
+    (void)st;
+    SearchTask *task = (SearchTask*)w->user;
+    if (d_type == DT_DIR) return strcmp(name, ".git") != 0;
+    if (d_type != DT_REG) return false;
+
+    GrepJob *job = malloc(sizeof(GrepJob));
+    if (!job) return false;
+    job->path = search_relative_path(task, dir, name);
+    job->next = NULL;
+    if (!job->path) {
+        free(job);
+        return false;
+    }
+
+    pthread_mutex_lock(&task->lock);
+    while (task->queue_length >= GREP_QUEUE_LIMIT && !task->stopping) {
+        pthread_cond_wait(&task->queue_space, &task->lock);
+    }
+    if (task->stopping) {
+        pthread_mutex_unlock(&task->lock);
+        free(job->path);
+        free(job);
+        return false;
+    }
+    if (task->queue_tail) {
+        task->queue_tail->next = job;
+    } else {
+        task->queue_head = job;
+    }
+    task->queue_tail = job;
+    task->queue_length++;
+    pthread_cond_signal(&task->queue_ready);
+    pthread_mutex_unlock(&task->lock);
+    return false;
+}
+
+typedef struct {
+    SearchTask *task;
+    const char *path;      // 상대 경로
+    bool stop;
+} GrepContext;
+
+static bool grep_on_line(void *user, long line, const char *text, size_t len) {
+    GrepContext *ctx = (GrepContext*)user;
+    char *path = strdup(ctx->path);
+    char *copy = malloc(len + 1);
+    if (!path || !copy) {
+        free(path);
+        free(copy);
+        return false;
+    }
+    memcpy(copy, text, len + 1);
+    search_push_hit(ctx->task, path, DT_REG, line, copy);
+    return !ctx->task->stopping;
+}
+
+// 내용 찾기 워커 - 대기열에서 파일을 하나씩 꺼내 읽음 (작은 파일용 버퍼는 워커마다 재사용)
+static void* grep_worker(void *arg) {
+    SearchTask *task = (SearchTask*)arg;
+    GrepBuffer buffer = {0};
+    char full[MAX_PATH_LEN * 2];
+
+    for (;;) {
+        pthread_mutex_lock(&task->lock);
+        while (!task->queue_head && !task->walk_done && !task->stopping) {
+            pthread_cond_wait(&task->queue_ready, &task->lock);
+        }
+        if (task->stopping || !task->queue_head) {
+            pthread_mutex_unlock(&task->lock);
+            break;
+        }
+        GrepJob *job = task->queue_head;
+        task->queue_head = job->next;
+        if (!task->queue_head) task->queue_tail = NULL;
+        task->queue_length--;
+        pthread_cond_signal(&task->queue_space);
+        pthread_mutex_unlock(&task->lock);
+
+        snprintf(full, sizeof(full), "%s/%s", strcmp(task->root, "/") == 0 ? "" : task->root, job->path);
+        GrepContext ctx = { .task = task, .path = job->path };
+        grep_file(&task->grep, full, &buffer, grep_on_line, &ctx);
+        free(job->path);
+        free(job);
+
+        pthread_mutex_lock(&task->lock);
+        task->files_scanned++;
+        pthread_mutex_unlock(&task->lock);
+    }
+    grep_buffer_free(&buffer);
+
+    // 마지막 워커가 끝나면 내용 찾기 전체가 끝난 것
+    pthread_mutex_lock(&task->lock);
+    bool last = (--task->grep_running == 0);
+    if (last) task->finished = true;
+    pthread_mutex_unlock(&task->lock);
+    if (last) notify_ui();
+    return NULL;
+}
+
+// 시작 디렉토리가 끝나면 전체 탐색이 끝난 것 (취소된 경우도 여기로 옴)
+// 내용 찾기는 대기열이 비고 워커가 모두 끝나야 끝남
+static void search_leave_dir(Walker *w, WalkDir *dir) {
+    if (dir->parent) return;
+    SearchTask *task = (SearchTask*)w->user;
+    pthread_mutex_lock(&task->lock);
+    if (task->kind == SEARCH_CONTENT) {
+        task->walk_done = true;
+        pthread_cond_broadcast(&task->queue_ready);
+        pthread_mutex_unlock(&task->lock);
+        return;
+    }
+    task->finished = true;
+    pthread_mutex_unlock(&task->lock);
+    notify_ui();
+}
+
+bool search_start(SearchTask *task, const char *root, const char *pattern, int max_depth,
+                  bool one_filesystem, char *error, size_t error_size) {
+    memset(task, 0, sizeof(SearchTask));
+    snprintf(task->root, sizeof(task->root), "%s", root);
+    task->root_len = strlen(task->root);
+    snprintf(task->pattern, sizeof(task->pattern), "%s", pattern);
+
+    size_t prefix_len = strlen(SEARCH_REGEX_PREFIX);
+    if (strncmp(pattern, SEARCH_REGEX_PREFIX, prefix_len) == 0) {
+        int rc = regcomp(&task->regex, pattern + prefix_len, REG_EXTENDED | REG_ICASE | REG_NOSUB);
+        if (rc != 0) {
+            regerror(rc, &task->regex, error, error_size);
+            return false;
+        }
+        task->use_regex = true;
+    } else if (strpbrk(pattern, "*?[")) {
+        snprintf(task->glob, sizeof(task->glob), "%s", pattern);
+    } else {
+        // 와일드카드가 없으면 이름의 일부로 찾음
+        snprintf(task->glob, sizeof(task->glob), "*%s*", pattern);
+    }
+
+    pthread_mutex_init(&task->lock, NULL);
+    WalkOps ops = { .visit = search_visit, .leave_dir = search_leave_dir };
+    walker_init(&task->walker, &ops, task);
+    task->walker.need_stat = false; // 이름과 d_type만으로 충분
+    task->walker.max_depth = max_depth;
+    task->walker.one_filesystem = one_filesystem;
+    task->active = true;
+
+    // 색인이 시작 디렉토리를 덮고 있으면 탐색 없이 바로 답함
+    if (one_filesystem) {
+        char literal[MAX_NAME_LEN];
+        search_literal(task, literal, sizeof(literal));
+        int found = index_lookup(task->root, literal, max_depth, search_index_match, search_index_hit,
+                                 task, SEARCH_MAX_RESULTS);
+        if (found >= 0) {
+            task->from_index = true;
+            task->finished = true;
+            notify_ui();
+            return true;
+        }
+    }
+
+    if (!walker_start(&task->walker, task->root)) {
+        task->finished = true;
+    }
+    return true;
+}
+
+bool search_start_content(SearchTask *task, const char *root, const char *text, int max_depth,
+                          bool one_filesystem, char *error, size_t error_size) {
+    memset(task, 0, sizeof(SearchTask));
+    if (!grep_compile(&task->grep, text)) {
+        snprintf(error, error_size, "찾을 내용은 1~%d바이트", GREP_MAX_PATTERN - 1);
+        return false;
+    }
+    task->kind = SEARCH_CONTENT;
+    snprintf(task->root, sizeof(task->root), "%s", root);
+    task->root_len = strlen(task->root);
+    snprintf(task->pattern, sizeof(task->pattern), "%s", text);
+
+    pthread_mutex_init(&task->lock, NULL);
+    pthread_cond_init(&task->queue_ready, NULL);
+    pthread_cond_init(&task->queue_space, NULL);
+    WalkOps ops = { .visit = grep_visit, .leave_dir = search_leave_dir };
+    walker_init(&task->walker, &ops, task);
+    task->walker.need_stat = false;
+    task->walker.max_depth = max_depth;
+    task->walker.one_filesystem = one_filesystem;
+    task->active = true;
+
+    // 파일 읽기는 디렉토리 탐색과 따로 파일 단위로 나눔 (큰 디렉토리 하나도 여러 워커가 읽음)
+    // 워커를 먼저 띄움 - 탐색 스레드를 만들지 못하면 walker_start가 이 스레드에서 바로 탐색하므로
+    // 그때 대기열을 비울 워커가 없으면 grep_visit이 가득 찬 대기열에서 영영 기다림
+    int workers = walker_default_threads();
+    if (workers > GREP_MAX_THREADS) workers = GREP_MAX_THREADS;
+    pthread_mutex_lock(&task->lock);
+    for (int i = 0; i < workers; i++) {
+        if (pthread_create(&task->grep_threads[task->grep_thread_count], NULL, grep_worker, task) == 0) {
+            task->grep_thread_count++;
+            task->grep_running++;
+        }
+    }
+    bool no_workers = (task->grep_thread_count == 0);
+    if (no_workers) task->finished = true;
+    pthread_mutex_unlock(&task->lock);
+    if (no_workers) return true;
+
+    if (!walker_start(&task->walker, task->root)) {
+        // 탐색할 것이 없으면 워커들이 빈 대기열을 보고 끝나며 finished를 켬
+        pthread_mutex_lock(&task->lock);
+        task->walk_done = true;
+        pthread_cond_broadcast(&task->queue_ready);
+        pthread_mutex_unlock(&task->lock);
+    }
+    return true;
+}
+
+void search_cancel(SearchTask *task) {
+    if (!task->active) return;
+    walker_cancel(&task->walker);
+    if (task->kind == SEARCH_CONTENT) {
+        pthread_mutex_lock(&task->lock);
+        task->stopping = true;
+        pthread_cond_broadcast(&task->queue_ready);
+        pthread_cond_broadcast(&task->queue_space);
+        pthread_mutex_unlock(&task->lock);
+    }
+}
+
+void search_stop(SearchTask *task) {
+    if (!task->active) return;
+    search_cancel(task);
+    walker_wait(&task->walker);
+    walker_destroy(&task->walker);
+    for (int i = 0; i < task->grep_thread_count; i++) {
+        pthread_join(task->grep_threads[i], NULL);
+    }
+    while (task->queue_head) {
+        GrepJob *job = task->queue_head;
+        task->queue_head = job->next;
+        free(job->path);
+        free(job);
+    }
+    if (task->use_regex) regfree(&task->regex);
+    for (int i = 0; i < task->hit_count; i++) {
+        free(task->hits[i].path);
+        free(task->hits[i].text);
+    }
+    free(task->hits);
+    if (task->kind == SEARCH_CONTENT) {
+        pthread_cond_destroy(&task->queue_ready);
+        pthread_cond_destroy(&task->queue_space);
+    }
+    pthread_mutex_destroy(&task->lock);
+    memset(task, 0, sizeof(SearchTask));
+}
+
+long search_dirs_scanned(SearchTask *task) {
+    pthread_mutex_lock(&task->walker.lock);
+    long dirs = task->walker.dirs_scanned;
+    pthread_mutex_unlock(&task->walker.lock);
+    return dirs;
+}
+
+long search_files_scanned(SearchTask *task) {
+    pthread_mutex_lock(&task->lock);
+    long files = task->files_scanned;
+    pthread_mutex_unlock(&task->lock);
+    return files;
+}
+
+void search_hit_path(const SearchTask *task, const SearchHit *hit, char *out, size_t out_size) {
+    if (task->root_len > 0 && task->root[task->root_len - 1] == '/') {
+        snprintf(out, out_size, "%s%s", task->root, hit->path);
+    } else {
+        snprintf(out, out_size, "%s/%s", task->root, hit->path);
+    }
+}
@@ -0,0 +1,108 @@
+// search.h
+#ifndef SEARCH_H
+#define SEARCH_H
+
+#include <stdbool.h>
+#include <dirent.h>
+#include <regex.h>
+#include <pthread.h>
+#include "fs.h"
+#include "walk.h"
+#include "grep.h"
+
+#define SEARCH_MAX_RESULTS 10000  // 이만큼 찾으면 탐색을 멈춤
+#define SEARCH_NOTIFY_MS 50       // 결과가 늘어날 때 화면을 깨우는 최소 간격
+#define SEARCH_REGEX_PREFIX "re:" // 이 접두어로 시작하면 정규식, 아니면 glob
+#define GREP_QUEUE_LIMIT 1024     // 내용 찾기에서 아직 읽지 않은 파일 대기열 한도 (차면 탐색기가 기다림)
+#define GREP_MAX_THREADS 16
+
+// 무엇을 찾는지
+typedef enum {
+    SEARCH_NAMES = 0,      // 이름
+    SEARCH_CONTENT         // 파일 내용 (grep)
+} SearchKind;
+
+// 내용 찾기 대기열의 파일 하나
+typedef struct GrepJob {
+    char *path;            // 시작 디렉토리 기준 상대 경로
+    struct GrepJob *next;
+} GrepJob;
+
+// 찾은 항목 하나
+typedef struct {
+    char *path;            // 시작 디렉토리 기준 상대 경로
+    unsigned char d_type;  // DT_DIR 등 (파일시스템이 알려 주지 않으면 DT_UNKNOWN)
+    long line;             // 내용 찾기에서 맞은 줄 번호 (이름 찾기는 0)
+    char *text;            // 내용 찾기에서 맞은 줄 내용 (이름 찾기는 NULL)
+} SearchHit;
+
+// 하위 디렉토리 전체에서 이름 찾기 - 색인이 덮는 곳이면 색인에서 바로, 아니면 병렬 탐색기로 훑으며
+// 찾은 항목을 바로 결과에 넣음 (탐색은 stat 없이 d_type만 쓰고, 결과는 찾는 동안에도 lock을 잡고 읽을 수 있음)
+// 내용 찾기는 탐색기가 일반 파일을 대기열에 넣고, 별도 워커들이 파일 단위로 나눠 읽으며 맞은 줄을 결과에 넣음
+typedef struct {
+    bool active;                   // 결과 화면이 열려 있음
+    SearchKind kind;
+    Walker walker;
+    char root[MAX_PATH_LEN];
+    size_t root_len;
+    char pattern[MAX_NAME_LEN];    // 입력한 그대로 (표시용)
+    char glob[MAX_NAME_LEN];       // glob으로 찾을 때의 패턴 (와일드카드가 없으면 *...*로 감쌈)
+    bool use_regex;
+    regex_t regex;
+    GrepPattern grep;              // 내용 찾기의 찾을 내용
+
+    pthread_mutex_t lock;          // 아래 결과와 내용 찾기 대기열 보호
+    SearchHit *hits;
+    int hit_count;
+    int hit_capacity;
+    bool finished;                 // 탐색이 끝남 (취소 포함)
+    bool truncated;                // SEARCH_MAX_RESULTS에서 멈춤
+    bool from_index;               // 탐색 없이 파일 이름 색인에서 찾음
+    long last_notify_ms;
+
+    // 내용 찾기 대기열과 워커
+    pthread_cond_t queue_ready;    // 파일이 들어옴 / 탐색이 끝남
+    pthread_cond_t queue_space;    // 대기열에 자리가 남
+    GrepJob *queue_head;
+    GrepJob *queue_tail;
+    int queue_length;
+    bool walk_done;                // 탐색기가 더 넣을 파일이 없음
+    bool stopping;                 // 취소 요청 (워커가 대기열을 버리고 끝냄)
+    pthread_t grep_threads[GREP_MAX_THREADS];
+    int grep_thread_count;
+    int grep_running;
+    long files_scanned;
+
+    int selection;                 // 결과 화면의 선택
+} SearchTask;
+
+// 환경 변수로 정한 탐색 제한 (FINDER_SEARCH_DEPTH: 최대 깊이, 기본 무제한
+// FINDER_SEARCH_XDEV=1: 다른 파일시스템으로도 내려감, 기본은 시작 디렉토리의 파일시스템만)
+void search_default_limits(int *max_depth, bool *one_filesystem);
+
+// 찾기 시작 (즉시 반환), 패턴이 잘못되었으면 false와 함께 error 설정
+// max_depth < 0이면 깊이 제한 없음, one_filesystem이면 마운트 지점을 넘지 않음 (다른 파일시스템까지 찾을 때는 색인을 쓰지 않음)
+bool search_start(SearchTask *task, const char *root, const char *pattern, int max_depth,
+                  bool one_filesystem, char *error, size_t error_size);
+
+// 내용 찾기 시작 (즉시 반환) - 일반 파일만 읽고 바이너리와 .git 디렉토리는 건너뜀
+// 찾을 내용은 그대로의 글자열이며 대문자가 없으면 대소문자를 무시함
+bool search_start_content(SearchTask *task, const char *root, const char *text, int max_depth,
+                          bool one_filesystem, char *error, size_t error_size);
+
+// 탐색 취소 (결과는 그대로 남음)
+void search_cancel(SearchTask *task);
+
+// 탐색을 멈추고 결과 해제 (active도 끔)
+void search_stop(SearchTask *task);
+
+// 읽은 디렉토리 수
+long search_dirs_scanned(SearchTask *task);
+
+// 내용 찾기에서 읽은 파일 수
+long search_files_scanned(SearchTask *task);
+
+// 찾은 항목의 절대 경로 (탐색 중이면 lock 안에서 호출)
+void search_hit_path(const SearchTask *task, const SearchHit *hit, char *out, size_t out_size);
+
+#endif
@@ -0,0 +1,536 @@
+// trash.c
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE // syscall, SYS_gettid
+#endif
+#include "trash.h"
+#include "fs.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <sys/stat.h>
+#include <sys/statvfs.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+
+// 휴지통 구조: <휴지통>/files/<이름> (내용), <휴지통>/info/<이름>.trashinfo (원래 경로, 삭제 시각)
+#define TRASH_PURGING_PREFIX ".purging-" // 정리 중인 항목 (중단되면 다음 정리 때 이어서 삭제)
+
+typedef struct {
+    char path[MAX_PATH_LEN];
+    dev_t dev;
+} TrashRoot;
+
+static TrashRoot g_trash_roots[TRASH_MAX_ROOTS];
+static int g_trash_root_count = 0;
+static char g_trash_undo[TRASH_UNDO_DEPTH][MAX_PATH_LEN]; // 최근에 옮긴 항목 (휴지통 안 경로)
+static int g_trash_undo_count = 0;
+static bool g_trash_enabled = false;
+static pthread_mutex_t g_trash_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+// 정리 스레드 상태
+static pthread_t g_purge_thread;
+static bool g_purge_started = false;
+static pthread_mutex_t g_purge_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t g_purge_cond = PTHREAD_COND_INITIALIZER;
+static bool g_purge_wake = false;
+static bool g_purge_stop = false;
+static time_t g_last_trash_at = 0; // 가장 최근 휴지통 이동이 시작된 시각 - 공간 부족 정리에서 이 시각 이후 항목은 제외
+static CopyTask g_purge_token; // 삭제 엔진에 넘겨 종료 시 취소하는 용도
+static long g_trash_days = TRASH_DEFAULT_DAYS;
+static long g_trash_min_free = TRASH_DEFAULT_MIN_FREE;
+
+static void* trash_purge_thread(void *arg);
+
+// 환경 변수 정수값 (없거나 잘못되면 기본값)
+static long env_long(const char *name, long default_value) {
+    const char *value = getenv(name);
+    if (!value || value[0] == '\0') return default_value;
+    char *end;
+    long result = strtol(value, &end, 10);
+    return (*end == '\0' && result >= 0) ? result : default_value;
+}
+
+// 경로를 디렉토리와 이름으로 분리
+static bool split_path(const char *path, char *dir, size_t dir_size, const char **name) {
+    const char *slash = strrchr(path, '/');
+    if (!slash || slash[1] == '\0') return false;
+
+    size_t len = (size_t)(slash - path);
+    if (len == 0) len = 1; // "/name"
+    if (len >= dir_size) return false;
+    memcpy(dir, path, len);
+    dir[len] = '\0';
+    *name = slash + 1;
+    return true;
+}
+
+// 휴지통 디렉토리 구조 생성 및 확인 (심볼릭 링크나 다른 장치는 거부)
+static bool prepare_trash_root(const char *root, dev_t dev) {
+    char sub[MAX_PATH_LEN];
+    const char *parts[] = { "", "/files", "/info" };
+
+    for (int i = 0; i < 3; i++) {
+        snprintf(sub, sizeof(sub), "%s%s", root, parts[i]);
+        if (mkdir(sub, 0700) != 0 && errno != EEXIST) {
+            return false;
+        }
+        struct stat st;
+        if (lstat(sub, &st) != 0 || !S_ISDIR(st.st_mode) || st.st_dev != dev) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// 휴지통 목록에 추가 (g_trash_mutex 안에서 호출)
+static const TrashRoot* register_trash_root(const char *root, dev_t dev) {
+    for (int i = 0; i < g_trash_root_count; i++) {
+        if (g_trash_roots[i].dev == dev) return &g_trash_roots[i];
+    }
+    if (g_trash_root_count >= TRASH_MAX_ROOTS) return NULL;
+
+    TrashRoot *entry = &g_trash_roots[g_trash_root_count++];
+    snprintf(entry->path, sizeof(entry->path), "%s", root);
+    entry->dev = dev;
+    return entry;
+}
+
+// 장치에 맞는 휴지통 찾기 (홈과 같은 장치면 ~/.trash, 아니면 마운트 지점의 .trash)
+static bool find_trash_root(const char *dir, dev_t dev, char *root, size_t size) {
+    pthread_mutex_lock(&g_trash_mutex);
+    for (int i = 0; i < g_trash_root_count; i++) {
+        if (g_trash_roots[i].dev == dev) {
+            snprintf(root, size, "%s", g_trash_roots[i].path);
+            pthread_mutex_unlock(&g_trash_mutex);
+            return true;
+        }
+    }
+    pthread_mutex_unlock(&g_trash_mutex);
+
+    char candidate[MAX_PATH_LEN];
+    struct stat st;
+    const char *home = getenv("HOME");
+    if (home && home[0] == '/' && stat(home, &st) == 0 && st.st_dev == dev) {
+        snprintf(candidate, sizeof(candidate), "%s/%s", home, TRASH_DIR_NAME);
+    } else {
+        // 같은 장치인 동안 상위로 올라가 마운트 지점 찾기
+        char mount_point[MAX_PATH_LEN];
+        if (!realpath(dir, mount_point)) return false;
+        while (strcmp(mount_point, "/") != 0) {
+            char parent[MAX_PATH_LEN];
+            const char *name;
+            if (!split_path(mount_point, parent, sizeof(parent), &name)) break;
+            if (stat(parent, &st) != 0 || st.st_dev != dev) break;
+            strcpy(mount_point, parent);
+        }
+        snprintf(candidate, sizeof(candidate), "%s%s%s", mount_point,
+                 strcmp(mount_point, "/") == 0 ? "" : "/", TRASH_DIR_NAME);
+    }
+
+    if (!prepare_trash_root(candidate, dev)) return false;
+
+    pthread_mutex_lock(&g_trash_mutex);
+    const TrashRoot *entry = register_trash_root(candidate, dev);
+    pthread_mutex_unlock(&g_trash_mutex);
+    if (!entry) return false;
+
+    snprintf(root, size, "%s", candidate);
+    return true;
+}
+
+// 정보 파일 쓰기
+static bool write_trash_info(const char *root, const char *name, const char *original_path) {
+    char info_path[MAX_PATH_LEN];
+    snprintf(info_path, sizeof(info_path), "%s/info/%s.trashinfo", root, name);
+
+    FILE *fp = fopen(info_path, "w");
+    if (!fp) return false;
+    fprintf(fp, "[Trash Info]\nPath=%s\nDeletionDate=%ld\n", original_path, (long)time(NULL));
+    return fclose(fp) == 0;
+}
+
+// 정보 파일 읽기
+static bool read_trash_info(const char *info_path, char *original_path, size_t size, time_t *deleted_at) {
+    FILE *fp = fopen(info_path, "r");
+    if (!fp) return false;
+
+    char line[MAX_PATH_LEN + 32];
+    bool has_path = false;
+    if (deleted_at) *deleted_at = 0;
+    while (fgets(line, sizeof(line), fp)) {
+        line[strcspn(line, "\n")] = '\0';
+        if (strncmp(line, "Path=", 5) == 0) {
+            if (original_path) snprintf(original_path, size, "%s", line + 5);
+            has_path = true;
+        } else if (strncmp(line, "DeletionDate=", 13) == 0 && deleted_at) {
+            *deleted_at = (time_t)strtol(line + 13, NULL, 10);
+        }
+    }
+    fclose(fp);
+    return has_path;
+}
+
+bool init_trash_system() {
+    g_trash_enabled = (env_long("FINDER_TRASH", 1) != 0);
+    g_trash_days = env_long("FINDER_TRASH_DAYS", TRASH_DEFAULT_DAYS);
+    g_trash_min_free = env_long("FINDER_TRASH_MIN_FREE", TRASH_DEFAULT_MIN_FREE);
+    if (!g_trash_enabled) return true;
+
+    // 이전 실행에서 쓰던 홈 휴지통은 바로 정리 대상으로
+    const char *home = getenv("HOME");
+    if (home && home[0] == '/') {
+        char root[MAX_PATH_LEN];
+        struct stat st;
+        snprintf(root, sizeof(root), "%s/%s", home, TRASH_DIR_NAME);
+        if (lstat(root, &st) == 0 && S_ISDIR(st.st_mode)) {
+            pthread_mutex_lock(&g_trash_mutex);
+            register_trash_root(root, st.st_dev);
+            pthread_mutex_unlock(&g_trash_mutex);
+        }
+    }
+
+    memset(&g_purge_token, 0, sizeof(g_purge_token));
+    pthread_mutex_init(&g_purge_token.progress_mutex, NULL);
+    g_purge_stop = false;
+    g_purge_started = (pthread_create(&g_purge_thread, NULL, trash_purge_thread, NULL) == 0);
+    return true;
+}
+
+void cleanup_trash_system() {
+    if (!g_purge_started) return;
+
+    pthread_mutex_lock(&g_purge_mutex);
+    g_purge_stop = true;
+    g_purge_token.cancel_requested = true; // 진행 중인 삭제도 중단
+    pthread_cond_signal(&g_purge_cond);
+    pthread_mutex_unlock(&g_purge_mutex);
+
+    pthread_join(g_purge_thread, NULL);
+    pthread_mutex_destroy(&g_purge_token.progress_mutex);
+    g_purge_started = false;
+}
+
+bool trash_enabled() {
+    return g_trash_enabled;
+}
+
+bool is_in_trash(const char *path) {
+    // 경로 구성 요소 중 하나라도 휴지통 이름이면 휴지통 안
+    size_t name_len = strlen(TRASH_DIR_NAME);
+    const char *p = path;
+    while ((p = strstr(p, TRASH_DIR_NAME)) != NULL) {
+        bool starts = (p == path || p[-1] == '/');
+        bool ends = (p[name_len] == '\0' || p[name_len] == '/');
+        if (starts && ends) return true;
+        p += name_len;
+    }
+    return false;
+}
+
+int trash_file(const char *path) {
+    if (!g_trash_enabled) return ENOTSUP;
+    if (is_in_trash(path)) return EINVAL; // 휴지통 안의 항목은 바로 삭제
+    time_t started_at = time(NULL); // 정보 파일의 DeletionDate는 이 시각 이후
+
+    char dir[MAX_PATH_LEN];
+    const char *name;
+    struct stat st;
+    if (!split_path(path, dir, sizeof(dir), &name) || lstat(path, &st) != 0) {
+        return ENOENT;
+    }
+
+    char root[MAX_PATH_LEN];
+    if (!find_trash_root(dir, st.st_dev, root, sizeof(root))) {
+        return EXDEV;
+    }
+
+    // rename 한 번으로 이동
+    char files_dir[MAX_PATH_LEN];
+    char trashed_name[MAX_NAME_LEN];
+    snprintf(files_dir, sizeof(files_dir), "%s/files", root);
+    int result = move_by_rename(path, files_dir, name, trashed_name, sizeof(trashed_name));
+    if (result != 0) {
+        return result;
+    }
+
+    char trashed_path[MAX_PATH_LEN];
+    snprintf(trashed_path, sizeof(trashed_path), "%s/%s", files_dir, trashed_name);
+
+    // 정보 파일이 없으면 복원도 정리도 할 수 없으므로 되돌림
+    if (!write_trash_info(root, trashed_name, path)) {
+        char restored_name[MAX_NAME_LEN];
+        move_by_rename(trashed_path, dir, name, restored_name, sizeof(restored_name));
+        return EIO;
+    }
+
+    pthread_mutex_lock(&g_trash_mutex);
+    if (g_trash_undo_count == TRASH_UNDO_DEPTH) {
+        memmove(g_trash_undo[0], g_trash_undo[1], sizeof(g_trash_undo[0]) * (TRASH_UNDO_DEPTH - 1));
+        g_trash_undo_count--;
+    }
+    strcpy(g_trash_undo[g_trash_undo_count++], trashed_path);
+    pthread_mutex_unlock(&g_trash_mutex);
+
+    // 방금 옮긴 항목이 공간 부족 정리에 걸려 바로 영구 삭제되지 않도록 시각 기록
+    pthread_mutex_lock(&g_purge_mutex);
+    if (started_at > g_last_trash_at) g_last_trash_at = started_at;
+    pthread_mutex_unlock(&g_purge_mutex);
+
+    // 공간을 확보하려는 삭제일 수 있으므로 정리 스레드가 여유 공간을 바로 확인하도록
+    trash_request_purge();
+    return 0;
+}
+
+bool trash_restore(const char *trashed_path, char *restored_path, size_t size) {
+    char files_dir[MAX_PATH_LEN];
+    char root[MAX_PATH_LEN];
+    const char *name;
+    const char *files_part;
+    if (!split_path(trashed_path, files_dir, sizeof(files_dir), &name) ||
+        !split_path(files_dir, root, sizeof(root), &files_part) ||
+        strcmp(files_part, "files") != 0 ||
+        strncmp(name, TRASH_PURGING_PREFIX, strlen(TRASH_PURGING_PREFIX)) == 0) {
+        return false;
+    }
+
+    char info_path[MAX_PATH_LEN];
+    char original_path[MAX_PATH_LEN];
+    char original_dir[MAX_PATH_LEN];
+    const char *original_name;
+    snprintf(info_path, sizeof(info_path), "%s/info/%s.trashinfo", root, name);
+
+    // 정리 스레드가 같은 항목을 가져가지 않도록 정보 파일 확인부터 이동까지 한 번에
+    pthread_mutex_lock(&g_purge_mutex);
+    bool ok = read_trash_info(info_path, original_path, sizeof(original_path), NULL) &&
+              split_path(original_path, original_dir, sizeof(original_dir), &original_name);
+    char restored_name[MAX_NAME_LEN];
+    if (ok) {
+        ok = (move_by_rename(trashed_path, original_dir, original_name,
+                             restored_name, sizeof(restored_name)) == 0);
+    }
+    if (ok) {
+        unlink(info_path);
+    }
+    pthread_mutex_unlock(&g_purge_mutex);
+
+    if (!ok) return false;
+
+    if (restored_path) {
+        snprintf(restored_path, size, "%s/%s", strcmp(original_dir, "/") == 0 ? "" : original_dir, restored_name);
+    }
+
+    // 되돌리기 목록에서 제거
+    pthread_mutex_lock(&g_trash_mutex);
+    for (int i = 0; i < g_trash_undo_count; i++) {
+        if (strcmp(g_trash_undo[i], trashed_path) == 0) {
+            memmove(g_trash_undo[i], g_trash_undo[i + 1], sizeof(g_trash_undo[0]) * (g_trash_undo_count - i - 1));
+            g_trash_undo_count--;
+            break;
+        }
+    }
+    pthread_mutex_unlock(&g_trash_mutex);
+    return true;
+}
+
+bool trash_restore_last(char *restored_path, size_t size) {
+    while (1) {
+        char trashed_path[MAX_PATH_LEN];
+        pthread_mutex_lock(&g_trash_mutex);
+        if (g_trash_undo_count == 0) {
+            pthread_mutex_unlock(&g_trash_mutex);
+            return false;
+        }
+        strcpy(trashed_path, g_trash_undo[--g_trash_undo_count]);
+        pthread_mutex_unlock(&g_trash_mutex);
+
+        // 이미 정리된 항목은 건너뛰고 그 이전 항목 시도
+        if (trash_restore(trashed_path, restored_path, size)) {
+            return true;
+        }
+    }
+}
+
+void trash_request_purge() {
+    pthread_mutex_lock(&g_purge_mutex);
+    g_purge_wake = true;
+    pthread_cond_signal(&g_purge_cond);
+    pthread_mutex_unlock(&g_purge_mutex);
+}
+
+// ---------------- 백그라운드 정리 ----------------
+
+typedef struct {
+    char name[MAX_NAME_LEN];
+    time_t deleted_at;
+} TrashItem;
+
+static int compare_trash_items(const void *a, const void *b) {
+    const TrashItem *ta = (const TrashItem*)a;
+    const TrashItem *tb = (const TrashItem*)b;
+    if (ta->deleted_at < tb->deleted_at) return -1;
+    if (ta->deleted_at > tb->deleted_at) return 1;
+    return strcmp(ta->name, tb->name);
+}
+
+// 여유 공간 비율(%)
+static long free_percent(const char *path) {
+    struct statvfs vfs;
+    if (statvfs(path, &vfs) != 0 || vfs.f_blocks == 0) return 100;
+    return (long)((unsigned long long)vfs.f_bavail * 100 / vfs.f_blocks);
+}
+
+static bool purge_should_stop() {
+    pthread_mutex_lock(&g_purge_mutex);
+    bool stop = g_purge_stop;
+    pthread_mutex_unlock(&g_purge_mutex);
+    return stop;
+}
+
+// 휴지통 안의 경로 하나 영구 삭제
+static void purge_path(const char *path) {
+    struct stat st;
+    if (lstat(path, &st) != 0) return;
+    if (S_ISDIR(st.st_mode)) {
+        delete_directory_recursive_with_progress(path, &g_purge_token);
+    } else {
+        unlink(path);
+    }
+}
+
+// 항목 하나 정리 - 정보 파일을 지우고 내용을 숨김 이름으로 바꾼 뒤 (이후로는 복원 불가) 삭제
+static void purge_item(const char *root, const char *name) {
+    char info_path[MAX_PATH_LEN];
+    char item_path[MAX_PATH_LEN];
+    char purging_path[MAX_PATH_LEN];
+    snprintf(info_path, sizeof(info_path), "%s/info/%s.trashinfo", root, name);
+    snprintf(item_path, sizeof(item_path), "%s/files/%s", root, name);
+    snprintf(purging_path, sizeof(purging_path), "%s/files/%s%s", root, TRASH_PURGING_PREFIX, name);
+
+    pthread_mutex_lock(&g_purge_mutex);
+    bool claimed = (unlink(info_path) == 0);
+    if (claimed && rename(item_path, purging_path) != 0) {
+        claimed = false;
+    }
+    pthread_mutex_unlock(&g_purge_mutex);
+
+    if (claimed) {
+        purge_path(purging_path);
+    }
+}
+
+// 휴지통 하나 정리 (보관 기간이 지난 항목, 공간이 부족하면 오래된 항목부터)
+static void purge_trash_root(const char *root) {
+    char dir_path[MAX_PATH_LEN];
+
+    // 지난번에 중단된 정리부터 마무리
+    snprintf(dir_path, sizeof(dir_path), "%s/files", root);
+    DIR *dir = opendir(dir_path);
+    if (dir) {
+        struct dirent *entry;
+        while ((entry = readdir(dir)) != NULL && !purge_should_stop()) {
+            if (strncmp(entry->d_name, TRASH_PURGING_PREFIX, strlen(TRASH_PURGING_PREFIX)) == 0) {
+                char path[MAX_PATH_LEN];
+                snprintf(path, sizeof(path), "%s/%s", dir_path, entry->d_name);
+                purge_path(path);
+            }
+        }
+        closedir(dir);
+    }
+
+    // 정보 파일 목록 수집
+    snprintf(dir_path, sizeof(dir_path), "%s/info", root);
+    dir = opendir(dir_path);
+    if (!dir) return;
+
+    int capacity = 64;
+    int count = 0;
+    TrashItem *items = malloc(sizeof(TrashItem) * capacity);
+    struct dirent *entry;
+    const char *suffix = ".trashinfo";
+    size_t suffix_len = strlen(suffix);
+    while (items && (entry = readdir(dir)) != NULL) {
+        size_t len = strlen(entry->d_name);
+        if (len <= suffix_len || strcmp(entry->d_name + len - suffix_len, suffix) != 0) continue;
+        if (len - suffix_len >= MAX_NAME_LEN) continue;
+
+        if (count == capacity) {
+            TrashItem *grown = realloc(items, sizeof(TrashItem) * capacity * 2);
+            if (!grown) break;
+            items = grown;
+            capacity *= 2;
+        }
+
+        char info_path[MAX_PATH_LEN];
+        snprintf(info_path, sizeof(info_path), "%s/%s", dir_path, entry->d_name);
+        TrashItem *item = &items[count];
+        memcpy(item->name, entry->d_name, len - suffix_len);
+        item->name[len - suffix_len] = '\0';
+        if (read_trash_info(info_path, NULL, 0, &item->deleted_at)) {
+            count++;
+        }
+    }
+    closedir(dir);
+    if (!items) return;
+
+    qsort(items, count, sizeof(TrashItem), compare_trash_items);
+
+    // 공간 부족 정리는 이번 정리를 부른 이동보다 먼저 옮긴 항목만 대상
+    // (그러지 않으면 디스크가 거의 찼을 때 d가 곧바로 D가 됨)
+    pthread_mutex_lock(&g_purge_mutex);
+    time_t protect_from = g_last_trash_at;
+    pthread_mutex_unlock(&g_purge_mutex);
+
+    time_t cutoff = time(NULL) - (time_t)g_trash_days * 24 * 60 * 60;
+    for (int i = 0; i < count && !purge_should_stop(); i++) {
+        bool expired = (items[i].deleted_at <= cutoff);
+        bool low_space = (protect_from == 0 || items[i].deleted_at < protect_from) &&
+                         free_percent(root) < g_trash_min_free;
+        if (!expired && !low_space) break; // 오래된 순이므로 이후 항목도 해당 없음
+        purge_item(root, items[i].name);
+    }
+
+    free(items);
+}
+
+// 정리 스레드 - 낮은 CPU/IO 우선순위로 주기적으로 휴지통 정리
+static void* trash_purge_thread(void *arg) {
+    (void)arg;
+    pid_t tid = (pid_t)syscall(SYS_gettid);
+    setpriority(PRIO_PROCESS, tid, 19);
+#ifdef SYS_ioprio_set
+    syscall(SYS_ioprio_set, 1 /* IOPRIO_WHO_PROCESS */, tid, 3 << 13 /* IOPRIO_CLASS_IDLE */);
+#endif
+
+    while (!purge_should_stop()) {
+        // 등록된 휴지통 목록 복사 후 정리
+        TrashRoot roots[TRASH_MAX_ROOTS];
+        pthread_mutex_lock(&g_trash_mutex);
+        int count = g_trash_root_count;
+        memcpy(roots, g_trash_roots, sizeof(TrashRoot) * count);
+        pthread_mutex_unlock(&g_trash_mutex);
+
+        for (int i = 0; i < count && !purge_should_stop(); i++) {
+            purge_trash_root(roots[i].path);
+        }
+
+        // 다음 주기 또는 요청까지 대기
+        struct timespec deadline;
+        clock_gettime(CLOCK_REALTIME, &deadline);
+        deadline.tv_sec += TRASH_PURGE_INTERVAL;
+
+        pthread_mutex_lock(&g_purge_mutex);
+        while (!g_purge_wake && !g_purge_stop) {
+            if (pthread_cond_timedwait(&g_purge_cond, &g_purge_mutex, &deadline) == ETIMEDOUT) break;
+        }
+        g_purge_wake = false;
+        pthread_mutex_unlock(&g_purge_mutex);
+    }
+
+    return NULL;
+}
@@ -0,0 +1,41 @@
+// trash.h
+#ifndef TRASH_H
+#define TRASH_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#define TRASH_DIR_NAME ".trash"
+#define TRASH_MAX_ROOTS 16           // 기억하는 휴지통 수 (파일시스템마다 하나)
+#define TRASH_UNDO_DEPTH 64          // 되돌리기(z)로 복원할 수 있는 최근 항목 수
+#define TRASH_PURGE_INTERVAL 300     // 정리 주기 (초)
+#define TRASH_DEFAULT_DAYS 7         // 기본 보관 기간 (FINDER_TRASH_DAYS로 변경)
+#define TRASH_DEFAULT_MIN_FREE 10    // 여유 공간이 이 비율(%) 아래면 오래된 항목부터 정리 (FINDER_TRASH_MIN_FREE)
+
+// 휴지통 시스템 초기화 (백그라운드 정리 스레드 시작)
+// FINDER_TRASH=0이면 휴지통을 쓰지 않고 바로 삭제
+bool init_trash_system();
+
+// 휴지통 시스템 정리 (정리 스레드 종료 대기)
+void cleanup_trash_system();
+
+// 휴지통 사용 여부
+bool trash_enabled();
+
+// 같은 파일시스템의 휴지통으로 rename 한 번에 이동 (성공 시 0, 실패 시 errno)
+// 휴지통을 만들 수 없거나 다른 장치면 실패하며, 이때는 호출 측에서 바로 삭제
+int trash_file(const char *path);
+
+// 경로가 휴지통 안(휴지통 자신 포함)인지 확인
+bool is_in_trash(const char *path);
+
+// 휴지통 안의 항목을 원래 위치로 복원 (원래 이름이 있으면 고유한 이름 사용)
+bool trash_restore(const char *trashed_path, char *restored_path, size_t size);
+
+// 이번 실행에서 가장 최근에 휴지통으로 옮긴 항목 복원
+bool trash_restore_last(char *restored_path, size_t size);
+
+// 정리 스레드를 바로 깨움 (공간 확인)
+void trash_request_purge();
+
+#endif
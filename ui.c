@@ -1,14 +1,91 @@
 #include "ui.h"      // ui.h에 선언된 함수들을 구현하기 위해 포함
+#include "event.h"   // event_now_ms (처리 속도 표본 시각)
+#include "filter.h"  // 퍼지 찾기 결과와 맞은 글자 위치
+#include "preview.h" // 미리보기 칸에 보이는 줄
+#include "search.h"  // 하위 디렉토리 찾기 결과
+#include "usage.h"   // 디스크 사용량 트리
+#include "dupes.h"   // 중복 파일 묶음
 #include <string.h>  // strlen, snprintf 등 문자열 처리 함수 사용
 #include <stdlib.h>  // abs, exit 등 표준 라이브러리 함수 사용
 #include <ncurses.h> // ncurses 함수를 사용하기 위해 필요
 #include <stdio.h>   // fprintf, stderr 사용
+#include <wchar.h>   // mbrlen (퍼지 찾기 강조를 글자 단위로)
 
 // 주 내용(파일 목록) 표시용 윈도우와 푸터용 윈도우들을 위한 포인터
 WINDOW *main_win = NULL;
 WINDOW *footer_win_path = NULL;
 WINDOW *footer_win_stats = NULL;
 
+// 진행률 패널 (한 번 만들어 두고 작업이 있는 동안만 목록 아래에 예약)
+static WINDOW *progress_win = NULL;
+static bool progress_visible = false;
+
+// 행 단위 렌더 캐시 - 각 행에 마지막으로 그린 내용과 속성을 기억해 바뀐 행만 다시 그림
+typedef struct {
+    bool valid;
+    attr_t attr;
+    char name[MAX_NAME_LEN];
+    char type[32];
+    char mtime[24];
+    char size[16];
+} RowCache;
+
+// 목록 칸 - 분할 화면이면 왼쪽(0)/오른쪽(1), 아니면 0번이 전체 너비를 씀
+typedef struct {
+    RowCache *rows;
+    int cached_rows;             // 캐시가 기억하는 행 수 (0이면 전체 다시 그림)
+    int cached_x;                // 마지막으로 그린 시작 열과 너비
+    int cached_cols;
+    char header[MAX_PATH_LEN];   // 분할 화면 머리줄에 마지막으로 그린 경로
+    bool header_focused;
+} ListPane;
+
+static ListPane list_panes[2];
+static bool split_mode = false;
+static char preview_drawn[MAX_PATH_LEN + 96]; // 미리보기 칸에 마지막으로 그린 상태 (같으면 다시 그리지 않음)
+
+// 목록 영역 전체를 다음 프레임에 다시 그림 (대시보드 등이 목록 영역을 덮은 뒤)
+static void invalidate_list_area() {
+    list_panes[0].cached_rows = 0;
+    list_panes[1].cached_rows = 0;
+    preview_drawn[0] = '\0';
+}
+static char footer_path_cache[MAX_PATH_LEN + 8];
+static char footer_stats_cache[512];
+
+// 진행률 패널에 마지막으로 그린 내용 (같으면 다시 그리지 않음)
+static char progress_line_cache[3][256];
+static int progress_fill_cache = -1;
+
+// 대화상자와 알림 레이어 - 메인 루프가 매 프레임 다른 윈도우 위에 그리고 키를 넘겨 줌
+typedef enum {
+    MODAL_KIND_NONE = 0,
+    MODAL_KIND_CONFIRM,  // 확인/취소
+    MODAL_KIND_PROMPT    // 한 줄 입력
+} ModalKind;
+
+static ModalKind modal_kind = MODAL_KIND_NONE;
+static char modal_message[MAX_PATH_LEN + 64];
+static char modal_input[MAX_PATH_LEN];
+static size_t modal_input_len = 0;
+static bool modal_dirty = false;      // 대화상자 내용을 다시 그려야 함
+static WINDOW *modal_win = NULL;
+
+static char toast_message[MAX_PATH_LEN + 64];
+static bool toast_is_error = false;
+static long toast_expire_ms = 0;      // 알림이 사라질 시각 (0이면 표시 중인 알림 없음)
+static WINDOW *toast_win = NULL;
+static bool overlay_closed = false;   // 닫힌 레이어가 덮었던 영역을 다음 프레임에 복원
+
+// 렌더 캐시 무효화 (다음 프레임에 전체 다시 그림)
+static void invalidate_render_cache() {
+    invalidate_list_area();
+    progress_line_cache[0][0] = '\0';
+    progress_fill_cache = -1;
+    footer_path_cache[0] = '\0';
+    footer_stats_cache[0] = '\0';
+}
+
 void init_ui() {
 	putenv("NCURSES_NO_UTF8_ACS=1");
     initscr();              // ncurses 모드 시작
@@ -30,6 +107,7 @@ void init_ui() {
             // 복사 중 상태를 위한 색상 정의
             init_pair(COLOR_PAIR_COPYING, COLOR_BLUE, COLOR_BLACK);      // 복사 중: 파란색 글씨, 검은색 배경
             init_pair(COLOR_PAIR_COPYING_SELECTED, COLOR_WHITE, COLOR_BLUE); // 복사 중 선택된 상태: 흰색 글씨, 파란색 배경
+            init_pair(COLOR_PAIR_MARKED, COLOR_YELLOW, COLOR_BLACK);     // 표시됨: 노란색 글씨, 검은색 배경
         }
     }
 
@@ -48,8 +126,11 @@ void init_ui() {
     footer_win_path = newwin(FOOTER_HEIGHT_PATH, screen_cols, screen_rows - FOOTER_TOTAL_HEIGHT, 0);
     // 통계 푸터는 경로 푸터 바로 아래에 시작
     footer_win_stats = newwin(FOOTER_HEIGHT_STATS, screen_cols, screen_rows - FOOTER_TOTAL_HEIGHT + FOOTER_HEIGHT_PATH, 0);
+    // 진행률 패널은 미리 만들어 두고 작업이 있을 때만 보임 (목록 영역 아래, 푸터 바로 위)
+    progress_win = newwin(PROGRESS_PANEL_HEIGHT, screen_cols, screen_rows - FOOTER_TOTAL_HEIGHT - PROGRESS_PANEL_HEIGHT, 0);
+    progress_visible = false;
 
-    if (!footer_win_path || !footer_win_stats) { // 윈도우 생성 실패 시
+    if (!footer_win_path || !footer_win_stats || !progress_win) { // 윈도우 생성 실패 시
         endwin();
         fprintf(stderr, "Error creating footer windows.\n");
         exit(1);
@@ -60,10 +141,14 @@ void init_ui() {
     wbkgd(main_win, COLOR_PAIR(COLOR_PAIR_REGULAR));
     wbkgd(footer_win_path, COLOR_PAIR(COLOR_PAIR_FOOTER));
     wbkgd(footer_win_stats, COLOR_PAIR(COLOR_PAIR_FOOTER));
+    wbkgd(progress_win, COLOR_PAIR(COLOR_PAIR_REGULAR));
 
     // 메인 윈도우에서 키 입력 받을 경우 필요
     keypad(main_win, TRUE);
 
+    // (편집기/실행 후 다시 초기화되는 경우) 이전 화면 기준의 렌더 캐시 폐기
+    invalidate_render_cache();
+
     refresh_screen(); // 초기 화면 반영
 	refresh();        // stdscr 갱신
     wrefresh(main_win);     // 메인 윈도우 갱신
@@ -75,6 +160,11 @@ void close_ui() {
     if (main_win) delwin(main_win);             // 메인 윈도우 삭제
     if (footer_win_path) delwin(footer_win_path); // 경로 푸터 윈도우 삭제
     if (footer_win_stats) delwin(footer_win_stats); // 통계 푸터 윈도우 삭제
+    if (progress_win) delwin(progress_win);     // 진행률 패널 삭제
+    if (modal_win) delwin(modal_win);
+    if (toast_win) delwin(toast_win);
+    modal_win = toast_win = NULL;
+    main_win = footer_win_path = footer_win_stats = progress_win = NULL;
     endwin();                                   // ncurses 모드 종료
 }
 
@@ -85,13 +175,73 @@ void clear_main_content_area() {
     }
 }
 
-void display_files(FileEntry files[], int num_files, int current_selection, int scroll_offset) {
-    if (!main_win) return; // 메인 윈도우가 없으면 함수 종료
+// 대화상자/알림이 덮었던 영역을 stdscr을 거치지 않고 원래 윈도우 내용으로 복원
+// (화면 반영은 프레임 끝의 refresh_screen에서)
+static void restore_windows() {
+    if (main_win) {
+        touchwin(main_win);
+        wnoutrefresh(main_win);
+    }
+    if (footer_win_path) {
+        touchwin(footer_win_path);
+        wnoutrefresh(footer_win_path);
+    }
+    if (footer_win_stats) {
+        touchwin(footer_win_stats);
+        wnoutrefresh(footer_win_stats);
+    }
+    if (progress_win && progress_visible) {
+        touchwin(progress_win);
+        wnoutrefresh(progress_win);
+    }
+}
 
-    clear_main_content_area(); // 이전 내용 지우기
+// 이름 칸 너비에 맞춘 자르기 위치 (칸 너비가 바뀐 경우에만 다시 계산)
+// 잘리는 이름은 마지막 한 칸에 '~'를 붙임
+static void fit_name(FileEntry *file, int cols) {
+    if (file->name_fit_cols == cols) return;
+    file->name_fit_cols = cols;
+    if (file->name_width <= cols) {
+        file->name_fit_bytes = strlen(file->name);
+    } else {
+        display_width(file->name, cols > 0 ? cols - 1 : 0, &file->name_fit_bytes);
+    }
+}
 
-    int max_y, max_x;
-    getmaxyx(main_win, max_y, max_x); // 메인 윈도우의 크기 가져오기
+// 행 하나 그리기 (행 전체를 속성의 배경색으로 채운 뒤 컬럼 출력)
+// 칸은 바이트가 아니라 표시 폭 기준이며, 미리 계산한 자르기 위치까지만 출력 (ncursesw가 UTF-8을 그대로 처리)
+// 수정일 칸 너비가 0이면 (좁은 분할 화면) 수정일을 건너뜀
+static void draw_file_row(int row, FileEntry *file, attr_t attr, int x, int width,
+                          int col2, int col3, int col4,
+                          int name_col_width, int type_col_width, int mtime_col_width) {
+    wattrset(main_win, attr);
+    mvwhline(main_win, row, x, ' ', width);
+
+    fit_name(file, name_col_width);
+    mvwaddnstr(main_win, row, x, file->name, file->name_fit_bytes);
+    if (file->name_width > name_col_width) {
+        waddch(main_win, '~');
+    }
+
+    if (file->type_width <= type_col_width) {
+        mvwaddstr(main_win, row, col2, file->type);
+    } else {
+        int type_bytes;
+        display_width(file->type, type_col_width, &type_bytes);
+        mvwaddnstr(main_win, row, col2, file->type, type_bytes);
+    }
+    if (mtime_col_width > 0) {
+        mvwaddnstr(main_win, row, col3, file->mtime, mtime_col_width);
+    }
+    mvwaddnstr(main_win, row, col4, file->size, x + width - col4);
+    wattrset(main_win, A_NORMAL);
+}
+
+// 목록 칸 하나 그리기 (x부터 width 열, 바뀐 행만 다시 그림)
+// 분할 화면에서는 첫 줄에 칸의 경로를 보여 주고 (활성 칸은 강조), 아니면 컬럼 제목
+static void draw_list_pane(ListPane *pane, int x, int width, FileEntry files[], int num_files,
+                           int current_selection, int scroll_offset, const char *path, bool focused) {
+    int max_y = getmaxy(main_win);
 
     // 메인 윈도우의 첫 번째 줄은 헤더로 사용될 수 있습니다.
     // 실제 파일 목록을 그릴 영역의 높이는 max_y - 1 입니다.
@@ -99,128 +249,311 @@ void display_files(FileEntry files[], int num_files, int current_selection, int
 
     // 각 컬럼의 너비 정의 (대략적인 값, 동적으로 조절 가능)
     // 컬럼 간 최소 1칸의 공백 또는 구분자가 필요
-    int name_col_width = max_x / 2;
-    int type_col_width = max_x / 5;
-    int mtime_col_width = max_x / 5;
+    // 수정일까지 넣기에 좁은 칸(분할 화면)은 수정일을 빼고 이름을 넓힘
+    bool show_mtime = (width >= 100);
+    int name_col_width = show_mtime ? width / 2 : width * 3 / 5;
+    int type_col_width = width / 5;
+    int mtime_col_width = show_mtime ? width / 5 : 0;
     // 나머지 공간을 크기 컬럼에 할당 (헤더, 타입, 수정일 컬럼 너비 및 구분자/패딩 공간 고려)
-    int size_col_width = max_x - name_col_width - type_col_width - mtime_col_width;
+    int size_col_width = width - name_col_width - type_col_width - mtime_col_width;
 
     // 각 컬럼 너비가 최소값 이상인지 확인 (화면이 매우 작을 때 크래시 방지)
-    if (name_col_width < 10 || type_col_width < 10 || mtime_col_width < 10 || size_col_width < 10) {
+    if (name_col_width < 10 || type_col_width < 10 || (show_mtime && mtime_col_width < 10) || size_col_width < 10) {
          // 화면이 너무 작아 컬럼을 표시할 수 없음, 오류 처리 또는 최소 레이아웃 표시 고려
-         mvwprintw(main_win, 0, 0, "Terminal too small");
-         wrefresh(main_win);
+         for (int row = 0; row < max_y; row++) {
+             mvwhline(main_win, row, x, ' ', width);
+         }
+         mvwaddnstr(main_win, 0, x, "Terminal too small", width);
+         wnoutrefresh(main_win);
+         pane->cached_rows = 0;
          return;
     }
 
     // 컬럼 너비 조정 - 구분자 공간 확보 (예: 각 컬럼 뒤에 1칸 공백)
     name_col_width -= 1;
     type_col_width -= 1;
-    mtime_col_width -= 1;
+    if (show_mtime) mtime_col_width -= 1;
     // size_col_width는 남은 공간을 모두 사용
 
 	// 각 컬럼의 시작 위치 계산
-	int col1 = 0;
-	int col2 = name_col_width + 1;
+	int col1 = x;
+	int col2 = col1 + name_col_width + 1;
 	int col3 = col2 + type_col_width + 1;
-	int col4 = col3 + mtime_col_width + 1;
-	
-	// 헤더 출력
-	wattron(main_win, A_BOLD | COLOR_PAIR(COLOR_PAIR_REGULAR));
-	mvwprintw(main_win, 0, col1, "%-*s", name_col_width, "Name");
-	mvwprintw(main_win, 0, col2, "%-*s", type_col_width, "Type");
-	mvwprintw(main_win, 0, col3, "%-*s", mtime_col_width, "Modified");
-	mvwprintw(main_win, 0, col4, "Size");
-	wattroff(main_win, A_BOLD | COLOR_PAIR(COLOR_PAIR_REGULAR));
-
-	// 화면에 표시될 수 있는 파일들만 루프
-	for (int i = 0; i < window_height && (i + scroll_offset) < num_files; ++i) {
-		int file_index = i + scroll_offset;
-		if (file_index >= num_files) break;
+	int col4 = show_mtime ? col3 + mtime_col_width + 1 : col3;
+
+    // 화면 크기나 칸 위치가 바뀌었거나 캐시가 무효화되었으면 전체 다시 그림
+    if (pane->cached_rows != window_height || pane->cached_cols != width || pane->cached_x != x) {
+        RowCache *resized = realloc(pane->rows, sizeof(RowCache) * (window_height > 0 ? window_height : 1));
+        if (!resized) return;
+        pane->rows = resized;
+        memset(pane->rows, 0, sizeof(RowCache) * (window_height > 0 ? window_height : 1));
+        pane->cached_rows = window_height;
+        pane->cached_cols = width;
+        pane->cached_x = x;
+        pane->header[0] = '\0';
+
+        if (split_mode) {
+            wattrset(main_win, A_NORMAL);
+            for (int row = 0; row < max_y; row++) {
+                mvwhline(main_win, row, x, ' ', width);
+            }
+        } else {
+            clear_main_content_area();
+
+            // 헤더 출력
+            wattron(main_win, A_BOLD | COLOR_PAIR(COLOR_PAIR_REGULAR));
+            mvwprintw(main_win, 0, col1, "%-*s", name_col_width, "Name");
+            mvwprintw(main_win, 0, col2, "%-*s", type_col_width, "Type");
+            if (show_mtime) mvwprintw(main_win, 0, col3, "%-*s", mtime_col_width, "Modified");
+            mvwprintw(main_win, 0, col4, "Size");
+            wattroff(main_win, A_BOLD | COLOR_PAIR(COLOR_PAIR_REGULAR));
+        }
+    }
 
+    // 분할 화면 머리줄 - 경로가 길면 뒤쪽(현재 디렉토리 이름 쪽)을 남김
+    if (split_mode && path && (strcmp(pane->header, path) != 0 || pane->header_focused != focused)) {
+        const char *shown = path;
+        int shown_width = display_width(shown, width, NULL);
+        while (shown_width > width - 1 && *shown) {
+            shown++;
+            while ((*shown & 0xC0) == 0x80) shown++; // UTF-8 글자 중간에서 자르지 않음
+            shown_width = display_width(shown, width, NULL);
+        }
+        attr_t attr = focused ? (COLOR_PAIR(COLOR_PAIR_HIGHLIGHT) | A_BOLD) : (COLOR_PAIR(COLOR_PAIR_FOOTER) | A_BOLD);
+        wattrset(main_win, attr);
+        mvwhline(main_win, 0, x, ' ', width);
+        if (shown != path) mvwaddch(main_win, 0, x, '<');
+        int shown_bytes;
+        display_width(shown, width - 1, &shown_bytes);
+        mvwaddnstr(main_win, 0, x + (shown != path ? 1 : 0), shown, shown_bytes);
+        wattrset(main_win, A_NORMAL);
+        snprintf(pane->header, sizeof(pane->header), "%s", path);
+        pane->header_focused = focused;
+    }
+
+	// 화면에 표시될 수 있는 행마다 내용이 바뀐 경우에만 다시 그림
+	for (int i = 0; i < window_height; ++i) {
+		int file_index = i + scroll_offset;
 		int display_row = i + 1; // 헤더 다음 줄부터 파일 정보 표시
-		if (display_row >= max_y) break;
+		RowCache *cache = &pane->rows[i];
 
-		// 복사 상태에 따른 색상 결정
-		int color_pair;
-		bool is_copying = (files[file_index].copy_status == COPY_STATUS_IN_PROGRESS);
-		bool is_selected = (file_index == current_selection);
-		
-		if (is_selected) {
-			// 선택된 항목
-			if (is_copying) {
-				color_pair = COLOR_PAIR_COPYING_SELECTED; // 복사 중이면서 선택된 상태 (흰색 글씨, 파란색 배경)
-			} else {
-				color_pair = COLOR_PAIR_HIGHLIGHT; // 일반 선택 상태 (검은색 글씨, 시안색 배경)
-			}
-			
-			// 먼저 전체 행에 색상 배경 적용
-			wattron(main_win, COLOR_PAIR(color_pair));
-			// 행 전체를 공백으로 채워 배경색 적용
-			for (int x = 0; x < max_x; x++) {
-				mvwaddch(main_win, display_row, x, ' ');
+		// 파일이 없는 행은 이전에 무언가 그렸을 때만 지움
+		if (file_index >= num_files) {
+			if (cache->valid) {
+				wattrset(main_win, A_NORMAL);
+				mvwhline(main_win, display_row, x, ' ', width);
+				cache->valid = false;
 			}
+			continue;
+		}
+
+		// 복사 상태와 선택/표시 여부에 따른 속성 결정
+		// 분할 화면의 비활성 칸은 선택 항목을 밑줄로만 표시
+		FileEntry *file = &files[file_index];
+		bool is_copying = (file->copy_status == COPY_STATUS_IN_PROGRESS);
+		bool is_selected = (file_index == current_selection) && focused;
+		bool is_marked = file->is_marked;
+		attr_t attr;
 
-			// 이제 텍스트 출력
-			mvwprintw(main_win, display_row, col1, "%-*s", name_col_width, files[file_index].name);
-			mvwprintw(main_win, display_row, col2, "%-*s", type_col_width, files[file_index].type);
-			mvwprintw(main_win, display_row, col3, "%-*s", mtime_col_width, files[file_index].mtime);
-			mvwprintw(main_win, display_row, col4, "%s", files[file_index].size);
-			wattroff(main_win, COLOR_PAIR(color_pair));
+		if (is_selected) {
+			// 선택된 항목: 복사 중이면 흰색 글씨/파란색 배경, 아니면 검은색 글씨/시안색 배경 (표시된 항목은 굵게)
+			attr = COLOR_PAIR(is_copying ? COLOR_PAIR_COPYING_SELECTED : COLOR_PAIR_HIGHLIGHT);
+			if (is_marked) attr |= A_BOLD;
+		} else if (is_copying) {
+			attr = COLOR_PAIR(COLOR_PAIR_COPYING); // 복사 중 (파란색 글씨, 검은색 배경)
+		} else if (is_marked) {
+			attr = COLOR_PAIR(COLOR_PAIR_MARKED); // 표시됨 (노란색 글씨, 검은색 배경)
 		} else {
-			// 선택되지 않은 항목
-			if (is_copying) {
-				color_pair = COLOR_PAIR_COPYING; // 복사 중 (파란색 글씨, 검은색 배경)
-			} else {
-				color_pair = COLOR_PAIR_REGULAR; // 일반 상태 (흰색 글씨, 검은색 배경)
-			}
-			
-			wattron(main_win, COLOR_PAIR(color_pair));
-			mvwprintw(main_win, display_row, col1, "%-*s", name_col_width, files[file_index].name);
-			mvwprintw(main_win, display_row, col2, "%-*s", type_col_width, files[file_index].type);
-			mvwprintw(main_win, display_row, col3, "%-*s", mtime_col_width, files[file_index].mtime);
-			mvwprintw(main_win, display_row, col4, "%s", files[file_index].size);
-			wattroff(main_win, COLOR_PAIR(color_pair));
+			attr = COLOR_PAIR(COLOR_PAIR_REGULAR); // 일반 상태 (흰색 글씨, 검은색 배경)
+		}
+		if (!focused && file_index == current_selection) {
+			attr |= A_UNDERLINE;
 		}
+
+		if (cache->valid && cache->attr == attr &&
+		    strcmp(cache->name, file->name) == 0 && strcmp(cache->type, file->type) == 0 &&
+		    strcmp(cache->mtime, file->mtime) == 0 && strcmp(cache->size, file->size) == 0) {
+			continue;
+		}
+
+		draw_file_row(display_row, file, attr, x, width, col2, col3, col4,
+		              name_col_width, type_col_width, mtime_col_width);
+
+		cache->valid = true;
+		cache->attr = attr;
+		strcpy(cache->name, file->name);
+		strcpy(cache->type, file->type);
+		strcpy(cache->mtime, file->mtime);
+		strcpy(cache->size, file->size);
 	}
 
-    wrefresh(main_win); // 메인 윈도우 변경 사항 화면에 반영
+    wnoutrefresh(main_win); // 변경 사항은 프레임 끝의 refresh_screen()에서 한 번에 반영
 }
 
-void display_footer(const char* current_path, int num_items_in_dir, const char* disk_free_space) {
-    if (!footer_win_path || !footer_win_stats) return; // 푸터 윈도우가 없으면 함수 종료
+void display_files(FileEntry files[], int num_files, int current_selection, int scroll_offset) {
+    if (!main_win) return; // 메인 윈도우가 없으면 함수 종료
+    draw_list_pane(&list_panes[0], 0, getmaxx(main_win), files, num_files, current_selection, scroll_offset,
+                   NULL, true);
+}
+
+void ui_set_split(bool enabled) {
+    split_mode = enabled;
+    invalidate_list_area();
+}
 
-    int max_y_path, max_x_path;
-    int max_y_stats, max_x_stats;
+void display_files_split(int side, FileEntry files[], int num_files, int current_selection, int scroll_offset,
+                         const char *path, bool focused) {
+    if (!main_win || side < 0 || side > 1) return;
 
-    getmaxyx(footer_win_path, max_y_path, max_x_path);   // 경로 푸터 윈도우 크기
-    getmaxyx(footer_win_stats, max_y_stats, max_x_stats); // 통계 푸터 윈도우 크기
+    // 왼쪽 칸 | 구분선 | 오른쪽 칸
+    int max_y, max_x;
+    getmaxyx(main_win, max_y, max_x);
+    int left_width = max_x / 2;
+    int x = (side == 0) ? 0 : left_width + 1;
+    int width = (side == 0) ? left_width : max_x - left_width - 1;
+
+    bool redraw = (list_panes[side].cached_rows == 0);
+    draw_list_pane(&list_panes[side], x, width, files, num_files, current_selection, scroll_offset, path, focused);
+    if (redraw && side == 0) {
+        wattrset(main_win, COLOR_PAIR(COLOR_PAIR_REGULAR));
+        mvwvline(main_win, 0, left_width, ACS_VLINE, max_y);
+        wattrset(main_win, A_NORMAL);
+    }
+}
+
+void ui_display_preview(Preview *preview, const char *name) {
+    if (!main_win) return;
+
+    // 분할 화면의 오른쪽 칸 자리
+    int max_y, max_x;
+    getmaxyx(main_win, max_y, max_x);
+    int left_width = max_x / 2;
+    int x = left_width + 1;
+    int width = max_x - x;
+    if (width < 10 || max_y < 2) return;
+
+    int bytes_per_row = ui_preview_bytes_per_row();
+
+    preview_validate(preview);
+
+    char state[sizeof(preview_drawn)];
+    snprintf(state, sizeof(state), "%d|%d|%d|%d|%lld|%lld|%s|%s", max_y, max_x, preview->loaded, preview->hex,
+             (long long)preview->top, (long long)preview->size, preview->message, name);
+    if (strcmp(state, preview_drawn) == 0) return;
+    snprintf(preview_drawn, sizeof(preview_drawn), "%s", state);
+
+    wattrset(main_win, A_NORMAL);
+    for (int row = 0; row < max_y; row++) {
+        mvwhline(main_win, row, x, ' ', width);
+    }
+
+    // 머리줄: 이름, 크기, 보기 방식
+    char size_str[16] = "";
+    if (preview->loaded) format_size(preview->size, size_str, sizeof(size_str));
+    char header[MAX_NAME_LEN + 48];
+    snprintf(header, sizeof(header), "%s  %s%s", name, size_str,
+             !preview->loaded ? "" : (preview->hex ? "  [HEX]" : "  [텍스트]"));
+    int header_bytes;
+    display_width(header, width, &header_bytes);
+    wattrset(main_win, COLOR_PAIR(COLOR_PAIR_FOOTER) | A_BOLD);
+    mvwhline(main_win, 0, x, ' ', width);
+    mvwaddnstr(main_win, 0, x, header, header_bytes);
+    wattrset(main_win, COLOR_PAIR(COLOR_PAIR_REGULAR));
+
+    if (!preview->loaded || preview->size == 0) {
+        const char *message = preview->message[0] ? preview->message : "...";
+        int message_bytes;
+        display_width(message, width - 1, &message_bytes);
+        mvwaddnstr(main_win, 1, x + 1, message, message_bytes);
+        wattrset(main_win, A_NORMAL);
+        wnoutrefresh(main_win);
+        return;
+    }
+
+    // 보이는 줄만 읽음 (매핑된 파일이면 해당 페이지만 읽힘)
+    char line[PREVIEW_MAX_LINE + 8];
+    off_t offset = preview->top;
+    for (int row = 1; row < max_y; row++) {
+        int len;
+        if (preview->hex) {
+            len = preview_hex_line(preview, offset, bytes_per_row, line, sizeof(line));
+            offset += bytes_per_row;
+        } else {
+            off_t next;
+            len = preview_text_line(preview, offset, line, sizeof(line), width - 1, &next);
+            offset = next;
+        }
+        if (len < 0) break;
+        int line_bytes;
+        display_width(line, width - 1, &line_bytes);
+        mvwaddnstr(main_win, row, x + 1, line, line_bytes);
+    }
+    wattrset(main_win, A_NORMAL);
+    wnoutrefresh(main_win);
+}
+
+// 16진수 보기는 폭이 되면 한 줄에 16바이트 (위치 11 + 바이트 3*n + 구분 + ASCII n + 2)
+int ui_preview_bytes_per_row() {
+    int max_x = main_win ? getmaxx(main_win) : 0;
+    int width = max_x - (max_x / 2 + 1);
+    return (width >= 11 + 2 + 16 * 4 + 3) ? 16 : 8;
+}
+
+void display_footer(const char* current_path, int num_items_in_dir, const char* disk_free_space, int num_marked,
+                    const char* status) {
+    if (!footer_win_path || !footer_win_stats) return; // 푸터 윈도우가 없으면 함수 종료
+
+    int max_x_path = getmaxx(footer_win_path);   // 경로 푸터 윈도우 너비
+    int max_x_stats = getmaxx(footer_win_stats); // 통계 푸터 윈도우 너비
 
     // 푸터 첫 번째 줄: 현재 경로
-    werase(footer_win_path); // 이전 내용 지우기
-    wattron(footer_win_path, COLOR_PAIR(COLOR_PAIR_FOOTER) | A_BOLD); // 푸터 색상 및 굵게 적용
     // 경로가 너무 길 경우 자르기 위한 버퍼 (윈도우 너비 - "Path: " 길이 - 패딩 공간)
-    char path_display[max_x_path - 7 + 1];
-    snprintf(path_display, sizeof(path_display), "Path: %.*s", max_x_path - 7, current_path); // "Path: " 접두사 고려
-    mvwprintw(footer_win_path, 0, 0, "%s", path_display); // 경로 출력 (왼쪽 정렬, 시작 열 0)
-    wattroff(footer_win_path, COLOR_PAIR(COLOR_PAIR_FOOTER) | A_BOLD); // 속성 해제
-    wrefresh(footer_win_path); // 경로 푸터 윈도우 변경 사항 화면에 반영
+    // 검색어 입력 중이면 경로 뒤에 상태를 붙이고 그만큼 경로를 줄임
+    char path_display[max_x_path + 1];
+    if (status && status[0] != '\0') {
+        int status_bytes;
+        int status_width = display_width(status, max_x_path - 10, &status_bytes);
+        if (status_width > max_x_path - 10) status_width = max_x_path - 10;
+        int path_room = max_x_path - 7 - status_width - 3;
+        if (path_room < 0) path_room = 0;
+        snprintf(path_display, sizeof(path_display), "Path: %.*s | %.*s", path_room, current_path, status_bytes, status);
+    } else {
+        snprintf(path_display, sizeof(path_display), "Path: %.*s", max_x_path - 7, current_path); // "Path: " 접두사 고려
+    }
+
+    // 내용이 바뀐 경우에만 다시 그림
+    if (strcmp(path_display, footer_path_cache) != 0) {
+        werase(footer_win_path); // 이전 내용 지우기
+        wattron(footer_win_path, COLOR_PAIR(COLOR_PAIR_FOOTER) | A_BOLD); // 푸터 색상 및 굵게 적용
+        mvwprintw(footer_win_path, 0, 0, "%s", path_display); // 경로 출력 (왼쪽 정렬, 시작 열 0)
+        wattroff(footer_win_path, COLOR_PAIR(COLOR_PAIR_FOOTER) | A_BOLD); // 속성 해제
+        snprintf(footer_path_cache, sizeof(footer_path_cache), "%s", path_display);
+    }
+    wnoutrefresh(footer_win_path);
 
     // 푸터 두 번째 줄: 항목 수 및 디스크 공간
-    werase(footer_win_stats); // 이전 내용 지우기
-    wattron(footer_win_stats, COLOR_PAIR(COLOR_PAIR_FOOTER) | A_BOLD); // 푸터 색상 및 굵게 적용
     char stats_str[max_x_stats + 1]; // 통계 문자열 버퍼
     // 형식: "64개 항목 | 10GB 사용가능"
-    snprintf(stats_str, sizeof(stats_str), "%d item(s) | %s", num_items_in_dir, disk_free_space);
+    if (num_marked > 0) {
+        snprintf(stats_str, sizeof(stats_str), "%d item(s) | %d marked | %s", num_items_in_dir, num_marked, disk_free_space);
+    } else {
+        snprintf(stats_str, sizeof(stats_str), "%d item(s) | %s", num_items_in_dir, disk_free_space);
+    }
 
-    // 통계 문자열 가운데 정렬
-    int stats_len = strlen(stats_str);
-    int start_col_stats = (max_x_stats - stats_len) / 2;
-    if (start_col_stats < 0) start_col_stats = 0; // 음수 방지 (윈도우가 텍스트보다 작을 경우)
+    if (strcmp(stats_str, footer_stats_cache) != 0) {
+        werase(footer_win_stats); // 이전 내용 지우기
+        wattron(footer_win_stats, COLOR_PAIR(COLOR_PAIR_FOOTER) | A_BOLD); // 푸터 색상 및 굵게 적용
 
-    mvwprintw(footer_win_stats, 0, start_col_stats, "%s", stats_str); // 통계 정보 출력
-    wattroff(footer_win_stats, COLOR_PAIR(COLOR_PAIR_FOOTER) | A_BOLD); // 속성 해제
-    wrefresh(footer_win_stats); // 통계 푸터 윈도우 변경 사항 화면에 반영
+        // 통계 문자열 가운데 정렬
+        int stats_len = strlen(stats_str);
+        int start_col_stats = (max_x_stats - stats_len) / 2;
+        if (start_col_stats < 0) start_col_stats = 0; // 음수 방지 (윈도우가 텍스트보다 작을 경우)
+
+        mvwprintw(footer_win_stats, 0, start_col_stats, "%s", stats_str); // 통계 정보 출력
+        wattroff(footer_win_stats, COLOR_PAIR(COLOR_PAIR_FOOTER) | A_BOLD); // 속성 해제
+        snprintf(footer_stats_cache, sizeof(footer_stats_cache), "%s", stats_str);
+    }
+    wnoutrefresh(footer_win_stats);
 }
 
 // 터미널 크기 변경 시 UI 윈도우를 재구성하는 함수
@@ -237,6 +570,12 @@ void resize_ui() {
     if (main_win) delwin(main_win);
     if (footer_win_path) delwin(footer_win_path);
     if (footer_win_stats) delwin(footer_win_stats);
+    if (progress_win) delwin(progress_win);
+
+    // 대화상자와 알림은 다음 프레임에 새 크기에 맞춰 다시 만듦
+    if (modal_win) delwin(modal_win);
+    if (toast_win) delwin(toast_win);
+    modal_win = toast_win = NULL;
 
     // 화면 전체를 지우고 배경색으로 채워 깨끗하게 만듭니다.
     clear();
@@ -245,7 +584,12 @@ void resize_ui() {
     // 새로운 크기에 맞춰 윈도우 다시 생성 및 배치
 
     // 메인 윈도우 생성: 새로운 화면 높이에서 푸터 높이를 뺀 영역을 차지합니다.
-    main_win = newwin(screen_rows - FOOTER_TOTAL_HEIGHT, screen_cols, 0, 0);
+    // 진행률 패널이 보이는 중이면 그만큼 목록 영역을 줄임 (화면이 너무 작으면 패널 숨김)
+    if (screen_rows - FOOTER_TOTAL_HEIGHT - PROGRESS_PANEL_HEIGHT < 3) {
+        progress_visible = false;
+    }
+    int main_height = screen_rows - FOOTER_TOTAL_HEIGHT - (progress_visible ? PROGRESS_PANEL_HEIGHT : 0);
+    main_win = newwin(main_height, screen_cols, 0, 0);
     if (!main_win) {
         endwin();
         fprintf(stderr, "Error creating main window after resize.\n");
@@ -258,8 +602,9 @@ void resize_ui() {
 
     footer_win_path = newwin(FOOTER_HEIGHT_PATH, screen_cols, footer_path_y, 0);
     footer_win_stats = newwin(FOOTER_HEIGHT_STATS, screen_cols, footer_stats_y, 0);
+    progress_win = newwin(PROGRESS_PANEL_HEIGHT, screen_cols, footer_path_y - PROGRESS_PANEL_HEIGHT, 0);
 
-     if (!footer_win_path || !footer_win_stats) {
+     if (!footer_win_path || !footer_win_stats || !progress_win) {
         endwin();
         fprintf(stderr, "Error creating footer windows after resize.\n");
         exit(1);
@@ -270,10 +615,14 @@ void resize_ui() {
     wbkgd(main_win, COLOR_PAIR(COLOR_PAIR_REGULAR));
     wbkgd(footer_win_path, COLOR_PAIR(COLOR_PAIR_FOOTER));
     wbkgd(footer_win_stats, COLOR_PAIR(COLOR_PAIR_FOOTER));
+    wbkgd(progress_win, COLOR_PAIR(COLOR_PAIR_REGULAR));
 
     // 필요한 경우 새로운 윈도우에 대해 keypad 등 설정 재적용
     keypad(main_win, TRUE); // 메인 윈도우에서 키 입력 받을 경우 필요
 
+    // 새 윈도우는 비어 있으므로 캐시된 행도 모두 다시 그려야 함
+    invalidate_render_cache();
+
     // 윈도우 변경 사항을 화면에 반영합니다.
     doupdate();
 
@@ -289,173 +638,977 @@ void refresh_screen() {
     // 개별 wrefresh 호출 방식도 가능하지만, doupdate가 일반적으로 더 효율적입니다.
 }
 
-// 확인 다이얼로그 표시 함수
-bool ui_show_confirmation_dialog(const char* message) {
+// 레이어 윈도우 닫기 (덮었던 영역은 다음 ui_display_overlays에서 복원)
+static void close_overlay(WINDOW **win) {
+    if (*win) {
+        delwin(*win);
+        *win = NULL;
+        overlay_closed = true;
+    }
+}
+
+// 대화상자 창 만들기 (화면 가운데, 화면 너비의 절반)
+static WINDOW* create_dialog_window(int height) {
     int screen_rows, screen_cols;
     getmaxyx(stdscr, screen_rows, screen_cols);
-    
-    // 다이얼로그 크기 및 위치 계산
+
     int dialog_width = screen_cols / 2;
     if (dialog_width < 40) dialog_width = screen_cols - 4; // 최소 너비 보장
     if (dialog_width > screen_cols - 4) dialog_width = screen_cols - 4;
-    
-    int dialog_height = 5;
-    int start_y = (screen_rows - dialog_height) / 2;
-    int start_x = (screen_cols - dialog_width) / 2;
-    
-    // 다이얼로그 창 생성
-    WINDOW *dialog_win = newwin(dialog_height, dialog_width, start_y, start_x);
-    if (!dialog_win) return false;
-    
-    // 테두리 설정 및 배경색 설정
-    box(dialog_win, 0, 0);
-    wbkgd(dialog_win, COLOR_PAIR(COLOR_PAIR_FOOTER));
-    
-    // 메시지 및 안내 표시
-    mvwprintw(dialog_win, 1, 2, "%s", message);
-    mvwprintw(dialog_win, 3, 2, "확인: Enter, 취소: ESC");
-    
-    wrefresh(dialog_win);
-    
-    // 입력 처리
-    keypad(dialog_win, TRUE);
-    noecho();
-    curs_set(0);
-    
-    int ch;
-    bool result = false;
-    
-    // 다이얼로그 입력 대기 루프
-    while (1) {
-        ch = wgetch(dialog_win);
-        
-        if (ch == '\n' || ch == KEY_ENTER) { // 확인 (Enter)
-            result = true;
-            break;
-        } else if (ch == 27 || ch == KEY_MESSAGE || ch == 'n' || ch == 'N') { // 취소 (ESC, n)
-            result = false;
-            break;
+    if (dialog_width < 1 || screen_rows < height) return NULL;
+
+    WINDOW *win = newwin(height, dialog_width, (screen_rows - height) / 2, (screen_cols - dialog_width) / 2);
+    if (win) wbkgd(win, COLOR_PAIR(COLOR_PAIR_FOOTER));
+    return win;
+}
+
+// 확인 다이얼로그 열기
+void ui_show_confirmation_dialog(const char* message) {
+    snprintf(modal_message, sizeof(modal_message), "%s", message);
+    modal_kind = MODAL_KIND_CONFIRM;
+    modal_dirty = true;
+}
+
+// 한 줄 입력 창 열기
+void ui_prompt_input(const char* prompt) {
+    snprintf(modal_message, sizeof(modal_message), "%s", prompt);
+    modal_input[0] = '\0';
+    modal_input_len = 0;
+    modal_kind = MODAL_KIND_PROMPT;
+    modal_dirty = true;
+}
+
+bool ui_modal_active() {
+    return modal_kind != MODAL_KIND_NONE;
+}
+
+const char* ui_modal_input() {
+    return modal_input;
+}
+
+// 열린 대화상자에 키 하나 전달
+ModalResult ui_modal_handle_key(int ch) {
+    if (modal_kind == MODAL_KIND_NONE) return MODAL_NONE;
+
+    ModalResult result = MODAL_PENDING;
+    if (ch == '\n' || ch == KEY_ENTER) { // 확인 (Enter)
+        result = MODAL_ACCEPTED;
+    } else if (ch == 27 || (modal_kind == MODAL_KIND_CONFIRM && (ch == 'n' || ch == 'N'))) { // 취소 (ESC, n)
+        result = MODAL_CANCELLED;
+    } else if (modal_kind == MODAL_KIND_PROMPT) {
+        if (ch == KEY_BACKSPACE || ch == 127 || ch == 8) {
+            if (modal_input_len > 0) modal_input[--modal_input_len] = '\0';
+        } else if (ch >= 32 && ch < 256 && modal_input_len + 1 < sizeof(modal_input)) {
+            modal_input[modal_input_len++] = (char)ch;
+            modal_input[modal_input_len] = '\0';
         }
+        modal_dirty = true;
+    }
+
+    if (result != MODAL_PENDING) {
+        modal_kind = MODAL_KIND_NONE;
+        close_overlay(&modal_win);
     }
-    
-    // 윈도우 정리 및 화면 갱신
-    delwin(dialog_win);
-    touchwin(stdscr);
-    refresh();
-    
     return result;
 }
 
-// 임시 메시지 표시 함수
+// 임시 메시지 표시 (TOAST_DURATION_MS 뒤 다음 프레임에서 사라짐)
 void ui_display_temporary_message(const char* message, bool is_error) {
+    snprintf(toast_message, sizeof(toast_message), "%s", message);
+    toast_is_error = is_error;
+    toast_expire_ms = event_now_ms() + TOAST_DURATION_MS;
+    close_overlay(&toast_win); // 메시지 길이에 맞춰 다시 만듦
+}
+
+int ui_toast_remaining_ms() {
+    if (toast_expire_ms == 0) return -1;
+    long remaining = toast_expire_ms - event_now_ms();
+    return remaining > 0 ? (int)remaining : 0;
+}
+
+// 알림 창 만들고 내용 그리기
+static void draw_toast() {
     int screen_rows, screen_cols;
     getmaxyx(stdscr, screen_rows, screen_cols);
     
-    // 메시지 창 크기 및 위치 계산
-    int msg_width = strlen(message) + 4;
+    // 메시지 창 크기 및 위치 계산 (대화상자가 열려 있으면 그 위에)
+    int msg_len = display_width(toast_message, 0, NULL);
+    int msg_width = msg_len + 4;
     if (msg_width > screen_cols - 4) msg_width = screen_cols - 4;
     if (msg_width < 20) msg_width = 20;
     
     int msg_height = 3;
     int start_y = (screen_rows - msg_height) / 2;
+    if (modal_kind != MODAL_KIND_NONE) start_y -= 4;
+    if (start_y < 0) start_y = 0;
     int start_x = (screen_cols - msg_width) / 2;
+    if (start_x < 0 || msg_width > screen_cols) return;
     
-    // 메시지 창 생성
-    WINDOW *msg_win = newwin(msg_height, msg_width, start_y, start_x);
-    if (!msg_win) return;
+    toast_win = newwin(msg_height, msg_width, start_y, start_x);
+    if (!toast_win) return;
     
     // 테두리 설정 및 배경색 설정
-    box(msg_win, 0, 0);
+    box(toast_win, 0, 0);
     
-    if (is_error) {
-        wattron(msg_win, A_BOLD | COLOR_PAIR(COLOR_PAIR_COPYING)); // 에러는 파란색으로
-    } else {
-        wattron(msg_win, A_BOLD | COLOR_PAIR(COLOR_PAIR_FOOTER)); // 일반 메시지는 노란색으로
-    }
+    // 에러는 파란색, 일반 메시지는 노란색으로
+    attr_t attr = A_BOLD | COLOR_PAIR(toast_is_error ? COLOR_PAIR_COPYING : COLOR_PAIR_FOOTER);
+    wattron(toast_win, attr);
     
     // 메시지 중앙 정렬
-    int msg_len = strlen(message);
     int msg_x = (msg_width - msg_len) / 2;
     if (msg_x < 1) msg_x = 1;
+    int msg_bytes;
+    display_width(toast_message, msg_width - msg_x - 1, &msg_bytes);
+    mvwaddnstr(toast_win, 1, msg_x, toast_message, msg_bytes);
     
-    mvwprintw(msg_win, 1, msg_x, "%s", message);
-    
-    if (is_error) {
-        wattroff(msg_win, A_BOLD | COLOR_PAIR(COLOR_PAIR_COPYING));
-    } else {
-        wattroff(msg_win, A_BOLD | COLOR_PAIR(COLOR_PAIR_FOOTER));
+    wattroff(toast_win, attr);
+}
+
+// 대화상자 내용 그리기
+static void draw_modal() {
+    werase(modal_win);
+    box(modal_win, 0, 0);
+    int width = getmaxx(modal_win);
+    int message_bytes;
+    display_width(modal_message, width - 4, &message_bytes);
+    mvwaddnstr(modal_win, 1, 2, modal_message, message_bytes);
+    if (modal_kind == MODAL_KIND_PROMPT) {
+        int field_width = width - 6;
+        const char *shown = (modal_input_len > (size_t)field_width) ? modal_input + modal_input_len - field_width : modal_input;
+        mvwprintw(modal_win, 2, 2, "> %s", shown);
     }
-    
-    wrefresh(msg_win);
-    
-    // 일정 시간 후 메시지 창 제거
-    napms(1500); // 1.5초 대기
-    
-    // 윈도우 정리 및 화면 갱신
-    delwin(msg_win);
-    touchwin(stdscr);
-    refresh();
+    mvwprintw(modal_win, 3, 2, "확인: Enter, 취소: ESC");
+    modal_dirty = false;
 }
 
-// 복사 진행률 표시 함수
-void ui_display_copy_progress(CopyTask* task) {
-    if (!task) return;
-    
+// 대화상자와 알림을 다른 윈도우 위에 그림 (프레임마다 목록/푸터를 그린 뒤 호출)
+void ui_display_overlays() {
+    if (toast_expire_ms != 0 && event_now_ms() >= toast_expire_ms) {
+        toast_expire_ms = 0;
+        close_overlay(&toast_win);
+    }
+
+    // 닫힌 레이어 아래의 원래 내용 복원
+    if (overlay_closed) {
+        overlay_closed = false;
+        restore_windows();
+    }
+
+    // 아래 윈도우가 이번 프레임에 덮어썼을 수 있으므로 항상 맨 위로 다시 올림
+    if (modal_kind != MODAL_KIND_NONE) {
+        if (!modal_win) {
+            modal_win = create_dialog_window(5);
+            modal_dirty = true;
+        }
+        if (modal_win) {
+            if (modal_dirty) draw_modal();
+            touchwin(modal_win);
+            wnoutrefresh(modal_win);
+        }
+    }
+    if (toast_expire_ms != 0) {
+        if (!toast_win) draw_toast();
+        if (toast_win) {
+            touchwin(toast_win);
+            wnoutrefresh(toast_win);
+        }
+    }
+}
+
+// 진행률 패널 보이기/숨기기 - 목록 영역의 높이를 조정하므로 목록은 전체 다시 그림
+static void set_progress_visible(bool visible) {
+    if (visible == progress_visible || !main_win || !progress_win) return;
+
     int screen_rows, screen_cols;
     getmaxyx(stdscr, screen_rows, screen_cols);
-    
-    // 진행률 창 크기 및 위치 계산
-    int progress_width = screen_cols / 2;
-    if (progress_width < 40) progress_width = screen_cols - 4;
-    if (progress_width > screen_cols - 4) progress_width = screen_cols - 4;
-    
-    int progress_height = 5;
-    int start_y = screen_rows - progress_height - 2;
-    int start_x = (screen_cols - progress_width) / 2;
-    
-    // 진행률 창 생성
-    WINDOW *progress_win = newwin(progress_height, progress_width, start_y, start_x);
-    if (!progress_win) return;
-    
-    // 테두리 설정 및 배경색 설정
-    box(progress_win, 0, 0);
-    wbkgd(progress_win, COLOR_PAIR(COLOR_PAIR_REGULAR));
-    
-    // 파일 이름 및 상태 표시
-    mvwprintw(progress_win, 1, 2, "복사 중: %s", task->dest_name);
+    int list_rows = screen_rows - FOOTER_TOTAL_HEIGHT - (visible ? PROGRESS_PANEL_HEIGHT : 0);
+    if (visible && list_rows < 3) return; // 화면이 너무 작으면 패널 없이
+
+    wresize(main_win, list_rows, screen_cols);
+    progress_visible = visible;
+    invalidate_render_cache();
+}
+
+int ui_list_height() {
+    if (!main_win) return 0;
+    int height = getmaxy(main_win) - 1; // 헤더 라인 제외
+    return height > 0 ? height : 0;
+}
+
+// 패널 한 줄 갱신 (내용이 같으면 건너뜀)
+static void update_progress_line(int index, const char *text) {
+    if (strcmp(progress_line_cache[index], text) == 0) return;
+
+    int width = getmaxx(progress_win);
+    int row = (index == 0) ? 1 : 3;
+    wmove(progress_win, row, 1);
+    whline(progress_win, ' ', width - 2);
+    mvwprintw(progress_win, row, 2, "%.*s", width - 4, text);
+    snprintf(progress_line_cache[index], sizeof(progress_line_cache[index]), "%s", text);
+}
+
+// 복사 진행률 표시 함수
+void ui_display_copy_progress(CopyTask* task) {
+    if (!task) {
+        set_progress_visible(false);
+        return;
+    }
+
+    set_progress_visible(true);
+    if (!progress_visible) return;
     
     // 진행률 계산
     pthread_mutex_lock(&task->progress_mutex);
+    off_t total_size = task->total_size;
+    off_t copied_size = task->copied_size;
+    TaskPhase phase = task->phase;
+    long files_total = task->files_total;
+    long files_done = task->files_done;
+    int failed_count = task->failed_count;
+    bool queued = task->is_queued;
+    pthread_mutex_unlock(&task->progress_mutex);
+
+    // 처리 속도는 최근 표본 창 기준, 다른 작업 수는 대시보드 안내용
+    TaskRates rates;
+    sample_task_rates(task, event_now_ms(), &rates);
+    int task_count = 0;
+    for (CopyTask *t = g_copy_tasks; t; t = t->next) {
+        if (t->is_running) task_count++;
+    }
+
+    // 패널이 새로 보이거나 캐시가 무효화되었으면 테두리부터 다시
+    if (progress_fill_cache < 0) {
+        werase(progress_win);
+        box(progress_win, 0, 0);
+        for (int i = 0; i < 3; i++) progress_line_cache[i][0] = '\0';
+    }
+
+    // 파일 이름 및 상태 표시 (이동은 복사 → 원본 삭제 두 단계)
+    const char *title = "복사 중";
+    if (queued) {
+        title = "대기 중";
+    } else if (task->type == TASK_TYPE_MOVE) {
+        title = (phase == TASK_PHASE_DELETE) ? "이동 중 (2/2 원본 삭제)" : "이동 중 (1/2 복사)";
+    } else if (task->type == TASK_TYPE_DELETE) {
+        title = "삭제 중";
+    } else if (task->type == TASK_TYPE_PACK) {
+        title = "묶는 중";
+    } else if (task->type == TASK_TYPE_SYNC) {
+        title = "동기화 중";
+    }
+    char line[256];
+    if (failed_count > 0) {
+        snprintf(line, sizeof(line), "%s: %s (%d개 실패)", title, task->dest_name, failed_count);
+    } else {
+        snprintf(line, sizeof(line), "%s: %s", title, task->dest_name);
+    }
+    update_progress_line(0, line);
+
     double progress_percent = 0.0;
-    if (task->total_size > 0) {
-        progress_percent = (double)task->copied_size / task->total_size * 100.0;
+    if (phase == TASK_PHASE_DELETE) {
+        if (files_total > 0) {
+            progress_percent = (double)files_done / files_total * 100.0;
+            if (progress_percent > 100.0) progress_percent = 100.0;
+        }
+    } else if (total_size > 0) {
+        progress_percent = (double)copied_size / total_size * 100.0;
+        if (progress_percent > 100.0) progress_percent = 100.0; // 캐시된 크기가 오래된 경우
     }
-    pthread_mutex_unlock(&task->progress_mutex);
     
-    // 진행률 막대 표시
-    int bar_width = progress_width - 10;
+    // 진행률 막대 - 표시되는 퍼센트(0.1% 단위)가 바뀐 경우에만 다시 그림
+    int progress_width = getmaxx(progress_win);
+    int bar_width = progress_width - 14;
+    if (bar_width < 0) bar_width = 0;
     int filled_width = (int)(bar_width * progress_percent / 100.0);
+    int percent_tenths = (int)(progress_percent * 10.0);
+    int fill_key = percent_tenths * 10000 + filled_width;
+    if (fill_key != progress_fill_cache) {
+        mvwaddch(progress_win, 2, 2, '[');
+        if (filled_width > 0) whline(progress_win, '=', filled_width);
+        wmove(progress_win, 2, 3 + filled_width);
+        if (bar_width - filled_width > 0) whline(progress_win, ' ', bar_width - filled_width);
+        mvwprintw(progress_win, 2, 3 + bar_width, "] %5.1f%%", percent_tenths / 10.0);
+        progress_fill_cache = fill_key;
+    }
     
-    mvwprintw(progress_win, 2, 2, "[");
-    for (int i = 0; i < bar_width; i++) {
-        if (i < filled_width) {
-            waddch(progress_win, '=');
+    // 취소 안내 표시 (전체 크기를 아직 계산 중이면 복사된 양, 복사 중이면 처리 속도도 함께)
+    int len;
+    if (queued) {
+        len = snprintf(line, sizeof(line), "취소: ESC | 앞선 작업이 끝나기를 기다리는 중");
+    } else if (phase == TASK_PHASE_DELETE) {
+        len = snprintf(line, sizeof(line), "취소: ESC | %ld개 항목 삭제됨", files_done);
+    } else {
+        char copied_str[16];
+        char rate_str[16];
+        format_size(copied_size, copied_str, sizeof(copied_str));
+        format_size((off_t)rates.current, rate_str, sizeof(rate_str));
+        if (total_size < 0) {
+            len = snprintf(line, sizeof(line), "취소: ESC | 크기 계산 중... %s 복사됨 | %s/s", copied_str, rate_str);
         } else {
-            waddch(progress_win, ' ');
+            len = snprintf(line, sizeof(line), "취소: ESC | %s 복사됨 | %s/s", copied_str, rate_str);
         }
     }
-    wprintw(progress_win, "] %.1f%%", progress_percent);
-    
-    // 취소 안내 표시
-    mvwprintw(progress_win, 3, 2, "취소: ESC");
+    if (task_count > 1 && len > 0 && len < (int)sizeof(line)) {
+        snprintf(line + len, sizeof(line) - len, " | 작업 %d개 (t: 전체 보기)", task_count);
+    }
+    update_progress_line(2, line);
     
-    wrefresh(progress_win);
-    delwin(progress_win);
+    wnoutrefresh(progress_win);
+}
+
+// 남은 시간 문자열 (예: 4:05, 1:02:03)
+static void format_eta(long seconds, char *buf, size_t size) {
+    if (seconds < 0) {
+        snprintf(buf, size, "-");
+    } else if (seconds < 3600) {
+        snprintf(buf, size, "%ld:%02ld", seconds / 60, seconds % 60);
+    } else {
+        snprintf(buf, size, "%ld:%02ld:%02ld", seconds / 3600, (seconds / 60) % 60, seconds % 60);
+    }
+}
+
+// 처리량 문자열 (바이트면 크기/s, 삭제 단계면 항목/s)
+static void format_rate(double rate, bool in_items, char *buf, size_t size) {
+    if (in_items) {
+        snprintf(buf, size, "%.0f개/s", rate);
+    } else {
+        char size_str[16];
+        format_size((off_t)rate, size_str, sizeof(size_str));
+        snprintf(buf, size, "%s/s", size_str);
+    }
+}
+
+// 작업 대시보드 표시 (목록 영역 전체 사용)
+int ui_display_task_dashboard(CopyTask* tasks, int selection) {
+    int height, width;
+    getmaxyx(main_win, height, width);
+    werase(main_win);
+    invalidate_list_area(); // 목록으로 돌아가면 전체 다시 그림
+
+    // 열 위치 (이름은 폭이 일정하지 않으므로 맨 끝)
+    const int x_state = 1, x_percent = 11, x_amount = 19, x_current = 42, x_average = 55, x_eta = 68, x_name = 78;
+
+    wattron(main_win, A_BOLD | COLOR_PAIR(COLOR_PAIR_REGULAR));
+    mvwprintw(main_win, 0, 0, "%.*s", width, "백그라운드 작업   ↑↓: 선택  x: 선택한 작업 취소  t/ESC: 닫기");
+    wattroff(main_win, A_BOLD | COLOR_PAIR(COLOR_PAIR_REGULAR));
+    wattron(main_win, A_UNDERLINE);
+    mvwprintw(main_win, 1, x_state, "상태");
+    mvwprintw(main_win, 1, x_percent, "진행률");
+    mvwprintw(main_win, 1, x_amount, "처리 / 전체");
+    mvwprintw(main_win, 1, x_current, "현재 속도");
+    mvwprintw(main_win, 1, x_average, "평균 속도");
+    mvwprintw(main_win, 1, x_eta, "남은 시간");
+    if (width > x_name) mvwprintw(main_win, 1, x_name, "작업");
+    wattroff(main_win, A_UNDERLINE);
+
+    long now_ms = event_now_ms();
+    int index = 0, active = 0, queued_count = 0;
+    double total_rate = 0.0;
+    off_t total_done = 0, total_remaining = 0;
+    bool total_known = true;
+    int first_row = 2, last_row = height - 3; // 아래 두 줄은 합계
+
+    for (CopyTask *task = tasks; task; task = task->next) {
+        if (!task->is_running) continue;
+
+        TaskRates rates;
+        sample_task_rates(task, now_ms, &rates);
+        pthread_mutex_lock(&task->progress_mutex);
+        bool queued = task->is_queued;
+        TaskPhase phase = task->phase;
+        long failed_count = task->failed_count;
+        pthread_mutex_unlock(&task->progress_mutex);
+
+        // 합계는 바이트 단위로 진행 중인 작업만
+        if (queued) {
+            queued_count++;
+        } else {
+            active++;
+        }
+        if (!rates.in_items) {
+            if (!queued) total_rate += rates.current;
+            total_done += rates.done;
+            if (rates.total >= 0) {
+                if (rates.total > rates.done) total_remaining += rates.total - rates.done;
+            } else {
+                total_known = false;
+            }
+        }
+
+        int row = first_row + index;
+        index++;
+        if (row > last_row) continue;
+
+        const char *state = "복사 중";
+        if (task->cancel_requested) {
+            state = "취소 중";
+        } else if (queued) {
+            state = "대기";
+        } else if (phase == TASK_PHASE_DELETE) {
+            state = (task->type == TASK_TYPE_MOVE) ? "원본 삭제" : "삭제 중";
+        } else if (task->type == TASK_TYPE_MOVE) {
+            state = "이동 중";
+        } else if (task->type == TASK_TYPE_PACK) {
+            state = "묶는 중";
+        } else if (task->type == TASK_TYPE_SYNC) {
+            state = "동기화 중";
+        }
+
+        char percent[16] = "-";
+        if (rates.total > 0) {
+            double value = (double)rates.done / rates.total * 100.0;
+            snprintf(percent, sizeof(percent), "%5.1f%%", value > 100.0 ? 100.0 : value);
+        }
+
+        char amount[32];
+        if (rates.in_items) {
+            if (rates.total >= 0) {
+                snprintf(amount, sizeof(amount), "%ld / %ld개", (long)rates.done, (long)rates.total);
+            } else {
+                snprintf(amount, sizeof(amount), "%ld / ?개", (long)rates.done);
+            }
+        } else {
+            char done_str[16], total_str[16];
+            format_size(rates.done, done_str, sizeof(done_str));
+            if (rates.total >= 0) {
+                format_size(rates.total, total_str, sizeof(total_str));
+            } else {
+                snprintf(total_str, sizeof(total_str), "계산 중");
+            }
+            snprintf(amount, sizeof(amount), "%s / %s", done_str, total_str);
+        }
+
+        char current[24] = "-", average[24] = "-", eta[16] = "-";
+        if (!queued) {
+            format_rate(rates.current, rates.in_items, current, sizeof(current));
+            format_rate(rates.average, rates.in_items, average, sizeof(average));
+            format_eta(rates.eta_sec, eta, sizeof(eta));
+        }
+
+        char name[MAX_NAME_LEN + 32];
+        if (failed_count > 0) {
+            snprintf(name, sizeof(name), "%s (%ld개 실패)", task->dest_name, failed_count);
+        } else {
+            snprintf(name, sizeof(name), "%s", task->dest_name);
+        }
+
+        bool selected = (index - 1 == selection);
+        if (selected) {
+            wattron(main_win, COLOR_PAIR(COLOR_PAIR_HIGHLIGHT));
+            mvwhline(main_win, row, 0, ' ', width);
+        }
+        mvwprintw(main_win, row, x_state, "%s", state);
+        mvwprintw(main_win, row, x_percent, "%s", percent);
+        mvwprintw(main_win, row, x_amount, "%s", amount);
+        mvwprintw(main_win, row, x_current, "%s", current);
+        mvwprintw(main_win, row, x_average, "%s", average);
+        mvwprintw(main_win, row, x_eta, "%s", eta);
+        if (width > x_name + 1) {
+            int name_bytes;
+            display_width(name, width - x_name - 1, &name_bytes);
+            mvwaddnstr(main_win, row, x_name, name, name_bytes);
+        }
+        if (selected) wattroff(main_win, COLOR_PAIR(COLOR_PAIR_HIGHLIGHT));
+    }
+
+    if (index == 0) {
+        mvwprintw(main_win, first_row, x_state, "진행 중인 작업이 없습니다");
+    } else if (index > last_row - first_row + 1) {
+        mvwprintw(main_win, last_row, x_state, "... 외 %d개", index - (last_row - first_row));
+    }
+
+    // 합계 - 동시에 도는 작업들이 디스크를 얼마나 쓰고 있는지
+    if (height >= 4) {
+        char rate_str[24], done_str[16], eta_str[16] = "-";
+        format_rate(total_rate, false, rate_str, sizeof(rate_str));
+        format_size(total_done, done_str, sizeof(done_str));
+        if (total_known && total_rate > 0.0) {
+            format_eta((long)(total_remaining / total_rate + 0.5), eta_str, sizeof(eta_str));
+        }
+        mvwhline(main_win, height - 2, 0, ACS_HLINE, width);
+        wattron(main_win, A_BOLD);
+        mvwprintw(main_win, height - 1, x_state, "합계: 실행 %d개, 대기 %d개 | 전체 속도 %s | %s 처리 | 남은 시간 %s",
+                  active, queued_count, rate_str, done_str, eta_str);
+        wattroff(main_win, A_BOLD);
+    }
+
+    wnoutrefresh(main_win);
+    return index;
+}
+
+// 퍼지 찾기 결과 이름 (맞은 글자는 굵은 밑줄, 다중 바이트 문자는 글자 단위로 강조)
+static void draw_fuzzy_name(int row, int col, FileEntry *file, const char *query, int cols, attr_t attr) {
+    int positions[FILTER_MAX_QUERY];
+    int count = fuzzy_match_positions(file->name, query, positions, FILTER_MAX_QUERY);
+
+    fit_name(file, cols);
+    int end = file->name_fit_bytes;
+    mbstate_t state;
+    memset(&state, 0, sizeof(state));
+
+    wmove(main_win, row, col);
+    int p = 0; // positions는 오름차순
+    for (int i = 0; i < end;) {
+        size_t len = mbrlen(file->name + i, end - i, &state);
+        if (len == (size_t)-1 || len == (size_t)-2 || len == 0) {
+            len = 1;
+            memset(&state, 0, sizeof(state));
+        }
+        bool hit = false;
+        while (p < count && positions[p] < i + (int)len) {
+            if (positions[p] >= i) hit = true;
+            p++;
+        }
+        wattrset(main_win, hit ? (attr | A_BOLD | A_UNDERLINE) : attr);
+        waddnstr(main_win, file->name + i, (int)len);
+        i += (int)len;
+    }
+    wattrset(main_win, attr);
+    if (file->name_width > cols) {
+        waddch(main_win, '~');
+    }
+}
+
+void ui_display_fuzzy_finder(FileEntry files[], const char *query, const FuzzyMatch *results, int result_count,
+                             int match_count, int total, int selection) {
+    int height, width;
+    getmaxyx(main_win, height, width);
+    werase(main_win);
+    invalidate_list_area(); // 목록으로 돌아가면 전체 다시 그림
+    if (height < 3 || width < 20) {
+        wnoutrefresh(main_win);
+        return;
+    }
+
+    wattron(main_win, A_BOLD | COLOR_PAIR(COLOR_PAIR_REGULAR));
+    mvwprintw(main_win, 0, 0, "%.*s", width, "퍼지 찾기   ↑↓: 선택  Enter: 이동  ESC: 닫기");
+    wattroff(main_win, A_BOLD | COLOR_PAIR(COLOR_PAIR_REGULAR));
+
+    char count_str[32];
+    snprintf(count_str, sizeof(count_str), "%d/%d개", match_count, total);
+    int count_col = width - (int)strlen(count_str) - 1;
+    int query_bytes;
+    display_width(query, count_col - 4 > 0 ? count_col - 4 : 0, &query_bytes);
+    mvwaddstr(main_win, 1, 0, "> ");
+    waddnstr(main_win, query, query_bytes);
+    waddch(main_win, '_');
+    mvwaddstr(main_win, 1, count_col, count_str);
+
+    // 이름은 목록과 같은 너비, 종류는 그 뒤
+    int name_cols = width / 2 - 2;
+    int type_col = name_cols + 3;
+    int visible = height - 2;
+    int offset = selection >= visible ? selection - visible + 1 : 0;
+
+    for (int r = 0; r < visible && offset + r < result_count; r++) {
+        int i = offset + r;
+        int row = 2 + r;
+        FileEntry *file = &files[results[i].index];
+        attr_t attr = (i == selection) ? COLOR_PAIR(COLOR_PAIR_HIGHLIGHT) : COLOR_PAIR(COLOR_PAIR_REGULAR);
+
+        wattrset(main_win, attr);
+        mvwhline(main_win, row, 0, ' ', width);
+        draw_fuzzy_name(row, 2, file, query, name_cols, attr);
+        int type_bytes;
+        display_width(file->type, width - type_col - 1, &type_bytes);
+        mvwaddnstr(main_win, row, type_col, file->type, type_bytes);
+        wattrset(main_win, A_NORMAL);
+    }
+    if (result_count == 0) {
+        mvwprintw(main_win, 2, 2, "맞는 항목이 없습니다");
+    }
+
+    wnoutrefresh(main_win);
+}
+
+// 찾은 경로를 cols칸에 맞게 (넘치면 앞쪽 디렉토리를 줄여 "~/..."로, 이름이 중요하므로 뒤쪽을 남김)
+static void draw_search_path(int row, int col, const char *path, bool is_dir, int cols) {
+    const char *shown = path;
+    int suffix = is_dir ? 1 : 0;
+    while (display_width(shown, cols, NULL) + suffix + (shown != path ? 1 : 0) > cols) {
+        const char *slash = strchr(shown + 1, '/');
+        if (!slash) break;
+        shown = slash;
+    }
+
+    wmove(main_win, row, col);
+    int room = cols - suffix;
+    if (shown != path) {
+        waddch(main_win, '~');
+        room--;
+    }
+    int fit_bytes;
+    display_width(shown, room > 0 ? room : 0, &fit_bytes);
+    waddnstr(main_win, shown, fit_bytes);
+    if (is_dir) waddch(main_win, '/');
+}
+
+void ui_display_search_results(const SearchTask *task, long dirs_scanned) {
+    int height, width;
+    getmaxyx(main_win, height, width);
+    werase(main_win);
+    invalidate_list_area(); // 목록으로 돌아가면 전체 다시 그림
+    if (height < 3 || width < 20) {
+        wnoutrefresh(main_win);
+        return;
+    }
+
+    bool content = (task->kind == SEARCH_CONTENT);
+    wattron(main_win, A_BOLD | COLOR_PAIR(COLOR_PAIR_REGULAR));
+    mvwprintw(main_win, 0, 0, "%.*s", width, content
+              ? "하위 디렉토리 내용 찾기   ↑↓: 선택  Enter: 편집기로 열기  x: 멈추기  ESC: 닫기"
+              : "하위 디렉토리 찾기   ↑↓: 선택  Enter: 이동  x: 멈추기  ESC: 닫기");
+    wattroff(main_win, A_BOLD | COLOR_PAIR(COLOR_PAIR_REGULAR));
+
+    const SearchHit *hits = task->hits;
+    int hit_count = task->hit_count;
+    char status[96];
+    if (content) {
+        const char *state = task->finished ? (task->truncated ? "최대 개수에서 멈춤" : "완료") : "찾는 중...";
+        snprintf(status, sizeof(status), "%d줄  파일 %ld개  %s", hit_count, task->files_scanned, state);
+    } else if (task->from_index) {
+        snprintf(status, sizeof(status), "%d개  색인%s", hit_count, task->truncated ? "  최대 개수에서 멈춤" : "");
+    } else {
+        const char *state = task->finished ? (task->truncated ? "최대 개수에서 멈춤" : "완료") : "찾는 중...";
+        snprintf(status, sizeof(status), "%d개  디렉토리 %ld개  %s", hit_count, dirs_scanned, state);
+    }
+    int status_col = width - display_width(status, width, NULL) - 1;
+    if (status_col < 0) status_col = 0;
+    char header[MAX_PATH_LEN + MAX_NAME_LEN + 8];
+    snprintf(header, sizeof(header), "%s: %s", task->root, task->pattern);
+    int header_bytes;
+    display_width(header, status_col - 1 > 0 ? status_col - 1 : 0, &header_bytes);
+    mvwaddnstr(main_win, 1, 0, header, header_bytes);
+    mvwaddstr(main_win, 1, status_col, status);
+
+    int visible = height - 2;
+    int offset = task->selection >= visible ? task->selection - visible + 1 : 0;
+    for (int r = 0; r < visible && offset + r < hit_count; r++) {
+        int i = offset + r;
+        int row = 2 + r;
+        attr_t attr = (i == task->selection) ? COLOR_PAIR(COLOR_PAIR_HIGHLIGHT) : COLOR_PAIR(COLOR_PAIR_REGULAR);
+        wattrset(main_win, attr);
+        mvwhline(main_win, row, 0, ' ', width);
+        if (content) {
+            // "경로:줄" (화면의 2/5까지) 뒤에 줄 내용
+            char location[MAX_PATH_LEN + 24];
+            snprintf(location, sizeof(location), "%s:%ld", hits[i].path, hits[i].line);
+            int location_cols = display_width(location, width, NULL);
+            if (location_cols > width * 2 / 5) location_cols = width * 2 / 5;
+            draw_search_path(row, 2, location, false, location_cols);
+            int text_col = 2 + location_cols + 2;
+            const char *text = hits[i].text;
+            while (*text == ' ') text++;
+            int text_bytes;
+            display_width(text, width - text_col - 1 > 0 ? width - text_col - 1 : 0, &text_bytes);
+            mvwaddnstr(main_win, row, text_col, text, text_bytes);
+        } else {
+            draw_search_path(row, 2, hits[i].path, hits[i].d_type == DT_DIR, width - 3);
+        }
+        wattrset(main_win, A_NORMAL);
+    }
+    if (hit_count == 0 && task->finished) {
+        mvwprintw(main_win, 2, 2, "맞는 항목이 없습니다");
+    }
+
+    wnoutrefresh(main_win);
+}
+
+void ui_display_usage(const UsageTask *task, long dirs_scanned) {
+    int height, width;
+    getmaxyx(main_win, height, width);
+    werase(main_win);
+    invalidate_list_area(); // 목록으로 돌아가면 전체 다시 그림
+    if (height < 3 || width < 40) {
+        wnoutrefresh(main_win);
+        return;
+    }
+
+    wattron(main_win, A_BOLD | COLOR_PAIR(COLOR_PAIR_REGULAR));
+    mvwprintw(main_win, 0, 0, "%.*s", width,
+              "디스크 사용량   ↑↓: 선택  Enter/→: 들어가기  ←/Backspace: 위로  a: 할당/겉보기 크기  g: 목록에서 보기  ESC: 닫기");
+    wattroff(main_win, A_BOLD | COLOR_PAIR(COLOR_PAIR_REGULAR));
+
+    char allocated[16];
+    if (!task->finished) {
+        format_size(task->allocated, allocated, sizeof(allocated));
+        mvwprintw(main_win, 1, 0, "%s: 읽는 중...  디렉토리 %ld개  항목 %ld개  %s  (x: 멈추기)",
+                  task->root, dirs_scanned, task->files, allocated);
+        wnoutrefresh(main_win);
+        return;
+    }
+
+    const UsageNode *node = task->current;
+    char apparent[16];
+    format_size(node->allocated, allocated, sizeof(allocated));
+    format_size(node->apparent, apparent, sizeof(apparent));
+    char status[96];
+    snprintf(status, sizeof(status), "할당 %s  겉보기 %s  항목 %ld개%s", allocated, apparent, node->items,
+             task->cancelled ? "  (중간에 멈춤)" : "");
+    int status_col = width - display_width(status, width, NULL) - 1;
+    if (status_col < 0) status_col = 0;
+    char path[MAX_PATH_LEN];
+    usage_node_path(task, node, path, sizeof(path));
+    draw_search_path(1, 0, path, false, status_col - 1 > 0 ? status_col - 1 : 0);
+    mvwaddstr(main_win, 1, status_col, status);
+
+    // 크기  [막대]  비율  이름
+    off_t total = task->by_apparent ? node->apparent : node->allocated;
+    const int bar_width = 10;
+    int name_col = 2 + 9 + 2 + bar_width + 2 + 2 + 6 + 2;
+    int visible = height - 2;
+    int offset = task->selection >= visible ? task->selection - visible + 1 : 0;
+    for (int r = 0; r < visible && offset + r < node->child_count; r++) {
+        int i = offset + r;
+        int row = 2 + r;
+        const UsageNode *child = node->children[i];
+        off_t size = task->by_apparent ? child->apparent : child->allocated;
+        double ratio = total > 0 ? (double)size / (double)total : 0.0;
+        int filled = (int)(ratio * bar_width + 0.5);
+
+        attr_t attr = (i == task->selection) ? COLOR_PAIR(COLOR_PAIR_HIGHLIGHT) : COLOR_PAIR(COLOR_PAIR_REGULAR);
+        wattrset(main_win, attr);
+        mvwhline(main_win, row, 0, ' ', width);
+        char size_text[16];
+        format_size(size, size_text, sizeof(size_text));
+        mvwprintw(main_win, row, 2, "%9s  [", size_text);
+        for (int b = 0; b < bar_width; b++) {
+            waddch(main_win, b < filled ? '#' : ' ');
+        }
+        wprintw(main_win, "]  %5.1f%%", ratio * 100.0);
+
+        bool is_dir = (child->d_type == DT_DIR);
+        int room = width - name_col - 1 - (child->hardlink ? 12 : 0);
+        int name_bytes;
+        display_width(child->name, room - (is_dir ? 1 : 0) > 0 ? room - (is_dir ? 1 : 0) : 0, &name_bytes);
+        mvwaddnstr(main_win, row, name_col, child->name, name_bytes);
+        if (is_dir) waddch(main_win, '/');
+        if (child->hardlink) waddstr(main_win, "  (하드 링크)");
+        wattrset(main_win, A_NORMAL);
+    }
+    if (node->child_count == 0) {
+        mvwprintw(main_win, 2, 2, "비어 있음");
+    }
+
+    wnoutrefresh(main_win);
+}
+
+void ui_display_dupes(const DupesTask *task, long dirs_scanned) {
+    int height, width;
+    getmaxyx(main_win, height, width);
+    werase(main_win);
+    invalidate_list_area(); // 목록으로 돌아가면 전체 다시 그림
+    if (height < 3 || width < 40) {
+        wnoutrefresh(main_win);
+        return;
+    }
+
+    wattron(main_win, A_BOLD | COLOR_PAIR(COLOR_PAIR_REGULAR));
+    mvwprintw(main_win, 0, 0, "%.*s", width,
+              "중복 파일   ↑↓: 선택  d/D: 삭제  l: 하드 링크로 바꾸기  g: 목록에서 보기  r: 다시 찾기  ESC: 닫기");
+    wattroff(main_win, A_BOLD | COLOR_PAIR(COLOR_PAIR_REGULAR));
+
+    char bytes[16];
+    if (!task->finished) {
+        format_size(task->bytes_read, bytes, sizeof(bytes));
+        if (task->stage == DUPES_STAGE_SCAN) {
+            mvwprintw(main_win, 1, 0, "%s: 파일 목록 읽는 중...  디렉토리 %ld개  파일 %d개  (x: 멈추기)",
+                      task->root, dirs_scanned, task->file_count);
+        } else {
+            const char *stage = (task->stage == DUPES_STAGE_EDGES) ? "크기가 같은 파일의 앞/뒤 블록 비교"
+                                                                   : "앞뒤가 같은 파일의 전체 내용 비교";
+            mvwprintw(main_win, 1, 0, "%s: %s  %ld/%ld  읽은 양 %s  (x: 멈추기)",
+                      task->root, stage, task->stage_done, task->stage_total, bytes);
+        }
+        wnoutrefresh(main_win);
+        return;
+    }
+
+    char wasted[16];
+    format_size(task->wasted, wasted, sizeof(wasted));
+    char status[96];
+    snprintf(status, sizeof(status), "묶음 %d개  파일 %d개  낭비 %s%s", task->group_count,
+             task->duplicate_count, wasted, task->cancelled ? "  (중간에 멈춤)" : "");
+    int status_col = width - display_width(status, width, NULL) - 1;
+    if (status_col < 0) status_col = 0;
+    draw_search_path(1, 0, task->root, false, status_col - 1 > 0 ? status_col - 1 : 0);
+    mvwaddstr(main_win, 1, status_col, status);
+    if (task->group_count == 0) {
+        mvwprintw(main_win, 2, 2, task->cancelled ? "멈춘 뒤에는 결과가 없습니다" : "중복 파일이 없습니다");
+        wnoutrefresh(main_win);
+        return;
+    }
+
+    // 묶음마다 제목 행 하나 + 파일 행 - 선택한 파일이 보이도록 (묶음의 첫 파일이면 제목도)
+    int group = 0, index = 0;
+    dupes_locate(task, task->selection, &group, &index);
+    int selected_row = task->selection + group + 1;
+    int visible = height - 2;
+    int offset = selected_row >= visible ? selected_row - visible + 1 : 0;
+    if (index == 0 && offset == selected_row && offset > 0) offset--;
+
+    size_t root_len = strlen(task->root);
+    int row_index = 0;
+    int ordinal = 0;
+    for (int g = 0; g < task->group_count && row_index - offset < visible; g++) {
+        const DupesGroup *dg = &task->groups[g];
+        if (row_index >= offset) {
+            char size[16], group_wasted[16];
+            format_size(dg->size, size, sizeof(size));
+            format_size(dg->size * (dg->count - 1), group_wasted, sizeof(group_wasted));
+            wattron(main_win, A_BOLD | COLOR_PAIR(COLOR_PAIR_REGULAR));
+            mvwprintw(main_win, 2 + row_index - offset, 1, "%s × %d개  (낭비 %s)", size, dg->count, group_wasted);
+            wattroff(main_win, A_BOLD | COLOR_PAIR(COLOR_PAIR_REGULAR));
+        }
+        row_index++;
+        for (int i = 0; i < dg->count && row_index - offset < visible; i++, row_index++, ordinal++) {
+            if (row_index < offset) continue;
+            int row = 2 + row_index - offset;
+            attr_t attr = (ordinal == task->selection) ? COLOR_PAIR(COLOR_PAIR_HIGHLIGHT) : COLOR_PAIR(COLOR_PAIR_REGULAR);
+            wattrset(main_win, attr);
+            mvwhline(main_win, row, 0, ' ', width);
+            const char *path = dg->files[i]->path;
+            if (strncmp(path, task->root, root_len) == 0) {
+                path += root_len;
+                while (*path == '/') path++;
+            }
+            draw_search_path(row, 4, path, false, width - 5);
+            wattrset(main_win, A_NORMAL);
+        }
+    }
+
+    wnoutrefresh(main_win);
+}
+
+// 비교 트리 한쪽의 크기 칸 (없으면 "-", 디렉토리와 링크는 종류)
+static void format_compare_side(const CompareNode *node, int side, char *buf, size_t buf_size) {
+    if (node->type[side] == DT_UNKNOWN) {
+        snprintf(buf, buf_size, "-");
+    } else if (node->type[side] == DT_DIR) {
+        snprintf(buf, buf_size, "<DIR>");
+    } else if (node->type[side] == DT_LNK) {
+        snprintf(buf, buf_size, "<LINK>");
+    } else {
+        format_size(node->size[side], buf, buf_size);
+    }
+}
+
+// 상태별 수 요약 ("다름 3  왼쪽만 1  오른쪽만 2"), 같음은 with_same일 때만
+static void format_compare_counts(const long counts[COMPARE_STATES], bool with_same, char *buf, size_t buf_size) {
+    static const char *labels[COMPARE_STATES] = { "같음", "다름", "왼쪽만", "오른쪽만" };
+    static const CompareState order[COMPARE_STATES] = {
+        COMPARE_DIFFERENT, COMPARE_LEFT_ONLY, COMPARE_RIGHT_ONLY, COMPARE_SAME
+    };
+    size_t len = 0;
+    buf[0] = '\0';
+    for (int i = 0; i < COMPARE_STATES && len < buf_size; i++) {
+        CompareState state = order[i];
+        if (counts[state] == 0 || (state == COMPARE_SAME && !with_same)) continue;
+        len += (size_t)snprintf(buf + len, buf_size - len, "%s%s %ld", len > 0 ? "  " : "", labels[state], counts[state]);
+    }
+}
+
+void ui_display_compare(const CompareTask *task, long dirs_scanned) {
+    int height, width;
+    getmaxyx(main_win, height, width);
+    werase(main_win);
+    invalidate_list_area(); // 목록으로 돌아가면 전체 다시 그림
+    if (height < 3 || width < 40) {
+        wnoutrefresh(main_win);
+        return;
+    }
+
+    wattron(main_win, A_BOLD | COLOR_PAIR(COLOR_PAIR_REGULAR));
+    mvwprintw(main_win, 0, 0, "%.*s", width,
+              "디렉토리 비교   ↑↓: 선택  Enter/→: 들어가기  ←/Backspace: 위로  a: 같은 항목 보이기  c: 내용 비교  g: 두 칸에서 보기  r: 다시 비교  ESC: 닫기");
+    wattroff(main_win, A_BOLD | COLOR_PAIR(COLOR_PAIR_REGULAR));
+
+    if (!task->finished) {
+        if (task->stage == COMPARE_STAGE_SCAN) {
+            mvwprintw(main_win, 1, 0, "양쪽 읽는 중...  디렉토리 %ld개  항목 왼쪽 %ld개 / 오른쪽 %ld개  (x: 멈추기)",
+                      dirs_scanned, task->entries[0], task->entries[1]);
+        } else {
+            char bytes[16];
+            format_size(task->bytes_read, bytes, sizeof(bytes));
+            mvwprintw(main_win, 1, 0, "크기가 같은 파일의 내용 비교  %ld/%ld  읽은 양 %s  (x: 멈추기)",
+                      task->stage_done, task->stage_total, bytes);
+        }
+        draw_search_path(2, 1, task->root[0], false, width - 2);
+        draw_search_path(3, 1, task->root[1], false, width - 2);
+        wnoutrefresh(main_win);
+        return;
+    }
+    if (!task->tree) {
+        mvwprintw(main_win, 1, 2, "멈춘 뒤에는 결과가 없습니다");
+        wnoutrefresh(main_win);
+        return;
+    }
+
+    // 현재 디렉토리 (시작 디렉토리 기준)와 그 아래 전체의 합계
+    const CompareNode *node = task->current;
+    char counts[128];
+    format_compare_counts(node->counts, true, counts, sizeof(counts));
+    char status[192];
+    snprintf(status, sizeof(status), "%s%s%s", counts[0] ? counts : "비어 있음",
+             task->content ? "  (내용 비교)" : "", task->cancelled ? "  (중간에 멈춤)" : "");
+    int status_col = width - display_width(status, width, NULL) - 1;
+    if (status_col < 0) status_col = 0;
+    char path[MAX_PATH_LEN];
+    compare_node_path(task, node, -1, path, sizeof(path));
+    draw_search_path(1, 0, path, false, status_col - 1 > 0 ? status_col - 1 : 0);
+    mvwaddstr(main_win, 1, status_col, status);
+
+    // 상태  왼쪽 크기  오른쪽 크기  이름  (디렉토리는 하위 차이 합계)
+    static const char marks[COMPARE_STATES] = { '=', '*', '<', '>' };
+    int name_col = 2 + 2 + 9 + 2 + 9 + 2;
+    int rows = compare_row_count(task);
+    int visible = height - 2;
+    int offset = task->selection >= visible ? task->selection - visible + 1 : 0;
+    int r = 0, shown = 0;
+    for (int c = 0; c < node->child_count && r < visible; c++) {
+        const CompareNode *child = node->children[c];
+        if (!task->show_same && child->state == COMPARE_SAME) continue;
+        if (shown++ < offset) continue;
+        int i = offset + r;
+        int row = 2 + r++;
+
+        attr_t attr = (i == task->selection) ? COLOR_PAIR(COLOR_PAIR_HIGHLIGHT) : COLOR_PAIR(COLOR_PAIR_REGULAR);
+        if (child->state != COMPARE_SAME) attr |= A_BOLD;
+        wattrset(main_win, attr);
+        mvwhline(main_win, row, 0, ' ', width);
+        char left[16], right[16];
+        format_compare_side(child, 0, left, sizeof(left));
+        format_compare_side(child, 1, right, sizeof(right));
+        mvwprintw(main_win, row, 2, "%c  %9s  %9s", marks[child->state], left, right);
+
+        bool is_dir = (child->type[0] == DT_DIR || child->type[1] == DT_DIR);
+        char summary[128] = "";
+        if (is_dir) {
+            char dir_counts[120];
+            format_compare_counts(child->counts, false, dir_counts, sizeof(dir_counts));
+            if (dir_counts[0]) snprintf(summary, sizeof(summary), "  (%s)", dir_counts);
+        }
+        int summary_width = display_width(summary, width, NULL);
+        int room = width - name_col - 1 - (is_dir ? 1 : 0);
+        if (room - summary_width >= 8) room -= summary_width; // 이름이 너무 짧아지면 합계는 생략
+        else summary[0] = '\0';
+        int name_bytes;
+        display_width(child->name, room > 0 ? room : 0, &name_bytes);
+        mvwaddnstr(main_win, row, name_col, child->name, name_bytes);
+        if (is_dir) waddch(main_win, '/');
+        if (summary[0]) waddstr(main_win, summary);
+        wattrset(main_win, A_NORMAL);
+    }
+    if (rows == 0) {
+        mvwprintw(main_win, 2, 2, node->child_count == 0 ? "비어 있음" : "차이가 없습니다 (a: 같은 항목 보이기)");
+    }
+
+    wnoutrefresh(main_win);
 }
 
 // 복사 작업 취소 확인 함수
-bool ui_confirm_cancel_copy(const char* filename) {
+void ui_confirm_cancel_copy(const char* filename) {
     char message[MAX_PATH_LEN + 30];
-    snprintf(message, sizeof(message), "'%s' 복사를 취소하시겠습니까?", filename);
-    return ui_show_confirmation_dialog(message);
+    snprintf(message, sizeof(message), "'%s' 작업을 취소하시겠습니까?", filename);
+    ui_show_confirmation_dialog(message);
 }
@@ -3,6 +3,12 @@
 
 #include <ncurses.h> // ncurses 라이브러리 사용을 위한 헤더
 #include <ncursesw/ncurses.h> // 한글문제 해결해보기
+#include "filter.h"  // FuzzyMatch (퍼지 찾기 결과)
+#include "preview.h" // Preview (미리보기 칸)
+#include "search.h"  // SearchHit (하위 디렉토리 찾기 결과)
+#include "usage.h"   // UsageTask (디스크 사용량 트리)
+#include "dupes.h"   // DupesTask (중복 파일 묶음)
+#include "compare.h" // CompareTask (두 디렉토리 비교 트리)
 #include "fs.h"      // FileEntry 구조체와 MAX_FILES 등을 사용하기 위해 포함 (fs.h에 정의되어 있다고 가정)
 
 // 색상 쌍(Color Pair) 정의 (사용자 정의 가능)
@@ -11,12 +17,16 @@
 #define COLOR_PAIR_FOOTER 3    // 하단 정보 표시용 색상 쌍 ID
 #define COLOR_PAIR_COPYING 4   // 복사 중 파일용 색상 쌍 ID (파란색)
 #define COLOR_PAIR_COPYING_SELECTED 5 // 복사 중이면서 선택된 상태용 색상 쌍 ID
+#define COLOR_PAIR_MARKED 6    // 표시(mark)된 항목용 색상 쌍 ID (노란색)
 
 // 푸터 높이 정의
 #define FOOTER_HEIGHT_PATH 1
 #define FOOTER_HEIGHT_STATS 1
 #define FOOTER_TOTAL_HEIGHT (FOOTER_HEIGHT_PATH + FOOTER_HEIGHT_STATS)
 
+// 진행률 패널 높이 (작업이 있는 동안 푸터 바로 위에 예약)
+#define PROGRESS_PANEL_HEIGHT 5
+
 /**
  * @brief ncurses 화면 및 UI 설정을 초기화합니다.
  * 프로그램 시작 시 한 번 호출되어야 합니다.
@@ -44,6 +54,21 @@ void close_ui();
  */
 void display_files(FileEntry files[], int num_files, int current_selection, int scroll_offset);
 
+// 분할 화면 켜기/끄기 (다음 프레임에 두 칸을 전체 다시 그림, 오른쪽 칸의 용도가 바뀔 때도 호출)
+void ui_set_split(bool enabled);
+
+// 분할 화면의 한 칸(0: 왼쪽, 1: 오른쪽)에 목록 표시 (첫 줄은 칸의 경로, focused면 선택 항목 강조)
+// 칸마다 렌더 캐시가 따로 있어 바뀐 행만 다시 그림
+void display_files_split(int side, FileEntry files[], int num_files, int current_selection, int scroll_offset,
+                         const char *path, bool focused);
+
+// 미리보기 칸 표시 (분할 화면의 오른쪽 칸 자리, ui_set_split(true)와 함께 사용)
+// 보이는 줄만 읽고, 파일/위치/보기 방식이 바뀐 경우에만 다시 그림. 아직 열지 않았으면 이름과 "..."만
+void ui_display_preview(Preview *preview, const char *name);
+
+// 미리보기 16진수 보기의 한 줄 바이트 수 (칸 너비에 따라 16 또는 8)
+int ui_preview_bytes_per_row();
+
 /**
  * @brief 화면 하단에 푸터(footer) 정보를 표시합니다.
  *
@@ -54,8 +79,11 @@ void display_files(FileEntry files[], int num_files, int current_selection, int
  * @param current_path 현재 디렉토리의 절대 경로 문자열.
  * @param num_items_in_dir 현재 디렉토리 내 항목(파일/디렉토리)의 수.
  * @param disk_free_space 사용 가능한 디스크 공간을 나타내는 문자열 (예: "10GB 사용가능").
+ * @param num_marked 표시된 항목 수 (0이면 표시하지 않음).
+ * @param status 경로 뒤에 붙일 상태 (검색어 입력, 필터 등, NULL이면 없음).
  */
-void display_footer(const char* current_path, int num_items_in_dir, const char* disk_free_space);
+void display_footer(const char* current_path, int num_items_in_dir, const char* disk_free_space, int num_marked,
+                    const char* status);
 
 /**
  * @brief 화면의 주 내용 영역을 지웁니다.
@@ -75,16 +103,76 @@ void resize_ui();
 
 // 추가할 함수들
 
-// 확인 다이얼로그 표시
-bool ui_show_confirmation_dialog(const char* message);
+// 대화상자 키 처리 결과
+typedef enum {
+    MODAL_NONE = 0,     // 열린 대화상자 없음
+    MODAL_PENDING,      // 아직 응답 전
+    MODAL_ACCEPTED,     // Enter
+    MODAL_CANCELLED     // ESC
+} ModalResult;
+
+#define TOAST_DURATION_MS 1500 // 임시 메시지 표시 시간
+
+// 대화상자와 알림은 메인 루프의 일부로 동작함 (진행률/목록 갱신이 멈추지 않음)
+// 열린 동안 메인 루프는 키를 ui_modal_handle_key로 넘기고, 응답이 나오면 기다리던 동작을 실행
+
+// 확인 다이얼로그 열기
+void ui_show_confirmation_dialog(const char* message);
+
+// 한 줄 입력 창 열기 (확인 후 ui_modal_input으로 입력값 확인)
+void ui_prompt_input(const char* prompt);
+
+// 대화상자가 열려 있는지
+bool ui_modal_active();
+
+// 열린 대화상자에 키 전달 (응답이 나오면 대화상자를 닫음)
+ModalResult ui_modal_handle_key(int ch);
 
-// 임시 메시지 표시
+// 마지막 입력 창에 입력한 내용
+const char* ui_modal_input();
+
+// 임시 메시지 표시 (기다리지 않고 바로 반환, 일정 시간 뒤 사라짐)
 void ui_display_temporary_message(const char* message, bool is_error);
 
-// 복사 진행률 표시
+// 표시 중인 임시 메시지가 사라질 때까지 남은 시간 (없으면 -1)
+int ui_toast_remaining_ms();
+
+// 대화상자와 임시 메시지를 다른 윈도우 위에 그림 (refresh_screen 직전에 호출)
+void ui_display_overlays();
+
+// 복사 진행률 표시 (NULL이면 패널을 숨기고 목록 영역을 원래대로)
+// 패널은 한 번 만들어 두고, 표시할 내용이 바뀐 경우에만 다시 그림
 void ui_display_copy_progress(CopyTask* task);
 
-// 복사 작업 취소 확인
-bool ui_confirm_cancel_copy(const char* filename);
+// 작업 대시보드 표시 (실행/대기 중인 모든 작업의 처리량, 평균 속도, 남은 시간과 합계)
+// 목록 영역에 그리며 g_tasks_mutex를 잡은 상태에서 호출, 표시한 작업 수 반환
+int ui_display_task_dashboard(CopyTask* tasks, int selection);
+
+// 퍼지 찾기 표시 (목록 영역에 검색어와 점수 순 결과, 맞은 글자는 강조)
+// results의 index는 files 기준이며, match_count는 맞는 전체 항목 수 (results는 그중 상위 일부)
+void ui_display_fuzzy_finder(FileEntry files[], const char *query, const FuzzyMatch *results, int result_count,
+                             int match_count, int total, int selection);
+
+// 하위 디렉토리 찾기 결과 표시 (목록 영역에 찾은 경로와 진행 상태, 찾는 동안 계속 늘어남)
+// 탐색 중이면 task->lock을 잡은 상태에서 호출
+void ui_display_search_results(const SearchTask *task, long dirs_scanned);
+
+// 디스크 사용량 표시 (탐색 중이면 진행 상황, 끝나면 현재 디렉토리의 하위 항목을 크기 순으로 막대와 함께)
+// 탐색 중이면 task->lock을 잡은 상태에서 호출
+void ui_display_usage(const UsageTask *task, long dirs_scanned);
+
+// 중복 파일 표시 (찾는 중이면 단계별 진행 상황, 끝나면 낭비 크기 순 묶음과 그 안의 파일)
+// 찾는 중이면 task->lock을 잡은 상태에서 호출
+void ui_display_dupes(const DupesTask *task, long dirs_scanned);
+
+// 디렉토리 비교 표시 (비교 중이면 진행 상황, 끝나면 현재 디렉토리의 하위 항목을 양쪽 크기와 상태로, 디렉토리는 차이 합계와 함께)
+// 비교 중이면 task->lock을 잡은 상태에서 호출
+void ui_display_compare(const CompareTask *task, long dirs_scanned);
+
+// 현재 파일 목록에 보이는 행 수 (진행률 패널이 보이면 그만큼 줄어듦)
+int ui_list_height();
+
+// 복사 작업 취소 확인 창 열기
+void ui_confirm_cancel_copy(const char* filename);
 
 #endif // UI_H
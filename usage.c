@@ -0,0 +1,222 @@
+// usage.c
+#include "usage.h"
+#include "event.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <dirent.h>
+#include <sys/stat.h>
+
+static UsageNode* usage_node_new(UsageNode *parent, const char *name, unsigned char d_type) {
+    size_t name_len = strlen(name);
+    UsageNode *node = calloc(1, sizeof(UsageNode) + name_len + 1);
+    if (!node) return NULL;
+    node->parent = parent;
+    node->d_type = d_type;
+    memcpy(node->name, name, name_len + 1);
+    return node;
+}
+
+// 하위 항목 추가 (디렉토리를 읽는 스레드만 그 디렉토리의 노드를 고치므로 잠금 없음)
+static bool usage_node_append(UsageNode *parent, UsageNode *child) {
+    if (parent->child_count == parent->child_capacity) {
+        int capacity = parent->child_capacity ? parent->child_capacity * 2 : 8;
+        UsageNode **grown = realloc(parent->children, sizeof(UsageNode*) * capacity);
+        if (!grown) return false;
+        parent->children = grown;
+        parent->child_capacity = capacity;
+    }
+    parent->children[parent->child_count++] = child;
+    return true;
+}
+
+static void usage_node_free(UsageNode *node) {
+    if (!node) return;
+    for (int i = 0; i < node->child_count; i++) {
+        usage_node_free(node->children[i]);
+    }
+    free(node->children);
+    free(node);
+}
+
+// 하드 링크가 여럿인 파일은 (장치, inode)로 한 번만 셈 - 처음 보면 false
+static bool usage_seen_link(UsageTask *task, const struct stat *st) {
+    unsigned int bucket = (unsigned int)((st->st_ino * 31u + st->st_dev) % USAGE_LINK_BUCKETS);
+    bool seen = false;
+    pthread_mutex_lock(&task->lock);
+    for (UsageLink *link = task->links[bucket]; link; link = link->next) {
+        if (link->dev == st->st_dev && link->ino == st->st_ino) {
+            seen = true;
+            break;
+        }
+    }
+    if (!seen) {
+        UsageLink *link = malloc(sizeof(UsageLink));
+        if (link) {
+            link->dev = st->st_dev;
+            link->ino = st->st_ino;
+            link->next = task->links[bucket];
+            task->links[bucket] = link;
+        }
+    }
+    pthread_mutex_unlock(&task->lock);
+    return seen;
+}
+
+static bool usage_enter_dir(Walker *w, WalkDir *dir, int dirfd) {
+    (void)dirfd;
+    if (!dir->parent) dir->data = ((UsageTask*)w->user)->tree;
+    return dir->data != NULL;
+}
+
+// sum[0] = 겉보기 크기, sum[1] = 할당 크기, sum[2] = 항목 수
+// 하위 디렉토리 자신의 크기는 여기서 상위에 더하고, 그 안의 내용은 leave_dir에서 합쳐짐
+static bool usage_visit(Walker *w, WalkDir *dir, int dirfd, const char *name,
+                        unsigned char d_type, const struct stat *st) {
+    (void)dirfd;
+    UsageTask *task = (UsageTask*)w->user;
+    UsageNode *parent = (UsageNode*)dir->data;
+    if (!parent || !st) return false;
+
+    UsageNode *node = usage_node_new(parent, name, d_type);
+    if (!node) return false;
+    if (!usage_node_append(parent, node)) {
+        free(node);
+        return false;
+    }
+
+    if (d_type != DT_DIR && st->st_nlink > 1 && usage_seen_link(task, st)) {
+        node->hardlink = true;
+    } else {
+        node->apparent = st->st_size;
+        node->allocated = (off_t)st->st_blocks * 512;
+    }
+    dir->sum_self[0] += node->apparent;
+    dir->sum_self[1] += node->allocated;
+    dir->sum_self[2]++;
+
+    if (d_type == DT_DIR) {
+        dir->child_data = node;
+        return true;
+    }
+    return false;
+}
+
+// 하위 항목이 모두 끝나면 디렉토리 합계 확정 (자신의 크기는 상위의 visit에서 이미 들어 있음)
+static void usage_leave_dir(Walker *w, WalkDir *dir) {
+    UsageTask *task = (UsageTask*)w->user;
+    UsageNode *node = (UsageNode*)dir->data;
+    if (node) {
+        node->apparent += dir->sum_self[0] + dir->sum_children[0];
+        node->allocated += dir->sum_self[1] + dir->sum_children[1];
+        node->items = (long)(dir->sum_self[2] + dir->sum_children[2]);
+    }
+
+    bool wake = false;
+    pthread_mutex_lock(&task->lock);
+    task->files += (long)dir->sum_self[2];
+    task->allocated += dir->sum_self[1];
+    if (!dir->parent) {
+        task->finished = true;
+        task->cancelled = w->cancel;
+        wake = true;
+    } else {
+        long now = event_now_ms();
+        if (now - task->last_notify_ms >= USAGE_NOTIFY_MS) {
+            task->last_notify_ms = now;
+            wake = true;
+        }
+    }
+    pthread_mutex_unlock(&task->lock);
+    if (wake) notify_ui();
+}
+
+bool usage_start(UsageTask *task, const char *root, bool one_filesystem) {
+    memset(task, 0, sizeof(UsageTask));
+    snprintf(task->root, sizeof(task->root), "%s", root);
+
+    struct stat st;
+    if (stat(task->root, &st) == -1 || !S_ISDIR(st.st_mode)) return false;
+    task->tree = usage_node_new(NULL, "", DT_DIR);
+    if (!task->tree) return false;
+    task->tree->apparent = st.st_size;
+    task->tree->allocated = (off_t)st.st_blocks * 512;
+
+    pthread_mutex_init(&task->lock, NULL);
+    WalkOps ops = { .enter_dir = usage_enter_dir, .visit = usage_visit, .leave_dir = usage_leave_dir };
+    walker_init(&task->walker, &ops, task);
+    task->walker.need_stat = true; // 크기와 블록 수, 하드 링크 수가 모두 필요
+    task->walker.one_filesystem = one_filesystem;
+    task->current = task->tree;
+    task->active = true;
+
+    if (!walker_start(&task->walker, task->root)) {
+        task->finished = true;
+    }
+    return true;
+}
+
+void usage_cancel(UsageTask *task) {
+    if (!task->active) return;
+    walker_cancel(&task->walker);
+}
+
+void usage_stop(UsageTask *task) {
+    if (!task->active) return;
+    walker_cancel(&task->walker);
+    walker_wait(&task->walker);
+    walker_destroy(&task->walker);
+    usage_node_free(task->tree);
+    for (int i = 0; i < USAGE_LINK_BUCKETS; i++) {
+        UsageLink *link = task->links[i];
+        while (link) {
+            UsageLink *next = link->next;
+            free(link);
+            link = next;
+        }
+    }
+    pthread_mutex_destroy(&task->lock);
+    memset(task, 0, sizeof(UsageTask));
+}
+
+long usage_dirs_scanned(UsageTask *task) {
+    pthread_mutex_lock(&task->walker.lock);
+    long dirs = task->walker.dirs_scanned;
+    pthread_mutex_unlock(&task->walker.lock);
+    return dirs;
+}
+
+static int compare_allocated(const void *a, const void *b) {
+    const UsageNode *x = *(const UsageNode *const *)a;
+    const UsageNode *y = *(const UsageNode *const *)b;
+    if (x->allocated != y->allocated) return x->allocated < y->allocated ? 1 : -1;
+    return strcmp(x->name, y->name);
+}
+
+static int compare_apparent(const void *a, const void *b) {
+    const UsageNode *x = *(const UsageNode *const *)a;
+    const UsageNode *y = *(const UsageNode *const *)b;
+    if (x->apparent != y->apparent) return x->apparent < y->apparent ? 1 : -1;
+    return strcmp(x->name, y->name);
+}
+
+void usage_sort(UsageNode *node, bool by_apparent) {
+    if (node->child_count > 1) {
+        qsort(node->children, node->child_count, sizeof(UsageNode*),
+              by_apparent ? compare_apparent : compare_allocated);
+    }
+}
+
+void usage_node_path(const UsageTask *task, const UsageNode *node, char *out, size_t out_size) {
+    // 시작 디렉토리까지 올라가며 이름을 뒤에서부터 채움
+    const char *names[MAX_PATH_LEN / 2];
+    int depth = 0;
+    for (const UsageNode *n = node; n && n->parent && depth < (int)(sizeof(names) / sizeof(names[0])); n = n->parent) {
+        names[depth++] = n->name;
+    }
+    size_t len = (size_t)snprintf(out, out_size, "%s", task->root);
+    for (int i = depth - 1; i >= 0 && len < out_size; i--) {
+        bool slash = len > 0 && out[len - 1] == '/';
+        len += (size_t)snprintf(out + len, out_size - len, "%s%s", slash ? "" : "/", names[i]);
+    }
+}
@@ -0,0 +1,75 @@
+// usage.h
+#ifndef USAGE_H
+#define USAGE_H
+
+#include <stdbool.h>
+#include <sys/types.h>
+#include <pthread.h>
+#include "fs.h"
+#include "walk.h"
+
+#define USAGE_LINK_BUCKETS 4096   // 하드 링크 (장치, inode) 집합의 버킷 수
+#define USAGE_NOTIFY_MS 100       // 탐색 중 화면을 깨우는 최소 간격
+
+// 사용량 트리의 항목 하나 (디렉토리면 하위 항목 포함 합계)
+typedef struct UsageNode {
+    struct UsageNode *parent;
+    struct UsageNode **children;
+    int child_count;
+    int child_capacity;
+    off_t apparent;                // 겉보기 크기 (st_size 합)
+    off_t allocated;               // 실제 할당 크기 (st_blocks * 512 합)
+    long items;                    // 하위 항목 수 (자신 제외)
+    unsigned char d_type;
+    bool hardlink;                 // 앞서 센 하드 링크라 크기를 0으로 셈
+    char name[];
+} UsageNode;
+
+// 이미 센 하드 링크
+typedef struct UsageLink {
+    dev_t dev;
+    ino_t ino;
+    struct UsageLink *next;
+} UsageLink;
+
+// 디스크 사용량 분석 - 병렬 탐색기로 하위 디렉토리 전체를 한 번 읽어 메모리에 트리로 두고
+// 탐색이 끝나면 다시 읽지 않고 트리 안에서 오르내림
+typedef struct {
+    bool active;                   // 사용량 화면이 열려 있음
+    Walker walker;
+    char root[MAX_PATH_LEN];
+    UsageNode *tree;               // 시작 디렉토리
+
+    pthread_mutex_t lock;          // 하드 링크 집합과 아래 진행 상황 보호
+    UsageLink *links[USAGE_LINK_BUCKETS];
+    long files;                    // 지금까지 센 항목 수
+    off_t allocated;               // 지금까지 센 할당 크기
+    bool finished;                 // 탐색이 끝남 (취소 포함)
+    bool cancelled;
+    long last_notify_ms;
+
+    // 보기 상태 (메인 스레드 전용, 탐색이 끝난 뒤에만 씀)
+    UsageNode *current;
+    int selection;
+    bool by_apparent;              // 겉보기 크기로 정렬/표시
+} UsageTask;
+
+// 사용량 탐색 시작 (즉시 반환), one_filesystem이면 마운트 지점을 넘지 않음
+bool usage_start(UsageTask *task, const char *root, bool one_filesystem);
+
+// 탐색 취소 (그때까지 읽은 트리는 남음)
+void usage_cancel(UsageTask *task);
+
+// 탐색을 멈추고 트리 해제 (active도 끔)
+void usage_stop(UsageTask *task);
+
+// 읽은 디렉토리 수
+long usage_dirs_scanned(UsageTask *task);
+
+// 하위 항목을 크기 큰 순으로 정렬 (by_apparent면 겉보기 크기 기준)
+void usage_sort(UsageNode *node, bool by_apparent);
+
+// 항목의 절대 경로
+void usage_node_path(const UsageTask *task, const UsageNode *node, char *out, size_t out_size);
+
+#endif
@@ -0,0 +1,349 @@
+// walk.c
+#include "walk.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <dirent.h>
+#include <fcntl.h>
+
+// 기본 워커 수 계산
+int walker_default_threads() {
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    if (cpus < 1) cpus = 1;
+
+    // stat/readdir는 대부분 I/O 대기이므로 CPU 수보다 넉넉하게
+    long threads = cpus * 2;
+    if (threads < 4) threads = 4;
+    if (threads > WALK_MAX_THREADS) threads = WALK_MAX_THREADS;
+    return (int)threads;
+}
+
+// stat 모드를 d_type 값으로 변환
+static unsigned char mode_to_dtype(mode_t mode) {
+    if (S_ISDIR(mode)) return DT_DIR;
+    if (S_ISREG(mode)) return DT_REG;
+    if (S_ISLNK(mode)) return DT_LNK;
+    if (S_ISFIFO(mode)) return DT_FIFO;
+    if (S_ISSOCK(mode)) return DT_SOCK;
+    if (S_ISBLK(mode)) return DT_BLK;
+    if (S_ISCHR(mode)) return DT_CHR;
+    return DT_UNKNOWN;
+}
+
+static void walker_count_error(Walker *w) {
+    pthread_mutex_lock(&w->lock);
+    w->errors++;
+    pthread_mutex_unlock(&w->lock);
+}
+
+// 하위 디렉토리를 작업 스택에 추가
+static void walker_push(Walker *w, WalkDir *parent, const char *name, const struct stat *st) {
+    size_t parent_len = strlen(parent->path);
+    size_t name_len = strlen(name);
+
+    WalkDir *child = calloc(1, sizeof(WalkDir));
+    if (!child) {
+        walker_count_error(w);
+        return;
+    }
+    child->path = malloc(parent_len + name_len + 2);
+    if (!child->path) {
+        free(child);
+        walker_count_error(w);
+        return;
+    }
+
+    // 루트가 "/"인 경우 "//name"이 되지 않도록 처리
+    memcpy(child->path, parent->path, parent_len);
+    size_t pos = parent_len;
+    if (pos == 0 || child->path[pos - 1] != '/') {
+        child->path[pos++] = '/';
+    }
+    memcpy(child->path + pos, name, name_len + 1);
+    child->name = child->path + pos;
+    child->fd = -1;
+
+    child->parent = parent;
+    child->depth = parent->depth + 1;
+    child->root_index = parent->root_index;
+    child->root_dev = parent->root_dev;
+    child->pending = 1;
+    child->data = parent->child_data;
+    if (st) {
+        child->st = *st;
+    }
+
+    pthread_mutex_lock(&w->lock);
+    parent->pending++;
+    child->next = w->stack;
+    w->stack = child;
+    pthread_cond_signal(&w->cond);
+    pthread_mutex_unlock(&w->lock);
+}
+
+// 디렉토리 열기 - 시작 디렉토리만 경로로, 나머지는 상위 디렉토리 fd 기준으로 이름 하나를 O_NOFOLLOW로 열어
+// 경로 중간이 심볼릭 링크로 바뀌어도 밖으로 나가지 않음 (상위 fd를 열어 두지 못했으면 상위도 같은 방법으로 다시 엶)
+static int walker_open_dir(const WalkDir *dir) {
+    if (!dir->parent) return open(dir->path, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+
+    int parent_fd = dir->parent->fd;
+    bool reopened = false;
+    if (parent_fd == -1) {
+        parent_fd = walker_open_dir(dir->parent);
+        if (parent_fd == -1) return -1;
+        reopened = true;
+    }
+    int fd = openat(parent_fd, dir->name, O_RDONLY | O_DIRECTORY | O_NOFOLLOW | O_CLOEXEC);
+    if (reopened) close(parent_fd);
+    return fd;
+}
+
+int walker_open_parent(const WalkDir *dir) {
+    if (!dir->parent) return -1;
+    if (dir->parent->fd != -1) return fcntl(dir->parent->fd, F_DUPFD_CLOEXEC, 0);
+    return walker_open_dir(dir->parent);
+}
+
+// 디렉토리 하나를 읽으며 엔트리마다 콜백 호출
+static void walker_scan_dir(Walker *w, WalkDir *dir) {
+    if (w->cancel) return;
+
+    int fd = walker_open_dir(dir);
+    if (fd == -1) {
+        walker_count_error(w);
+        return;
+    }
+
+    // d_type만으로 내려온 디렉토리는 여기서 stat 채움
+    if (dir->st.st_ino == 0 && fstat(fd, &dir->st) == -1) {
+        close(fd);
+        walker_count_error(w);
+        return;
+    }
+
+    // 마운트 지점을 넘지 않도록
+    if (w->one_filesystem && dir->st.st_dev != dir->root_dev) {
+        close(fd);
+        return;
+    }
+
+    if (w->ops.enter_dir && !w->ops.enter_dir(w, dir, fd)) {
+        close(fd);
+        return;
+    }
+
+    // 하위 디렉토리가 끝날 때까지 fd를 열어 둠 (한도를 넘으면 하위가 위에서부터 다시 엶)
+    bool can_descend = (w->max_depth < 0 || dir->depth < w->max_depth);
+    if (can_descend) {
+        pthread_mutex_lock(&w->lock);
+        if (w->held_fds < WALK_MAX_HELD_FDS) {
+            dir->fd = fcntl(fd, F_DUPFD_CLOEXEC, 0);
+            if (dir->fd != -1) w->held_fds++;
+        }
+        pthread_mutex_unlock(&w->lock);
+    }
+
+    DIR *d = fdopendir(fd);
+    if (!d) {
+        close(fd);
+        walker_count_error(w);
+        return;
+    }
+
+    struct dirent *entry;
+    while ((entry = readdir(d)) != NULL) {
+        if (w->cancel) break;
+
+        const char *name = entry->d_name;
+        if (name[0] == '.' && (name[1] == '\0' || (name[1] == '.' && name[2] == '\0'))) {
+            continue;
+        }
+
+        struct stat st;
+        const struct stat *stp = NULL;
+        unsigned char type = entry->d_type;
+
+        // d_type을 모르는 파일시스템이거나 stat이 필요할 때만 fstatat
+        if (w->need_stat || type == DT_UNKNOWN) {
+            if (fstatat(fd, name, &st, AT_SYMLINK_NOFOLLOW) == -1) {
+                walker_count_error(w);
+                continue;
+            }
+            stp = &st;
+            type = mode_to_dtype(st.st_mode);
+        }
+
+        dir->child_data = NULL;
+        bool descend = w->ops.visit ? w->ops.visit(w, dir, fd, name, type, stp) : true;
+
+        if (descend && type == DT_DIR && can_descend) {
+            if (w->one_filesystem && stp && stp->st_dev != dir->root_dev) {
+                continue;
+            }
+            walker_push(w, dir, name, stp);
+        }
+    }
+
+    closedir(d);
+    pthread_mutex_lock(&w->lock);
+    w->dirs_scanned++;
+    pthread_mutex_unlock(&w->lock);
+}
+
+// 디렉토리 처리 완료 - 하위가 모두 끝났으면 post-order 콜백 후 상위로 전파
+static void walker_release(Walker *w, WalkDir *dir) {
+    while (dir) {
+        pthread_mutex_lock(&w->lock);
+        bool last = (--dir->pending == 0);
+        pthread_mutex_unlock(&w->lock);
+        if (!last) return;
+
+        if (w->ops.leave_dir) {
+            w->ops.leave_dir(w, dir);
+        }
+        if (dir->fd != -1) close(dir->fd);
+
+        WalkDir *parent = dir->parent;
+        pthread_mutex_lock(&w->lock);
+        if (dir->fd != -1) w->held_fds--;
+        if (parent) {
+            for (int i = 0; i < WALK_SUMS; i++) {
+                parent->sum_children[i] += dir->sum_self[i] + dir->sum_children[i];
+            }
+        } else if (--w->roots_pending == 0) {
+            // 모든 시작 디렉토리가 끝나면 전체 탐색 완료
+            w->done = true;
+            pthread_cond_broadcast(&w->cond);
+        }
+        pthread_mutex_unlock(&w->lock);
+
+        free(dir->path);
+        free(dir);
+        dir = parent;
+    }
+}
+
+// 워커 스레드
+static void* walker_thread(void *arg) {
+    Walker *w = (Walker*)arg;
+
+    while (1) {
+        pthread_mutex_lock(&w->lock);
+        while (!w->stack && !w->done) {
+            pthread_cond_wait(&w->cond, &w->lock);
+        }
+        if (!w->stack) {
+            pthread_mutex_unlock(&w->lock);
+            break;
+        }
+        WalkDir *dir = w->stack;
+        w->stack = dir->next;
+        pthread_mutex_unlock(&w->lock);
+
+        walker_scan_dir(w, dir);
+        walker_release(w, dir);
+    }
+
+    return NULL;
+}
+
+void walker_init(Walker *w, const WalkOps *ops, void *user) {
+    memset(w, 0, sizeof(Walker));
+    if (ops) w->ops = *ops;
+    w->user = user;
+    w->max_depth = -1;
+    w->need_stat = true;
+    pthread_mutex_init(&w->lock, NULL);
+    pthread_cond_init(&w->cond, NULL);
+}
+
+bool walker_start(Walker *w, const char *root) {
+    return walker_start_multi(w, &root, 1);
+}
+
+bool walker_start_multi(Walker *w, const char *const *roots, int count) {
+    w->done = false;
+    w->stack = NULL;
+    w->roots_pending = 0;
+
+    for (int i = 0; i < count; i++) {
+        struct stat st;
+        if (stat(roots[i], &st) == -1 || !S_ISDIR(st.st_mode)) {
+            continue;
+        }
+
+        WalkDir *dir = calloc(1, sizeof(WalkDir));
+        if (!dir) continue;
+        dir->path = strdup(roots[i]);
+        if (!dir->path) {
+            free(dir);
+            continue;
+        }
+        dir->name = dir->path;
+        dir->fd = -1;
+        dir->st = st;
+        dir->pending = 1;
+        dir->root_index = i;
+        dir->root_dev = st.st_dev;
+
+        dir->next = w->stack;
+        w->stack = dir;
+        w->roots_pending++;
+    }
+
+    if (w->roots_pending == 0) {
+        w->done = true;
+        return false;
+    }
+
+    int nthreads = w->nthreads > 0 ? w->nthreads : walker_default_threads();
+    if (nthreads > WALK_MAX_THREADS) nthreads = WALK_MAX_THREADS;
+
+    w->started_threads = 0;
+    for (int i = 0; i < nthreads; i++) {
+        if (pthread_create(&w->threads[w->started_threads], NULL, walker_thread, w) == 0) {
+            w->started_threads++;
+        }
+    }
+
+    // 스레드를 하나도 만들지 못하면 현재 스레드에서 직접 처리
+    if (w->started_threads == 0) {
+        walker_thread(w);
+    }
+    return true;
+}
+
+void walker_wait(Walker *w) {
+    for (int i = 0; i < w->started_threads; i++) {
+        pthread_join(w->threads[i], NULL);
+    }
+    w->started_threads = 0;
+}
+
+bool walker_run(Walker *w, const char *root) {
+    if (!walker_start(w, root)) {
+        return false;
+    }
+    walker_wait(w);
+    return true;
+}
+
+void walker_cancel(Walker *w) {
+    pthread_mutex_lock(&w->lock);
+    w->cancel = true;
+    pthread_cond_broadcast(&w->cond);
+    pthread_mutex_unlock(&w->lock);
+}
+
+bool walker_finished(Walker *w) {
+    pthread_mutex_lock(&w->lock);
+    bool done = w->done;
+    pthread_mutex_unlock(&w->lock);
+    return done;
+}
+
+void walker_destroy(Walker *w) {
+    pthread_mutex_destroy(&w->lock);
+    pthread_cond_destroy(&w->cond);
+}
@@ -0,0 +1,100 @@
+// walk.h
+#ifndef WALK_H
+#define WALK_H
+
+#include <stdbool.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <pthread.h>
+
+#define WALK_MAX_THREADS 8
+#define WALK_SUMS 3 // 디렉토리별 누적 값 개수 (예: 바이트, 블록, 파일 수)
+#define WALK_MAX_HELD_FDS 256 // 하위 디렉토리를 openat하려고 열어 두는 디렉토리 fd 최대 수
+
+// 탐색 중인 디렉토리 하나
+typedef struct WalkDir {
+    struct WalkDir *parent;     // 상위 디렉토리 (루트는 NULL)
+    char *path;                 // 디렉토리 절대 경로
+    const char *name;           // 상위 디렉토리 안에서의 이름 (path의 마지막 부분)
+    int fd;                     // 하위 디렉토리를 여는 기준으로 열어 둔 fd (-1이면 없음, leave_dir 뒤에 닫힘)
+    int depth;                  // 시작 디렉토리 = 0
+    int root_index;             // 여러 시작 디렉토리 중 몇 번째 아래인지
+    dev_t root_dev;             // 시작 디렉토리의 장치 번호
+    struct stat st;             // 디렉토리 자신의 stat
+    int pending;                // 자신 + 아직 끝나지 않은 하위 디렉토리 수
+    off_t sum_self[WALK_SUMS];  // visit 중 누적 (해당 디렉토리를 읽는 스레드 전용)
+    off_t sum_children[WALK_SUMS]; // 하위 디렉토리 완료 시 자동 합산 (walker 잠금으로 보호)
+    void *data;                 // 콜백이 자유롭게 쓰는 데이터
+    void *child_data;           // visit에서 설정하면 그 엔트리로 만들어지는 하위 디렉토리의 data가 됨 (엔트리마다 비움)
+    struct WalkDir *next;       // 작업 스택 연결
+} WalkDir;
+
+typedef struct Walker Walker;
+
+// 탐색 콜백 (여러 워커 스레드에서 동시에 호출됨)
+typedef struct {
+    // 디렉토리를 연 직후 호출. false 반환 시 내용을 읽지 않음 (NULL 가능)
+    bool (*enter_dir)(Walker *w, WalkDir *dir, int dirfd);
+    // 엔트리 하나마다 호출. st는 need_stat이거나 디렉토리 판별에 필요할 때만 채워짐 (아니면 NULL)
+    // 디렉토리에 대해 true를 반환하면 하위로 내려감
+    bool (*visit)(Walker *w, WalkDir *dir, int dirfd, const char *name,
+                  unsigned char d_type, const struct stat *st);
+    // 하위 항목이 모두 끝난 뒤 호출 (post-order). 이후 WalkDir는 해제됨 (NULL 가능)
+    void (*leave_dir)(Walker *w, WalkDir *dir);
+} WalkOps;
+
+// 병렬 디렉토리 탐색기
+struct Walker {
+    WalkOps ops;
+    void *user;                 // 콜백용 사용자 데이터
+    int max_depth;              // 최대 깊이 (음수면 무제한)
+    bool one_filesystem;        // 다른 파일시스템으로 넘어가지 않음
+    bool need_stat;             // 모든 엔트리에 fstatat 수행
+    int nthreads;               // 워커 스레드 수 (0이면 기본값)
+    volatile bool cancel;       // 취소 요청
+
+    // 내부 상태
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    WalkDir *stack;             // 아직 읽지 않은 디렉토리들
+    bool done;
+    int roots_pending;          // 아직 끝나지 않은 시작 디렉토리 수
+    pthread_t threads[WALK_MAX_THREADS];
+    int started_threads;
+    long dirs_scanned;          // 통계: 읽은 디렉토리 수
+    long errors;                // 통계: 열기/stat 실패 수
+    int held_fds;               // 열어 둔 WalkDir.fd 수 (WALK_MAX_HELD_FDS까지)
+};
+
+// 기본 워커 수 (CPU 수 기반, I/O 대기를 고려해 넉넉히)
+int walker_default_threads();
+
+// 탐색기 초기화 (기본값: 깊이 무제한, stat 필요, 같은 파일시스템 제한 없음)
+void walker_init(Walker *w, const WalkOps *ops, void *user);
+
+// 백그라운드 탐색 시작 (즉시 반환)
+bool walker_start(Walker *w, const char *root);
+
+// 여러 시작 디렉토리를 한 스레드 풀로 탐색 (디렉토리가 아닌 경로는 건너뜀)
+bool walker_start_multi(Walker *w, const char *const *roots, int count);
+
+// 탐색이 끝날 때까지 대기 후 스레드 정리
+void walker_wait(Walker *w);
+
+// 시작 + 대기
+bool walker_run(Walker *w, const char *root);
+
+// 탐색 취소 요청 (콜백 안에서도 호출 가능)
+void walker_cancel(Walker *w);
+
+// 탐색이 끝났는지 확인
+bool walker_finished(Walker *w);
+
+// dir의 상위 디렉토리를 새 fd로 (열어 둔 fd를 복제하거나 시작 디렉토리부터 이름 하나씩 다시 엶, 호출자가 닫음)
+// leave_dir에서 경로 대신 상위 fd 기준으로 지울 때 사용, 시작 디렉토리거나 열 수 없으면 -1
+int walker_open_parent(const WalkDir *dir);
+
+// 탐색기 자원 해제 (walker_wait 이후)
+void walker_destroy(Walker *w);
+
+#endif